@@ -79,6 +79,17 @@ bool isBlockCulled(int type, int dataVal)
     return gIsCulledByIndex[idx] != 0;
 }
 
+unsigned int cullingSchemeHash()
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < NUM_CULL_ENTRIES; i++) {
+        hash ^= gIsCulledByIndex[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 // =============================================================================================
 // Registry persistence (CullingManager) — parallel to ColorManager
 // =============================================================================================
@@ -75,3 +75,6 @@ void applyCullingScheme(const unsigned char* culled);
 // Both pipelines (map render and OBJ/schem export) call this. Returns false if no scheme is
 // active, so the overhead is one branch per voxel in the no-culling case.
 bool isBlockCulled(int type, int dataVal);
+
+// A number that changes when the set of culled blocks does, e.g., to tell if a saved map tile is still good.
+unsigned int cullingSchemeHash();
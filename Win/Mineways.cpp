@@ -36,6 +36,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "publishSkfb.h"
 #endif
 #include "XZip.h"
+#include "parallelzip.h"
 #include "rwpng.h"
 #include <assert.h>
 #include <ShlObj.h>
@@ -118,6 +119,7 @@ static Options gOptions = { 0,   // which world is visible
     0x0,
     0,  // start with low memory
     INITIAL_CACHE_SIZE,	// cache size
+    0,  // export all at once, not in tiles
     NULL };
 
 static WorldGuide gWorldGuide;
@@ -5034,7 +5036,7 @@ static int processSketchfabExport(PublishSkfbData* skfbPData, wchar_t* objFileNa
                 (*updateProgress)(0.90f + 0.10f * (float)i / (float)outputFileList.count, NULL);
             }
 
-            ZipAdd(hz, nameOnly, outputFileList.name[i], 0, ZIP_FILENAME);
+            ZipAddParallel(hz, nameOnly, outputFileList.name[i]);
 
             // delete model files if not needed
             if (!gpEFD->chkCreateModelFiles[gpEFD->fileType])
@@ -5594,7 +5596,7 @@ static int saveObjFile(HWND hWnd, wchar_t* objFileName, int printModel, wchar_t*
                     // reality: if you're zipping and using separate tiles, I'm not going to delete those tiles.
                     // I'm also going to zip the whole folder, vs. messing around trying to export just the tiles needed.
                     // TODO - really should just export tiles needed, but this functionality is a bit tricky.
-                    if (ZipAdd(hz, relativeFile, outputFileList.name[i], 0, ZIP_FILENAME) != ZR_OK)
+                    if (ZipAddParallel(hz, relativeFile, outputFileList.name[i]) != ZR_OK)
                     {
                         retCode |= MW_CANNOT_WRITE_TO_FILE;
                         DWORD errorCode = GetLastError();
@@ -8603,6 +8605,54 @@ JumpToSpawn:
         return INTERPRETER_FOUND_VALID_LINE;
     }
 
+    strPtr = findLineDataNoCase(line, "Export tile size:");
+    if (strPtr != NULL) {
+        int v;
+        if (1 != sscanf_s(strPtr, "%d", &v)) {
+            // bad parse - warn and quit
+            saveErrorMessage(is, L"could not read 'Export tile size' value.", strPtr);
+            return INTERPRETER_FOUND_ERROR;
+        }
+        if (v < 0) {
+            saveErrorMessage(is, L"export tile size must be 0 or more, with '0' meaning no tiles.", strPtr);
+            return INTERPRETER_FOUND_ERROR;
+        }
+        if (is.processData) {
+            gOptions.exportTileSize = v;
+        }
+        return INTERPRETER_FOUND_VALID_LINE;
+    }
+
+    strPtr = findLineDataNoCase(line, "PNG compression:");
+    if (strPtr != NULL) {
+        if (1 != sscanf_s(strPtr, "%s", string1, (unsigned)_countof(string1)))
+        {
+            saveErrorMessage(is, L"could not find value for 'PNG compression' command.");
+            return INTERPRETER_FOUND_ERROR;
+        }
+        int effort;
+        if (_stricmp(string1, "none") == 0) {
+            effort = PNG_EFFORT_STORE;
+        }
+        else if (_stricmp(string1, "fast") == 0) {
+            effort = PNG_EFFORT_FAST;
+        }
+        else if (_stricmp(string1, "default") == 0) {
+            effort = PNG_EFFORT_DEFAULT;
+        }
+        else if (_stricmp(string1, "small") == 0) {
+            effort = PNG_EFFORT_SMALL;
+        }
+        else {
+            saveErrorMessage(is, L"PNG compression must be 'none', 'fast', 'default', or 'small'.", strPtr);
+            return INTERPRETER_FOUND_ERROR;
+        }
+        if (is.processData) {
+            setpngeffort(effort);
+        }
+        return INTERPRETER_FOUND_VALID_LINE;
+    }
+
     strPtr = findLineDataNoCase(line, "Close");
     if (strPtr != NULL) {
         removeLeadingWhitespace(strPtr);
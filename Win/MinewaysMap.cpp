@@ -34,18 +34,34 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include "biomes.h"
 #include "CullingSchemes.h"	// isBlockCulled() — skip culled voxels in the map render
+#include "tilestore.h"
 #include <assert.h>
 #include <string.h>
 
 static void clearUndoHighlight();
 static void copyHighlightState(HighlightBox& destBox, HighlightBox& srcBox);
+typedef struct MapTiles MapTiles;
+static void drawTileRows(MapTiles* pTiles, int firstRow, int numRows, int* hitsFound, int& sumRetCode);
+static void blitTile(MapTiles* pTiles, unsigned char* blockbits, int x, int z);
+static void copyTile(MapTiles* pTiles, unsigned char* blockbits, int x, int z);
 static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int topy, int mapMaxY, Options* pOpts,
-    ProgressCallback callback, float percent, float & pctprogress, int* hitsFound, int mcVersion, int versionID, int& retCode);
+    ProgressCallback callback, float percent, float & pctprogress, int* hitsFound, int mcVersion, int versionID, bool loadMissing, unsigned char* transitionTile, int& retCode);
 static void blit(unsigned char* block, unsigned char* bits, int px, int py, double zoom, int w, int h);
+static void blitCell(unsigned char* cell, unsigned char* bits, int px, int py, int level, int blockScale, int w, int h);
 static WorldBlock* determineMaxFilledHeight(WorldBlock* block);
+static bool fillBlock(WorldGuide* pWorldGuide, WorldBlock* block, int cx, int cz, int& retCode, RegionDecoder* pDecoder, char* unknownBlockName);
 static int createBlockFromSchematic(WorldGuide* pWorldGuide, int cx, int cz, WorldBlock* block);
 static void initColors();
 static void saveBadChunkLocation(int bx, int bz);
+static void prepareStoredTiles(WorldGuide* pWorldGuide, Options* pOpts, int topy, int mapMaxY, bool useStored);
+static bool findStoredTile(int bx, int bz, unsigned char* tile);
+static bool findStoredEastHeights(int bx, int bz, short* eastHeights);
+static void storeTile(int bx, int bz, WorldBlock* block);
+static bool westIsEmpty(int bx, int bz);
+static void shrinkToQuadrant(const unsigned char* tile, unsigned char* cell, int qx, int qz);
+static unsigned char* drawCell(MapTiles* pTiles, int level, int tx, int tz, bool loadMissing, float percent, float& pctprogress,
+    unsigned char* cell, int* hitsFound, int& retCode, bool& complete);
+static int prefetchBlocks(WorldGuide* pWorldGuide, int minbx, int minbz, int maxbx, int maxbz, int worldType, int mcVersion, int versionID, ProgressCallback callback, bool skipStored);
 
 
 static int gColorsInited = 0;
@@ -53,7 +69,11 @@ static unsigned int gBlockColors[NUM_BLOCKS_DEFINED * 16];
 static unsigned char gEmptyR, gEmptyG, gEmptyB;
 static unsigned char gBlankTile[16 * 16 * 4];
 static unsigned char gBlankHighlitTile[16 * 16 * 4];
-static unsigned char gBlankTransitionTile[16 * 16 * 4];
+
+// Zoomed out, the map is drawn with LOD cells, 16x16 tiles each covering 2^level x 2^level chunks, see drawCell().
+#define MAX_LOD_LEVEL 4
+// gBlankTile, shrunk for each level
+static unsigned char gBlankCells[MAX_LOD_LEVEL + 1][16 * 16 * 4];
 
 static unsigned short gColormap = 0;
 // no longer needed: static long long gMapSeed;
@@ -73,6 +93,12 @@ static int gHred = 205;
 static int gHgreen = 50;
 static int gHblue = 255;
 static int gHighlightID = 0;
+
+// draw() blends colors in fixed point, with 1.0 as this. With 31 bits, a float alpha converts exactly, so layers
+// blend to within a level of what doubles gave.
+#define MAP_FIXED_SHIFT 31
+#define MAP_FIXED_ONE (1ULL << MAP_FIXED_SHIFT)
+
 static bool gUndoAvailable = false;
 
 // was an unknown block read in?
@@ -89,9 +115,63 @@ static wchar_t gSeparator[3];
 static int gBx = 0;
 static int gBz = 0;
 
+// for LoadBlocks(), one per worker thread; worker 0 is the calling thread, which uses region.cpp's own main decoder
+static RegionDecoder* gWorkerDecoders[MAX_WORKERS];
+
+// Saved map tiles, see tilestore.h, for the map being drawn: set up by prepareStoredTiles() before any drawing.
+// Tiles drawn are saved when gTileSettings is not 0; chunks not in memory are looked for in the store if gUseStoredTiles.
+static unsigned int gTileSettings = 0;
+static bool gUseStoredTiles = false;
+static wchar_t gTileDirectory[MAX_PATH_AND_FILE];
+
 // when reading in a map and drawing, 1/x how often to update the progress bar
 #define DRAW_PROGRESS_INCREMENT 0.05f
 
+// The grid of chunk tiles DrawMap() or DrawMapToArray() draws, and where each tile goes. Each row of tiles
+// is drawn west to east by one thread, as a chunk's shading uses the heights of the chunk to its west;
+// rows put their pixels in separate parts of the output, so can be drawn at the same time.
+typedef void (*PlaceTile)(MapTiles* pTiles, unsigned char* blockbits, int x, int z);
+struct MapTiles {
+    WorldGuide* pWorldGuide;
+    Options* pOpts;
+    int topy;
+    int mapMaxY;
+    int mcVersion;
+    int versionID;
+    int startxblock;
+    int startzblock;
+    int numX;   // tiles in each row
+    int numZ;   // rows, in all
+    PlaceTile place;
+    // 0 if tiles are chunks, else the tiles are LOD cells of this level, and startxblock, startzblock are cell coordinates
+    int level;
+
+    // output: DrawMap() blits to bits, DrawMapToArray() copies to image
+    unsigned char* bits;
+    unsigned char* image;
+    int w, h;
+    int shiftx, shifty;
+    double zoom;            // DrawMap()
+    int blockScale;         // DrawMap(), pixels across a chunk
+    int firstChunkX;        // DrawMap(), chunk shiftx, shifty are relative to; cells may start before it
+    int firstChunkZ;
+    int cx, cz;             // DrawMapToArray()
+    int imageZoom;          // DrawMapToArray()
+
+    // progress: draw() reports chunk loads, done on the calling thread only; if tileProgress is set,
+    // the count of tiles drawn by all threads is reported, too
+    ProgressCallback callback;
+    float pctprogress;
+    bool tileProgress;
+    volatile LONG tilesDone;
+
+    // for the rows being drawn in parallel: the x each row stopped at, and its results
+    int firstRow;
+    int* rowStop;
+    int* rowRetCode;
+    int (*rowHits)[4];
+};
+
 void SetSeparatorMap(const wchar_t* separator)
 {
     wcscpy_s(gSeparator, 3, separator);
@@ -323,8 +403,6 @@ int DrawMap(WorldGuide* pWorldGuide, double cx, double cz, int topy, int mapMaxY
         }
     }
 
-    unsigned char* blockbits;
-    int z, x, px, py;
     // TODO: zooming out by setting -zl gives a jumpy center point. I can make this smoother by
     // turning a bunch of the things below to doubles (other than startxblock and startzblock),
     // but then the edges don't draw well, and zooming > 1 gives incorrect leftover lines from
@@ -361,26 +439,60 @@ int DrawMap(WorldGuide* pWorldGuide, double cx, double cz, int topy, int mapMaxY
     if (!gColorsInited)
         initColors();
 
-    float pctprogress = DRAW_PROGRESS_INCREMENT;
-    // x increases south, decreases north
-    for (z = 0, py = -shifty; z <= vBlocks; z++, py += blockScale)
-    {
-        // z increases west, decreases east
-        for (x = 0, px = -shiftx; x <= hBlocks; x++, px += blockScale)
-        {
-            blockbits = draw(pWorldGuide, startxblock + x, startzblock + z, topy, mapMaxY, pOpts, callback, (float)(z * hBlocks + x) / (float)(vBlocks * hBlocks), pctprogress, hitsFound, mcVersion, versionID, retCode);
-            if (retCode < 0) {
-                // preserve the error code, which will (mysteriously) be displayed
-                sumRetCode = retCode;
-            }
-            else if (sumRetCode >= 0)
-            {
-                // warnings can chained together
-                sumRetCode |= retCode;
-            } // else sumRetCode has an error code, so don't touch it
-            blit(blockbits, bits, px, py, zoom, w, h);
+    // If the view is more than the block cache can hold, chunks get thrown out and read in again as we draw.
+    // Save the bother for chunks with a tile saved from before. Otherwise keep the chunks loaded, e.g., for IDBlock().
+    prepareStoredTiles(pWorldGuide, pOpts, topy, mapMaxY, (hBlocks + 1) * (vBlocks + 1) > Cache_Capacity() / 2);
+
+    // Zoomed out that far, a chunk is at most 8 pixels across, so draw LOD cells with just enough pixels per chunk.
+    // Once made, cells are saved, so panning around reads only these, not the chunks.
+    int level = 0;
+    if (gUseStoredTiles) {
+        while (level < MAX_LOD_LEVEL && (16 >> (level + 1)) >= blockScale)
+            level++;
+    }
+
+    if (level == 0) {
+        // decode all the chunks in view at once, across all cores, instead of one by one as draw() needs them
+        retCode = prefetchBlocks(pWorldGuide, startxblock, startzblock, startxblock + hBlocks, startzblock + vBlocks, pOpts->worldType, mcVersion, versionID, callback, gUseStoredTiles);
+        if (retCode < 0) {
+            sumRetCode = retCode;
+        }
+        else if (sumRetCode >= 0) {
+            sumRetCode |= retCode;
         }
     }
+
+    MapTiles tiles;
+    memset(&tiles, 0, sizeof(MapTiles));
+    tiles.pWorldGuide = pWorldGuide;
+    tiles.pOpts = pOpts;
+    tiles.topy = topy;
+    tiles.mapMaxY = mapMaxY;
+    tiles.mcVersion = mcVersion;
+    tiles.versionID = versionID;
+    // cells holding the chunks in view; shifting floors negative chunk coordinates, too
+    tiles.startxblock = startxblock >> level;
+    tiles.startzblock = startzblock >> level;
+    tiles.numX = ((startxblock + hBlocks) >> level) - tiles.startxblock + 1;
+    tiles.numZ = ((startzblock + vBlocks) >> level) - tiles.startzblock + 1;
+    tiles.place = blitTile;
+    tiles.level = level;
+    tiles.firstChunkX = startxblock;
+    tiles.firstChunkZ = startzblock;
+    tiles.bits = bits;
+    tiles.w = w;
+    tiles.h = h;
+    tiles.shiftx = shiftx;
+    tiles.shifty = shifty;
+    tiles.zoom = zoom;
+    tiles.blockScale = blockScale;
+    // the loading above is what takes time, and reported progress itself; don't flash the bar on every pan
+    tiles.callback = callback;
+    tiles.pctprogress = DRAW_PROGRESS_INCREMENT;
+    tiles.tileProgress = false;
+
+    // x increases south, decreases north; z increases west, decreases east
+    drawTileRows(&tiles, 0, tiles.numZ, hitsFound, sumRetCode);
     // clear dirty rectangle, if any
     if (gBox.highlightUsed)
     {
@@ -399,6 +511,8 @@ int DrawMap(WorldGuide* pWorldGuide, double cx, double cz, int topy, int mapMaxY
         gDirtyBoxMaxX = gDirtyBoxMaxZ = INT_MIN;
     }
 
+    // don't keep region files mapped between redraws
+    regionReleaseFiles();
     return sumRetCode;
 }
 
@@ -413,11 +527,8 @@ int DrawMap(WorldGuide* pWorldGuide, double cx, double cz, int topy, int mapMaxY
 //opts = bitmasks of render options (see MinewaysMap.h)
 int DrawMapToArray(unsigned char* image, WorldGuide* pWorldGuide, int cx, int cz, int topy, int mapMaxY, int w, int h, int zoom, Options* pOpts, int* hitsFound, ProgressCallback callback, int mcVersion, int versionID)
 {
-    unsigned char* blockbits;
-    int z, x, px, pz;
     int chunkSize = 16;
     int sumRetCode = 0;
-    int retCode;
 
     assert(zoom >= 1);
 
@@ -446,106 +557,470 @@ int DrawMapToArray(unsigned char* image, WorldGuide* pWorldGuide, int cx, int cz
     if (!gColorsInited)
         initColors();
 
-    // x increases south, decreases north
-    int iblockxstart, b2ix, iblockxend, iblockzstart, b2iz, iblockzend;
-    for (z = 0, pz = -shifty; z < vBlocks; z++, pz += chunkSize)
+    // use saved tiles where possible, as nothing else needs the chunks
+    prepareStoredTiles(pWorldGuide, pOpts, topy, mapMaxY, true);
+
+    MapTiles tiles;
+    memset(&tiles, 0, sizeof(MapTiles));
+    tiles.pWorldGuide = pWorldGuide;
+    tiles.pOpts = pOpts;
+    tiles.topy = topy;
+    tiles.mapMaxY = mapMaxY;
+    tiles.mcVersion = mcVersion;
+    tiles.versionID = versionID;
+    tiles.startxblock = startxblock;
+    tiles.startzblock = startzblock;
+    tiles.numX = hBlocks;
+    tiles.numZ = vBlocks;
+    tiles.place = copyTile;
+    tiles.image = image;
+    tiles.w = w;
+    tiles.h = h;
+    tiles.cx = cx;
+    tiles.cz = cz;
+    tiles.imageZoom = zoom;
+    tiles.callback = callback;
+    tiles.pctprogress = DRAW_PROGRESS_INCREMENT;
+    tiles.tileProgress = true;
+
+    // Decode and draw in bands of rows that fit in the cache, so a band's chunks all stay loaded while
+    // it's drawn on all cores. If even a single row doesn't fit, rows are drawn on this thread, as before.
+    int bandRows = max(1, (Cache_Capacity() / 2) / hBlocks);
+    for (int firstRow = 0; firstRow < vBlocks; firstRow += bandRows)
     {
-        int wblockzmin = (startzblock + z) * chunkSize;
-        int wblockzmax = wblockzmin + chunkSize;
+        int numRows = min(bandRows, vBlocks - firstRow);
+        sumRetCode |= prefetchBlocks(pWorldGuide, startxblock, startzblock + firstRow, startxblock + hBlocks - 1, startzblock + firstRow + numRows - 1, pOpts->worldType, mcVersion, versionID, NULL, gUseStoredTiles);
+        drawTileRows(&tiles, firstRow, numRows, hitsFound, sumRetCode);
+    }
+    regionReleaseFiles();
+    return sumRetCode;
+}
 
-        if (wblockzmin < cz) {
-            // beginning of column
-            b2iz = wblockzmin - cz;
-            iblockzstart = -b2iz;
+// DrawMap(): blit the tile at x,z to the screen bitmap, at the current zoom.
+static void blitTile(MapTiles* pTiles, unsigned char* blockbits, int x, int z)
+{
+    // where the tile's northwest chunk goes
+    int px = -pTiles->shiftx + (((pTiles->startxblock + x) << pTiles->level) - pTiles->firstChunkX) * pTiles->blockScale;
+    int py = -pTiles->shifty + (((pTiles->startzblock + z) << pTiles->level) - pTiles->firstChunkZ) * pTiles->blockScale;
+    if (pTiles->level == 0)
+        blit(blockbits, pTiles->bits, px, py, pTiles->zoom, pTiles->w, pTiles->h);
+    else
+        blitCell(blockbits, pTiles->bits, px, py, pTiles->level, pTiles->blockScale, pTiles->w, pTiles->h);
+}
+
+// DrawMapToArray(): copy the part of the tile at x,z that's inside the area to the 3 byte per pixel image.
+static void copyTile(MapTiles* pTiles, unsigned char* blockbits, int x, int z)
+{
+    int chunkSize = 16;
+    int cx = pTiles->cx;
+    int cz = pTiles->cz;
+    int w = pTiles->w;
+    int h = pTiles->h;
+    int zoom = pTiles->imageZoom;
+    int iblockxstart, b2ix, iblockxend, iblockzstart, b2iz, iblockzend;
+
+    int wblockzmin = (pTiles->startzblock + z) * chunkSize;
+    int wblockzmax = wblockzmin + chunkSize;
+
+    if (wblockzmin < cz) {
+        // beginning of column
+        b2iz = wblockzmin - cz;
+        iblockzstart = -b2iz;
+    }
+    else {
+        b2iz = ((int)(wblockzmin / chunkSize)) * chunkSize - cz;
+        iblockzstart = wblockzmin % chunkSize;
+    }
+    if (wblockzmax > cz + h) {
+        // end of row, number from 1 to 16
+        iblockzend = cz + h - wblockzmax + chunkSize;
+    }
+    else {
+        iblockzend = chunkSize;
+    }
+    assert(iblockzstart < iblockzend);
+    assert(iblockzstart >= 0 && iblockzstart < chunkSize);
+    assert(iblockzend > 0 && iblockzend <= chunkSize);
+
+    int nextLine = zoom * w * 3;
+
+    // world space of block:
+    int wblockxmin = (pTiles->startxblock + x) * chunkSize;
+    int wblockxmax = wblockxmin + chunkSize;
+
+    if (wblockxmin < cx) {
+        // beginning of row, number from 0 to 15
+        b2ix = wblockxmin - cx;
+        iblockxstart = -b2ix;
+    }
+    else {
+        b2ix = ((int)(wblockxmin / chunkSize)) * chunkSize - cx;
+        iblockxstart = wblockxmin % chunkSize;
+    }
+    if (wblockxmax > cx + w) {
+        // end of row, number from 1 to 16
+        iblockxend = cx + w - wblockxmax + chunkSize;
+    }
+    else {
+        iblockxend = chunkSize;
+    }
+
+    // now walk through these, grabbing from the bits
+    assert(iblockxstart < iblockxend);
+    assert(iblockxstart >= 0 && iblockxstart < chunkSize);
+    assert(iblockxend > 0 && iblockxend <= chunkSize);
+
+    // copy over the data
+    unsigned char* image = pTiles->image;
+    for (int iz = iblockzstart; iz < iblockzend; iz++) {
+        unsigned char* curImg = &image[((iz + b2iz) * zoom * w + (iblockxstart + b2ix)) * zoom * 3];
+        unsigned char* curBits = &blockbits[(iz * chunkSize + iblockxstart) * 4];
+        for (int ix = iblockxstart; ix < iblockxend; ix++) {
+            // make sure in range
+            //assert(((iz + b2iz) * w + (ix + b2ix)) >= 0 && ((iz + b2iz) * w + (ix + b2ix)) <= w * h);
+            if (zoom == 1) {
+                *curImg++ = *curBits++;
+                *curImg++ = *curBits++;
+                *curImg++ = *curBits++;
+                curBits++;
+            }
+            else {
+                // loop and fill in image
+                unsigned char r = *curBits++;
+                unsigned char g = *curBits++;
+                unsigned char b = *curBits++;
+                curBits++;
+                unsigned char* curImgLine = curImg;
+                for (int imgz = 0; imgz < zoom; imgz++) {
+                    unsigned char* curImgLoc = curImgLine;
+                    for (int imgx = 0; imgx < zoom; imgx++) {
+                        *curImgLoc++ = r;
+                        *curImgLoc++ = g;
+                        *curImgLoc++ = b;
+                        //assert(curImgLoc - image <= zoom * zoom * w * h * 3);
+                    }
+                    curImgLine += nextLine;
+                }
+                // next pixel start location in line
+                curImg += zoom * 3;
+            }
+        }
+    }
+}
+
+// Draw row z of the tiles, from tile x on east. With loadMissing false, as on the worker threads, stop at the first
+// chunk that isn't in the cache: loading it could throw out a chunk another thread is drawing.
+// Returns the x drawing stopped at, numX if the row is done.
+static int drawTileRow(MapTiles* pTiles, int z, int x, bool loadMissing, int* hitsFound, int& sumRetCode)
+{
+    // draw() may build a partly highlighted blank tile here, and drawCell() its cell, which is placed before the next tile is drawn
+    unsigned char transitionTile[16 * 16 * 4];
+    float noProgress = 2.0f;
+    int retCode;
+    for (; x < pTiles->numX; x++)
+    {
+        float percent = (float)(z * pTiles->numX + x) / (float)(pTiles->numZ * pTiles->numX);
+        unsigned char* blockbits;
+        if (pTiles->level == 0) {
+            blockbits = draw(pTiles->pWorldGuide, pTiles->startxblock + x, pTiles->startzblock + z, pTiles->topy, pTiles->mapMaxY, pTiles->pOpts,
+                loadMissing ? pTiles->callback : NULL, percent, loadMissing ? pTiles->pctprogress : noProgress,
+                hitsFound, pTiles->mcVersion, pTiles->versionID, loadMissing, transitionTile, retCode);
         }
         else {
-            b2iz = ((int)(wblockzmin / chunkSize)) * chunkSize - cz;
-            iblockzstart = wblockzmin % chunkSize;
+            bool complete;
+            blockbits = drawCell(pTiles, pTiles->level, pTiles->startxblock + x, pTiles->startzblock + z, loadMissing, percent, loadMissing ? pTiles->pctprogress : noProgress,
+                transitionTile, hitsFound, retCode, complete);
         }
-        if (wblockzmax > cz + h) {
-            // end of row, number from 1 to 16
-            iblockzend = cz + h - wblockzmax + chunkSize;
+        if (blockbits == NULL)
+            break;
+        if (retCode < 0) {
+            // preserve the error code, which will (mysteriously) be displayed
+            sumRetCode = retCode;
         }
-        else {
-            iblockzend = chunkSize;
+        else if (sumRetCode >= 0)
+        {
+            // warnings can chained together
+            sumRetCode |= retCode;
+        } // else sumRetCode has an error code, so don't touch it
+        pTiles->place(pTiles, blockbits, x, z);
+    }
+    return x;
+}
+
+static void drawTileRowTask(int taskIndex, int workerIndex, void* userData)
+{
+    MapTiles* pTiles = (MapTiles*)userData;
+    int x = drawTileRow(pTiles, pTiles->firstRow + taskIndex, 0, false, pTiles->rowHits[taskIndex], pTiles->rowRetCode[taskIndex]);
+    pTiles->rowStop[taskIndex] = x;
+
+    LONG tilesDone = InterlockedExchangeAdd(&pTiles->tilesDone, (LONG)x) + (LONG)x;
+    // the callback updates the window, so only the calling thread reports
+    if (workerIndex == 0 && pTiles->tileProgress && pTiles->callback) {
+        float percent = (float)tilesDone / (float)(pTiles->numZ * pTiles->numX);
+        if (percent > pTiles->pctprogress) {
+            pTiles->callback(percent, NULL);
+            pTiles->pctprogress += DRAW_PROGRESS_INCREMENT;
         }
-        assert(iblockzstart < iblockzend);
-        assert(iblockzstart >= 0 && iblockzstart < chunkSize);
-        assert(iblockzend > 0 && iblockzend <= chunkSize);
+    }
+}
 
-        int nextLine = zoom * w * 3;
+// Draw rows firstRow through firstRow + numRows - 1 of the tiles, a row per task, on all cores. Rows stopped short by a chunk
+// that's not loaded are then finished here, loading chunks as needed. Results are combined as DrawMap() has always done.
+static void drawTileRows(MapTiles* pTiles, int firstRow, int numRows, int* hitsFound, int& sumRetCode)
+{
+    int row;
+    int* rowStop = NULL;
+    int* rowRetCode = NULL;
+    int (*rowHits)[4] = NULL;
+    if (GetWorkerCount() > 1 && numRows > 1) {
+        rowStop = (int*)malloc(numRows * sizeof(int));
+        rowRetCode = (int*)calloc(numRows, sizeof(int));
+        rowHits = (int (*)[4])malloc(numRows * sizeof(int[4]));
+    }
+    if (rowStop == NULL || rowRetCode == NULL || rowHits == NULL) {
+        // serial, just as it was
+        free(rowStop);
+        free(rowRetCode);
+        free(rowHits);
+        for (row = firstRow; row < firstRow + numRows; row++)
+            drawTileRow(pTiles, row, 0, true, hitsFound, sumRetCode);
+        return;
+    }
 
-        // z increases west, decreases east
-        float pctprogress = 0.1f;
-        for (x = 0, px = -shiftx; x < hBlocks; x++, px += chunkSize)
-        {
-            blockbits = draw(pWorldGuide, startxblock + x, startzblock + z, topy, mapMaxY, pOpts, callback, (float)(z * hBlocks + x) / (float)(vBlocks * hBlocks), pctprogress, hitsFound, mcVersion, versionID, retCode);
-            sumRetCode |= retCode;
+    // hits are found per row and merged: 0-2 are flags, 3 is the minimum height seen
+    for (row = 0; row < numRows; row++) {
+        rowHits[row][0] = rowHits[row][1] = rowHits[row][2] = 0;
+        rowHits[row][3] = hitsFound[3];
+    }
+    pTiles->firstRow = firstRow;
+    pTiles->rowStop = rowStop;
+    pTiles->rowRetCode = rowRetCode;
+    pTiles->rowHits = rowHits;
+    RunWorkerTasks(numRows, drawTileRowTask, pTiles);
+    // the workers may have built column runs that put the cache over budget, but could not evict chunks
+    Cache_Trim();
+
+    for (row = 0; row < numRows; row++) {
+        hitsFound[0] |= rowHits[row][0];
+        hitsFound[1] |= rowHits[row][1];
+        hitsFound[2] |= rowHits[row][2];
+        hitsFound[3] = min(hitsFound[3], rowHits[row][3]);
+        if (rowRetCode[row] < 0) {
+            sumRetCode = rowRetCode[row];
+        }
+        else if (sumRetCode >= 0) {
+            sumRetCode |= rowRetCode[row];
+        }
+    }
+    // finish, in order, any rows that ran into chunks not yet loaded
+    for (row = 0; row < numRows; row++) {
+        if (rowStop[row] < pTiles->numX)
+            drawTileRow(pTiles, firstRow + row, rowStop[row], true, hitsFound, sumRetCode);
+    }
+    pTiles->rowStop = NULL;
+    pTiles->rowRetCode = NULL;
+    pTiles->rowHits = NULL;
+    free(rowStop);
+    free(rowRetCode);
+    free(rowHits);
+}
 
-            // world space of block:
-            int wblockxmin = (startxblock + x) * chunkSize;
-            int wblockxmax = wblockxmin + chunkSize;
+// Everything besides the chunk itself that a map tile's look depends on, as one number, never 0.
+static unsigned int tileSettingsHash(WorldGuide* pWorldGuide, Options* pOpts, int topy, int mapMaxY)
+{
+    int i;
+    // FNV-1a, over ints
+    unsigned int hash = 2166136261u;
+#define HASH_INT(val) { hash ^= (unsigned int)(val); hash *= 16777619u; }
+    HASH_INT(topy);
+    HASH_INT(mapMaxY);
+    HASH_INT(pWorldGuide->minHeight);
+    HASH_INT(pOpts->worldType);
+    HASH_INT(gUnknownBlockID);
+    HASH_INT((gEmptyR << 16) | (gEmptyG << 8) | gEmptyB);
+    HASH_INT(cullingSchemeHash());
+    for (i = 0; i < NUM_BLOCKS_DEFINED * 16; i++)
+        HASH_INT(gBlockColors[i]);
+    for (i = 0; i < NUM_BLOCKS_DEFINED; i++) {
+        float alpha = gBlockDefinitions[i].alpha;
+        unsigned int alphaBits;
+        memcpy(&alphaBits, &alpha, sizeof(alphaBits));
+        HASH_INT(alphaBits);
+        HASH_INT(gBlockDefinitions[i].pcolor);
+        HASH_INT(gBlockDefinitions[i].flags);
+    }
+#undef HASH_INT
+    return (hash == 0) ? 1 : hash;
+}
 
-            if (wblockxmin < cx) {
-                // beginning of row, number from 0 to 15
-                b2ix = wblockxmin - cx;
-                iblockxstart = -b2ix;
-            }
-            else {
-                b2ix = ((int)(wblockxmin / chunkSize)) * chunkSize - cx;
-                iblockxstart = wblockxmin % chunkSize;
-            }
-            if (wblockxmax > cx + w) {
-                // end of row, number from 1 to 16
-                iblockxend = cx + w - wblockxmax + chunkSize;
-            }
-            else {
-                iblockxend = chunkSize;
-            }
+// Called on the main thread before any drawing: saved tiles are for real worlds only.
+static void prepareStoredTiles(WorldGuide* pWorldGuide, Options* pOpts, int topy, int mapMaxY, bool useStored)
+{
+    gTileSettings = 0;
+    gUseStoredTiles = false;
+    if (pWorldGuide->type != WORLD_LEVEL_TYPE)
+        return;
+    SetDimensionDirectory(pWorldGuide, pOpts->worldType);
+    wcscpy_s(gTileDirectory, MAX_PATH_AND_FILE, pWorldGuide->directory);
+    gTileSettings = tileSettingsHash(pWorldGuide, pOpts, topy, mapMaxY);
+    gUseStoredTiles = useStored;
+}
 
-            // now walk through these, grabbing from the bits
-            assert(iblockxstart < iblockxend);
-            assert(iblockxstart >= 0 && iblockxstart < chunkSize);
-            assert(iblockxend > 0 && iblockxend <= chunkSize);
-
-            // copy over the data
-            for (int iz = iblockzstart; iz < iblockzend; iz++) {
-                unsigned char* curImg = &image[((iz + b2iz) * zoom * w + (iblockxstart + b2ix)) * zoom * 3];
-                unsigned char* curBits = &blockbits[(iz * chunkSize + iblockxstart) * 4];
-                for (int ix = iblockxstart; ix < iblockxend; ix++) {
-                    // make sure in range
-                    //assert(((iz + b2iz) * w + (ix + b2ix)) >= 0 && ((iz + b2iz) * w + (ix + b2ix)) <= w * h);
-                    if (zoom == 1) {
-                        *curImg++ = *curBits++;
-                        *curImg++ = *curBits++;
-                        *curImg++ = *curBits++;
-                        curBits++;
-                    }
-                    else {
-                        // loop and fill in image
-                        unsigned char r = *curBits++;
-                        unsigned char g = *curBits++;
-                        unsigned char b = *curBits++;
-                        curBits++;
-                        unsigned char* curImgLine = curImg;
-                        for (int imgz = 0; imgz < zoom; imgz++) {
-                            unsigned char* curImgLoc = curImgLine;
-                            for (int imgx = 0; imgx < zoom; imgx++) {
-                                *curImgLoc++ = r;
-                                *curImgLoc++ = g;
-                                *curImgLoc++ = b;
-                                //assert(curImgLoc - image <= zoom * zoom * w * h * 3);
-                            }
-                            curImgLine += nextLine;
-                        }
-                        // next pixel start location in line
-                        curImg += zoom * 3;
-                    }
-                }
-            }
+// highlighted tiles are never saved
+static bool touchesHighlight(int bx, int bz)
+{
+    return gBox.highlightUsed &&
+        (bx * 16 + 15 >= gBox.minX) && (bx * 16 <= gBox.maxX) &&
+        (bz * 16 + 15 >= gBox.minZ) && (bz * 16 <= gBox.maxZ);
+}
+
+// Find an up-to-date saved tile for chunk bx,bz and copy it to tile, if not NULL.
+static bool findStoredTile(int bx, int bz, unsigned char* tile)
+{
+    if (touchesHighlight(bx, bz))
+        return false;
+    unsigned int timestamp = regionGetChunkTimestamp(gTileDirectory, bx, bz);
+    if (timestamp == 0)
+        return false;
+    return tileStoreFindTile(gTileDirectory, 0, bx, bz, gTileSettings, timestamp, regionGetChunkTimestamp(gTileDirectory, bx - 1, bz), tile);
+}
+
+static bool findStoredEastHeights(int bx, int bz, short* eastHeights)
+{
+    unsigned int timestamp = regionGetChunkTimestamp(gTileDirectory, bx, bz);
+    if (timestamp == 0)
+        return false;
+    return tileStoreFindEastHeights(gTileDirectory, bx, bz, gTileSettings, timestamp, eastHeights);
+}
+
+// Save the chunk's freshly drawn tile; it must be complete, see chunkTileComplete().
+static void storeTile(int bx, int bz, WorldBlock* block)
+{
+    if (touchesHighlight(bx, bz))
+        return;
+    unsigned int timestamp = regionGetChunkTimestamp(gTileDirectory, bx, bz);
+    if (timestamp == 0)
+        return;
+    unsigned int westTimestamp = regionGetChunkTimestamp(gTileDirectory, bx - 1, bz);
+    short eastHeights[16];
+    for (int z = 0; z < 16; z++)
+        eastHeights[z] = block->heightmap[15 + z * 16];
+    tileStoreSave(gTileDirectory, 0, bx, bz, gTileSettings, timestamp, westTimestamp, block->rendercache, eastHeights);
+}
+
+// The chunk to the west is loaded, and is blank, so won't ever shade this one.
+static bool westIsEmpty(int bx, int bz)
+{
+    void* data;
+    if (!Cache_Find(bx - 1, bz, &data))
+        return false;
+    WorldBlock* block = (WorldBlock*)data;
+    return (block == NULL || block->blockType == NBT_NO_SECTIONS);
+}
+
+// Was the tile draw() just returned for the chunk drawn with all it depends on, i.e., can it be saved?
+static bool chunkTileComplete(int bx, int bz)
+{
+    void* data;
+    if (!Cache_Find(bx, bz, &data))
+        // read from the tile store
+        return true;
+    WorldBlock* block = (WorldBlock*)data;
+    if (block == NULL || block->blockType == NBT_NO_SECTIONS)
+        // blank
+        return true;
+    return (block->rendermissing == 0 || westIsEmpty(bx, bz));
+}
+
+// Average a 16x16 RGBA tile down to 8x8 and put it in the quadrant qx,qz of cell.
+static void shrinkToQuadrant(const unsigned char* tile, unsigned char* cell, int qx, int qz)
+{
+    for (int z = 0; z < 8; z++) {
+        const unsigned char* src = tile + z * 2 * 64;
+        unsigned char* dst = cell + ((qz * 8 + z) * 16 + qx * 8) * 4;
+        for (int x = 0; x < 8; x++, src += 8, dst += 4) {
+            for (int c = 0; c < 3; c++)
+                dst[c] = (unsigned char)((src[c] + src[c + 4] + src[c + 64] + src[c + 68] + 2) >> 2);
+            dst[3] = 0xff;
         }
     }
-    return sumRetCode;
+}
+
+// The keys an LOD cell is saved with: digests of the region timestamps of the size x size chunks at bx,bz, and of the column
+// of chunks to their west. Returns false if none of the chunks exist.
+static bool cellDigests(int bx, int bz, int size, unsigned int& digest, unsigned int& westDigest)
+{
+    unsigned int timestamps[32 * 32];
+    bool any = regionGetChunkTimestamps(gTileDirectory, bx, bz, size, size, timestamps);
+    // FNV-1a
+    int i;
+    digest = 2166136261u;
+    for (i = 0; i < size * size; i++) {
+        digest ^= timestamps[i];
+        digest *= 16777619u;
+    }
+    regionGetChunkTimestamps(gTileDirectory, bx - 1, bz, 1, size, timestamps);
+    westDigest = 2166136261u;
+    for (i = 0; i < size; i++) {
+        westDigest ^= timestamps[i];
+        westDigest *= 16777619u;
+    }
+    return any;
+}
+
+// Draw the LOD cell tx,tz of the level, 2^level chunks on a side, into cell: the four cells, or chunks, of the level below,
+// northwest, northeast, southwest, southeast, each averaged down to a quadrant. This order draws a chunk after the one to
+// its west. Cells are saved in the tile store, keyed on their chunks' region timestamps, so once made, zoomed out views
+// read only these. Returns NULL if a chunk would have to be loaded and loadMissing is false, else cell or a blank cell.
+// complete is set false if some chunk was drawn without its west neighbor's heights, so the cell shouldn't be saved.
+static unsigned char* drawCell(MapTiles* pTiles, int level, int tx, int tz, bool loadMissing, float percent, float& pctprogress,
+    unsigned char* cell, int* hitsFound, int& retCode, bool& complete)
+{
+    int size = 1 << level;
+    int bx = tx << level;
+    int bz = tz << level;
+    retCode = 0;
+    complete = true;
+
+    // highlighted cells are drawn from their chunks each time, and not saved
+    bool highlit = gBox.highlightUsed &&
+        ((bx + size) * 16 > gBox.minX) && (bx * 16 <= gBox.maxX) &&
+        ((bz + size) * 16 > gBox.minZ) && (bz * 16 <= gBox.maxZ);
+    unsigned int digest, westDigest;
+    if (!cellDigests(bx, bz, size, digest, westDigest) && !highlit)
+        return gBlankCells[level];
+    if (!highlit && tileStoreFindTile(gTileDirectory, level, tx, tz, gTileSettings, digest, westDigest, cell))
+        return cell;
+
+    unsigned char child[16 * 16 * 4];
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        int qx = quadrant & 1;
+        int qz = quadrant >> 1;
+        int childRetCode;
+        bool childComplete;
+        unsigned char* childbits;
+        if (level == 1) {
+            childbits = draw(pTiles->pWorldGuide, bx + qx, bz + qz, pTiles->topy, pTiles->mapMaxY, pTiles->pOpts, loadMissing ? pTiles->callback : NULL, percent, pctprogress,
+                hitsFound, pTiles->mcVersion, pTiles->versionID, loadMissing, child, childRetCode);
+            childComplete = (childbits != NULL) && chunkTileComplete(bx + qx, bz + qz);
+        }
+        else {
+            childbits = drawCell(pTiles, level - 1, tx * 2 + qx, tz * 2 + qz, loadMissing, percent, pctprogress, child, hitsFound, childRetCode, childComplete);
+        }
+        if (childbits == NULL)
+            return NULL;
+        if (childRetCode < 0) {
+            retCode = childRetCode;
+        }
+        else if (retCode >= 0) {
+            retCode |= childRetCode;
+        }
+        complete = complete && childComplete;
+        shrinkToQuadrant(childbits, cell, qx, qz);
+    }
+    if (!highlit && complete)
+        tileStoreSave(gTileDirectory, level, tx, tz, gTileSettings, digest, westDigest, cell, NULL);
+    return cell;
 }
 
 //bx = x coord of pixel
@@ -664,8 +1139,9 @@ const char* IDBlock(int bx, int by, double cx, double cz, int w, int h, int yOff
 
     int chunkIndex = xoff + zoff * 16 + y * 256;
     assert((chunkIndex >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
-    *type = block->grid[chunkIndex];
-    *dataVal = block->data[chunkIndex];
+    unsigned short typeData = block_type_data(block, chunkIndex);
+    *type = typeData & 0xff;
+    *dataVal = typeData >> 8;
 
     // 1.13+ fun: move topmost dataVal value to type - note that BLOCK_HEAD and BLOCK_FLOWER_POT are "reserved" and the high-bit version is not used
     // Here is where the high data bit gets masked off and moved to the type bit.
@@ -2888,25 +3364,116 @@ static void blit(unsigned char* block, unsigned char* bits, int px, int py,
     }
 }
 
+// Copy an LOD cell, 2^level chunks on a side, to bits at px,py, each chunk blockScale pixels across, as blit()
+// does for chunks. The cell has 16 >> level pixels across each chunk, at least blockScale, so pixels are picked.
+static void blitCell(unsigned char* cell, unsigned char* bits, int px, int py, int level, int blockScale, int w, int h)
+{
+    int x, y;
+    int chunkPixels = 16 >> level;
+    int span = blockScale << level;
+    for (y = max(0, -py); y < span && py + y < h; y++)
+    {
+        int cy = (y / blockScale) * chunkPixels + (y % blockScale) * chunkPixels / blockScale;
+        unsigned char* src = cell + (cy << 6);
+        unsigned char* dst = bits + ((py + y) * w + px) * 4;
+        for (x = max(0, -px); x < span && px + x < w; x++)
+        {
+            int cx = (x / blockScale) * chunkPixels + (x % blockScale) * chunkPixels / blockScale;
+            memcpy(dst + x * 4, src + cx * 4, 4);
+        }
+    }
+}
+
 void CloseAll()
 {
     Cache_Empty();
     regionCleanup();
+    tileStoreClose();
+    for (int i = 0; i < MAX_WORKERS; i++) {
+        regionFreeDecoder(gWorkerDecoders[i]);
+        gWorkerDecoders[i] = NULL;
+    }
 }
 
 static unsigned short retrieveType(WorldBlock* block, unsigned int voxel)
 {
     assert(((int)voxel >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
 
-    unsigned short type = block->grid[voxel];
+    unsigned short typeData = block_type_data(block, voxel);
+    unsigned short type = typeData & 0xff;
     if (block->mcVersion >= 13) {
-        if ((block->data[voxel] & 0x80) && (type != BLOCK_HEAD) && (type != BLOCK_FLOWER_POT)) {
+        if ((typeData & 0x8000) && (type != BLOCK_HEAD) && (type != BLOCK_FLOWER_POT)) {
             type |= 0x100;
         }
     }
     return type;
 }
 
+// Does the map show nothing of this voxel, so that the march down a column in draw() goes right past it?
+static bool isMapEmpty(WorldBlock* block, unsigned int voxel, unsigned int viewFilterFlags, char transparentWater)
+{
+    unsigned short type = retrieveType(block, voxel);
+    return (type == BLOCK_AIR) ||
+        !(gBlockDefinitions[type].flags & viewFilterFlags) ||
+        (transparentWater && (type == BLOCK_STATIONARY_WATER || type == BLOCK_WATER)) ||
+        isBlockCulled(type, block_data(block, voxel));
+}
+
+// Find the runs of levels in each column that are not empty to the map, see WorldBlock::columnRuns.
+// If out of memory, the chunk is left without runs and draw() marches down each column as before.
+static void buildColumnRuns(WorldBlock* block, unsigned int viewFilterFlags, char transparentWater, int runsOpts)
+{
+    if (block->columnRuns != NULL) {
+        free(block->columnRuns);
+        block->columnRuns = NULL;
+    }
+    int top = block->maxFilledHeight;
+    // at worst, every other level starts a run
+    int maxRuns = 256 * (top / 2 + 1);
+    unsigned int* runs = (unsigned int*)malloc((257 + maxRuns) * sizeof(unsigned int));
+    if (runs == NULL)
+        return;
+
+    int numRuns = 0;
+    for (int column = 0; column < 256; column++) {
+        runs[column] = numRuns;
+        int runTop = -1;
+        unsigned int voxel = top * 16 * 16 + column;
+        for (int level = top; level >= 0; level--, voxel -= 16 * 16) {
+            if (isMapEmpty(block, voxel, viewFilterFlags, transparentWater)) {
+                if (runTop >= 0) {
+                    runs[257 + numRuns++] = (runTop << 16) | (level + 1);
+                    runTop = -1;
+                }
+            }
+            else if (runTop < 0) {
+                runTop = level;
+            }
+        }
+        if (runTop >= 0)
+            runs[257 + numRuns++] = runTop << 16;
+    }
+    runs[256] = numRuns;
+
+    // give back what wasn't used; if that somehow fails, the larger block is fine
+    unsigned int* shrunk = (unsigned int*)realloc(runs, (257 + numRuns) * sizeof(unsigned int));
+    block->columnRuns = (shrunk != NULL) ? shrunk : runs;
+    block->runsOpts = runsOpts;
+    block->runsColormap = gColormap;
+}
+
+// fixed-point weight for a blend factor from 0.0 to 1.0
+static inline unsigned long long toFixedWeight(double weight)
+{
+    return (unsigned long long)(weight * (double)MAP_FIXED_ONE + 0.5);
+}
+
+// color channel blended toward the target by the fixed-point weight
+static inline unsigned char blendFixed(unsigned int channel, unsigned long long weight, unsigned int target)
+{
+    return (unsigned char)((channel * (MAP_FIXED_ONE - weight) + target * weight) >> MAP_FIXED_SHIFT);
+}
+
 static unsigned int scaleColor(unsigned int color, float scale)
 {
     unsigned int r = color >> 16;
@@ -4577,7 +5144,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
     // --- Stained glass: needs alpha premultiplication after color lookup ---
     case BLOCK_STAINED_GLASS:
     case BLOCK_STAINED_GLASS_PANE:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         color = GetBlockDataColor(type, dataVal);
         if (color == gBlockDefinitions[type].color) {
             lightComputed = true;
@@ -4605,7 +5172,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
     case BLOCK_CUT_COPPER_SLAB:
     case BLOCK_PURPUR_DOUBLE_SLAB:
     case BLOCK_PURPUR_SLAB:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         alphaComputed = true;
         color = GetBlockDataColor(type, dataVal);
         if (color == gBlockDefinitions[type].color) {
@@ -4616,7 +5183,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
 
     // --- Biome-affected blocks: leaves, grass, vines, water, double flower ---
     case BLOCK_LEAVES:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         // some upper bit is used in the old 1.12 and earlier format, beats me what.
         switch (dataVal & 0x3)
         {
@@ -4652,7 +5219,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
         break;
 
     case BLOCK_AD_LEAVES:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         if (dataVal & 0x2) {
             // azalea, flowering or not
             color = (dataVal & 0x1) ? 0x6B7252 : 0x5D762C;
@@ -4665,7 +5232,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
                 // This oak leaf color (and jungle, below) makes the trees easier to pick out.
 
                 // acacia and dark oak
-                dataVal = block->data[voxel];
+                dataVal = block_data(block, voxel);
                 // dark oak and acacia
                 color = dataVal ? 0x2C6F0F : 0x3D9A14;
             }
@@ -4678,7 +5245,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
         break;
 
     case BLOCK_MANGROVE_LEAVES:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         switch (dataVal & 0x3)
         {
         default:
@@ -4701,7 +5268,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
         break;
 
     case BLOCK_GRASS:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         switch (dataVal & 0xf)
         {
         case 0: // dead bush
@@ -4746,7 +5313,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
         break;
 
     case BLOCK_GRASS_BLOCK:
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         affectedByBiome = 1;
         if (dataVal & SNOWY_BIT) {
             color = 0xFCFFFF;
@@ -4769,11 +5336,11 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
         // this is entirely bogus, as we really need the bottom half to get the right bits, but perhaps
         // some modded data uses the bottom three bits in this way...
         // This is just a safety net now - we actually shove the data value into the upper part of the plant nowadays, in extractChunk
-        dataVal = block->data[voxel];
+        dataVal = block_data(block, voxel);
         if (dataVal & 0x8) {
             // looking at the top of the plant, so get the bottom of the plant, if available, to get the bits (pre-1.13)
-            if ((voxel >= 256) && (block->grid[voxel - 256] == BLOCK_DOUBLE_FLOWER))
-                dataVal = block->data[voxel - 256];
+            if ((voxel >= 256) && (block_type(block, voxel - 256) == BLOCK_DOUBLE_FLOWER))
+                dataVal = block_data(block, voxel - 256);
         }
         // masking just in case it's a top half (and probably bogus)
         switch (dataVal & 0x7)
@@ -4823,7 +5390,7 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
 
     // --- All other block types: use GetBlockDataColor ---
     default:
-        color = GetBlockDataColor(type, block->data[voxel]);
+        color = GetBlockDataColor(type, block_data(block, voxel));
         if (color == gBlockDefinitions[type].color) {
             // Base/default color for this block type — use precomputed lit version
             lightComputed = true;
@@ -4946,7 +5513,9 @@ static unsigned int checkSpecialBlockColor(WorldBlock* block, unsigned int voxel
 // opts is a bitmask representing render options (see MinewaysMap.h)
 // returns 16x16 set of block colors to use to render map.
 // colors are adjusted by height, transparency, etc.
-static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAlloc, int mapMaxY, Options* pOpts, ProgressCallback callback, float percent, float & pctprogress, int* hitsFound, int mcVersion, int versionID, int& retCode)
+// If the chunk isn't cached and loadMissing is false, returns NULL instead of loading it.
+// transitionTile is 16x16x4 scratch space, returned for a blank chunk that's partly highlighted.
+static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAlloc, int mapMaxY, Options* pOpts, ProgressCallback callback, float percent, float & pctprogress, int* hitsFound, int mcVersion, int versionID, bool loadMissing, unsigned char* transitionTile, int& retCode)
 {
     WorldBlock* block, * prevblock;
     int ofs = 0, prevy, prevSely, blockSolid, saveHeight;
@@ -4956,7 +5525,8 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
     unsigned int color, viewFilterFlags;
     unsigned short type;
     unsigned char r, g, b, seenempty;
-    double alpha, blend;
+    // how much of what's below still shows through the layers so far, and how much highlight is blended in, fixed point
+    unsigned long long transmit, blend;
 
     char useBiome, useElevation, cavemode, showobscured, depthshading, lighting, transparentWater, mapGrid, showAll;
     unsigned char* bits;
@@ -4979,6 +5549,8 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
     lighting = !!(pOpts->worldType & LIGHTING);
     viewFilterFlags = BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF | BLF_MIDDLER | BLF_BILLBOARD | BLF_PANE | BLF_FLATTEN |   // what's visible
         (showAll ? (BLF_FLATTEN_SMALL | BLF_SMALL_MIDDLER | BLF_SMALL_BILLBOARD) : 0x0);
+    unsigned long long hiliteWeight = toFixedWeight(gHalpha);
+    unsigned long long hiliteBorderWeight = toFixedWeight(gHalphaBorder);
 
     void* data;
     bool found = (WorldBlock*)Cache_Find(bx, bz, &data);
@@ -4986,6 +5558,14 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
 
     if (!found)
     {
+        // drawn in some earlier session? Then there's no need to read in the chunk at all
+        if (gUseStoredTiles && findStoredTile(bx, bz, transitionTile))
+            return transitionTile;
+
+        // not loaded, and we may not load it here? Caller will draw this one later
+        if (!loadMissing)
+            return NULL;
+
         SetDimensionDirectory(pWorldGuide, pOpts->worldType);
 
         //char debugString[256];
@@ -5020,13 +5600,12 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                 return gBlankTile;
 
             // fully inside? Use precomputed highlit area
-            static int flux = 0;
             if ((bx * 16 > gBox.minX) && (bx * 16 + 15 < gBox.maxX) &&
                 (bz * 16 > gBox.minZ) && (bz * 16 + 15 < gBox.maxZ))
                 return gBlankHighlitTile;
 
             // draw the highlighted area
-            memcpy(gBlankTransitionTile, gBlankTile, 16 * 16 * 4);
+            memcpy(transitionTile, gBlankTile, 16 * 16 * 4);
             // z increases south, decreases north
             for (z = 0; z < 16; z++)
             {
@@ -5039,20 +5618,20 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                         bz * 16 + z >= gBox.minZ && bz * 16 + z <= gBox.maxZ)
                     {
                         // blend in highlight color
-                        blend = gHalpha;
+                        blend = hiliteWeight;
                         // are we on a border? If so, change blend factor
                         if (bx * 16 + x == gBox.minX || bx * 16 + x == gBox.maxX ||
                             bz * 16 + z == gBox.minZ || bz * 16 + z == gBox.maxZ)
                         {
-                            blend = gHalphaBorder;
+                            blend = hiliteBorderWeight;
                         }
-                        gBlankTransitionTile[offset++] = (unsigned char)((double)gBlankTransitionTile[offset] * (1.0 - blend) + blend * (double)gHred);
-                        gBlankTransitionTile[offset++] = (unsigned char)((double)gBlankTransitionTile[offset] * (1.0 - blend) + blend * (double)gHgreen);
-                        gBlankTransitionTile[offset] = (unsigned char)((double)gBlankTransitionTile[offset] * (1.0 - blend) + blend * (double)gHblue);
+                        transitionTile[offset] = blendFixed(transitionTile[offset], blend, gHred);
+                        transitionTile[offset + 1] = blendFixed(transitionTile[offset + 1], blend, gHgreen);
+                        transitionTile[offset + 2] = blendFixed(transitionTile[offset + 2], blend, gHblue);
                     }
                 }
             }
-            return gBlankTransitionTile;
+            return transitionTile;
         }
     } else if (block == NULL || block->blockType == NBT_NO_SECTIONS) {
         // should really call a "draw blank" subroutine, but here goes...
@@ -5090,6 +5669,17 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
         }
     }
 
+    // Drawn before at some other height, such as when the height slider moves? Then find the runs of visible stuff
+    // in each column, so that this and later redraws skip the empty levels. First draws don't spend the time.
+    int runsOpts = pOpts->worldType & (SHOWALL | TRANSPARENT_WATER);
+    bool runsCurrent = (block->columnRuns != NULL && block->runsOpts == runsOpts && block->runsColormap == gColormap);
+    if (!runsCurrent && block->rendery >= 0 && block->rendery != heightAlloc) {
+        buildColumnRuns(block, viewFilterFlags, transparentWater, runsOpts);
+        runsCurrent = (block->columnRuns != NULL);
+        // the runs count against the cache's memory budget; only a thread that may load chunks may also evict them
+        Cache_Recharge(bx, bz, loadMissing);
+    }
+
     block->rendery = heightAlloc;
     block->renderopts = pOpts->worldType;
     // if the block to be drawn is inside, note the ID, else note it's "clean" of highlighting;
@@ -5111,6 +5701,11 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
         block->rendermissing = 1; //note improperly rendered block to west
         prevblock = NULL; //block was rendered at a different y level, ignore
     }
+    // the block to the west may not be loaded because its tile was saved; if so, use the saved heights along its edge
+    short westHeights[16];
+    bool storedWest = (prevblock == NULL && gUseStoredTiles && findStoredEastHeights(bx - 1, bz, westHeights));
+    if (storedWest)
+        block->rendermissing = 0;
 
     // what height can we (must we, if we reduce the grid storage) start at?
     int clippedMaxHeight = heightAlloc;
@@ -5125,6 +5720,8 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
         // Note it is set to the previous y height for the loop below.
         if (prevblock != NULL)
             prevy = prevblock->heightmap[15 + z * 16];
+        else if (storedWest)
+            prevy = westHeights[z];
         else
             prevy = -1;
 
@@ -5145,17 +5742,51 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
             // the next solid block is then shown. If it's solid all the way down, the block will be
             // drawn as "empty". Note we truly want to test maxHeight here, not clippedMaxHeight.
             seenempty = (heightAlloc == mapMaxY ? 1 : 0);
-            alpha = 0.0;
+            transmit = MAP_FIXED_ONE;
+
+            // with runs, find the first run at or below the starting height
+            const unsigned int* pRun = NULL;
+            const unsigned int* pRunEnd = NULL;
+            if (runsCurrent) {
+                pRun = block->columnRuns + 257 + block->columnRuns[x + z * 16];
+                pRunEnd = block->columnRuns + 257 + block->columnRuns[x + z * 16 + 1];
+                const unsigned int* pHigh = pRunEnd;
+                while (pRun < pHigh) {
+                    const unsigned int* pMid = pRun + (pHigh - pRun) / 2;
+                    if ((int)(*pMid & 0xffff) > clippedMaxHeight)
+                        pRun = pMid + 1;
+                    else
+                        pHigh = pMid;
+                }
+            }
+
             // go from top down through all voxels, looking for the first one visible.
             for (i = clippedMaxHeight; i >= 0; i--, voxel -= 16 * 16)
             {
+                if (pRun != NULL) {
+                    // jump past empty levels to the next run, same as marching through them
+                    while (pRun < pRunEnd && i < (int)(*pRun & 0xffff))
+                        pRun++;
+                    if (pRun == pRunEnd) {
+                        seenempty = 1;
+                        voxel -= (i + 1) * 16 * 16;
+                        i = -1;
+                        break;
+                    }
+                    int runTop = (int)(*pRun >> 16);
+                    if (i > runTop) {
+                        seenempty = 1;
+                        voxel -= (i - runTop) * 16 * 16;
+                        i = runTop;
+                    }
+                }
                 type = retrieveType(block, voxel);
                 // if block is air or something very small, or water when transparent water is
                 // flagged, or hidden by the active Culling Scheme, note it's empty and continue.
                 if ((type == BLOCK_AIR) ||
                     !(gBlockDefinitions[type].flags & viewFilterFlags) ||
                     (transparentWater && (type == BLOCK_STATIONARY_WATER || type == BLOCK_WATER)) ||
-                    isBlockCulled(type, block->data[voxel]))
+                    isBlockCulled(type, block_data(block, voxel)))
                 {
                     seenempty = 1;
                     continue;
@@ -5184,9 +5815,7 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                     {
                         if (i < mapMaxY)
                         {
-                            light = block->light[voxel / 2];
-                            if (voxel & 1) light >>= 4;
-                            light &= 0xf;
+                            light = block_light(block, voxel);
                         }
                         else
                         {
@@ -5214,12 +5843,13 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                     color = checkSpecialBlockColor(block, voxel, type, light, useBiome, useElevation);
 
                     // is this the first block encountered?
-                    if (alpha == 0.0)
+                    unsigned long long alphaWeight = toFixedWeight(currentAlpha);
+                    if (transmit == MAP_FIXED_ONE)
                     {
                         // yes; since there's no accumulated alpha, simply substitute the values into place;
                         // note that semi-transparent values already have their alpha multiplied in.
                         saveHeight = i;
-                        alpha = currentAlpha;
+                        transmit = MAP_FIXED_ONE - alphaWeight;
                         r = (unsigned char)(color >> 16);
                         g = (unsigned char)((color >> 8) & 0xff);
                         b = (unsigned char)(color & 0xff);
@@ -5229,10 +5859,10 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                         // Else need to blend in this color with the previous.
                         // This is an "under" operation, putting the new color under the previous
                         // accumulated alpha
-                        r += (unsigned char)((1.0 - alpha) * (color >> 16));
-                        g += (unsigned char)((1.0 - alpha) * ((color >> 8) & 0xff));
-                        b += (unsigned char)((1.0 - alpha) * (color & 0xff));
-                        alpha += currentAlpha * (1.0 - alpha);
+                        r += (unsigned char)((transmit * (color >> 16)) >> MAP_FIXED_SHIFT);
+                        g += (unsigned char)((transmit * ((color >> 8) & 0xff)) >> MAP_FIXED_SHIFT);
+                        b += (unsigned char)((transmit * (color & 0xff)) >> MAP_FIXED_SHIFT);
+                        transmit = (transmit * (MAP_FIXED_ONE - alphaWeight)) >> MAP_FIXED_SHIFT;
                     }
                     // if the current block's color is fully opaque, finish.
                     if (currentAlpha == 1.0f)
@@ -5351,17 +5981,17 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                     {
                         hitsFound[1] = 1;
                         // blend in highlight color
-                        blend = gHalpha;
+                        blend = hiliteWeight;
                         // are we on a border? If so, change blend factor
                         if (prevSely == gBox.minY || prevSely == gBox.maxY ||
                             bx * 16 + x == gBox.minX || bx * 16 + x == gBox.maxX ||
                             bz * 16 + z == gBox.minZ || bz * 16 + z == gBox.maxZ)
                         {
-                            blend = gHalphaBorder;
+                            blend = hiliteBorderWeight;
                         }
-                        r = (unsigned char)((double)r * (1.0 - blend) + blend * (double)gHred);
-                        g = (unsigned char)((double)g * (1.0 - blend) + blend * (double)gHgreen);
-                        b = (unsigned char)((double)b * (1.0 - blend) + blend * (double)gHblue);
+                        r = blendFixed(r, blend, gHred);
+                        g = blendFixed(g, blend, gHgreen);
+                        b = blendFixed(b, blend, gHblue);
                     }
                     else if (prevSely < gBox.minY)
                     {
@@ -5408,16 +6038,16 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
                     bz * 16 + z >= gBox.minZ && bz * 16 + z <= gBox.maxZ)
                 {
                     // blend in highlight color
-                    blend = gHalpha;
+                    blend = hiliteWeight;
                     // are we on a border? If so, change blend factor
                     if (bx * 16 + x == gBox.minX || bx * 16 + x == gBox.maxX ||
                         bz * 16 + z == gBox.minZ || bz * 16 + z == gBox.maxZ)
                     {
-                        blend = gHalphaBorder;
+                        blend = hiliteBorderWeight;
                     }
-                    r = (unsigned char)((double)r * (1.0 - blend) + blend * (double)gHred);
-                    g = (unsigned char)((double)g * (1.0 - blend) + blend * (double)gHgreen);
-                    b = (unsigned char)((double)b * (1.0 - blend) + blend * (double)gHblue);
+                    r = blendFixed(r, blend, gHred);
+                    g = blendFixed(g, blend, gHgreen);
+                    b = blendFixed(b, blend, gHblue);
                 }
             }
 
@@ -5439,6 +6069,10 @@ static unsigned char* draw(WorldGuide* pWorldGuide, int bx, int bz, int heightAl
             block->heightmap[x + z * 16] = (prevy < 0) ? EMPTY_HEIGHT : (short)prevy;
         }
     }
+
+    // save it for next time, if it's complete and not highlighted
+    if (gTileSettings != 0 && (block->rendermissing == 0 || westIsEmpty(bx, bz)))
+        storeTile(bx, bz, block);
     return bits;
 }
 
@@ -7963,23 +8597,9 @@ void testNumeral(WorldBlock* block, int type, int y, int digitPlace, int outType
     }
 }
 
-// return NULL if no block loaded.
-WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, int versionID, int& retCode)
+// Allocate a WorldBlock ready to be filled by fillBlock(). Not thread-safe, as it may touch the block cache.
+static WorldBlock* newLoadBlock(WorldGuide* pWorldGuide, int mcVersion, int versionID)
 {
-    // return negative value on error, 1 on read OK, 2 on read and it's empty, and higher bits than 1 or 2 are warnings
-    retCode = 0;
-
-    // if there's no world, simply return
-    if (pWorldGuide->type == WORLD_UNLOADED_TYPE)
-        return NULL;
-
-    // don't get a block for the synthetic world if it's not going to be populated
-    if (pWorldGuide->type == WORLD_TEST_BLOCK_TYPE) {
-        if (!(cx >= 0 && cx * 2 < NUM_BLOCKS_DEFINED && cz >= -3 && cz <= 8)) {
-            return NULL;
-        }
-    }
-
     // WorldBlock* block = block_alloc(MAX_ARRAY_HEIGHT(versionID, mcVersion));
     WorldBlock* block = block_alloc(pWorldGuide->minHeight, pWorldGuide->maxHeight);
 
@@ -8000,6 +8620,42 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
     block->versionID = versionID;
     // this version of 1.17 beta went to a height of 384;
     // now is set above in block_alloc(): block->maxHeight = (versionID >= 2685) ? 384 : 256;
+    return block;
+}
+
+// return NULL if no block loaded.
+WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, int versionID, int& retCode)
+{
+    // return negative value on error, 1 on read OK, 2 on read and it's empty, and higher bits than 1 or 2 are warnings
+    retCode = 0;
+
+    // if there's no world, simply return
+    if (pWorldGuide->type == WORLD_UNLOADED_TYPE)
+        return NULL;
+
+    // don't get a block for the synthetic world if it's not going to be populated
+    if (pWorldGuide->type == WORLD_TEST_BLOCK_TYPE) {
+        if (!(cx >= 0 && cx * 2 < NUM_BLOCKS_DEFINED && cz >= -3 && cz <= 8)) {
+            return NULL;
+        }
+    }
+
+    WorldBlock* block = newLoadBlock(pWorldGuide, mcVersion, versionID);
+    if (block == NULL)
+        return NULL;
+
+    if (!fillBlock(pWorldGuide, block, cx, cz, retCode, NULL, gUnknownBlockName)) {
+        block_free(block);
+        return NULL;
+    }
+    return block;
+}
+
+// Read the chunk's contents into the block. Returns false if there's nothing worth keeping, in which case the caller should free the block.
+// This is the part of LoadBlock() that can run on any thread: pass in that thread's own decoder and unknown block name string.
+static bool fillBlock(WorldGuide* pWorldGuide, WorldBlock* block, int cx, int cz, int& retCode, RegionDecoder* pDecoder, char* unknownBlockName)
+{
+    retCode = 0;
 
     if (pWorldGuide->type == WORLD_TEST_BLOCK_TYPE)
     {
@@ -8047,7 +8703,8 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
                 testBlock(block, type + 1, blockHeight, cz * 2);
                 testBlock(block, type + 1, blockHeight, cz * 2 + 1);
             }
-            return determineMaxFilledHeight(block);
+            determineMaxFilledHeight(block);
+            return true;
         }
         // tick marks
         else if (type >= 0 && type < NUM_BLOCKS_DEFINED && (cz == -1 || cz == 8))
@@ -8075,7 +8732,8 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
                     }
                 }
             }
-            return determineMaxFilledHeight(block);
+            determineMaxFilledHeight(block);
+            return true;
         }
         // numbers (yes, I'm insane)
         else if (type >= 0 && type < NUM_BLOCKS_DEFINED && (cz <= -2 && cz >= -3))
@@ -8110,12 +8768,12 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
                 testNumeral(block, type + 1, blockHeight, -cz * 2 - 3, letterType);
                 testNumeral(block, type + 1, blockHeight, -cz * 2 - 1 - 3, letterType);
             }
-            return determineMaxFilledHeight(block);
+            determineMaxFilledHeight(block);
+            return true;
         }
         else
         {
-            block_free(block);
-            return NULL;
+            return false;
         }
     }
     else {
@@ -8127,12 +8785,12 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
 
             // Given coordinates, check if the file for that location exists, data for the chunk exists, and populate the block.
             // Return 
-            retCode = regionGetBlocks(pWorldGuide->directory, cx, cz, block->grid, block->data, block->light, block->biome, blockEntities, &block->numEntities, block->mcVersion, block->minHeight, block->maxHeight, block->maxFilledSectionHeight, gUnknownBlockName, gUnknownBlockID);
+            retCode = regionGetBlocks(pDecoder, pWorldGuide->directory, cx, cz, block->grid, block->data, block->light, block->biome, blockEntities, &block->numEntities, block->mcVersion, block->minHeight, block->maxHeight, block->maxFilledSectionHeight, unknownBlockName, gUnknownBlockID);
             assert(block->numEntities <= 384);  // if higher, the allocation above needs to change!
 
             if (retCode == ERROR_INFLATE) {
                 block->blockType = retCode;
-                return NULL;
+                return false;
             }
 
             // values 1 and 2 are valid; 3's not used - higher bits are warnings; see nbt.h
@@ -8148,7 +8806,7 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
                         memcpy(block->entities, blockEntities, block->numEntities * sizeof(BlockEntity));
                     else
                         // couldn't alloc data
-                        return NULL;
+                        return false;
                 }
             }
             else {
@@ -8165,14 +8823,13 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
         // Note that NBT_NO_SECTIONS blocks will not go in here and be freed at the end.
         if (block->blockType == NBT_VALID_BLOCK) {
             int i;
-            // TODO someday: we could actually free the block, but the logic's a bit tricky. Leaving it be, since it works.
-            determineMaxFilledHeight(block);
-
-            // look for unknown blocks and recover
+            // look for unknown blocks and recover. This is done first, while the grid is still dense,
+            // as determineMaxFilledHeight() compacts the block. Nothing is above maxFilledSectionHeight,
+            // if it was found; if not, the whole chunk is checked.
+            int scanHeight = (block->maxFilledSectionHeight <= EMPTY_MAX_HEIGHT) ? block->heightAlloc : block->maxFilledSectionHeight + 1;
             unsigned char* pBlockID = block->grid;
-            for (i = 0; i < 16 * 16 * (block->maxFilledHeight+1); i++, pBlockID++)
+            for (i = 0; i < 16 * 16 * scanHeight; i++, pBlockID++)
             {
-                assert((i >> 8) <= block->maxFilledHeight);
                 if ((*pBlockID >= NUM_BLOCKS_STANDARD) && (*pBlockID != BLOCK_STRUCTURE_BLOCK))
                 {
                     // some new version of Minecraft, block ID is unrecognized;
@@ -8183,16 +8840,221 @@ WorldBlock* LoadBlock(WorldGuide* pWorldGuide, int cx, int cz, int mcVersion, in
                     // note that we always clean up bad blocks;
                     // whether we flag that a bad block was found is optional.
                     // This gets turned off once the user has been warned, once, that his map has some funky data.
+                    // (Any number of loading threads may set this flag; they all set it to 1, so no harm done.)
                     if (gPerformUnknownBlockCheck)
                         gUnknownBlock = 1;
                 }
             }
-            return block;
+
+            // TODO someday: we could actually free the block, but the logic's a bit tricky. Leaving it be, since it works.
+            determineMaxFilledHeight(block);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Add names from a loading thread's unknown block string to the global one, following readPalette()'s rules.
+static void mergeUnknownBlockNames(char* names)
+{
+    char* context = NULL;
+    char* name = strtok_s(names, ", ", &context);
+    while (name != NULL) {
+        if (strcmp(name, "etc.") != 0 && strstr(gUnknownBlockName, name) == NULL) {
+            size_t stringLength = strlen(gUnknownBlockName);
+            if (stringLength + strlen(name) + 8 < MAX_PATH_AND_FILE) {
+                if (stringLength > 0) {
+                    // already added a name, so add comma
+                    strcat_s(gUnknownBlockName, MAX_PATH_AND_FILE, ", ");
+                }
+                strcat_s(gUnknownBlockName, MAX_PATH_AND_FILE, name);
+            }
+            else if (stringLength + 6 < MAX_PATH_AND_FILE && strstr(gUnknownBlockName, ", etc.") == NULL) {
+                // end it - no more room!
+                strcat_s(gUnknownBlockName, MAX_PATH_AND_FILE, ", etc.");
+            }
+        }
+        name = strtok_s(NULL, ", ", &context);
+    }
+}
+
+typedef struct LoadBlocksJob {
+    WorldGuide* pWorldGuide;
+    const int* coords;      // bx, bz pairs
+    WorldBlock** blocks;
+    int* retCodes;
+    char (*unknownNames)[MAX_PATH_AND_FILE];    // one string per worker
+} LoadBlocksJob;
+
+static void loadBlockTask(int taskIndex, int workerIndex, void* userData)
+{
+    LoadBlocksJob* pJob = (LoadBlocksJob*)userData;
+    int bx = pJob->coords[2 * taskIndex];
+    int bz = pJob->coords[2 * taskIndex + 1];
+    WorldBlock* block = pJob->blocks[taskIndex];
+    if (!fillBlock(pJob->pWorldGuide, block, bx, bz, pJob->retCodes[taskIndex], gWorkerDecoders[workerIndex], pJob->unknownNames[workerIndex])) {
+        block_free(block);
+        block = NULL;
+    }
+    // always add the block, even if empty, so that we don't have to look it up as
+    // being empty in the future. If the same chunk was listed twice, the later add replaces the first.
+    Cache_Add(bx, bz, block);
+}
+
+// Chunks LoadBlocks() decodes at once, per worker: each is allocated at full height before decoding starts,
+// so this bounds the memory in flight, while giving workers that finish early something more to do
+#define LOAD_BATCH_PER_WORKER   4
+
+// Load the listed chunks, bx, bz pairs, decoding them across all worker threads, and add them to the block cache.
+// Chunks already in the cache are skipped. The world's dimension directory must already be set, as for LoadBlock().
+// Only real worlds are loaded here; test worlds and schematics are cheap to make on demand.
+// Returns the retCodes combined as DrawMap() does: the last error if any, else the OR of all warnings.
+int LoadBlocks(WorldGuide* pWorldGuide, int numChunks, const int* chunkCoords, int mcVersion, int versionID)
+{
+    int i;
+    int sumRetCode = 0;
+    if (pWorldGuide->type != WORLD_LEVEL_TYPE || numChunks <= 0)
+        return 0;
+
+    int batchSize = min(numChunks, LOAD_BATCH_PER_WORKER * GetWorkerCount());
+    int* coords = (int*)malloc(2 * batchSize * sizeof(int));
+    WorldBlock** blocks = (WorldBlock**)malloc(batchSize * sizeof(WorldBlock*));
+    int* retCodes = (int*)malloc(batchSize * sizeof(int));
+    char (*unknownNames)[MAX_PATH_AND_FILE] = (char (*)[MAX_PATH_AND_FILE])calloc(MAX_WORKERS, MAX_PATH_AND_FILE);
+    if (coords == NULL || blocks == NULL || retCodes == NULL || unknownNames == NULL) {
+        // not much to do: let the chunks load one by one later, as usual
+        free(coords);
+        free(blocks);
+        free(retCodes);
+        free(unknownNames);
+        return 0;
+    }
+
+    int numWorkers = 0;
+    int next = 0;
+    while (next < numChunks) {
+        // allocate blocks here, on the calling thread, since running out of memory empties the whole cache
+        int numToLoad = 0;
+        bool outOfMemory = false;
+        for (; next < numChunks && numToLoad < batchSize; next++) {
+            void* data;
+            if (!Cache_Find(chunkCoords[2 * next], chunkCoords[2 * next + 1], &data)) {
+                WorldBlock* block = newLoadBlock(pWorldGuide, mcVersion, versionID);
+                if (block == NULL) {
+                    outOfMemory = true;
+                    break;
+                }
+                coords[2 * numToLoad] = chunkCoords[2 * next];
+                coords[2 * numToLoad + 1] = chunkCoords[2 * next + 1];
+                blocks[numToLoad++] = block;
+            }
+        }
+        if (numToLoad == 0)
+            break;
+
+        if (numWorkers == 0) {
+            // set up everything the loading threads share, before they start
+            nbtPrepareTables();
+            numWorkers = GetWorkerCount();
+            for (i = 1; i < numWorkers; i++) {
+                if (gWorkerDecoders[i] == NULL)
+                    gWorkerDecoders[i] = regionNewDecoder();
+            }
+            // a worker without a decoder would fall back to the main decoder, which worker 0 is using
+            for (i = 1; i < numWorkers && gWorkerDecoders[i] != NULL; i++)
+                ;
+            numWorkers = i;
+        }
+
+        LoadBlocksJob job;
+        job.pWorldGuide = pWorldGuide;
+        job.coords = coords;
+        job.blocks = blocks;
+        job.retCodes = retCodes;
+        job.unknownNames = unknownNames;
+        RunWorkerTasks(numToLoad, loadBlockTask, &job, min(numWorkers, numToLoad));
+
+        for (i = 0; i < numToLoad; i++) {
+            int bx = coords[2 * i];
+            int bz = coords[2 * i + 1];
+            if (retCodes[i] < 0) {
+                // save bx and bz for error message later
+                saveBadChunkLocation(bx, bz);
+                sumRetCode = retCodes[i];
+            }
+            else if (sumRetCode >= 0) {
+                sumRetCode |= retCodes[i];
+            }
+        }
+        // the rest will be loaded one by one later, if memory allows
+        if (outOfMemory)
+            break;
+    }
+
+    for (i = 0; i < numWorkers; i++) {
+        if (unknownNames[i][0])
+            mergeUnknownBlockNames(unknownNames[i]);
+    }
+
+    free(coords);
+    free(blocks);
+    free(retCodes);
+    free(unknownNames);
+    return sumRetCode;
+}
+
+// Load, in parallel, all chunks in the rectangle [minbx,maxbx] x [minbz,maxbz] that are not yet cached.
+// Does nothing if the rectangle won't fit in the cache, as chunks would be thrown out before they're used.
+// Chunks are loaded in batches, so that the progress callback, if any, is called now and again.
+int PrefetchBlocks(WorldGuide* pWorldGuide, int minbx, int minbz, int maxbx, int maxbz, int worldType, int mcVersion, int versionID, ProgressCallback callback)
+{
+    return prefetchBlocks(pWorldGuide, minbx, minbz, maxbx, maxbz, worldType, mcVersion, versionID, callback, false);
+}
+
+// skipStored: don't load chunks that findStoredTile() would find, as they'll be drawn from the tile store
+static int prefetchBlocks(WorldGuide* pWorldGuide, int minbx, int minbz, int maxbx, int maxbz, int worldType, int mcVersion, int versionID, ProgressCallback callback, bool skipStored)
+{
+    if (pWorldGuide->type != WORLD_LEVEL_TYPE || minbx > maxbx || minbz > maxbz)
+        return 0;
+    int numChunks = (maxbx - minbx + 1) * (maxbz - minbz + 1);
+    if (numChunks > Cache_Capacity() / 2)
+        return 0;
+
+    int* coords = (int*)malloc(2 * numChunks * sizeof(int));
+    if (coords == NULL)
+        return 0;
+    int numToLoad = 0;
+    for (int bz = minbz; bz <= maxbz; bz++) {
+        for (int bx = minbx; bx <= maxbx; bx++) {
+            void* data;
+            if (!Cache_Find(bx, bz, &data) && !(skipStored && findStoredTile(bx, bz, NULL))) {
+                coords[2 * numToLoad] = bx;
+                coords[2 * numToLoad + 1] = bz;
+                numToLoad++;
+            }
         }
     }
 
-    block_free(block);
-    return NULL;
+    int sumRetCode = 0;
+    if (numToLoad > 0) {
+        SetDimensionDirectory(pWorldGuide, worldType);
+        int batchSize = 16 * GetWorkerCount();
+        for (int start = 0; start < numToLoad; start += batchSize) {
+            int retCode = LoadBlocks(pWorldGuide, min(batchSize, numToLoad - start), coords + 2 * start, mcVersion, versionID);
+            if (retCode < 0) {
+                // preserve the error code
+                sumRetCode = retCode;
+            }
+            else if (sumRetCode >= 0) {
+                sumRetCode |= retCode;
+            }
+            if (callback)
+                callback((float)min(start + batchSize, numToLoad) / (float)numToLoad, NULL);
+        }
+    }
+    free(coords);
+    return sumRetCode;
 }
 
 static WorldBlock* determineMaxFilledHeight(WorldBlock* block)
@@ -8218,7 +9080,10 @@ static WorldBlock* determineMaxFilledHeight(WorldBlock* block)
         //return NULL;
     }
 
-    // and, realloc, if set to minimize memory
+    // note the types in each section, for exports to skip sections with nothing to export
+    block_summarize(block);
+
+    // and compact it for the cache
     block_realloc(block);
 
     return block;
@@ -8619,6 +9484,13 @@ static void initColors()
             gBlankHighlitTile[off + 3] = (unsigned char)255;
         }
     }
+
+    // and the blank tile as an LOD cell, at each level
+    memcpy(gBlankCells[0], gBlankTile, 16 * 16 * 4);
+    for (int level = 1; level <= MAX_LOD_LEVEL; level++) {
+        for (int quadrant = 0; quadrant < 4; quadrant++)
+            shrinkToQuadrant(gBlankCells[level - 1], gBlankCells[level], quadrant & 1, quadrant >> 1);
+    }
 }
 
 char* MapUnknownBlockName()
@@ -34,6 +34,8 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "rwpng.h"
 #include "vector.h"
 #include "mdlFiles.h"
+#include "outstream.h"
+#include "radixsort.h"
 #include <assert.h>
 #include <string.h>
 #include <math.h>
@@ -82,14 +84,6 @@ DWORD br;
 // if we see this value, it's probably bad
 #define UNINITIALIZED_INT	-98789
 
-typedef struct BoxCell {
-    int group;	// for 3D printing, what connected group a block is part of
-    unsigned short type;
-    unsigned short origType;
-    unsigned char flatFlags;	// pointer to which origType to use for face output, for "merged" snow, redstone, etc. in cell above
-    unsigned char data;     // extra data for block (wool color, etc.); note that four top bits are not used
-} BoxCell;
-
 typedef struct BoxGroup
 {
     int groupID;	// which group number am I? Always matches index of gGroupInfo array - TODO: maybe could be made an unsigned short...
@@ -98,14 +92,54 @@ typedef struct BoxGroup
     IBox bounds;	// the box that this group occupies. Not valid if population is 0 (merged)
 } BoxGroup;
 
-static BoxCell* gBoxData = NULL;
+// A run of cells going down a column that are all solid or all air, used by findGroupsByRuns. Runs that touch are linked
+// to a common root, which is always the earliest run made in the set.
+typedef struct GroupRun
+{
+    int parent;     // index of the run this one is linked to; the root points to itself
+    int groupID;    // group made for the set, only set on the root (and on entrances)
+    int boxIndex;   // top cell of the run
+    bool solid;
+    bool entrance;  // a single sealed entrance cell, which joins a group but does not connect other cells through it
+} GroupRun;
+
+// While findGroupsByRuns runs, cells hold negative group values giving their run index
+#define RUN_GROUP_LABEL(run)    (-1-(run))
+
+// The box's cells, one array per field, all indexed by BOX_INDEX. Kept apart so that passes which only look at
+// the types stream through just those, and so that there's no padding: 6 bytes a cell, plus 4 while groups exist.
+static unsigned short* gBoxType = NULL;
+static unsigned short* gBoxOrigType = NULL;
+static unsigned char* gBoxFlatFlags = NULL;	// pointer to which origType to use for face output, for "merged" snow, redstone, etc. in cell above
+static unsigned char* gBoxDataVal = NULL;	// extra data for block (wool color, etc.); note that four top bits are not used
+// for 3D printing, what connected group a block is part of. Only allocated while the group and hollowing passes need it; see allocBoxGroups()
+static int* gBoxGroup = NULL;
 static unsigned char* gBiomeArray = NULL;
+// the whole export volume, in world coordinates, while it's being exported a tile at a time; else NULL
+static IBox* gpTiledExportBox = NULL;
+// while exporting a tile at a time, the tile being exported, from 0, and the number of tiles; see scaleTileProgress()
+static int gProgressTile = 0;
+static int gProgressNumTiles = 0;
+
+// Largest box, in cells, that all of the export volume is ever read into at once, see extractWholeBox(). The box
+// must also fit in a fraction of the memory available. Larger volumes are read twice instead, first to find the
+// bounds of what's in them.
+#ifndef MINEWAYS_X64
+#define WHOLE_BOX_MAX_CELLS (1<<24)
+#else
+#define WHOLE_BOX_MAX_CELLS (1<<28)
+#endif
+// bytes per box cell, see allocBoxCells()
+#define BOX_CELL_BYTES (2 * sizeof(unsigned short) + 2 * sizeof(unsigned char))
+
+// section_type_key()s of blocks that could be exported, see setSavedTypeMask(); chunk sections with none are skipped
+static unsigned long long gSavedTypeMask[SECTION_TYPE_WORDS];
 static IPoint gBoxSize;
 static int gBoxSizeYZ = UNINITIALIZED_INT;
 static int gBoxSizeXYZ = UNINITIALIZED_INT;
-// the box bounds of gBoxData that has something in it, before processing
+// the box bounds of the box cells that have something in them, before processing
 static IBox gSolidBox;
-// the box bounds of gBoxData that has something in it, +1 in all directions for air
+// the box bounds of the box cells that have something in them, +1 in all directions for air
 // Basically, gSolidBox + 1 in all directions, but generated once for readability
 static IBox gAirBox;
 // Dimensions of what truly has stuff in it, after all processing is done and we're ready to write
@@ -124,6 +158,18 @@ typedef struct FillAlpha {
     int underlay;
 } FillAlpha;
 
+// When exporting individual tiles, each tile image written is a separate task
+typedef struct TileWriteTask {
+    int swatchLoc;      // the tile
+    int category;       // CATEGORY_RGBA comes from the output texture, the rest from the input textures
+    int clampLevel;     // if > 0, an emitter made from the output texture, see writeTileFromMasterOutput()
+    int rc;
+    wchar_t filename[MAX_PATH_AND_FILE];
+} TileWriteTask;
+
+// tasks gathered per batch; each tile takes up to TOTAL_CATEGORIES of them
+#define TILE_WRITE_BATCH 256
+
 // The size of the border added to a tile to make a swatch. So a 16x16 tile makes an 18x18 swatch.
 // The whole point here is simple: bilinear interpolation is done on swatches when rendering textures
 // (unless your renderer is cool enough to allow you to turn it off and so get the block Minecraft look).
@@ -153,6 +199,40 @@ static int gGroupCount = UNINITIALIZED_INT;
 
 // offsets in box coordinates to the neighboring faces
 static int gFaceOffset[6];
+
+// generateBlockDataAndStatistics() finds which faces to make for this many bytes' worth of blocks at a time, a byte each
+#define FACE_MASK_BAND_BYTES (32 * 1024 * 1024)
+
+// appendToOBJFile() copies a tiled export's geometry into the OBJ file this many bytes at a time
+#define APPEND_BUFFER_SIZE (4 * 1024 * 1024)
+
+// orders sortFaces() can put faces in; see the comparison functions of the same names
+#define FACE_ORDER_ID       0   // faceIdCompare
+#define FACE_ORDER_TILE     1   // tileIdCompare
+#define FACE_ORDER_USD_TILE 2   // tileUSDIdCompare
+
+typedef struct FaceMaskBand {
+    int firstX;             // X of the band's first slab
+    int zCount, yCount;     // gSolidBox's size
+    unsigned char* mask;    // for each slab, Z, Y, a bit per face direction
+} FaceMaskBand;
+
+// key of a face that meshFaceBand() can't merge with its neighbors
+#define NO_MESH_FACE -1
+
+// A merged face reaching the far X edge of a band, left open to be widened into the next band.
+typedef struct OpenMergedFace {
+    IPoint loc;             // corner block
+    int faceDirection;
+    int key;
+    int xlen, ylen;
+} OpenMergedFace;
+
+typedef struct OpenMergedFaceList {
+    OpenMergedFace* faces;
+    int count;
+    int size;
+} OpenMergedFaceList;
 // flat flag for a neighbor that points to the original block
 static int gFlagPointsTo[6];
 
@@ -392,9 +472,9 @@ static int gFaceDirectionVector[6][3] =
 };
 
 // I wish file writing was faster. Don't know why it seems so slow. TODO. Relevant? https://stackoverflow.com/questions/64795981/how-to-make-fs-writefile-faster-for-an-image
-#define WERROR_MODEL(x) if(x) { assert(0); PortaClose(gModelFile); return MW_CANNOT_WRITE_TO_FILE; }
-#define WERROR_FH(x) if(x) { assert(0); PortaClose(fh); return MW_CANNOT_WRITE_TO_FILE; }
-#define WERROR_SPECIFY(x,FHANDLE) if(x) { assert(0); PortaClose(FHANDLE); return MW_CANNOT_WRITE_TO_FILE; }
+#define WERROR_MODEL(x) if(x) { assert(0); OutClose(gModelFile); return MW_CANNOT_WRITE_TO_FILE; }
+#define WERROR_FH(x) if(x) { assert(0); OutClose(fh); return MW_CANNOT_WRITE_TO_FILE; }
+#define WERROR_SPECIFY(x,FHANDLE) if(x) { assert(0); OutClose(FHANDLE); return MW_CANNOT_WRITE_TO_FILE; }
 
 
 // feed world coordinate in to get box index: in our coordinate system, X is dominant, Z is next, Y is weakest.
@@ -423,7 +503,7 @@ static int gFaceDirectionVector[6][3] =
     ((x)-(bx)*16)  )
 
 #define UPDATE_STATUS(p,s)		{                               \
-if (*gpCallback) { (*gpCallback)((float)(p),s); }               \
+if (*gpCallback) { (*gpCallback)(scaleTileProgress((float)(p)),s); }    \
 }
 
 #ifdef _DEBUG
@@ -431,7 +511,7 @@ clock_t gStartTimeStamp;
 clock_t gTimeStamp;
 
 #define UPDATE_PROGRESS(p)		{                               \
-if (*gpCallback) { (*gpCallback)((float)(p),NULL); }            \
+if (*gpCallback) { (*gpCallback)(scaleTileProgress((float)(p)),NULL); } \
 clock_t now = clock();                                          \
 double diffTime = (now-gTimeStamp)/(CLOCKS_PER_SEC/1000);       \
 gTimeStamp = now;                                               \
@@ -442,7 +522,7 @@ OutputDebugStringA(progString);                                 \
 #else
 
 #define UPDATE_PROGRESS(p)		{                               \
-if (*gpCallback) { (*gpCallback)((float)(p),NULL); }            \
+if (*gpCallback) { (*gpCallback)(scaleTileProgress((float)(p)),NULL); } \
 }
 
 #endif
@@ -469,6 +549,20 @@ typedef struct ProgressValues {
 
 ProgressValues gProgress;
 
+// When exporting a tile at a time, each tile goes through reading blocks to writing out geometry, so progress within
+// that span is put into the current tile's share of it; otherwise the bar would jump back at the start of each tile.
+// Negative values, which leave the bar as is, pass through.
+static float scaleTileProgress(float progress)
+{
+    if (gProgressNumTiles == 0 || progress < 0.0f)
+        return progress;
+    float start = gProgress.start.readBlocks;
+    float span = gProgress.start.texture - start;
+    float withinTile = (span > 0.0f) ? (progress - start) / span : 0.0f;
+    withinTile = (withinTile < 0.0f) ? 0.0f : ((withinTile > 1.0f) ? 1.0f : withinTile);
+    return start + span * ((float)gProgressTile + withinTile) / (float)gProgressNumTiles;
+}
+
 #define NO_INDEX_SET 0xffffffff
 
 // alpha for group debug mode
@@ -486,7 +580,7 @@ ProgressValues gProgress;
 
 // objects that are waterlogged should be considered fully in water, as if the block was in water
 #define IS_WATERLOGGED(tval,bi) ((gBlockDefinitions[tval].flags & BLF_WATERLOG) || \
-								((gBlockDefinitions[tval].flags & BLF_MAYWATERLOG) && !(gBlockDefinitions[tval].flags & BLF_LAME_WATERLOG) && (gBoxData[bi].data & WATERLOGGED_BIT)))
+								((gBlockDefinitions[tval].flags & BLF_MAYWATERLOG) && !(gBlockDefinitions[tval].flags & BLF_LAME_WATERLOG) && (gBoxDataVal[bi] & WATERLOGGED_BIT)))
 
 #define IS_FLUID(tval,bi)	(((tval) >= BLOCK_WATER && (tval) <= BLOCK_STATIONARY_LAVA) || IS_WATERLOGGED(tval,bi))
 #define IS_NOT_FLUID(tval,bi)	(!IS_FLUID(tval,bi))
@@ -501,6 +595,27 @@ typedef struct TouchCell {
 
 TouchCell* gTouchGrid = NULL;
 
+// obscurity of each cell in the air box, from computeObscurityGrid(); NULL means compute each cell as needed
+static unsigned char* gObscurityGrid = NULL;
+
+// scratch "solid seen so far" flags, gBoxSize[Y] per worker, for the obscurity scans
+typedef struct ObscurityScan {
+    unsigned char* seen;
+} ObscurityScan;
+
+// OBJ indices are for the whole file, so when it's written a tile at a time, each tile's indices are offset by
+// the normals, texture coordinates and vertices output before it. Groups and materials also carry across tiles.
+typedef struct OBJOutputState {
+    int normalBase;
+    int uvBase;
+    int vertexBase;
+    int uvCount;    // texture coordinates written so far
+    int groupCount;
+    unsigned char outputMaterial[NUM_BLOCKS];   // notes when a material is used for the first time
+} OBJOutputState;
+
+static OBJOutputState gOBJState;
+
 static int gTouchSize;
 
 typedef struct TouchRecord {
@@ -607,22 +722,33 @@ static int gAssertFacesNotReusedMask = 0x0;
 static void determineProgressValues(int fileType, int xdim, int zdim);
 
 static int modifyAndWriteTextures(int needDifferentTextures, int fileType);
+static int writePBRMosaics(const wchar_t* path);
 
 static void convertWcharPathUnderlined(char* worldNameUnderlined, wchar_t* worldName, bool convertPunctuation);
 static void convertCharPathUnderlined(char* worldNameUnderlined, char* worldCharName, bool convertPunctuation);
 
 static void initializeWorldData(IBox* worldBox, int xmin, int ymin, int zmin, int xmax, int ymax, int zmax);
 static int initializeModelData();
+static int prepareExportTexture();
 
 static int readTerrainPNG(const wchar_t* curDir, progimage_info* pII, wchar_t* terrainFileName, int category, int exportFileType);
 static void invertImage(progimage_info* dst);
 
 static int populateBox(WorldGuide* pWorldGuide, ChangeBlockCommand* pCBC, IBox* box);
+static int allocBoxCells();
+static void freeBoxCells();
+static int allocBoxGroups();
+static void freeBoxGroups();
 static void findChunkBounds(WorldGuide* pWorldGuide, int bx, int bz, IBox* worldBox, int mcVersion, int versionID);
-static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* box, int mcVersion, int versionID);
+static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorldBox, IBox* boundsBox, int mcVersion, int versionID);
+static bool extractWholeBox(WorldGuide* pWorldGuide, IBox* worldBox);
+static void compactWholeBox(IPoint wholeBoxSize, IPoint wholeWorld2BoxOffset, IBox* edgeWorldBox);
+static bool isBlockSaved(int blockID, int dataVal);
+static void setSavedTypeMask();
 static bool willChangeBlockCommandModifyAir(ChangeBlockCommand* pCBC);
 static void modifySides(int editMode);
 static void modifySlab(int by, int editMode);
+static bool isTileSeam(int boxCoord, int axis);
 static void editBlock(int x, int y, int z, int editMode);
 
 static int filterBox(ChangeBlockCommand* pCBC);
@@ -671,6 +797,9 @@ static int checkVertexListSize();
 static int checkFaceListSize();
 
 static int findGroups();
+static bool findGroupsByRuns(int& retCode);
+static int findRunRoot(GroupRun* runs, int run);
+static void joinRuns(GroupRun* runs, int run, int neighborIndex);
 static void addVolumeToGroup(int groupID, int minx, int miny, int minz, int maxx, int maxy, int maxz);
 static void propagateSeed(IPoint point, BoxGroup* groupInfo, IPoint** seedStack, int* seedSize, int* seedCount);
 static bool notAirEdge(IPoint pt);
@@ -696,6 +825,9 @@ static int fixTouchingEdges();
 static int touchRecordCompare(void* context, const void* str1, const void* str2);
 static void checkForTouchingEdge(int boxIndex, int offx, int offy, int offz);
 static int computeObscurity(int boxIndex);
+static void computeObscurityGrid();
+static void obscuritySlabTask(int taskIndex, int workerIndex, void* userData);
+static void obscurityRowTask(int taskIndex, int workerIndex, void* userData);
 static void decrementNeighbors(int boxIndex);
 static float computeHidingDistance(Point loc1, Point loc2, float norm);
 static void boxIndexToLoc(IPoint loc, int boxIndex);
@@ -721,12 +853,19 @@ static int tileIdDeleteAndCompare(void* context, const void* str1, const void* s
 static int tileUSDIdDeleteAndCompare(void* context, const void* str1, const void* str2);
 #endif
 static int faceIdCompare(void* context, const void* str1, const void* str2);
+static void sortFaces(FaceRecord** faceList, int faceCount, int order);
+static bool radixSortFaces(FaceRecord** faceList, unsigned long long* keys, int faceCount, int order);
 static int chunkUSDCompare(void* context, const void* str1, const void* str2);
 static int instanceUSDCompare(void* context, const void* str1, const void* str2);
 
 static int getDimensionsAndCount(Point dimensions);
 static void rotateLocation(Point pt);
-static int checkAndCreateFaces(int boxIndex, IPoint loc);
+static int findFaceMask(int boxIndex);
+static void findFaceMaskTask(int taskIndex, int workerIndex, void* userData);
+static int checkAndCreateFaces(int boxIndex, IPoint loc, int faceMask);
+static int meshFaceKey(int boxIndex, int faceDirection);
+static int meshFaceBand(FaceMaskBand* pBand, int slabs, OpenMergedFaceList* pOpen, OpenMergedFaceList* pNextOpen, int& savings);
+static int saveMergedFace(IPoint loc, int faceDirection, int uAxis, int vAxis, int xlen, int ylen, int& savings);
 static int checkMakeFace(int type, int neighborType, int view3D, int testPartial, int faceDirection, int boxIndex, int neighborBoxIndex, int fluidFullBlock);
 static int neighborMayCoverFace(int neighborType, int view3D, int testPartial, int faceDirection, int neighborBoxIndex);
 static int lesserBlockCoversWholeFace(int faceDirection, int neighborBoxIndex, int view3D);
@@ -737,6 +876,8 @@ static float getFluidHeightPercent(int dataVal);
 static int sameFluid(int fluidBI, int typeBI);
 static int saveSpecialVertices(int boxIndex, int faceDirection, IPoint loc, float heights[4], int heightIndices[4]);
 static int saveVertices(int boxIndex, int faceDirection, IPoint loc);
+static int saveGridVertex(int vertexIndex, IPoint loc);
+static int getFaceMaterial(int boxIndex, int faceDirection, short& materialType, unsigned short& materialDataVal, int& dataVal);
 static int saveFaceLoop(int boxIndex, int faceDirection, float heights[4], int heightIndex[4], int firstFace);
 static int getMaterialUsingGroup(int groupID);
 static void randomlyRotateTopAndBottomFace(int faceDirection, int boxIndex, int* localIndices, bool halfOnly = false, bool allFaces = false);
@@ -754,6 +895,7 @@ static void saveRectangleTextureUVs(int swatchLoc, int type, float minu, float m
 static int saveTextureUV(int swatchLoc, int type, float u, float v);
 
 static void freeModel(Model* pModel);
+static void freeModelGeometry(Model* pModel);
 
 static int findMatchingNormal(FaceRecord* pFace, Vector normal, Vector* normalList, int normalListCount);
 static int addNormalToList(Vector normal, Vector* normalList, int* normalListCount, int normalListSize);
@@ -766,6 +908,15 @@ static int mosaicUVtoSeparateUV();
 static int writeAsciiSTLBox(WorldGuide* pWorldGuide, IBox* box, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
 static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* box, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
 static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
+static int getExportTileSize(int fileType, IBox* worldBox);
+static int writeOBJTiles(WorldGuide* pWorldGuide, IBox* worldBox, int tileSize, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
+static int getTiledExportCenter(int axis);
+static int writeOBJTile(WorldGuide* pWorldGuide, IBox* tileBox, IBox* worldBox, ChangeBlockCommand* pCBC, bool& partFileOpen);
+static int appendToOBJFile(const wchar_t* fileName);
+static int writeOBJHeader(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
+static int writeOBJGeometry();
+static int writeOBJFinish();
+static void addToMtlList(unsigned int typeData);
 static int writeOBJTextureUV(float u, float v, int addComment, int swatchLoc);
 static int writeOBJMtlFile();
 static int writeOBJFullMtlDescription(char* mtlName, int type, int dataVal, char* textureRGB, char* textureRGBA, char* textureAlpha, char* textureRoot, int swatchLoc);
@@ -773,6 +924,7 @@ static int writeOBJFullMtlDescription(char* mtlName, int type, int dataVal, char
 static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* box, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
 static int writeVRMLAttributeShapeSplit(int type, int dataVal, char* mtlName, char* textureOutputString);
 static int writeVRMLTextureUV(float u, float v, int addComment, int swatchLoc);
+static char* formatVRMLIndexLoop(char* dst, const int* indices, int count, int offset, char separator, const char* ending);
 
 static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* box, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC);
 static bool findNextChunk(int startInstance, int& endInstance, char* chunkLocation);
@@ -785,6 +937,8 @@ static void initializeBox(Box& b);
 static void increaseBoxByVertex(Box& b, Point& p);
 static int createMeshesUSD(wchar_t* blockLibraryPath, char* materialLibrary, bool singleTerrainFile, char* slashDefaultPrim);
 static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int numVerts, char* prefixLook, char* slashDefaultPrim, char* mtlName, int & progressTick, int progressIncrement, bool singleTerrainFile, int type, int dataVal);
+static char* formatUSDInt(char* dst, int value, const char* separator);
+static char* formatUSDTuple(char* dst, const float* values, int count, const char* separator);
 static void removeDuplicateVertices(Box& box);
 static void removeDuplicateNormals();
 static void removeDuplicateTextureSTs();
@@ -822,6 +976,7 @@ static int schematicWriteStringValue(gzFile gz, char* stringValue);
 static int spongeWriteVarint(gzFile gz, unsigned int value, unsigned char* outBytes);
 static int spongeBlockStateString(int type, int dataVal, char* out, size_t outSize);
 
+static void writeTileTask(int taskIndex, int workerIndex, void* userData);
 static int writeEmissiveScaledTile(wchar_t* filename, int index);
 static int writeTileFromCategoryInput(wchar_t* filename, int index, int category);
 static boolean isTileValue(int category, int swatchLoc, boolean checkAllPixels, unsigned char value);
@@ -894,12 +1049,17 @@ static double myrand();
 static int analyzeChunk(WorldGuide* pWorldGuide, Options* pOptions, int bx, int bz, int minx, int miny, int minz, int maxx, int maxy, int maxz, int mapMinHeight, int mapMaxHeight, bool ignoreTransparent, int mcVersion, int versionID);
 
 static int decimateMesh();
+static int allocSimplifyUVGrid();
 static bool faceCanTile(int faceId);
+static bool materialCanTile(short materialType, int swatchLoc, const short uvIndex[4]);
 static void extractZXYfromNormalAndBounds(FaceRecord* pFace, SimplifyFaceRecord* pSimplifyFace);
 static void simplifyFaceSet(int faceCount, SimplifyFaceRecord** ppSFR);
 static int simplifyFaceCompareYminor(void* context, const void* str1, const void* str2);
 static int simplifyFaceCompareXminor(void* context, const void* str1, const void* str2);
+static void sortSimplifyFaces(SimplifyFaceRecord** ppSFR, int faceCount, bool yMinor);
+static bool radixSortSimplifyFaces(SimplifyFaceRecord** ppSFR, unsigned long long* keys, int faceCount, bool yMinor);
 static void mergeSimplifySet(SimplifyFaceRecord** ppSFR, int faceCount);
+static void setMergedFace(FaceRecord* pFace, int vertexIndex[4], int xlen, int ylen);
 static short findUVinIndex(FaceRecord* pFace, float bx, float by);
 static int getVertexIDmatching(FaceRecord* pFace, float xnx, float yny);
 
@@ -952,6 +1112,7 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
     int retCode = MW_NO_ERROR;
     int needDifferentTextures = 0;
     int catIndex;
+    int exportTileSize;
     gTotalInputTextures = 1;
     gUserSelectedBiome = userSelectedBiome;
 
@@ -1041,7 +1202,11 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
     gModel.groupCountSize = groupCountSize;
     gModel.groupCountArray = groupCountArray;
 
-    gBoxData = NULL;
+    gBoxType = NULL;
+    gBoxOrigType = NULL;
+    gBoxFlatFlags = NULL;
+    gBoxDataVal = NULL;
+    gBoxGroup = NULL;
     gBiomeArray = NULL;
 
     gMinorBlockCount = 0;
@@ -1237,6 +1402,19 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
     initializeWorldData(&worldBox, xmin, ymin, zmin, xmax, ymax, zmax);
     tightenedWorldBox = worldBox;
 
+    // Large enough exports to OBJ can be read, processed and written out a tile of chunks at a time, see writeOBJTiles().
+    exportTileSize = getExportTileSize(fileType, &worldBox);
+    if (exportTileSize > 0)
+    {
+        needDifferentTextures = 1;
+        retCode |= writeOBJTiles(pWorldGuide, &worldBox, exportTileSize, curDir, terrainFileName, cullSchemeSelected, pCBC);
+        if (retCode >= MW_BEGIN_ERRORS || retCode >= MW_BEGIN_NOTHING_TO_DO)
+        {
+            goto Exit;
+        }
+        goto FinishOutput;
+    }
+
     // Note that tightenedWorldBox will come back with the "solid" bounds, of where data was actually found.
     // Mostly "of interest", not particularly useful - we used to output it, but that's a bit confusing when importing.
     retCode |= populateBox(pWorldGuide, pCBC, &tightenedWorldBox);
@@ -1247,57 +1425,13 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
     }
 
     // prepare to write texture, if needed
-    if (gModel.exportTexture)
-    {
-        // Make it twice as large if we're outputting image textures, too- we need the space.
-        // We're just setting up here, giving something to write UVs against; even per-tile texture
-        // output uses this. We export the texture at the end.
-        if (gModel.options->exportFlags & EXPT_OUTPUT_TEXTURE_IMAGES_OR_TILES)
-        {
-            // use true textures - for 3D printing or if swatches are needed, we need to make output image larger to accomodate composite swatches.
-            // for 1.16 and earlier: gModel.textureResolution = ((gModel.print3D || gModel.options->pEFD->chkCompositeOverlay) ? 4 : 2) * gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
-            gModel.textureResolution = 4 * gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
-            gModel.terrainWidth = gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
-        }
-        else
-        {
-            // Use "noisy" colors, fixed 512 x 512 - we could actually make this texture quite small
-            // Note this used to be 256 x 256, but that's only 14*14 = 196 materials, and we're now
-            // at 198 or so...
-            gModel.textureResolution = 1024;    // was 512 for 1.16
-            // This number determines number of swatches per row. Make it 256, even though there's
-            // no incoming image. This then ensures there's room for enough solid color images.
-            gModel.terrainWidth = 256;    // really, no image, but act like there is
-        }
-        // there are always 16 tiles wide in terrainExt.png, so we divide by this.
-        gModel.tileSize = gModel.terrainWidth / 16;
-        gModel.resScale = 16.0f / (float)gModel.tileSize;
-        gModel.swatchSize = 2 + gModel.tileSize;
-        gModel.invTextureResolution = 1.0f / (float)gModel.textureResolution;
-        gModel.swatchesPerRow = (int)(gModel.textureResolution / gModel.swatchSize);
-        gModel.textureUVPerSwatch = (float)gModel.swatchSize / (float)gModel.textureResolution; // e.g. 18 / 256
-        gModel.textureUVPerTile = (float)gModel.tileSize / (float)gModel.textureResolution; // e.g. 16 / 256
-        gModel.swatchListSize = gModel.swatchesPerRow * gModel.swatchesPerRow;
-
-        if (EXPORT_TEXTURE) {
-            retCode |= createBaseMaterialTexture();
-        }
-    }
-
-    // were there errors?
+    retCode |= prepareExportTexture();
     if (retCode >= MW_BEGIN_ERRORS)
     {
         // texture out of memory or some other read error.
         goto Exit;
     }
 
-    // check if resolution is massively high; warn once
-    static bool warnOnSize = true;
-    if (warnOnSize && gModel.textureResolution >= 16384 && !gModel.exportTiles) {
-        warnOnSize = false;
-        retCode |= MW_TEXTURE_RESOLUTION_HIGH;
-    }
-
     UPDATE_PROGRESS(gProgress.start.readBlocks + 0.45f * gProgress.absolute.readBlocks);
     retCode |= initializeModelData();
     if (retCode >= MW_BEGIN_ERRORS)
@@ -1337,6 +1471,11 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
         // problem found
         goto Exit;
     }
+    // groups are done with, unless they're being shown as materials
+    if (!(gModel.options->exportFlags & EXPT_DEBUG_SHOW_GROUPS))
+    {
+        freeBoxGroups();
+    }
     UPDATE_STATUS(gProgress.start.makeFaces,L"Make faces to output");
     //UPDATE_PROGRESS(gProgress.start.makeFaces);
 
@@ -1391,6 +1530,7 @@ int SaveVolume(wchar_t* saveFileName, int fileType, Options* options, WorldGuide
         break;
     }
 
+FinishOutput:
     // note if groups were updated, a value that is returned
     groupCount = gModel.groupCount;
 
@@ -1420,9 +1560,9 @@ Exit:
     UPDATE_STATUS(gProgress.start.zip, L"Cleanup");
     freeModel(&gModel);
 
-    if (gBoxData)
-        free(gBoxData);
-    gBoxData = NULL;
+    freeBoxCells();
+    // don't keep region files mapped after the export
+    regionReleaseFiles();
 
     if (gBiomeArray)
         free(gBiomeArray);
@@ -1799,121 +1939,131 @@ static int modifyAndWriteTextures(int needDifferentTextures, int fileType)
                 assert(gModel.tileListCount);   // should be computed before calling this function
                 bool isOBJ = (fileType == FILE_TYPE_WAVEFRONT_REL_OBJ) || (fileType == FILE_TYPE_WAVEFRONT_ABS_OBJ);
                 int outputCount = 0;
-                int frequency = (int)(1 + (gModel.tileListCount / 5));
-                for (int i = 0; i < TOTAL_TILES; i++) {
-                    // tile name is material name, period
-                    if (gModel.tileList[CATEGORY_RGBA][i]) {
-                        // tile found that should be output
-                        wchar_t materialTile[MAX_PATH_AND_FILE];
-                        if (gModel.exportTiles && (gTilesTable[i].flags & SBIT_SYNTHESIZED)) {
-                            concatFileName3(materialTile, gTextureDirectoryPath, gTilesTable[i].filename, L"_y.png");
-                        }
-                        else {
-                            concatFileName3(materialTile, gTextureDirectoryPath, gTilesTable[i].filename, L".png");
-                        }
-                        rc = writeTileFromMasterOutput(materialTile, gModel.pPNGtexture, i, gModel.swatchSize, gModel.swatchesPerRow, false, 0);
-                        assert(rc == 0);
-                        retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
-                        // if we can't write one file, we can't write any, so break out
-                        if (rc)
-                            break;
+                // Each tile's color image and each of its PBR images is cropped and written as its own task on
+                // the worker threads. Tiles are gathered a batch at a time, to bound memory and to update progress.
+                TileWriteTask* tasks = (TileWriteTask*)malloc(TILE_WRITE_BATCH * sizeof(TileWriteTask));
+                if (tasks == NULL) {
+                    retCode |= MW_WORLD_EXPORT_TOO_LARGE;
+                    return retCode;
+                }
+                int nextTile = 0;
+                bool writeFailed = false;
+                while (nextTile < TOTAL_TILES && !writeFailed) {
+                    int numTasks = 0;
+                    int batchTiles = 0;
+                    for (; nextTile < TOTAL_TILES && numTasks + TOTAL_CATEGORIES <= TILE_WRITE_BATCH; nextTile++) {
+                        int i = nextTile;
+                        // tile name is material name, period
+                        if (gModel.tileList[CATEGORY_RGBA][i]) {
+                            // tile found that should be output
+                            TileWriteTask* pTask = &tasks[numTasks++];
+                            pTask->swatchLoc = i;
+                            pTask->category = CATEGORY_RGBA;
+                            pTask->clampLevel = 0;
+                            if (gModel.exportTiles && (gTilesTable[i].flags & SBIT_SYNTHESIZED)) {
+                                concatFileName3(pTask->filename, gTextureDirectoryPath, gTilesTable[i].filename, L"_y.png");
+                            }
+                            else {
+                                concatFileName3(pTask->filename, gTextureDirectoryPath, gTilesTable[i].filename, L".png");
+                            }
 
-                        // Check if there is a normal map etc. to output, copying directly from the input texture, and note that it's output.
-                        for (int j = 1; j < gTotalInputTextures; j++) {
-                            // have a texture to output?
-                            if (gModel.tileList[j][i]) {
-                                // special, stupid case: output roughness with _s for OBJ files, as specular is output
-                                int category = (isOBJ && j == CATEGORY_ROUGHNESS) ? CATEGORY_SPECULAR : j;
-                                concatFileName4(materialTile, gTextureDirectoryPath, gTilesTable[i].filename, gCatSuffixes[category], L".png");
+                            // Check if there is a normal map etc. to output, copying directly from the input texture, and note that it's output.
+                            for (int j = 1; j < gTotalInputTextures; j++) {
+                                // have a texture to output?
+                                if (gModel.tileList[j][i]) {
+                                    // special, stupid case: output roughness with _s for OBJ files, as specular is output
+                                    int category = (isOBJ && j == CATEGORY_ROUGHNESS) ? CATEGORY_SPECULAR : j;
+                                    pTask = &tasks[numTasks++];
+                                    pTask->swatchLoc = i;
+                                    pTask->category = j;
+                                    pTask->clampLevel = 0;
+                                    concatFileName4(pTask->filename, gTextureDirectoryPath, gTilesTable[i].filename, gCatSuffixes[category], L".png");
 // Define in order to make separate emission grayscale textures for each light.
 // To make these look better, we multiply by the hue of the diffuse texture (i.e., scale the diffuse texture texel to the max and multiply).
 #define GENERATE_EMISSION_TILES
 #ifdef GENERATE_EMISSION_TILES
-                                // if we're doing emissions, and the emitter doesn't have an emissive texture so we need to have a texture synthesized for them
-                                if (j == CATEGORY_EMISSION && gModel.tileEmissionNeeded[i]) {
-                                    int clampLevel = 1; // used as a sign that this is an emitter of some sort - if black, it won't emit at that pixel anyway
-                                    // For some textures we want a special emissive texture, not just a grayscale of the original RGB. We want to clamp:
-                                    // if a value is lower than the clamp value, it is set to black so that no light emits from its texel.
-                                    switch (i) {    // TODOUSD need to add burning furnace, glowing redstone ore, jack o lantern, portal, brewing stand, dragon egg, redstone lamp,
-                                        // TODOUSD beacon, sea lantern, end rod, end gateway, magma?, conduit, sea pickle, crying obsidian, respawn anchor
-                                    case 80: // torch
-                                    case 99: // redstone torch on
-                                    case 240: // torch top
-                                    case 241: // redstone torch top
-                                    case 683: // soul torch
-                                    case 751: // soul torch top - TODO USD: is this still needed? Can't we now just trim the polygon itself?
-                                    case 3*16 + 13: // furnace front on - misses a few darker bits, but avoids lots of bright furnace surfaces
-                                        clampLevel = 226;
-                                        break;
-                                    case 7*16 + 8: // jack o' lantern
-                                        clampLevel = 230;
-                                        break;
-                                    case 9*16 + 13: // brewing stand
-                                        clampLevel = 167;
-                                        break;
-                                    case 13*16 + 4: // redstone lamp
-                                        clampLevel = 110;
-                                        break;
-                                    case 37*16 + 11: // lantern
-                                    case 42*16 + 13: // soul lantern
-                                        clampLevel = 115;
-                                        break;
-                                    case 23*16 + 12: // end rod
-                                    case 38*16 + 10: // blast furnace front on
-                                        clampLevel = 203;
-                                        break;
-                                    case 40*16 + 15: // smoker front on - not quite right, as the top edge of the cover is higher than this
-                                        clampLevel = 187;
-                                        break;
-                                    case 626:   // campfire log lit
-                                    case 687:   // soul campfire log lit
-                                        clampLevel = 155;
-                                        break;
-                                    case 723: // respawn anchor faces
-                                    case 725: // respawn anchor faces
-                                    case 726: // respawn anchor faces
-                                    case 727: // respawn anchor faces
-                                    case 728: // respawn anchor faces
-                                    case 729: // respawn anchor faces
-                                    case 730: // respawn anchor faces
-                                        clampLevel = 147;
-                                        break;
-                                    case 9*16 + 12: // brewing stand base - should emit no light.
-                                        clampLevel = 255;
-                                        break;
-                                    default:
-                                        break;
+                                    // if we're doing emissions, and the emitter doesn't have an emissive texture so we need to have a texture synthesized for them
+                                    if (j == CATEGORY_EMISSION && gModel.tileEmissionNeeded[i]) {
+                                        int clampLevel = 1; // used as a sign that this is an emitter of some sort - if black, it won't emit at that pixel anyway
+                                        // For some textures we want a special emissive texture, not just a grayscale of the original RGB. We want to clamp:
+                                        // if a value is lower than the clamp value, it is set to black so that no light emits from its texel.
+                                        switch (i) {    // TODOUSD need to add burning furnace, glowing redstone ore, jack o lantern, portal, brewing stand, dragon egg, redstone lamp,
+                                            // TODOUSD beacon, sea lantern, end rod, end gateway, magma?, conduit, sea pickle, crying obsidian, respawn anchor
+                                        case 80: // torch
+                                        case 99: // redstone torch on
+                                        case 240: // torch top
+                                        case 241: // redstone torch top
+                                        case 683: // soul torch
+                                        case 751: // soul torch top - TODO USD: is this still needed? Can't we now just trim the polygon itself?
+                                        case 3*16 + 13: // furnace front on - misses a few darker bits, but avoids lots of bright furnace surfaces
+                                            clampLevel = 226;
+                                            break;
+                                        case 7*16 + 8: // jack o' lantern
+                                            clampLevel = 230;
+                                            break;
+                                        case 9*16 + 13: // brewing stand
+                                            clampLevel = 167;
+                                            break;
+                                        case 13*16 + 4: // redstone lamp
+                                            clampLevel = 110;
+                                            break;
+                                        case 37*16 + 11: // lantern
+                                        case 42*16 + 13: // soul lantern
+                                            clampLevel = 115;
+                                            break;
+                                        case 23*16 + 12: // end rod
+                                        case 38*16 + 10: // blast furnace front on
+                                            clampLevel = 203;
+                                            break;
+                                        case 40*16 + 15: // smoker front on - not quite right, as the top edge of the cover is higher than this
+                                            clampLevel = 187;
+                                            break;
+                                        case 626:   // campfire log lit
+                                        case 687:   // soul campfire log lit
+                                            clampLevel = 155;
+                                            break;
+                                        case 723: // respawn anchor faces
+                                        case 725: // respawn anchor faces
+                                        case 726: // respawn anchor faces
+                                        case 727: // respawn anchor faces
+                                        case 728: // respawn anchor faces
+                                        case 729: // respawn anchor faces
+                                        case 730: // respawn anchor faces
+                                            clampLevel = 147;
+                                            break;
+                                        case 9*16 + 12: // brewing stand base - should emit no light.
+                                            clampLevel = 255;
+                                            break;
+                                        default:
+                                            break;
+                                        }
+                                        pTask->clampLevel = clampLevel;
                                     }
-                                    // color output - to go back to grayscale, simply change next-to-last arg from false to true
-                                    rc = writeTileFromMasterOutput(materialTile, gModel.pPNGtexture, i, gModel.swatchSize, gModel.swatchesPerRow, false, clampLevel);
-                                }
-                                else
 #endif
-                                {
-                                    // special case: if there's an emissive texture, it's grayscale (just the way Minecraft RTX defines it).
-                                    // But, these look bad in some DCC apps. So, we do this crazy thing: hue of diffuse times grayscale.
-                                    if (j == CATEGORY_EMISSION) {
-                                        rc = writeEmissiveScaledTile(materialTile, i);
-                                    }
-                                    else {
-                                        rc = writeTileFromCategoryInput(materialTile, i, j);
-                                    }
                                 }
-                                assert(rc == 0);
-                                retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
-                                // if we can't write one file, we can't write any, so break out
-                                if (rc)
-                                    break;
                             }
+                            batchTiles++;
                         }
+                    }
 
-                        // update status
-                        if (outputCount % frequency == frequency-1)
-                            UPDATE_PROGRESS(gProgress.start.texture + gProgress.absolute.texture * (float)outputCount / (float)gModel.tileListCount);
+                    RunWorkerTasks(numTasks, writeTileTask, tasks);
 
-                        outputCount++;
+                    // list the files in the same order as writing them one by one did
+                    for (int t = 0; t < numTasks; t++) {
+                        addOutputFilenameToList(tasks[t].filename);
+                        rc = tasks[t].rc;
+                        assert(rc == 0);
+                        retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
+                        // if we can't write one file, we can't write any, so stop after this batch
+                        if (rc)
+                            writeFailed = true;
                     }
+
+                    // update status
+                    outputCount += batchTiles;
+                    UPDATE_PROGRESS(gProgress.start.texture + gProgress.absolute.texture * (float)outputCount / (float)gModel.tileListCount);
                 }
+                free(tasks);
             }
         }
 
@@ -1967,16 +2117,7 @@ static int modifyAndWriteTextures(int needDifferentTextures, int fileType)
             }
 
             // Write PBR mosaic files for OBJ
-            for (int cat = 1; cat < TOTAL_CATEGORIES; cat++) {
-                if (gModel.pPBRtexture[cat] != NULL) {
-                    wchar_t pbrFileName[MAX_PATH_AND_FILE];
-                    concatFileName4(pbrFileName, gOutputFilePath, gOutputFileRootClean, gCatSuffixes[cat], L".png");
-                    rc = writepng(gModel.pPBRtexture[cat], gCatChannels[cat], pbrFileName);
-                    assert(rc == 0);
-                    addOutputFilenameToList(pbrFileName);
-                    retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
-                }
-            }
+            retCode |= writePBRMosaics(gOutputFilePath);
         }
         else
         {
@@ -2020,16 +2161,7 @@ static int modifyAndWriteTextures(int needDifferentTextures, int fileType)
             retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
 
             // Write PBR mosaic files for USD
-            for (int cat = 1; cat < TOTAL_CATEGORIES; cat++) {
-                if (gModel.pPBRtexture[cat] != NULL) {
-                    wchar_t pbrFileName[MAX_PATH_AND_FILE];
-                    concatFileName4(pbrFileName, gTextureDirectoryPath, gOutputFileRootClean, gCatSuffixes[cat], L".png");
-                    rc = writepng(gModel.pPBRtexture[cat], gCatChannels[cat], pbrFileName);
-                    assert(rc == 0);
-                    addOutputFilenameToList(pbrFileName);
-                    retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
-                }
-            }
+            retCode |= writePBRMosaics(gTextureDirectoryPath);
         }
 
         writepng_cleanup(gModel.pPNGtexture);
@@ -2037,6 +2169,34 @@ static int modifyAndWriteTextures(int needDifferentTextures, int fileType)
     return retCode;
 }
 
+// The PBR mosaics are separate images, so are compressed and written all at once.
+static int writePBRMosaics(const wchar_t* path)
+{
+    int retCode = MW_NO_ERROR;
+    wchar_t pbrFileName[TOTAL_CATEGORIES][MAX_PATH_AND_FILE];
+    pngwrite_info writes[TOTAL_CATEGORIES];
+    int numWrites = 0;
+    for (int cat = 1; cat < TOTAL_CATEGORIES; cat++) {
+        if (gModel.pPBRtexture[cat] != NULL) {
+            concatFileName4(pbrFileName[numWrites], path, gOutputFileRootClean, gCatSuffixes[cat], L".png");
+            writes[numWrites].image = gModel.pPBRtexture[cat];
+            writes[numWrites].channels = gCatChannels[cat];
+            writes[numWrites].filename = pbrFileName[numWrites];
+            numWrites++;
+        }
+    }
+    writepngs(writes, numWrites);
+
+    // list the files in category order, same as always
+    for (int i = 0; i < numWrites; i++) {
+        int rc = writes[i].rc;
+        assert(rc == 0);
+        addOutputFilenameToList(pbrFileName[i]);
+        retCode |= rc ? (MW_CANNOT_CREATE_PNG_FILE | (rc << MW_NUM_CODES)) : MW_NO_ERROR;
+    }
+    return retCode;
+}
+
 
 // assumes same maximum length (or longer) for both strings
 void WcharToChar(const wchar_t* inWString, char* outString, int maxlength)
@@ -2155,7 +2315,7 @@ static void initializeWorldData(IBox* worldBox, int xmin, int ymin, int zmin, in
     gBoxSize[Z] = zmax - zmin + 3;
     // scale for X index value
     gBoxSizeYZ = gBoxSize[Y] * gBoxSize[Z];
-    // this will be the size of gBoxData
+    // this will be the size of the box cell arrays
     gBoxSizeXYZ = gBoxSize[X] * gBoxSizeYZ;
 
     gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X] = -gBoxSizeYZ;	// -X
@@ -2235,9 +2395,9 @@ static int initializeModelData()
             {
                 for (faceDirection = 0; faceDirection < 6; faceDirection++)
                 {
-                    if (gBoxData[boxIndex].type > BLOCK_AIR)
+                    if (gBoxType[boxIndex] > BLOCK_AIR)
                     {
-                        if (gBoxData[boxIndex + gFaceOffset[faceDirection]].type == BLOCK_AIR)
+                        if (gBoxType[boxIndex + gFaceOffset[faceDirection]] == BLOCK_AIR)
                             gModel.faceSize++;
                     }
                 }
@@ -2260,6 +2420,65 @@ static int initializeModelData()
     return MW_NO_ERROR;
 }
 
+// Set up the output texture's resolution and swatch layout, and create the texture itself if it's to be exported.
+static int prepareExportTexture()
+{
+    int retCode = MW_NO_ERROR;
+
+    if (gModel.exportTexture)
+    {
+        // Make it twice as large if we're outputting image textures, too- we need the space.
+        // We're just setting up here, giving something to write UVs against; even per-tile texture
+        // output uses this. We export the texture at the end.
+        if (gModel.options->exportFlags & EXPT_OUTPUT_TEXTURE_IMAGES_OR_TILES)
+        {
+            // use true textures - for 3D printing or if swatches are needed, we need to make output image larger to accomodate composite swatches.
+            // for 1.16 and earlier: gModel.textureResolution = ((gModel.print3D || gModel.options->pEFD->chkCompositeOverlay) ? 4 : 2) * gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
+            gModel.textureResolution = 4 * gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
+            gModel.terrainWidth = gModel.pInputTerrainImage[CATEGORY_RGBA]->width;
+        }
+        else
+        {
+            // Use "noisy" colors, fixed 512 x 512 - we could actually make this texture quite small
+            // Note this used to be 256 x 256, but that's only 14*14 = 196 materials, and we're now
+            // at 198 or so...
+            gModel.textureResolution = 1024;    // was 512 for 1.16
+            // This number determines number of swatches per row. Make it 256, even though there's
+            // no incoming image. This then ensures there's room for enough solid color images.
+            gModel.terrainWidth = 256;    // really, no image, but act like there is
+        }
+        // there are always 16 tiles wide in terrainExt.png, so we divide by this.
+        gModel.tileSize = gModel.terrainWidth / 16;
+        gModel.resScale = 16.0f / (float)gModel.tileSize;
+        gModel.swatchSize = 2 + gModel.tileSize;
+        gModel.invTextureResolution = 1.0f / (float)gModel.textureResolution;
+        gModel.swatchesPerRow = (int)(gModel.textureResolution / gModel.swatchSize);
+        gModel.textureUVPerSwatch = (float)gModel.swatchSize / (float)gModel.textureResolution; // e.g. 18 / 256
+        gModel.textureUVPerTile = (float)gModel.tileSize / (float)gModel.textureResolution; // e.g. 16 / 256
+        gModel.swatchListSize = gModel.swatchesPerRow * gModel.swatchesPerRow;
+
+        if (EXPORT_TEXTURE) {
+            retCode |= createBaseMaterialTexture();
+        }
+    }
+
+    // were there errors?
+    if (retCode >= MW_BEGIN_ERRORS)
+    {
+        // texture out of memory or some other read error.
+        return retCode;
+    }
+
+    // check if resolution is massively high; warn once
+    static bool warnOnSize = true;
+    if (warnOnSize && gModel.textureResolution >= 16384 && !gModel.exportTiles) {
+        warnOnSize = false;
+        retCode |= MW_TEXTURE_RESOLUTION_HIGH;
+    }
+
+    return retCode;
+}
+
 static int readTerrainPNG(const wchar_t* curDir, progimage_info* pITI, wchar_t* selectedTerrainFileName, int category, int exportFileType)
 {
     // file should be in same directory as .exe, sort of
@@ -2367,24 +2586,24 @@ static int readTerrainPNG(const wchar_t* curDir, progimage_info* pITI, wchar_t*
 
         // create the Wavefront OBJ file
         //DeleteFile(codeFileNameWithSuffix);
-        static PORTAFILE outFile = PortaCreate(codeFileNameWithSuffix);
+        static PORTAFILE outFile = OutCreate(codeFileNameWithSuffix);
         if (outFile != INVALID_HANDLE_VALUE)
         {
             // write .h file
             char outputString[MAX_PATH_AND_FILE];
             strcpy_s(outputString, 256, "#ifndef __TERRAINEXTDATA_H__\n#define __TERRAINEXTDATA_H__\n\n");
-            WERROR_SPECIFY(PortaWrite(outFile, outputString, strlen(outputString)), outFile);
+            WERROR_SPECIFY(OutWrite(outFile, outputString, strlen(outputString)), outFile);
             sprintf_s(outputString, 256, "extern int gTerrainExtWidth;\nextern int gTerrainExtHeight;\nextern unsigned char gTerrainExt[%d];\n\n#endif\n", size);
-            WERROR_SPECIFY(PortaWrite(outFile, outputString, strlen(outputString)), outFile);
-            PortaClose(outFile);
+            WERROR_SPECIFY(OutWrite(outFile, outputString, strlen(outputString)), outFile);
+            OutClose(outFile);
 
             // now write .cpp file
             concatFileName3(codeFileNameWithSuffix, gOutputFilePath, gOutputFileRoot, L".cpp");
-            outFile = PortaCreate(codeFileNameWithSuffix);
+            outFile = OutCreate(codeFileNameWithSuffix);
             if (outFile != INVALID_HANDLE_VALUE)
             {
                 sprintf_s(outputString, 256, "#include \"stdafx.h\"\n\nint gTerrainExtWidth = %d;\nint gTerrainExtHeight = %d;\n\nunsigned char gTerrainExt[] = {\n", pITI->width, pITI->height);
-                WERROR_SPECIFY(PortaWrite(outFile, outputString, strlen(outputString)), outFile);
+                WERROR_SPECIFY(OutWrite(outFile, outputString, strlen(outputString)), outFile);
 
                 // dump the data
                 for (int i = 0; i < size / 16; i++)
@@ -2410,12 +2629,12 @@ static int readTerrainPNG(const wchar_t* curDir, progimage_info* pITI, wchar_t*
                             *(p + 12), *(p + 13), *(p + 14), *(p + 15)
                         );
                     }
-                    WERROR_SPECIFY(PortaWrite(outFile, outputString, strlen(outputString)), outFile);
+                    WERROR_SPECIFY(OutWrite(outFile, outputString, strlen(outputString)), outFile);
                 }
 
                 strcpy_s(outputString, 256, "};\n");
-                WERROR_SPECIFY(PortaWrite(outFile, outputString, strlen(outputString)), outFile);
-                PortaClose(outFile);
+                WERROR_SPECIFY(OutWrite(outFile, outputString, strlen(outputString)), outFile);
+                OutClose(outFile);
             }
         }
     }
@@ -2467,6 +2686,80 @@ static void invertImage(progimage_info* dst)
 }
 
 
+// Decode the chunks for the next few columns, starting at blockX, in parallel, as many columns as fit in half the cache.
+// Skipped when moreExportMemory is set, as each chunk is then thrown out of the cache right after use.
+static void prefetchChunkColumns(WorldGuide* pWorldGuide, int blockX, int startxblock, int endxblock, int startzblock, int endzblock)
+{
+    if (gModel.options->moreExportMemory)
+        return;
+
+    int columnsPerBatch = max(1, (Cache_Capacity() / 2) / (endzblock - startzblock + 1));
+    if ((blockX - startxblock) % columnsPerBatch == 0) {
+        int retCode = PrefetchBlocks(pWorldGuide, blockX, startzblock, min(blockX + columnsPerBatch - 1, endxblock), endzblock, gModel.options->worldType, gMcVersion, gMinecraftWorldVersion, NULL);
+        // add to, rather than replace, whatever earlier loads found
+        if (retCode < 0) {
+            gBlockRetCode = retCode;
+        }
+        else if (gBlockRetCode >= 0) {
+            gBlockRetCode |= retCode;
+        }
+    }
+}
+
+// Allocate the box's cell arrays, all set to air. Groups are allocated separately, only when needed.
+static int allocBoxCells()
+{
+    gBoxType = (unsigned short*)calloc(gBoxSizeXYZ, sizeof(unsigned short));
+    gBoxOrigType = (unsigned short*)calloc(gBoxSizeXYZ, sizeof(unsigned short));
+    gBoxFlatFlags = (unsigned char*)calloc(gBoxSizeXYZ, sizeof(unsigned char));
+    gBoxDataVal = (unsigned char*)calloc(gBoxSizeXYZ, sizeof(unsigned char));
+    if (gBoxType == NULL || gBoxOrigType == NULL || gBoxFlatFlags == NULL || gBoxDataVal == NULL)
+    {
+        freeBoxCells();
+        return MW_WORLD_EXPORT_TOO_LARGE;
+    }
+    return MW_NO_ERROR;
+}
+
+static void freeBoxCells()
+{
+    if (gBoxType)
+        free(gBoxType);
+    gBoxType = NULL;
+    if (gBoxOrigType)
+        free(gBoxOrigType);
+    gBoxOrigType = NULL;
+    if (gBoxFlatFlags)
+        free(gBoxFlatFlags);
+    gBoxFlatFlags = NULL;
+    if (gBoxDataVal)
+        free(gBoxDataVal);
+    gBoxDataVal = NULL;
+    freeBoxGroups();
+}
+
+// Allocate the cell groups, all NO_GROUP_SET, if they're not already around. They're only needed by the 3D printing
+// passes that find and fix up groups, and by hollowing and snow melting.
+static int allocBoxGroups()
+{
+    if (gBoxGroup == NULL)
+    {
+        gBoxGroup = (int*)calloc(gBoxSizeXYZ, sizeof(int));
+        if (gBoxGroup == NULL)
+        {
+            return MW_WORLD_EXPORT_TOO_LARGE;
+        }
+    }
+    return MW_NO_ERROR;
+}
+
+static void freeBoxGroups()
+{
+    if (gBoxGroup)
+        free(gBoxGroup);
+    gBoxGroup = NULL;
+}
+
 static int populateBox(WorldGuide* pWorldGuide, ChangeBlockCommand* pCBC, IBox* worldBox)
 {
     int startxblock, startzblock;
@@ -2483,11 +2776,20 @@ static int populateBox(WorldGuide* pWorldGuide, ChangeBlockCommand* pCBC, IBox*
     // get bounds on Y coordinates, since top part of box is usually air
     VecScalar(gSolidWorldBox.min, =, INT_MAX);
     VecScalar(gSolidWorldBox.max, =, INT_MIN);
+    setSavedTypeMask();
 
-    // We now extract twice: first time is just to get bounds of solid stuff we'll actually output.
+    // If there's room, read each chunk just once, finding the bounds of the solid stuff as the blocks are copied.
+    // The box is then cut down to those bounds.
+    bool wholeBoxRead = extractWholeBox(pWorldGuide, worldBox);
+    IPoint wholeBoxSize, wholeWorld2BoxOffset;
+    Vec2Op(wholeBoxSize, =, gBoxSize);
+    Vec2Op(wholeWorld2BoxOffset, =, gWorld2BoxOffset);
+
+    // Else we extract twice: first time is just to get bounds of solid stuff we'll actually output.
     // Results of this first pass are put in gSolidWorldBox.
-    for (blockX = startxblock; blockX <= endxblock; blockX++)
+    for (blockX = startxblock; blockX <= endxblock && !wholeBoxRead; blockX++)
     {
+        prefetchChunkColumns(pWorldGuide, blockX, startxblock, endxblock, startzblock, endzblock);
         //UPDATE_PROGRESS( 0.1f*(blockX-startxblock+1)/(endxblock-startxblock+1) );
         // z increases west, decreases east
         for (blockZ = startzblock; blockZ <= endzblock; blockZ++)
@@ -2511,22 +2813,26 @@ static int populateBox(WorldGuide* pWorldGuide, ChangeBlockCommand* pCBC, IBox*
     }
     else if (gSolidWorldBox.min[Y] > gSolidWorldBox.max[Y]) {
         // quick out test, nothing to do: there is nothing in the box
+        if (wholeBoxRead)
+        {
+            freeBoxCells();
+            if (gBiomeArray)
+                free(gBiomeArray);
+            gBiomeArray = NULL;
+        }
         return MW_NO_BLOCKS_FOUND;
     }
 
     // have to reinitialize to get right globals for gSolidWorldBox.
     initializeWorldData(worldBox, gSolidWorldBox.min[X], gSolidWorldBox.min[Y], gSolidWorldBox.min[Z], gSolidWorldBox.max[X], gSolidWorldBox.max[Y], gSolidWorldBox.max[Z]);
 
-    gBoxData = (BoxCell*)calloc(gBoxSizeXYZ, sizeof(BoxCell));
-    if (gBoxData == NULL)
+    // set all values to "air", 0, etc.
+    if (!wholeBoxRead && allocBoxCells() >= MW_BEGIN_ERRORS)
     {
         return MW_WORLD_EXPORT_TOO_LARGE;
     }
 
-    // set all values to "air", 0, etc.
-    //memset(gBoxData, 0x0, gBoxSizeXYZ * sizeof(BoxCell));
-
-    if (gModel.options->exportFlags & EXPT_BIOME)
+    if (!wholeBoxRead && (gModel.options->exportFlags & EXPT_BIOME))
     {
         gBiomeArray = (unsigned char*)calloc(gBoxSize[X] * gBoxSize[Z], sizeof(unsigned char));
         if (gBiomeArray == NULL)
@@ -2591,13 +2897,20 @@ static int populateBox(WorldGuide* pWorldGuide, ChangeBlockCommand* pCBC, IBox*
     int edgeendxblock = (int)floor((float)edgeWorldBox.max[X] / 16.0f);
     int edgeendzblock = (int)floor((float)edgeWorldBox.max[Z] / 16.0f);
 
-    for (blockX = edgestartxblock; blockX <= edgeendxblock; blockX++)
+    if (wholeBoxRead)
+    {
+        // all of this has been read in already, so just move it into place
+        compactWholeBox(wholeBoxSize, wholeWorld2BoxOffset, &edgeWorldBox);
+    }
+
+    for (blockX = edgestartxblock; blockX <= edgeendxblock && !wholeBoxRead; blockX++)
     {
+        prefetchChunkColumns(pWorldGuide, blockX, edgestartxblock, edgeendxblock, edgestartzblock, edgeendzblock);
         //UPDATE_PROGRESS( 0.1f*(blockX-edgestartxblock+1)/(edgeendxblock-edgestartxblock+1) );
         // z increases south, decreases north
         for (blockZ = edgestartzblock; blockZ <= edgeendzblock; blockZ++)
         {
-            extractChunk(pWorldGuide, blockX, blockZ, &edgeWorldBox, gMcVersion, gMinecraftWorldVersion);
+            extractChunk(pWorldGuide, blockX, blockZ, &edgeWorldBox, NULL, gMcVersion, gMinecraftWorldVersion);
 
             // done with reading chunk for export, so free memory
             if (gModel.options->moreExportMemory)
@@ -2687,22 +3000,32 @@ static void findChunkBounds(WorldGuide* pWorldGuide, int bx, int bz, IBox* world
             boxIndex = WORLD_TO_BOX_INDEX(x, miny, z);
             chunkIndex = CHUNK_INDEX(bx, bz, x, miny, z);
             for (y = miny; y <= maxy; y++, boxIndex++) {
+                if (((y == miny) || ((chunkIndex & 0xf00) == 0)) && !section_has_types(block, chunkIndex >> 12, gSavedTypeMask)) {
+                    // nothing in this section will be exported, so go on to the next one
+                    int skip = 15 - ((chunkIndex >> 8) & 0xf);
+                    y += skip;
+                    boxIndex += skip;
+                    chunkIndex += 256 * (skip + 1);
+                    continue;
+                }
                 // fold in the high bit to get the type
                 // 1.13 fun: if the highest bit of the data value is 1, this is a 1.13+ block of some sort,
                 // so "move" that bit from data to the type. Ignore head data, which comes in with the high bit set.
                 assert((chunkIndex >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
                 // Capture dataVal from the chunk loader buffer BEFORE we advance chunkIndex.
-                // We can't read it from gBoxData here — this is the bounds-finding pre-pass and
-                // gBoxData isn't allocated yet. block->data carries the same HIGH_BIT-tagged value
-                // that gBoxData.data will later hold, so it's the right source for cull lookup.
-                unsigned char curData = block->data[chunkIndex];
-                if (gIs13orNewer && (curData & 0x80) && (block->grid[chunkIndex] != BLOCK_HEAD) && (block->grid[chunkIndex] != BLOCK_FLOWER_POT)) {
+                // We can't read it from gBoxDataVal here — this is the bounds-finding pre-pass and
+                // the box cells aren't allocated yet. block->data carries the same HIGH_BIT-tagged value
+                // that gBoxDataVal will later hold, so it's the right source for cull lookup.
+                unsigned short typeData = block_type_data(block, chunkIndex);
+                unsigned char curType = typeData & 0xff;
+                unsigned char curData = typeData >> 8;
+                if (gIs13orNewer && (curData & 0x80) && (curType != BLOCK_HEAD) && (curType != BLOCK_FLOWER_POT)) {
                     // high bit set, so blockID >= 256
-                    blockID = block->grid[chunkIndex] | 0x100;
+                    blockID = curType | 0x100;
                 }
                 else {
                     // normal case - just transfer the data
-                    blockID = block->grid[chunkIndex];
+                    blockID = curType;
                 }
 
                 // For Anvil, Y goes up by 256 (in 1.1 and earlier, it was just ++)
@@ -2711,28 +3034,183 @@ static void findChunkBounds(WorldGuide* pWorldGuide, int bx, int bz, IBox* world
                 // get bounds on y searches:
                 // search for air, and if not found then
                 // add to vertical bounds.
-                if (blockID > BLOCK_AIR)
+                if (isBlockSaved(blockID, curData))
                 {
-                    // Also check that object is not culled out because it's filtered (see filterBox).
-                    int flags = gBlockDefinitions[blockID].flags;
+                    IPoint loc;
+                    Vec3Scalar(loc, =, x, y, z);
+                    addBounds(loc, &gSolidWorldBox);
+                }
+            }
+        }
+    }
+}
 
-                    // check if it's something not to be filtered out: in the output list and alpha > 0
-                    // and not hidden by the active Culling Scheme (per-(type,dataVal) check).
-                    if ((flags & gModel.options->saveFilterFlags) &&
-                        (gBlockDefinitions[blockID].alpha > 0.0) &&
-                        !isBlockCulled(blockID, curData)) {
-                        IPoint loc;
-                        Vec3Scalar(loc, =, x, y, z);
-                        addBounds(loc, &gSolidWorldBox);
-                    }
+// Is this block one that will be exported: in the output list, with alpha > 0, and not hidden by the active
+// Culling Scheme (per-(type,dataVal) check)? If not, filterBox() will remove it.
+static bool isBlockSaved(int blockID, int dataVal)
+{
+    return (blockID > BLOCK_AIR) &&
+        (gBlockDefinitions[blockID].flags & gModel.options->saveFilterFlags) &&
+        (gBlockDefinitions[blockID].alpha > 0.0) &&
+        !isBlockCulled(blockID, dataVal);
+}
+
+// Find which section_type_key()s could be exported with the current filter and Culling Scheme, so that chunk
+// sections holding none of them can be skipped when finding the bounds of the solid stuff.
+static void setSavedTypeMask()
+{
+    memset(gSavedTypeMask, 0, sizeof(gSavedTypeMask));
+    for (int key = 0; key < SECTION_TYPE_WORDS * 64; key++) {
+        int type = key & 0xff;
+        int highBit = (key & 0x100) ? HIGH_BIT : 0;
+        int blockID = (gIs13orNewer && highBit && (type != BLOCK_HEAD) && (type != BLOCK_FLOWER_POT)) ? (type | 0x100) : type;
+        // out of range shouldn't happen, but if it does, leave it to the tests on each block
+        bool saved = (blockID >= NUM_BLOCKS_DEFINED);
+        for (int dataVal = 0; dataVal < 0x80 && !saved; dataVal++) {
+            saved = isBlockSaved(blockID, dataVal | highBit);
+        }
+        if (saved) {
+            gSavedTypeMask[key >> 6] |= 1ULL << (key & 0x3f);
+        }
+    }
+}
+
+// Read the whole export volume into the box, plus the border of blocks around it that might be needed (see
+// populateBox()), reading each chunk just once. The bounds of the solid stuff in the volume are found in
+// gSolidWorldBox as it's read. compactWholeBox() then cuts the box down to these bounds.
+// Since the box is then larger than the two pass way's, this is done only if the user has given export more memory.
+// Returns false, having read nothing, if not, or if such a box would be too large or can't be allocated.
+static bool extractWholeBox(WorldGuide* pWorldGuide, IBox* worldBox)
+{
+    IBox wholeBox;
+    int blockX, blockZ;
+
+    if (!gModel.options->moreExportMemory)
+    {
+        return false;
+    }
+
+    // we don't know yet which sides the solid stuff reaches, so read a border all around
+    int ymin = (worldBox->min[Y] > gMinHeight) ? worldBox->min[Y] - 1 : worldBox->min[Y];
+    int ymax = (worldBox->max[Y] < gMaxHeight) ? worldBox->max[Y] + 1 : worldBox->max[Y];
+    double cells = (double)(worldBox->max[X] - worldBox->min[X] + 5) * (double)(ymax - ymin + 3) * (double)(worldBox->max[Z] - worldBox->min[Z] + 5);
+    if (cells > (double)WHOLE_BOX_MAX_CELLS)
+    {
+        return false;
+    }
+    // leave at least three quarters of the available memory for making and writing out the faces
+    MEMORYSTATUSEX memoryStatus;
+    memoryStatus.dwLength = sizeof(memoryStatus);
+    if (!GlobalMemoryStatusEx(&memoryStatus) ||
+        cells * (double)BOX_CELL_BYTES > 0.25 * (double)min(memoryStatus.ullAvailPhys, memoryStatus.ullAvailVirtual))
+    {
+        return false;
+    }
+    initializeWorldData(&wholeBox, worldBox->min[X] - 1, ymin, worldBox->min[Z] - 1, worldBox->max[X] + 1, ymax, worldBox->max[Z] + 1);
+
+    if (allocBoxCells() >= MW_BEGIN_ERRORS)
+    {
+        return false;
+    }
+    if (gModel.options->exportFlags & EXPT_BIOME)
+    {
+        gBiomeArray = (unsigned char*)calloc(gBoxSize[X] * gBoxSize[Z], sizeof(unsigned char));
+        if (gBiomeArray == NULL)
+        {
+            freeBoxCells();
+            return false;
+        }
+    }
+
+    int startxblock = (int)floor((float)wholeBox.min[X] / 16.0f);
+    int startzblock = (int)floor((float)wholeBox.min[Z] / 16.0f);
+    int endxblock = (int)floor((float)wholeBox.max[X] / 16.0f);
+    int endzblock = (int)floor((float)wholeBox.max[Z] / 16.0f);
+
+    for (blockX = startxblock; blockX <= endxblock; blockX++)
+    {
+        prefetchChunkColumns(pWorldGuide, blockX, startxblock, endxblock, startzblock, endzblock);
+        for (blockZ = startzblock; blockZ <= endzblock; blockZ++)
+        {
+            extractChunk(pWorldGuide, blockX, blockZ, &wholeBox, worldBox, gMcVersion, gMinecraftWorldVersion);
+
+            // done with reading chunk for export, so free memory
+            if (gModel.options->moreExportMemory)
+            {
+                ClearCache();
+            }
+        }
+    }
+    return true;
+}
+
+// The box was read in by extractWholeBox() and the globals are now set for the solid bounds. Move the blocks in
+// edgeWorldBox into place in the smaller box, clear the rest, and free the extra memory. The smaller box lies
+// inside the whole box, so each cell moves to a lower index and the move can be done in place, in index order.
+static void compactWholeBox(IPoint wholeBoxSize, IPoint wholeWorld2BoxOffset, IBox* edgeWorldBox)
+{
+    int wholeBoxSizeYZ = wholeBoxSize[Y] * wholeBoxSize[Z];
+    int runStart = edgeWorldBox->min[Y] + gWorld2BoxOffset[Y];
+    int runLength = edgeWorldBox->max[Y] - edgeWorldBox->min[Y] + 1;
+
+    for (int boxX = 0; boxX < gBoxSize[X]; boxX++)
+    {
+        int x = boxX - gWorld2BoxOffset[X];
+        for (int boxZ = 0; boxZ < gBoxSize[Z]; boxZ++)
+        {
+            int z = boxZ - gWorld2BoxOffset[Z];
+            int column = boxX * gBoxSizeYZ + boxZ * gBoxSize[Y];
+            int biomeIndex = boxX * gBoxSize[Z] + boxZ;
+            if ((x >= edgeWorldBox->min[X]) && (x <= edgeWorldBox->max[X]) && (z >= edgeWorldBox->min[Z]) && (z <= edgeWorldBox->max[Z]))
+            {
+                int from = (x + wholeWorld2BoxOffset[X]) * wholeBoxSizeYZ + (z + wholeWorld2BoxOffset[Z]) * wholeBoxSize[Y] + edgeWorldBox->min[Y] + wholeWorld2BoxOffset[Y];
+                int to = column + runStart;
+                memmove(gBoxType + to, gBoxType + from, runLength * sizeof(unsigned short));
+                memmove(gBoxOrigType + to, gBoxOrigType + from, runLength * sizeof(unsigned short));
+                memmove(gBoxDataVal + to, gBoxDataVal + from, runLength * sizeof(unsigned char));
+                // clear above and below the blocks moved
+                memset(gBoxType + column, 0, runStart * sizeof(unsigned short));
+                memset(gBoxOrigType + column, 0, runStart * sizeof(unsigned short));
+                memset(gBoxDataVal + column, 0, runStart * sizeof(unsigned char));
+                memset(gBoxType + to + runLength, 0, (gBoxSize[Y] - runStart - runLength) * sizeof(unsigned short));
+                memset(gBoxOrigType + to + runLength, 0, (gBoxSize[Y] - runStart - runLength) * sizeof(unsigned short));
+                memset(gBoxDataVal + to + runLength, 0, (gBoxSize[Y] - runStart - runLength) * sizeof(unsigned char));
+                if (gBiomeArray)
+                {
+                    gBiomeArray[biomeIndex] = gBiomeArray[(x + wholeWorld2BoxOffset[X]) * wholeBoxSize[Z] + z + wholeWorld2BoxOffset[Z]];
+                }
+            }
+            else
+            {
+                memset(gBoxType + column, 0, gBoxSize[Y] * sizeof(unsigned short));
+                memset(gBoxOrigType + column, 0, gBoxSize[Y] * sizeof(unsigned short));
+                memset(gBoxDataVal + column, 0, gBoxSize[Y] * sizeof(unsigned char));
+                if (gBiomeArray)
+                {
+                    gBiomeArray[biomeIndex] = 0;
                 }
             }
         }
     }
+
+    // give back the rest; shrinking can't fail, but keep the larger block if it somehow does.
+    // Flat flags are not set when reading, so are still all clear.
+    void* shrunk;
+    if ((shrunk = realloc(gBoxType, gBoxSizeXYZ * sizeof(unsigned short))) != NULL)
+        gBoxType = (unsigned short*)shrunk;
+    if ((shrunk = realloc(gBoxOrigType, gBoxSizeXYZ * sizeof(unsigned short))) != NULL)
+        gBoxOrigType = (unsigned short*)shrunk;
+    if ((shrunk = realloc(gBoxFlatFlags, gBoxSizeXYZ * sizeof(unsigned char))) != NULL)
+        gBoxFlatFlags = (unsigned char*)shrunk;
+    if ((shrunk = realloc(gBoxDataVal, gBoxSizeXYZ * sizeof(unsigned char))) != NULL)
+        gBoxDataVal = (unsigned char*)shrunk;
+    if (gBiomeArray && (shrunk = realloc(gBiomeArray, gBoxSize[X] * gBoxSize[Z] * sizeof(unsigned char))) != NULL)
+        gBiomeArray = (unsigned char*)shrunk;
 }
 
-// copy relevant part of a given chunk to the box data grid
-static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorldBox, int mcVersion, int versionID)
+// Copy relevant part of a given chunk to the box data grid. If boundsBox is given, the bounds of the solid stuff
+// inside it are also added to gSolidWorldBox, as findChunkBounds() does.
+static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorldBox, IBox* boundsBox, int mcVersion, int versionID)
 {
     int chunkX, chunkZ;
 
@@ -2762,6 +3240,11 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
     if ((block == NULL) || (block->blockType == NBT_NO_SECTIONS)) //blank tile, nothing to do
         return;
 
+    if (boundsBox != NULL) {
+        // set version for later use by textures, etc.
+        gModel.mcVersion = block->mcVersion;
+    }
+
     // loop through area of box that overlaps with this chunk
     chunkX = bx * 16;
     chunkZ = bz * 16;
@@ -2795,26 +3278,36 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                 int biomeIdx = (x + gWorld2BoxOffset[X]) * gBoxSize[Z] + z + gWorld2BoxOffset[Z];
                 gBiomeArray[biomeIdx] = block->biome[chunkIndex & 0xff];
             }
+            // is this column inside the volume to find solid bounds for?
+            bool findBounds = (boundsBox != NULL) &&
+                (x >= boundsBox->min[X]) && (x <= boundsBox->max[X]) && (z >= boundsBox->min[Z]) && (z <= boundsBox->max[Z]);
+            bool sectionSaved = false;
 
             for (y = miny; y <= maxy; y++, boxIndex++) {
+                if (findBounds && ((y == miny) || ((chunkIndex & 0xf00) == 0))) {
+                    // only test blocks for the bounds in sections with something that will be exported
+                    sectionSaved = section_has_types(block, chunkIndex >> 12, gSavedTypeMask);
+                }
                 // Get the extra values (orientation, type) for the blocks
                 assert((chunkIndex >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
-                unsigned char dataVal = block->data[chunkIndex];
+                unsigned short typeData = block_type_data(block, chunkIndex);
+                unsigned char gridType = typeData & 0xff;
+                unsigned char dataVal = typeData >> 8;
                 // 1.13 fun: if the highest bit of the data value is 1, this is a 1.13+ block of some sort,
                 // so "move" that bit from data to the type. Ignore head data, which comes in with the high bit set.
-                if (gIs13orNewer && (dataVal & HIGH_BIT) && (block->grid[chunkIndex] != BLOCK_HEAD) && (block->grid[chunkIndex] != BLOCK_FLOWER_POT)) {
+                if (gIs13orNewer && (dataVal & HIGH_BIT) && (gridType != BLOCK_HEAD) && (gridType != BLOCK_FLOWER_POT)) {
                     // if you hit this, something has gone odd with the dataVal, which shouldn't happen. See nbt.cpp where it says "make sure upper bits are not set - they should not be!"
-                    assert(block->grid[chunkIndex] < NUM_BLOCKS_DEFINED - 256);
-                    gBoxData[boxIndex].data = dataVal & 0x7F;
+                    assert(gridType < NUM_BLOCKS_DEFINED - 256);
+                    gBoxDataVal[boxIndex] = dataVal & 0x7F;
                     // high bit turns into +256
-                    blockID = gBoxData[boxIndex].origType =
-                        gBoxData[boxIndex].type = block->grid[chunkIndex] | 0x100;
+                    blockID = gBoxOrigType[boxIndex] =
+                        gBoxType[boxIndex] = gridType | 0x100;
                 }
                 else {
                     // normal case - just transfer the data
-                    gBoxData[boxIndex].data = dataVal;
-                    blockID = gBoxData[boxIndex].origType =
-                        gBoxData[boxIndex].type = block->grid[chunkIndex];
+                    gBoxDataVal[boxIndex] = dataVal;
+                    blockID = gBoxOrigType[boxIndex] =
+                        gBoxType[boxIndex] = gridType;
                 }
 
                 // tile entities needed if using old data format
@@ -2833,7 +3326,7 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                                     if (pBE->type == blockID || ((pBE->type == BLOCK_STANDING_BANNER) && (blockID == BLOCK_WALL_BANNER))) {
                                         // found it, data gets stored differently for heads and flowers
                                         if (blockID == BLOCK_FLOWER_POT) {
-                                            gBoxData[boxIndex].data = pBE->data;
+                                            gBoxDataVal[boxIndex] = pBE->data;
                                         }
                                         else if (blockID == BLOCK_HEAD) {
                                             // BLOCK_HEAD
@@ -2844,18 +3337,18 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                                             // bit 7 - is bottom four bits 3210 the rotation on floor? If off, put on wall.
                                             // bits 654 - the head. Hopefully Minecraft won't add more than 8 heads...
                                             // bits 3210 - depends on bit 7; rotation if on floor, or on which wall (2-5)
-                                            if (gBoxData[boxIndex].data > 1) {
+                                            if (gBoxDataVal[boxIndex] > 1) {
                                                 // head is on the wall, so rotation is ignored; just store the head in the high 4 bits
                                                 assert((pBE->data & 0x80) == 0x0);	// topmost bit better not be used...
                                                 // use wall rotation value 2-5 in lower 4 bits, put head type in next top 3 bits.
-                                                gBoxData[boxIndex].data |= pBE->data & 0x70;
+                                                gBoxDataVal[boxIndex] |= pBE->data & 0x70;
                                             }
                                             else {
                                                 // head is on the floor, use the rotation angle too.
-                                                assert(gBoxData[boxIndex].data == 1);
+                                                assert(gBoxDataVal[boxIndex] == 1);
                                                 // flag very highest bit: this means the lower data field is the rotation angle, 0-16, like sign posts.
                                                 // use head data and rotation data, and flag topmost bit to note it's this way
-                                                gBoxData[boxIndex].data = pBE->data | 0x80;
+                                                gBoxDataVal[boxIndex] = pBE->data | 0x80;
                                             }
                                         }
                                         else if ((blockID == BLOCK_STANDING_BANNER) || (blockID == BLOCK_WALL_BANNER)) {
@@ -2867,10 +3360,10 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                                                 //{ 0, 177,           0, "white_wall_banner", FACING_PROP },
                                                 //{ 0,  38,    HIGH_BIT, "orange_wall_banner", FACING_PROP },
                                                 if (blockID == BLOCK_STANDING_BANNER) {
-                                                    gBoxData[boxIndex].type = (23 | 0x100) + 14 - pBE->data;
+                                                    gBoxType[boxIndex] = (23 | 0x100) + 14 - pBE->data;
                                                 }
                                                 else {
-                                                    gBoxData[boxIndex].type = (38 | 0x100) + 14 - pBE->data;
+                                                    gBoxType[boxIndex] = (38 | 0x100) + 14 - pBE->data;
                                                 }
                                             }
                                         }
@@ -2887,11 +3380,11 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                         }
                     }
                     // for 1.12 and earlier, shove bottom half flower ID number into top half, too
-                    else if ((blockID == BLOCK_DOUBLE_FLOWER) && (gBoxData[boxIndex].data & 0x8)) {
+                    else if ((blockID == BLOCK_DOUBLE_FLOWER) && (gBoxDataVal[boxIndex] & 0x8)) {
                         // The top part of the flower doesn't always have the lower bits that identifies it. Copy these over from the block below, if available.
                         // This could screw up schematic export. TODO
                         if (y > miny) {
-                            gBoxData[boxIndex].data = 0x8 | gBoxData[boxIndex - 1].data;
+                            gBoxDataVal[boxIndex] = 0x8 | gBoxDataVal[boxIndex - 1];
                         }
                     }
                 }
@@ -2899,16 +3392,19 @@ static void extractChunk(WorldGuide* pWorldGuide, int bx, int bz, IBox* edgeWorl
                 // For Anvil, Y goes up by 256 (in 1.1 and earlier, it was just ++)
                 chunkIndex += 256;
 
-                // get bounds on y searches:
+                // get bounds on y searches, if not done by findChunkBounds:
                 // search for air, and if not found then
                 // add to vertical bounds.
-                // now done by findChunkBounds:
-                //if ( blockID > BLOCK_AIR )
-                //{
-                //Vec3Scalar( loc, =, x,y,z );
-                //addBounds(loc,&gSolidWorldBox);
+                bool inBounds = findBounds && (y >= boundsBox->min[Y]) && (y <= boundsBox->max[Y]);
+                if (inBounds && sectionSaved && isBlockSaved(blockID, dataVal))
+                {
+                    IPoint loc;
+                    Vec3Scalar(loc, =, x, y, z);
+                    addBounds(loc, &gSolidWorldBox);
+                }
 
-                if (blockID == BLOCK_UNKNOWN)
+                // when reading the whole box, only blocks inside the volume itself are counted
+                if ((blockID == BLOCK_UNKNOWN) && (inBounds || (boundsBox == NULL)))
                 {
                     gBadBlocksInModel++;
                 }
@@ -2942,6 +3438,9 @@ static void modifySides(int editMode)
     // do X min and max sides first
     for (int x = gAirBox.min[X]; x <= gAirBox.max[X]; x += gAirBox.max[X] - gAirBox.min[X])
     {
+        // the side where one tile meets the next is not a border of the export
+        if (isTileSeam(x, X))
+            continue;
         for (int z = gAirBox.min[Z]; z <= gAirBox.max[Z]; z++)
         {
             // note that Y slabs at top and bottom will be cleared by modifySlab
@@ -2956,6 +3455,8 @@ static void modifySides(int editMode)
     {
         for (int z = gAirBox.min[Z]; z <= gAirBox.max[Z]; z += gAirBox.max[Z] - gAirBox.min[Z])
         {
+            if (isTileSeam(z, Z))
+                continue;
             // note that Y slabs at top and bottom will be cleared by modifySlab
             for (int y = gAirBox.min[Y]+1; y < gAirBox.max[Y]; y++)
             {
@@ -2965,6 +3466,15 @@ static void modifySides(int editMode)
     }
 }
 
+// Is this box coordinate along the axis inside the whole export volume, i.e., is it a seam with another tile of a tiled export?
+static bool isTileSeam(int boxCoord, int axis)
+{
+    if (gpTiledExportBox == NULL)
+        return false;
+    int worldCoord = boxCoord - gWorld2BoxOffset[axis];
+    return (worldCoord >= gpTiledExportBox->min[axis]) && (worldCoord <= gpTiledExportBox->max[axis]);
+}
+
 // This is used to clear out the bordering upper and lower slabs surrounding the model of data
 static void modifySlab(int y, int editMode)
 {
@@ -2985,20 +3495,20 @@ static void editBlock(int x, int y, int z, int editMode)
     switch (editMode)
     {
     case EDIT_MODE_CLEAR_TYPE:
-        gBoxData[boxIndex].type = BLOCK_AIR;
+        gBoxType[boxIndex] = BLOCK_AIR;
         // don't clear data field, since origType is still intact
         break;
     case EDIT_MODE_CLEAR_ALL:
-        gBoxData[boxIndex].type = gBoxData[boxIndex].origType = BLOCK_AIR;
-        gBoxData[boxIndex].data = 0x0f;
+        gBoxType[boxIndex] = gBoxOrigType[boxIndex] = BLOCK_AIR;
+        gBoxDataVal[boxIndex] = 0x0f;
         break;
     case EDIT_MODE_CLEAR_TYPE_AND_ENTRANCES:
         // if type is an entrance, clear it fully: done so seed propagation along borders happens properly
-        if (gBlockDefinitions[gBoxData[boxIndex].origType].flags & BLF_ENTRANCE)
+        if (gBlockDefinitions[gBoxOrigType[boxIndex]].flags & BLF_ENTRANCE)
         {
-            gBoxData[boxIndex].origType = BLOCK_AIR;
+            gBoxOrigType[boxIndex] = BLOCK_AIR;
         }
-        gBoxData[boxIndex].type = BLOCK_AIR;
+        gBoxType[boxIndex] = BLOCK_AIR;
         // don't clear data field, since origType may still be intact
         break;
     default:
@@ -3030,18 +3540,18 @@ static int filterBox(ChangeBlockCommand* pCBC)
             for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
             {
                 // sorry, air is never allowed to turn solid
-                if (gBoxData[boxIndex].type != BLOCK_AIR)
+                if (gBoxType[boxIndex] != BLOCK_AIR)
                 {
-                    int flags = gBlockDefinitions[gBoxData[boxIndex].type].flags;
+                    int flags = gBlockDefinitions[gBoxType[boxIndex]].flags;
 
                     // check if it's something to be filtered out: not in the output list,
                     // alpha is 0, or the active Culling Scheme hides this (type, dataVal).
                     if (!(flags & gModel.options->saveFilterFlags) ||
-                        gBlockDefinitions[gBoxData[boxIndex].type].alpha <= 0.0 ||
-                        isBlockCulled(gBoxData[boxIndex].type, gBoxData[boxIndex].data)) {
+                        gBlockDefinitions[gBoxType[boxIndex]].alpha <= 0.0 ||
+                        isBlockCulled(gBoxType[boxIndex], gBoxDataVal[boxIndex])) {
                         // things that should not be saved should be gone, gone, gone, no trace left
-                        gBoxData[boxIndex].type = gBoxData[boxIndex].origType = BLOCK_AIR;
-                        gBoxData[boxIndex].data = 0x0;
+                        gBoxType[boxIndex] = gBoxOrigType[boxIndex] = BLOCK_AIR;
+                        gBoxDataVal[boxIndex] = 0x0;
                     }
                 }
             }
@@ -3103,7 +3613,7 @@ static int filterBox(ChangeBlockCommand* pCBC)
                     boxIndex = BOX_INDEX(x, gSolidBox.min[Y], z);
                     for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
                     {
-                        if (gBoxData[boxIndex].type == BLOCK_REDSTONE_WIRE)
+                        if (gBoxType[boxIndex] == BLOCK_REDSTONE_WIRE)
                             computeRedstoneConnectivity(boxIndex);
                     }
                 }
@@ -3119,7 +3629,7 @@ static int filterBox(ChangeBlockCommand* pCBC)
                 for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
                 {
                     // sorry, air is never allowed to turn solid
-                    type = gBoxData[boxIndex].type;
+                    type = gBoxType[boxIndex];
                     if (type != BLOCK_AIR)
                     {
                         if (type >= NUM_BLOCKS_DEFINED) {
@@ -3129,11 +3639,11 @@ static int filterBox(ChangeBlockCommand* pCBC)
                             // But it's flakey - seems more like uninitialized or corrupted memory. Ugh.
 //#ifdef _DEBUG
 //                            type = BLOCK_BEDROCK;
-//                            gBoxData[boxIndex].type = BLOCK_BEDROCK;
+//                            gBoxType[boxIndex] = BLOCK_BEDROCK;
 //#else
-                            type = gBoxData[boxIndex].type = (unsigned short)(GetUnknownBlockID() & 0xff);
+                            type = gBoxType[boxIndex] = (unsigned short)(GetUnknownBlockID() & 0xff);
 
-                            gBoxData[boxIndex].data = 0x0;
+                            gBoxDataVal[boxIndex] = 0x0;
                             gBadBlocksInModel = true;
                         }
                         int flags = gBlockDefinitions[type].flags;
@@ -3155,15 +3665,15 @@ static int filterBox(ChangeBlockCommand* pCBC)
                                     // this block is then cleared out, since it's been processed.
                                     if (IS_WATERLOGGED(type, boxIndex)) {
                                         // clears to water if waterlogged, e.g., seagrass.
-                                        gBoxData[boxIndex].type = BLOCK_STATIONARY_WATER;
-                                        gBoxData[boxIndex].data = 8;
+                                        gBoxType[boxIndex] = BLOCK_STATIONARY_WATER;
+                                        gBoxDataVal[boxIndex] = 8;
                                     }
                                     else {
-                                        gBoxData[boxIndex].type = BLOCK_AIR;
+                                        gBoxType[boxIndex] = BLOCK_AIR;
                                     }
                                     // do NOT do this, as we use the data later to check if geometry
                                     // covers a voxel face, etc., e.g. stairs in particular:
-                                    // NO NO NO gBoxData[boxIndex].data = 0x0;
+                                    // NO NO NO gBoxDataVal[boxIndex] = 0x0;
                                     blockProcessed = 1;
                                 }
                                 else if (retVal >= MW_BEGIN_ERRORS)
@@ -3180,20 +3690,20 @@ static int filterBox(ChangeBlockCommand* pCBC)
                             // or to its neighbor, or both (depends on dataval),
                             // instead of rendering a block for it.
 
-                            // was: gBoxData[boxIndex-1].flatFlags = type;
+                            // was: gBoxFlatFlags[boxIndex-1] = type;
                             // if object was indeed flattened, set it to air
                             if (computeFlatFlags(boxIndex))
                             {
                                 if (IS_WATERLOGGED(type, boxIndex)) {
                                     // clears to water if waterlogged, e.g., seagrass
-                                    gBoxData[boxIndex].type = BLOCK_STATIONARY_WATER;
-                                    gBoxData[boxIndex].data = 8; // level of water set to full
+                                    gBoxType[boxIndex] = BLOCK_STATIONARY_WATER;
+                                    gBoxDataVal[boxIndex] = 8; // level of water set to full
                                 }
                                 else {
-                                    gBoxData[boxIndex].type = BLOCK_AIR;
+                                    gBoxType[boxIndex] = BLOCK_AIR;
                                 }
                                 // don't do this: we may use origType and data at some point:
-                                // NO NO NO: gBoxData[boxIndex].data = 0x0;
+                                // NO NO NO: gBoxDataVal[boxIndex] = 0x0;
                             }
                             else
                             {
@@ -3225,7 +3735,7 @@ static int filterBox(ChangeBlockCommand* pCBC)
                     for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
                     {
                         // sorry, air is never allowed to turn solid
-                        type = gBoxData[boxIndex].type;
+                        type = gBoxType[boxIndex];
                         if (type != BLOCK_AIR)
                         {
                             int flags = gBlockDefinitions[type].flags;
@@ -3243,15 +3753,15 @@ static int filterBox(ChangeBlockCommand* pCBC)
                                     // this block is then cleared out, since it's been processed.
                                     if (IS_WATERLOGGED(type, boxIndex)) {
                                         // clears to water if waterlogged, e.g., seagrass
-                                        gBoxData[boxIndex].type = BLOCK_STATIONARY_WATER;
-                                        gBoxData[boxIndex].data = 8;
+                                        gBoxType[boxIndex] = BLOCK_STATIONARY_WATER;
+                                        gBoxDataVal[boxIndex] = 8;
                                     }
                                     else {
-                                        gBoxData[boxIndex].type = BLOCK_AIR;
+                                        gBoxType[boxIndex] = BLOCK_AIR;
                                     }
                                     // do NOT do this, as we use the data later to check if geometry
                                     // covers a voxel face, etc., e.g. stairs in particular:
-                                    // NO NO NO gBoxData[boxIndex].data = 0x0;
+                                    // NO NO NO gBoxDataVal[boxIndex] = 0x0;
                                     foundBlock = 1;
                                 }
                                 else if (retVal >= MW_BEGIN_ERRORS)
@@ -3319,6 +3829,10 @@ static int filterBox(ChangeBlockCommand* pCBC)
             }
 
             int foundTouching = 0;
+            if (allocBoxGroups() >= MW_BEGIN_ERRORS)
+            {
+                return retCode | MW_WORLD_EXPORT_TOO_LARGE;
+            }
             gGroupListSize = 200;
             gGroupList = (BoxGroup*)calloc(gGroupListSize, sizeof(BoxGroup));
             if (gGroupList == NULL)
@@ -3540,21 +4054,21 @@ static bool applyChangeBlockCommand(ChangeBlockCommand* pCBC)
                 bool modify = false;
                 if (pCBC->useFromArray) {
                     // apply array: see if bit for type is flagged
-                    if (pCBC->fromDataBitsArray[gBoxData[boxIndex].type] & (1 << gBoxData[boxIndex].data))
+                    if (pCBC->fromDataBitsArray[gBoxType[boxIndex]] & (1 << gBoxDataVal[boxIndex]))
                         modify = true;
                 }
                 else {
                     // apply range and bits
-                    int fromType = gBoxData[boxIndex].type;
-                    if ((pCBC->simpleFromDataBits & (1 << gBoxData[boxIndex].data)) &&
+                    int fromType = gBoxType[boxIndex];
+                    if ((pCBC->simpleFromDataBits & (1 << gBoxDataVal[boxIndex])) &&
                         (pCBC->simpleFromTypeBegin <= fromType) &&
                         (pCBC->simpleFromTypeEnd >= fromType)) {
                         modify = true;
                     }
                 }
                 if (modify) {
-                    gBoxData[boxIndex].type = gBoxData[boxIndex].origType = toType;
-                    gBoxData[boxIndex].data = toData;
+                    gBoxType[boxIndex] = gBoxOrigType[boxIndex] = toType;
+                    gBoxDataVal[boxIndex] = toData;
                 }
             }
         }
@@ -3574,7 +4088,7 @@ static bool isWorldVolumeEmpty()
             boxIndex = BOX_INDEX(x, y, gSolidBox.min[Z]);
             for (z = gSolidBox.min[Z]; z <= gSolidBox.max[Z]; z++, boxIndex += gBoxSize[Y])
             {
-                if (gBoxData[boxIndex].type != BLOCK_AIR) {
+                if (gBoxType[boxIndex] != BLOCK_AIR) {
                     gSolidBox.max[Y] = y;
                     return false;
                 }
@@ -3588,7 +4102,7 @@ static bool isWorldVolumeEmpty()
     //		boxIndex = BOX_INDEX(x, gSolidBox.min[Y], z);
     //		for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
     //		{
-    //			if (gBoxData[boxIndex].type != BLOCK_AIR)
+    //			if (gBoxType[boxIndex] != BLOCK_AIR)
     //				return false;
     //		}
     //	}
@@ -3600,7 +4114,7 @@ static bool isWorldVolumeEmpty()
 static void computeRedstoneConnectivity(int boxIndex)
 {
     //BLOCK_REDSTONE_WIRE:
-    gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+    gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
     // look to see whether there is wire neighboring and above: if so, run this wire
     // up the sides of the blocks
 
@@ -3614,8 +4128,8 @@ static void computeRedstoneConnectivity(int boxIndex)
     //
     // Version test here isn't quite right, but basically 1.16 20w21a is the time
     //if (gMinecraftWorldVersion >= 2532) {
-    //    isCross = (gBoxData[boxIndex].data == BIT_16);
-    //    gBoxData[boxIndex].data &= ~BIT_16;
+    //    isCross = (gBoxDataVal[boxIndex] == BIT_16);
+    //    gBoxDataVal[boxIndex] &= ~BIT_16;
     //}
 
     // first, is the block above the redstone wire not a whole block, or is a whole block and is glass on the outside or a piston?
@@ -3625,61 +4139,61 @@ static void computeRedstoneConnectivity(int boxIndex)
     // These two will normally connect. However, if just above the redstone on the ground is a full block that is not glass/glowstone/piston/observer/etc.,
     // it will chop the redstone on the ground from connecting with the neighboring redstone a level up. Whew.
     // See the "full-block solids" section here https://minecraft.wiki/w/Opacity#Types_of_transparent_blocks for which blocks should be listed below
-    if (!(gBlockDefinitions[gBoxData[boxIndex + 1].origType].flags & BLF_WHOLE) ||
-        //(gBoxData[boxIndex + 1].origType == BLOCK_PISTON) || - not needed; not a whole block
-        (gBoxData[boxIndex + 1].origType == BLOCK_GLASS) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_GLOWSTONE && (gBoxData[boxIndex + 1].data & 0xf) == 0x0) ||   // shroomlight blocks *do* cut off redstone wires
+    if (!(gBlockDefinitions[gBoxOrigType[boxIndex + 1]].flags & BLF_WHOLE) ||
+        //(gBoxOrigType[boxIndex + 1] == BLOCK_PISTON) || - not needed; not a whole block
+        (gBoxOrigType[boxIndex + 1] == BLOCK_GLASS) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_GLOWSTONE && (gBoxDataVal[boxIndex + 1] & 0xf) == 0x0) ||   // shroomlight blocks *do* cut off redstone wires
          // "Target" used to conduct in 20w16a, now it does not - testing here is easier than moving the TNT elsewhere
-        (gBoxData[boxIndex + 1].origType == BLOCK_TNT && !(gBoxData[boxIndex + 1].data & 0x1)) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_REDSTONE_BLOCK) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_SEA_LANTERN) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_BEACON) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_ICE) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_FROSTED_ICE) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_OBSERVER) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_LEAVES) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_AD_LEAVES) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_MANGROVE_LEAVES) ||
-        (gBoxData[boxIndex + 1].origType == BLOCK_STAINED_GLASS))
+        (gBoxOrigType[boxIndex + 1] == BLOCK_TNT && !(gBoxDataVal[boxIndex + 1] & 0x1)) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_REDSTONE_BLOCK) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_SEA_LANTERN) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_BEACON) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_ICE) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_FROSTED_ICE) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_OBSERVER) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_LEAVES) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_AD_LEAVES) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_MANGROVE_LEAVES) ||
+        (gBoxOrigType[boxIndex + 1] == BLOCK_STAINED_GLASS))
     {
         // first hurdle passed - now check each in turn: is block above wire. If so,
         // then these will connect. Note we must check again origType, as wires get culled out
         // as we go through the blocks.
-        if (gBoxData[boxIndex + 1 + gBoxSizeYZ].origType == BLOCK_REDSTONE_WIRE)
+        if (gBoxOrigType[boxIndex + 1 + gBoxSizeYZ] == BLOCK_REDSTONE_WIRE)
         {
             // (upside down) stairs do not have redstone put on their sides.
-            if (!(gBlockDefinitions[gBoxData[boxIndex + gBoxSizeYZ].type].flags & (BLF_STAIRS | BLF_HALF))) {
-                gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            if (!(gBlockDefinitions[gBoxType[boxIndex + gBoxSizeYZ]].flags & (BLF_STAIRS | BLF_HALF))) {
+                gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             }
-            gBoxData[boxIndex + 1 + gBoxSizeYZ].data |= (FLAT_FACE_LO_X << 4);
-            gBoxData[boxIndex].data |= (FLAT_FACE_HI_X << 4);
+            gBoxDataVal[boxIndex + 1 + gBoxSizeYZ] |= (FLAT_FACE_LO_X << 4);
+            gBoxDataVal[boxIndex] |= (FLAT_FACE_HI_X << 4);
         }
-        if (gBoxData[boxIndex + 1 - gBoxSizeYZ].origType == BLOCK_REDSTONE_WIRE)
+        if (gBoxOrigType[boxIndex + 1 - gBoxSizeYZ] == BLOCK_REDSTONE_WIRE)
         {
             // (upside down) stairs do not have redstone put on their sides.
-            if (!(gBlockDefinitions[gBoxData[boxIndex - gBoxSizeYZ].type].flags & (BLF_STAIRS | BLF_HALF))) {
-                gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            if (!(gBlockDefinitions[gBoxType[boxIndex - gBoxSizeYZ]].flags & (BLF_STAIRS | BLF_HALF))) {
+                gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             }
-            gBoxData[boxIndex + 1 - gBoxSizeYZ].data |= (FLAT_FACE_HI_X << 4);
-            gBoxData[boxIndex].data |= (FLAT_FACE_LO_X << 4);
+            gBoxDataVal[boxIndex + 1 - gBoxSizeYZ] |= (FLAT_FACE_HI_X << 4);
+            gBoxDataVal[boxIndex] |= (FLAT_FACE_LO_X << 4);
         }
-        if (gBoxData[boxIndex + 1 + gBoxSize[Y]].origType == BLOCK_REDSTONE_WIRE)
+        if (gBoxOrigType[boxIndex + 1 + gBoxSize[Y]] == BLOCK_REDSTONE_WIRE)
         {
             // (upside down) stairs do not have redstone put on their sides.
-            if (!(gBlockDefinitions[gBoxData[boxIndex + gBoxSize[Y]].type].flags & (BLF_STAIRS | BLF_HALF))) {
-                gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            if (!(gBlockDefinitions[gBoxType[boxIndex + gBoxSize[Y]]].flags & (BLF_STAIRS | BLF_HALF))) {
+                gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             }
-            gBoxData[boxIndex + 1 + gBoxSize[Y]].data |= (FLAT_FACE_LO_Z << 4);
-            gBoxData[boxIndex].data |= (FLAT_FACE_HI_Z << 4);
+            gBoxDataVal[boxIndex + 1 + gBoxSize[Y]] |= (FLAT_FACE_LO_Z << 4);
+            gBoxDataVal[boxIndex] |= (FLAT_FACE_HI_Z << 4);
         }
-        if (gBoxData[boxIndex + 1 - gBoxSize[Y]].origType == BLOCK_REDSTONE_WIRE)
+        if (gBoxOrigType[boxIndex + 1 - gBoxSize[Y]] == BLOCK_REDSTONE_WIRE)
         {
             // (upside down) stairs do not have redstone put on their sides.
-            if (!(gBlockDefinitions[gBoxData[boxIndex - gBoxSize[Y]].type].flags & (BLF_STAIRS | BLF_HALF))) {
-                gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            if (!(gBlockDefinitions[gBoxType[boxIndex - gBoxSize[Y]]].flags & (BLF_STAIRS | BLF_HALF))) {
+                gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             }
-            gBoxData[boxIndex + 1 - gBoxSize[Y]].data |= (FLAT_FACE_HI_Z << 4);
-            gBoxData[boxIndex].data |= (FLAT_FACE_LO_Z << 4);
+            gBoxDataVal[boxIndex + 1 - gBoxSize[Y]] |= (FLAT_FACE_HI_Z << 4);
+            gBoxDataVal[boxIndex] |= (FLAT_FACE_LO_Z << 4);
         }
     }
     // finally, check the +X and +Z neighbors on this level: if wire, connect them.
@@ -3689,48 +4203,48 @@ static void computeRedstoneConnectivity(int boxIndex)
     // Test *all* things that redstone connects to. This could become a table, for speed.
     // What this means: given a block, it will have BLF_CONNECTS_REDSTONE for it if, when you put the block
     // down and put redstone dust next to it, the dust forms a single straight line into the block, instead of a cross.
-    if ((gBlockDefinitions[gBoxData[boxIndex + gBoxSizeYZ].origType].flags & BLF_CONNECTS_REDSTONE) ||
+    if ((gBlockDefinitions[gBoxOrigType[boxIndex + gBoxSizeYZ]].flags & BLF_CONNECTS_REDSTONE) ||
         // repeaters attach only at their ends, so test the direction they're at
-        (gBoxData[boxIndex + gBoxSizeYZ].origType == BLOCK_REDSTONE_REPEATER_OFF && (gBoxData[boxIndex + gBoxSizeYZ].data & 0x1)) ||
-        (gBoxData[boxIndex + gBoxSizeYZ].origType == BLOCK_REDSTONE_REPEATER_ON && (gBoxData[boxIndex + gBoxSizeYZ].data & 0x1))
+        (gBoxOrigType[boxIndex + gBoxSizeYZ] == BLOCK_REDSTONE_REPEATER_OFF && (gBoxDataVal[boxIndex + gBoxSizeYZ] & 0x1)) ||
+        (gBoxOrigType[boxIndex + gBoxSizeYZ] == BLOCK_REDSTONE_REPEATER_ON && (gBoxDataVal[boxIndex + gBoxSizeYZ] & 0x1))
         )
     {
-        if (gBoxData[boxIndex + gBoxSizeYZ].origType == BLOCK_REDSTONE_WIRE)
-            gBoxData[boxIndex + gBoxSizeYZ].data |= (FLAT_FACE_LO_X << 4);
-        gBoxData[boxIndex].data |= (FLAT_FACE_HI_X << 4);
+        if (gBoxOrigType[boxIndex + gBoxSizeYZ] == BLOCK_REDSTONE_WIRE)
+            gBoxDataVal[boxIndex + gBoxSizeYZ] |= (FLAT_FACE_LO_X << 4);
+        gBoxDataVal[boxIndex] |= (FLAT_FACE_HI_X << 4);
     }
-    if ((gBlockDefinitions[gBoxData[boxIndex + gBoxSize[Y]].origType].flags & BLF_CONNECTS_REDSTONE) ||
+    if ((gBlockDefinitions[gBoxOrigType[boxIndex + gBoxSize[Y]]].flags & BLF_CONNECTS_REDSTONE) ||
         // repeaters attach only at their ends, so test the direction they're at
-        (gBoxData[boxIndex + gBoxSize[Y]].origType == BLOCK_REDSTONE_REPEATER_OFF && !(gBoxData[boxIndex + gBoxSize[Y]].data & 0x1)) ||
-        (gBoxData[boxIndex + gBoxSize[Y]].origType == BLOCK_REDSTONE_REPEATER_ON && !(gBoxData[boxIndex + gBoxSize[Y]].data & 0x1))
+        (gBoxOrigType[boxIndex + gBoxSize[Y]] == BLOCK_REDSTONE_REPEATER_OFF && !(gBoxDataVal[boxIndex + gBoxSize[Y]] & 0x1)) ||
+        (gBoxOrigType[boxIndex + gBoxSize[Y]] == BLOCK_REDSTONE_REPEATER_ON && !(gBoxDataVal[boxIndex + gBoxSize[Y]] & 0x1))
         )
     {
-        if (gBoxData[boxIndex + gBoxSize[Y]].origType == BLOCK_REDSTONE_WIRE)
-            gBoxData[boxIndex + gBoxSize[Y]].data |= (FLAT_FACE_LO_Z << 4);
-        gBoxData[boxIndex].data |= (FLAT_FACE_HI_Z << 4);
+        if (gBoxOrigType[boxIndex + gBoxSize[Y]] == BLOCK_REDSTONE_WIRE)
+            gBoxDataVal[boxIndex + gBoxSize[Y]] |= (FLAT_FACE_LO_Z << 4);
+        gBoxDataVal[boxIndex] |= (FLAT_FACE_HI_Z << 4);
     }
     // catch redstone torches at the -X and -Z faces
-    if ((gBlockDefinitions[gBoxData[boxIndex - gBoxSizeYZ].origType].flags & BLF_CONNECTS_REDSTONE) ||
+    if ((gBlockDefinitions[gBoxOrigType[boxIndex - gBoxSizeYZ]].flags & BLF_CONNECTS_REDSTONE) ||
         // repeaters attach only at their ends, so test the direction they're at
-        (gBoxData[boxIndex - gBoxSizeYZ].origType == BLOCK_REDSTONE_REPEATER_OFF && (gBoxData[boxIndex - gBoxSizeYZ].data & 0x1)) ||
-        (gBoxData[boxIndex - gBoxSizeYZ].origType == BLOCK_REDSTONE_REPEATER_ON && (gBoxData[boxIndex - gBoxSizeYZ].data & 0x1))
+        (gBoxOrigType[boxIndex - gBoxSizeYZ] == BLOCK_REDSTONE_REPEATER_OFF && (gBoxDataVal[boxIndex - gBoxSizeYZ] & 0x1)) ||
+        (gBoxOrigType[boxIndex - gBoxSizeYZ] == BLOCK_REDSTONE_REPEATER_ON && (gBoxDataVal[boxIndex - gBoxSizeYZ] & 0x1))
         )
     {
-        gBoxData[boxIndex].data |= (FLAT_FACE_LO_X << 4);
+        gBoxDataVal[boxIndex] |= (FLAT_FACE_LO_X << 4);
     }
-    if ((gBlockDefinitions[gBoxData[boxIndex - gBoxSize[Y]].origType].flags & BLF_CONNECTS_REDSTONE) ||
+    if ((gBlockDefinitions[gBoxOrigType[boxIndex - gBoxSize[Y]]].flags & BLF_CONNECTS_REDSTONE) ||
         // repeaters attach only at their ends, so test the direction they're at
-        (gBoxData[boxIndex - gBoxSize[Y]].origType == BLOCK_REDSTONE_REPEATER_OFF && !(gBoxData[boxIndex - gBoxSize[Y]].data & 0x1)) ||
-        (gBoxData[boxIndex - gBoxSize[Y]].origType == BLOCK_REDSTONE_REPEATER_ON && !(gBoxData[boxIndex - gBoxSize[Y]].data & 0x1))
+        (gBoxOrigType[boxIndex - gBoxSize[Y]] == BLOCK_REDSTONE_REPEATER_OFF && !(gBoxDataVal[boxIndex - gBoxSize[Y]] & 0x1)) ||
+        (gBoxOrigType[boxIndex - gBoxSize[Y]] == BLOCK_REDSTONE_REPEATER_ON && !(gBoxDataVal[boxIndex - gBoxSize[Y]] & 0x1))
         )
     {
-        gBoxData[boxIndex].data |= (FLAT_FACE_LO_Z << 4);
+        gBoxDataVal[boxIndex] |= (FLAT_FACE_LO_Z << 4);
     }
 
     // finally finally, if ONLY waterlogged bit is set, which means there are no other connections, unset it and make this one a cross.
     // this is a 1.16 20w21a addition, see https://minecraft.wiki/w/Java_Edition_20w21a
-    //if (isCross && (gBoxData[boxIndex].data & ((FLAT_FACE_HI_X | FLAT_FACE_HI_Z | FLAT_FACE_LO_X | FLAT_FACE_LO_Z) << 4)) == 0x0) {
-    //    gBoxData[boxIndex].data |= (FLAT_FACE_HI_X|FLAT_FACE_HI_Z|FLAT_FACE_LO_X|FLAT_FACE_LO_Z) << 4;
+    //if (isCross && (gBoxDataVal[boxIndex] & ((FLAT_FACE_HI_X | FLAT_FACE_HI_Z | FLAT_FACE_LO_X | FLAT_FACE_LO_Z) << 4)) == 0x0) {
+    //    gBoxDataVal[boxIndex] |= (FLAT_FACE_HI_X|FLAT_FACE_HI_Z|FLAT_FACE_LO_X|FLAT_FACE_LO_Z) << 4;
     //}
 }
 
@@ -3739,7 +4253,7 @@ static int computeFlatFlags(int boxIndex)
 {
     // for this box's contents, mark the neighbor(s) that should receive
     // its flatness
-    switch (gBoxData[boxIndex].type)
+    switch (gBoxType[boxIndex])
     {
         // the block below this one, if solid, gets marked
     case BLOCK_STONE_PRESSURE_PLATE:						// computeFlatFlags
@@ -3786,22 +4300,22 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_PINK_PETALS:
     case BLOCK_TORCHFLOWER_CROP:
         //case BLOCK_CHAIN:   // questionable: should a chain (offset to the edge!) really be flattened onto the neighbor below?
-        gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+        gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
         break;
 
     case BLOCK_MANGROVE_PROPAGULE:
         //case BLOCK_CHAIN:   // questionable: should a chain (offset to the edge!) really be flattened onto the neighbor below?
         // If mangrove propagule is hanging, just ignore it (can't really used textures, and hard to see, anyway)
-        if ((gBoxData[boxIndex].data & 0x7) == 0x0)
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+        if ((gBoxDataVal[boxIndex] & 0x7) == 0x0)
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
         break;
 
         // easy ones: flattops
     case BLOCK_RAIL:						// computeFlatFlags
-        if (gBoxData[boxIndex].data >= 6)
+        if (gBoxDataVal[boxIndex] >= 6)
         {
             // curved rail bit, it's always just flat
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             break;
         }
         // NOTE: if curve test failed, needed only for basic rails, continue on through tilted track tests
@@ -3811,25 +4325,25 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_ACTIVATOR_RAIL:
         // only pay attention to sloped rails, as these mark sides;
         // remove top bit, as that's whether it's powered
-        switch (gBoxData[boxIndex].data & 0x7)
+        switch (gBoxDataVal[boxIndex] & 0x7)
         {
         case 2: // east, +X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 3:
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         case 4:
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 5:
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         default:
             // don't do anything, this rail is not sloped; continue on down to mark top face
             break;
         }
-        gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+        gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
         break;
 
     case BLOCK_TORCH:						// computeFlatFlags
@@ -3837,22 +4351,22 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_REDSTONE_TORCH_ON:
     case BLOCK_SOUL_TORCH:
     case BLOCK_COPPER_TORCH:
-        switch (gBoxData[boxIndex].data)
+        switch (gBoxDataVal[boxIndex])
         {
         case 1: // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         case 2:
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 3:
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 4:
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 5:
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             break;
         default:
             // don't do anything, this torch is not touching a side
@@ -3861,20 +4375,20 @@ static int computeFlatFlags(int boxIndex)
         break;
 
     case BLOCK_PALE_MOSS_CARPET:						// computeFlatFlags
-        if (gBoxData[boxIndex].data & 0x1) {
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+        if (gBoxDataVal[boxIndex] & 0x1) {
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
         }
-        if (gBoxData[boxIndex].data & 0x2) {    // south, -Z (northern facing) face
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+        if (gBoxDataVal[boxIndex] & 0x2) {    // south, -Z (northern facing) face
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
         }
-        if (gBoxData[boxIndex].data & 0x4) { // west, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+        if (gBoxDataVal[boxIndex] & 0x4) { // west, +X
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
         }
-        if (gBoxData[boxIndex].data & 0x8) {    // north, +Z
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+        if (gBoxDataVal[boxIndex] & 0x8) {    // north, +Z
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
         }
-		if (gBoxData[boxIndex].data & BIT_16) { // east, -X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+		if (gBoxDataVal[boxIndex] & BIT_16) { // east, -X
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
         }
         break;
 
@@ -3899,19 +4413,19 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_BLACK_WALL_BANNER:
     case BLOCK_ACACIA_SHELF:
     case BLOCK_PALE_OAK_SHELF:
-        switch (gBoxData[boxIndex].data & 0x7)
+        switch (gBoxDataVal[boxIndex] & 0x7)
         {
         case 2: // north, -Z
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 3: // south, +Z
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 4: // west, -X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 5: // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         default:
             assert(0);
@@ -3920,28 +4434,28 @@ static int computeFlatFlags(int boxIndex)
         break;
 
     case BLOCK_LEVER:						// computeFlatFlags
-        switch (gBoxData[boxIndex].data & 0x7)
+        switch (gBoxDataVal[boxIndex] & 0x7)
         {
         case 1: // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         case 2:
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 3:
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 4:
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 5:
         case 6:
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             break;
             // added in 1.3:
         case 7:	// pointing south
         case 0:	// pointing east
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
             break;
         default:
             assert(0);
@@ -3962,25 +4476,25 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_MANGROVE_BUTTON:
     case BLOCK_CHERRY_BUTTON:
     case BLOCK_BAMBOO_BUTTON:
-        switch (gBoxData[boxIndex].data & 0x7)
+        switch (gBoxDataVal[boxIndex] & 0x7)
         {
         case 0: // at top of block, +Y
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
             break;
         case 5: // at bottom of block, -Y
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             break;
         case 4: // north, -Z
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 3: // south, +Z
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 2: // west, -X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 1: // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         default:
             assert(0);
@@ -3991,19 +4505,19 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_TRIPWIRE_HOOK:						// computeFlatFlags
         // 0x4 means "tripwire connected"
         // 0x8 means "tripwire tripped"
-        switch (gBoxData[boxIndex].data & 0x3)
+        switch (gBoxDataVal[boxIndex] & 0x3)
         {
         case 0: // south, +Z
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 1: // west, -X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 2: // north, -Z
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 3: // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         default:
             assert(0);
@@ -4032,22 +4546,22 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_WAXED_WEATHERED_COPPER_TRAPDOOR:
     case BLOCK_WAXED_OXIDIZED_COPPER_TRAPDOOR:
     case BLOCK_PALE_OAK_TRAPDOOR:
-        if (gBoxData[boxIndex].data & 0x4)
+        if (gBoxDataVal[boxIndex] & 0x4)
         {
             // trapdoor is open, so is against a wall
-            switch (gBoxData[boxIndex].data & 0x3)
+            switch (gBoxDataVal[boxIndex] & 0x3)
             {
             case 0: // north, -Z
-                gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+                gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
                 break;
             case 1: // south, +Z
-                gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+                gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
                 break;
             case 2: // west, -X
-                gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+                gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
                 break;
             case 3: // east, +X
-                gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+                gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
                 break;
             default:
                 assert(0);
@@ -4058,7 +4572,7 @@ static int computeFlatFlags(int boxIndex)
         {
             // Not open, so connected to floor (if any!) or "roof". Very special case:
             // attached to roof?
-            if (gBoxData[boxIndex].data & 0x8)
+            if (gBoxDataVal[boxIndex] & 0x8)
             {
                 // Roof: don't need to do anything, should show up as full block.'
                 return 0;
@@ -4068,19 +4582,19 @@ static int computeFlatFlags(int boxIndex)
                 // On floor
                 // if there's nothing below trapdoor, block below is set to trapdoor, if
                 // Y is not too low
-                if (gBoxData[boxIndex - 1].origType == BLOCK_AIR)
+                if (gBoxOrigType[boxIndex - 1] == BLOCK_AIR)
                 {
                     IPoint loc;
                     boxIndexToLoc(loc, boxIndex);
                     if (loc[Y] > gSolidBox.min[Y])
                     {
-                        gBoxData[boxIndex - 1].origType = gBoxData[boxIndex].type;
+                        gBoxOrigType[boxIndex - 1] = gBoxType[boxIndex];
                     }
                 }
                 else
                 {
                     // mark the solid box, as usual
-                    gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+                    gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
                 }
             }
         }
@@ -4089,20 +4603,20 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_VINES:						// computeFlatFlags
         // first, if this block was not originally a vine, then forget it - this block was generated
         // by a vine spreading to its neighbor - see below.
-        if (gBoxData[boxIndex].origType != BLOCK_VINES)
+        if (gBoxOrigType[boxIndex] != BLOCK_VINES)
         {
             return 0;
         }
         // the rules: vines can cover up to four sides, or if no bits set (or BIT_32, new format), top of overhanging block.
         // The overhanging block stops side faces from appearing, essentially.
         // If billboarding is on and we're not printing, then we've already exported everything else of the vine, so remove it.
-        if ((gBoxData[boxIndex].data == 0) || (gBoxData[boxIndex].data == BIT_16) || (gBoxData[boxIndex].data == BIT_32) || (gExportBillboards && !gModel.print3D))
+        if ((gBoxDataVal[boxIndex] == 0) || (gBoxDataVal[boxIndex] == BIT_16) || (gBoxDataVal[boxIndex] == BIT_32) || (gExportBillboards && !gModel.print3D))
         {
             // top face, flatten to bottom of block above, if the neighbor exists. If it doesn't,
             // something odd is going on (this shouldn't happen).
-            if (gBoxData[boxIndex + 1].origType != BLOCK_AIR)
+            if (gBoxOrigType[boxIndex + 1] != BLOCK_AIR)
             {
-                gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+                gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
             }
             else
             {
@@ -4116,11 +4630,11 @@ static int computeFlatFlags(int boxIndex)
         else
         {
             // if a block is above a vine, there's always a below
-            if (gBoxData[boxIndex + 1].origType != BLOCK_AIR)
+            if (gBoxOrigType[boxIndex + 1] != BLOCK_AIR)
             {
-                gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+                gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
             }
-            if (gBoxData[boxIndex].data & 0x1)
+            if (gBoxDataVal[boxIndex] & 0x1)
             {
                 // south face (+Z)
                 // is there a neighbor large enough to composite a vine onto?
@@ -4129,73 +4643,73 @@ static int computeFlatFlags(int boxIndex)
                 // TODO shift the "air vines" inwards, as shown in the "else" statement. However, this code here is not
                 // really the place to do it - vines could extend past the border, and if "seal tunnels" etc. is done things go
                 // very wrong.
-                if (gBlockDefinitions[gBoxData[boxIndex + gBoxSize[Y]].type].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
-                    !TYPE_IS_LEAF(gBoxData[boxIndex + gBoxSize[Y]].type))
+                if (gBlockDefinitions[gBoxType[boxIndex + gBoxSize[Y]]].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
+                    !TYPE_IS_LEAF(gBoxType[boxIndex + gBoxSize[Y]]))
                 {
                     // neighbor's a whole block, so shove the vine onto it
-                    gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+                    gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
                 }
                 else
                 {
                     // force the block to become a vine - could be weird if there was something else here.
                     // This is not quite legal, first of all because we might set a location to solid that's outside the border
-                    //gBoxData[boxIndex+gBoxSize[Y]].type = BLOCK_VINES;
-                    //gBoxData[boxIndex+gBoxSize[Y]].data = 0x0;
+                    //gBoxType[boxIndex+gBoxSize[Y]] = BLOCK_VINES;
+                    //gBoxDataVal[boxIndex+gBoxSize[Y]] = 0x0;
                     return 0;
                 }
             }
-            if (gBoxData[boxIndex].data & 0x2)
+            if (gBoxDataVal[boxIndex] & 0x2)
             {
                 // west face (-X)
                 // is there a neighbor?
-                if (gBlockDefinitions[gBoxData[boxIndex - gBoxSizeYZ].type].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
-                    !TYPE_IS_LEAF(gBoxData[boxIndex - gBoxSizeYZ].type))
+                if (gBlockDefinitions[gBoxType[boxIndex - gBoxSizeYZ]].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
+                    !TYPE_IS_LEAF(gBoxType[boxIndex - gBoxSizeYZ]))
                 {
                     // neighbor's a whole block, so shove the vine onto it
-                    gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+                    gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
                 }
                 else
                 {
                     // force the block to become a vine - could be weird if there was something else here.
-                    //gBoxData[boxIndex-gBoxSizeYZ].type = BLOCK_VINES;
-                    //gBoxData[boxIndex-gBoxSizeYZ].data = 0x0;
+                    //gBoxType[boxIndex-gBoxSizeYZ] = BLOCK_VINES;
+                    //gBoxDataVal[boxIndex-gBoxSizeYZ] = 0x0;
                     return 0;
                 }
             }
-            if (gBoxData[boxIndex].data & 0x4)
+            if (gBoxDataVal[boxIndex] & 0x4)
             {
                 // north face (-Z)
                 // is there a neighbor?
-                if (gBlockDefinitions[gBoxData[boxIndex - gBoxSize[Y]].type].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
-                    !TYPE_IS_LEAF(gBoxData[boxIndex - gBoxSize[Y]].type))
+                if (gBlockDefinitions[gBoxType[boxIndex - gBoxSize[Y]]].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
+                    !TYPE_IS_LEAF(gBoxType[boxIndex - gBoxSize[Y]]))
                 {
                     // neighbor's a real-live whole block, so shove the vine onto it
-                    gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+                    gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
                 }
                 else
                 {
                     // TODO for rendering export, we really want vines to always be offset billboards, I believe
                     // force the block to become a vine - could be weird if there was something else here.
-                    //gBoxData[boxIndex-gBoxSize[Y]].type = BLOCK_VINES;
-                    //gBoxData[boxIndex-gBoxSize[Y]].data = 0x0;
+                    //gBoxType[boxIndex-gBoxSize[Y]] = BLOCK_VINES;
+                    //gBoxDataVal[boxIndex-gBoxSize[Y]] = 0x0;
                     return 0;
                 }
             }
-            if (gBoxData[boxIndex].data & 0x8)
+            if (gBoxDataVal[boxIndex] & 0x8)
             {
                 // east face (+X)
                 // is there a neighbor?
-                if (gBlockDefinitions[gBoxData[boxIndex + gBoxSizeYZ].type].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
-                    !TYPE_IS_LEAF(gBoxData[boxIndex + gBoxSizeYZ].type))
+                if (gBlockDefinitions[gBoxType[boxIndex + gBoxSizeYZ]].flags & (BLF_WHOLE | BLF_ALMOST_WHOLE | BLF_STAIRS | BLF_HALF) &&
+                    !TYPE_IS_LEAF(gBoxType[boxIndex + gBoxSizeYZ]))
                 {
                     // neighbor's a whole block, so shove the vine onto it
-                    gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+                    gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
                 }
                 else
                 {
                     // force the block to become a vine - could be weird if there was something else here.
-                    //gBoxData[boxIndex+gBoxSizeYZ].type = BLOCK_VINES;
-                    //gBoxData[boxIndex+gBoxSizeYZ].data = 0x0;
+                    //gBoxType[boxIndex+gBoxSizeYZ] = BLOCK_VINES;
+                    //gBoxDataVal[boxIndex+gBoxSizeYZ] = 0x0;
                     return 0;
                 }
             }
@@ -4203,25 +4717,25 @@ static int computeFlatFlags(int boxIndex)
         break;
 
     case BLOCK_AMETHYST_BUD:
-        switch ((gBoxData[boxIndex].data & 0x1c) >> 2)
+        switch ((gBoxDataVal[boxIndex] & 0x1c) >> 2)
         {
         case 0: // pointing down
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
             break;
         case 1: // pointing up
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             break;
         case 2: // pointing north
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
             break;
         case 3: // pointing south
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
             break;
         case 4: // pointing west
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
             break;
         case 5: // pointing east
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
             break;
         default:
             assert(0);
@@ -4233,29 +4747,29 @@ static int computeFlatFlags(int boxIndex)
     case BLOCK_SCULK_VEIN:
     case BLOCK_RESIN_CLUMP:
         // (south ? 1 : 0) | (west ? 2 : 0) | (north ? 4 : 0) | (east ? 8 : 0) | (down ? BIT_16 : 0) | (up ? BIT_32 : 0);
-        if (gBoxData[boxIndex].data & 0x01) {
+        if (gBoxDataVal[boxIndex] & 0x01) {
             // south, +Z
-            gBoxData[boxIndex - gBoxSize[Y]].flatFlags |= FLAT_FACE_HI_Z;
+            gBoxFlatFlags[boxIndex - gBoxSize[Y]] |= FLAT_FACE_HI_Z;
         }
-        if (gBoxData[boxIndex].data & 0x02) {
+        if (gBoxDataVal[boxIndex] & 0x02) {
             // west, -X
-            gBoxData[boxIndex + gBoxSizeYZ].flatFlags |= FLAT_FACE_LO_X;
+            gBoxFlatFlags[boxIndex + gBoxSizeYZ] |= FLAT_FACE_LO_X;
         }
-        if (gBoxData[boxIndex].data & 0x04) {
+        if (gBoxDataVal[boxIndex] & 0x04) {
             // north, -Z
-            gBoxData[boxIndex + gBoxSize[Y]].flatFlags |= FLAT_FACE_LO_Z;
+            gBoxFlatFlags[boxIndex + gBoxSize[Y]] |= FLAT_FACE_LO_Z;
         }
-        if (gBoxData[boxIndex].data & 0x08) {
+        if (gBoxDataVal[boxIndex] & 0x08) {
             // east, +X
-            gBoxData[boxIndex - gBoxSizeYZ].flatFlags |= FLAT_FACE_HI_X;
+            gBoxFlatFlags[boxIndex - gBoxSizeYZ] |= FLAT_FACE_HI_X;
         }
-        if (gBoxData[boxIndex].data & 0x10) {
+        if (gBoxDataVal[boxIndex] & 0x10) {
             // (hanging) down
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
         }
-        if (gBoxData[boxIndex].data & 0x20) {
+        if (gBoxDataVal[boxIndex] & 0x20) {
             // up
-            gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
         }
         break;
 
@@ -4265,32 +4779,32 @@ static int computeFlatFlags(int boxIndex)
 
     case BLOCK_PALE_HANGING_MOSS:						// computeFlatFlags
         // moss goes up
-        gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+        gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
         break;
 
     case BLOCK_WEEPING_VINES:						// computeFlatFlags
-        if ((gBoxData[boxIndex].data & 0xf) == 0x1) {
+        if ((gBoxDataVal[boxIndex] & 0xf) == 0x1) {
             // twisting vines go up
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_ABOVE;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_ABOVE;
         }
         else {
             // other vines, roots, etc. hang
-            gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+            gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
         }
         break;
 
     case BLOCK_SPORE_BLOSSOM:						// computeFlatFlags
-        gBoxData[boxIndex + 1].flatFlags |= FLAT_FACE_BELOW;
+        gBoxFlatFlags[boxIndex + 1] |= FLAT_FACE_BELOW;
         break;
 
     case BLOCK_PITCHER_CROP:						// computeFlatFlags
         // flatten only if age is 0
         {
-            int age = (gBoxData[boxIndex].data & 0x7);
+            int age = (gBoxDataVal[boxIndex] & 0x7);
 
             // if age > 1, there's a flower. Get the swatch to use, then output it
             if (age == 0) {
-                gBoxData[boxIndex - 1].flatFlags |= FLAT_FACE_ABOVE;
+                gBoxFlatFlags[boxIndex - 1] |= FLAT_FACE_ABOVE;
             }
             else {
                 return 0;
@@ -4299,7 +4813,7 @@ static int computeFlatFlags(int boxIndex)
         break;
 
     default:
-        // something needs to be added to the cases above! The gBoxData[boxIndex].type is not in the switch list
+        // something needs to be added to the cases above! The gBoxType[boxIndex] is not in the switch list
         assert(0);
         return 0;
 
@@ -4617,7 +5131,7 @@ static bool fenceNeighbor(int type, int boxIndex, int blockSide)
         return false;
     }
     int neighborIndex = boxIndex + gFaceOffset[blockSide];
-    int neighborType = gBoxData[neighborIndex].origType;
+    int neighborType = gBoxOrigType[neighborIndex];
     // is neighbor of same type? Easy out
     if (type == neighborType)
         return true;
@@ -4630,7 +5144,7 @@ static bool fenceNeighbor(int type, int boxIndex, int blockSide)
     if (gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) {
         // fence gate only connects if it is oriented properly
         int bitSet = ((blockSide == DIRECTION_BLOCK_SIDE_LO_Z) || (blockSide == DIRECTION_BLOCK_SIDE_HI_Z)) ? 0x1 : 0x0;
-        if ((gBoxData[neighborIndex].data & 0x1) == bitSet)
+        if ((gBoxDataVal[neighborIndex] & 0x1) == bitSet)
             return true;
     }
 
@@ -4669,7 +5183,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
     float shiftX, shiftZ;  // cppcheck-suppress 398
     float x, z;
 
-    dataVal = gBoxData[boxIndex].data;
+    dataVal = gBoxDataVal[boxIndex];
 
     // Add to minor count if this object has some heft. This is approximate, but better than nothing.
     // This count can be slightly off if we return 0, meaning the block wasn't a billboard or geometry after all
@@ -4964,18 +5478,18 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             }
             else {
                 matchType = (type == BLOCK_PUMPKIN_STEM) ? BLOCK_PUMPKIN : BLOCK_MELON;
-                if (gBoxData[boxIndex - gBoxSizeYZ].origType == matchType) {
+                if (gBoxOrigType[boxIndex - gBoxSizeYZ] == matchType) {
                     // to west
                     angle = 0;
                 }
-                else if (gBoxData[boxIndex + gBoxSizeYZ].origType == matchType) {
+                else if (gBoxOrigType[boxIndex + gBoxSizeYZ] == matchType) {
                     // east
                     angle = 180;
                 }
-                else if (gBoxData[boxIndex - gBoxSize[Y]].origType == matchType) {
+                else if (gBoxOrigType[boxIndex - gBoxSize[Y]] == matchType) {
                     angle = 90;
                 }
-                else if (gBoxData[boxIndex + gBoxSize[Y]].origType == matchType) {
+                else if (gBoxOrigType[boxIndex + gBoxSize[Y]] == matchType) {
                     angle = 270;
                 }
                 else
@@ -5080,7 +5594,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             }
 
             // it's sloping, so check if object below it is not air
-            typeBelow = gBoxData[boxIndex - 1].origType;
+            typeBelow = gBoxOrigType[boxIndex - 1];
             if (typeBelow == BLOCK_AIR)
             {
                 // air below, which means this rail's at the bottom level, descending.
@@ -5108,11 +5622,11 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                     assert(0);
                 }
                 boxIndexBelow = boxIndex + gFaceOffset[transNeighbor];
-                typeBelow = gBoxData[boxIndex + gFaceOffset[transNeighbor]].origType;
+                typeBelow = gBoxOrigType[boxIndex + gFaceOffset[transNeighbor]];
                 // make sure the block to the side is something valid for a rail to be on
                 if (gBlockDefinitions[typeBelow].flags & BLF_WHOLE)
                 {
-                    dataValBelow = gBoxData[boxIndexBelow].data;
+                    dataValBelow = gBoxDataVal[boxIndexBelow];
                 }
                 else
                 {
@@ -5126,7 +5640,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             else
             {
                 boxIndexBelow = boxIndex - 1;
-                dataValBelow = gBoxData[boxIndexBelow].data;
+                dataValBelow = gBoxDataVal[boxIndexBelow];
             }
 
             // brute force the four cases: always draw bottom of block as the thing, use top of block for decal,
@@ -5388,7 +5902,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         // brace here, so that we can declare local variables
         {
             // if there's *anything* above the wall, put the post, at least temporarily
-            if (gBoxData[boxIndex + 1].origType != 0)
+            if (gBoxOrigType[boxIndex + 1] != 0)
             {
                 hasPost = 1;
                 if (gMcVersion >= 16) {
@@ -5399,13 +5913,13 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                     // So we leave hasPost == 1.
                     // Most partial blocks above will create a post but not cover things
 
-                    neighborType = gBoxData[boxIndex + 1].origType;
+                    neighborType = gBoxOrigType[boxIndex + 1];
                     // Some things actually have no effect.
                     // If the block above is a slab or stairs that's "above" (upside down), it doesn't affect the wall at all;
                     // pointed dripstone doesn't, either. Nor does a hopper pointing any way but down.
-                    if (((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && (gBoxData[boxIndex + 1].data & 0x4)) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_HALF) && (gBoxData[boxIndex + 1].data & 0x8)) ||
-                        ((neighborType == BLOCK_HOPPER) && (gBoxData[boxIndex + 1].data & 0x7)) ||  // pointing down is 0, other directions are values > 0
+                    if (((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && (gBoxDataVal[boxIndex + 1] & 0x4)) ||
+                        ((gBlockDefinitions[neighborType].flags & BLF_HALF) && (gBoxDataVal[boxIndex + 1] & 0x8)) ||
+                        ((neighborType == BLOCK_HOPPER) && (gBoxDataVal[boxIndex + 1] & 0x7)) ||  // pointing down is 0, other directions are values > 0
                         (neighborType >= BLOCK_WATER && neighborType <= BLOCK_STATIONARY_LAVA) ||
                         (neighborType == BLOCK_POINTED_DRIPSTONE)
                         ) {
@@ -5423,7 +5937,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                         (neighborType == BLOCK_WEIGHTED_PRESSURE_PLATE_HEAVY) ||
                         (neighborType == BLOCK_STANDING_BANNER) ||
                         (neighborType >= BLOCK_ORANGE_BANNER && neighborType <= BLOCK_BLACK_BANNER) ||
-                        ((neighborType == BLOCK_HOPPER) && !(gBoxData[boxIndex + 1].data & 0x7)) ||  // pointing down is 0, which makes a post but no cover
+                        ((neighborType == BLOCK_HOPPER) && !(gBoxDataVal[boxIndex + 1] & 0x7)) ||  // pointing down is 0, which makes a post but no cover
                         (neighborType == BLOCK_LADDER) ||
                         (neighborType == BLOCK_VINES) ||
                         (neighborType == BLOCK_CHAIN) ||
@@ -5459,39 +5973,39 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             float xHighWall = 0.0f;
             float zLowWall = 0.0f;
             float zHighWall = 0.0f;
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
             if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                 (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].data & 0x3)) == 0) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].data & 0x1)) == 0))
+                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] & 0x3)) == 0) ||
+                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] & 0x1)) == 0))
             {
                 xLowWall = 1 + covered;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
             if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                 (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].data & 0x3)) == 1) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].data & 0x1)) == 0))
+                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] & 0x3)) == 1) ||
+                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] & 0x1)) == 0))
             {
                 xHighWall = 1 + covered;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
             if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                 (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].data & 0x3)) == 2) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].data & 0x1)) == 1))
+                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] & 0x3)) == 2) ||
+                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] & 0x1)) == 1))
             {
                 zLowWall = 1 + covered;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
             if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                 (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].data & 0x3)) == 3) ||
-                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].data & 0x1)) == 1))
+                ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] & 0x3)) == 3) ||
+                ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] & 0x1)) == 1))
             {
                 zHighWall = 1 + covered;
             }
@@ -5500,18 +6014,18 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             // Rules: iron/panes/walls/fences and fence gates directly above
             if (!covered) {
                 bool upper_matches = true;
-                neighborType = gBoxData[boxIndex + 1].origType; // above
+                neighborType = gBoxOrigType[boxIndex + 1]; // above
 
                 // OK, is it a wall above?
                 if (neighborType == BLOCK_COBBLESTONE_WALL) {
                     // yes, so check all connections (similar to earlier code) to see how these walls *above* are connected.
                     // If they connect exactly the same, then there's no post.
-                    neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X] + 1].origType;
+                    neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X] + 1];
                     if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                         (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                         (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].data & 0x3)) == 0) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].data & 0x1)) == 0))
+                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] & 0x3)) == 0) ||
+                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] & 0x1)) == 0))
                     {
                         if (xLowWall) {
                             xLowWall += 1.0f;   // now covered after all
@@ -5526,12 +6040,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                         }
                     }
 
-                    neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X] + 1].origType;
+                    neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X] + 1];
                     if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                         (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                         (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].data & 0x3)) == 1) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].data & 0x1)) == 0))
+                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] & 0x3)) == 1) ||
+                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] & 0x1)) == 0))
                     {
                         if (xHighWall) {
                             xHighWall += 1.0f;   // now covered after all
@@ -5545,12 +6059,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                             upper_matches = false;
                         }
                     }
-                    neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z] + 1].origType;
+                    neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z] + 1];
                     if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                         (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                         (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].data & 0x3)) == 2) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].data & 0x1)) == 1))
+                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] & 0x3)) == 2) ||
+                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] & 0x1)) == 1))
                     {
                         if (zLowWall) {
                             zLowWall += 1.0f;   // now covered after all
@@ -5564,12 +6078,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                             upper_matches = false;
                         }
                     }
-                    neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z] + 1].origType;
+                    neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z] + 1];
                     if ((neighborType == BLOCK_COBBLESTONE_WALL) || (gBlockDefinitions[neighborType].flags & BLF_FENCE_NEIGHBOR) ||
                         (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS) ||
                         (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].data & 0x3)) == 3) ||
-                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].data & 0x1)) == 1))
+                        ((gBlockDefinitions[neighborType].flags & BLF_STAIRS) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] & 0x3)) == 3) ||
+                        ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && ((gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] & 0x1)) == 1))
                     {
                         if (zHighWall) {
                             zHighWall += 1.0f;   // now covered after all
@@ -5587,7 +6101,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 else if ((neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || (neighborType == BLOCK_IRON_BARS)) {
                     if (gIs13orNewer && neighborType != BLOCK_STAINED_GLASS_PANE) {
                         // easy and dependable - neighbors marked by bits 0-3
-                        dataVal = gBoxData[boxIndex + 1].data;
+                        dataVal = gBoxDataVal[boxIndex + 1];
                         if (dataVal & 0x2)
                         {
                             if (xLowWall) {
@@ -5648,7 +6162,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                     else {
                         // which neighboring blocks have something that attaches to a glass pane? Things that attach:
                         // whole blocks, glass panes, iron bars, walls
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
                         if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                             (neighborType == BLOCK_COBBLESTONE_WALL) ||
                             (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -5667,7 +6181,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                             }
                         }
 
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X] + 1].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X] + 1];
                         if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                             (neighborType == BLOCK_COBBLESTONE_WALL) ||
                             (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -5685,7 +6199,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                                 upper_matches = false;
                             }
                         }
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z] + 1].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z] + 1];
                         if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                             (neighborType == BLOCK_COBBLESTONE_WALL) ||
                             (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -5703,7 +6217,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                                 upper_matches = false;
                             }
                         }
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z] + 1].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z] + 1];
                         if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                             (neighborType == BLOCK_COBBLESTONE_WALL) ||
                             (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -5782,9 +6296,9 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                         }
                     }
                 }
-                else if ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && !(gBoxData[boxIndex + 1].data & 0x4)) {
+                else if ((gBlockDefinitions[neighborType].flags & BLF_FENCE_GATE) && !(gBoxDataVal[boxIndex + 1] & 0x4)) {
                     // if fence gate is overhead and not open (weirdly, when the gate closes, the wall below is covered), it covers EW or NS, odd or even
-                    if (gBoxData[boxIndex + 1].data & 0x1) {
+                    if (gBoxDataVal[boxIndex + 1] & 0x1) {
                         if (zLowWall) {
                             zLowWall += 1.0f;   // now covered after all
                         }
@@ -5862,28 +6376,28 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             if (xLowWall > 0.0f) {
                 // this wall connects to the neighboring block, so output the wall piece
                 // if the neighbor is transparent, or a different type, or individual blocks are made, we'll output the face facing the neighbor (important if we connect to a fence, for example)
-                neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+                neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
                 transNeighbor = (gBlockDefinitions[neighborType].flags & BLF_TRANSPARENT) || individualBlocks || (type != neighborType) || (xLowWall == 2.0f);
                 saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc, firstFace, (gModel.print3D ? 0x0 : DIR_HI_X_BIT) | (transNeighbor ? 0x0 : DIR_LO_X_BIT), 0, 8 - hasPost * 4, 0, 12 + xLowWall * 2, 5, 11);
                 firstFace = 0;
             }
             if (xHighWall > 0.0f) {
                 // this wall connects to the neighboring block, so output the wall piece
-                neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+                neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
                 transNeighbor = (gBlockDefinitions[neighborType].flags & BLF_TRANSPARENT) || individualBlocks || (type != neighborType) || (xHighWall == 2.0f);
                 saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc, firstFace, (gModel.print3D ? 0x0 : DIR_LO_X_BIT) | (transNeighbor ? 0x0 : DIR_HI_X_BIT), 8 + hasPost * 4, 16, 0, 12 + xHighWall * 2, 5, 11);
                 firstFace = 0;
             }
             if (zLowWall > 0.0f) {
                 // this wall connects to the neighboring block, so output the wall piece
-                neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+                neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
                 transNeighbor = (gBlockDefinitions[neighborType].flags & BLF_TRANSPARENT) || individualBlocks || (type != neighborType) || (zLowWall == 2.0f);
                 saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc, firstFace, (gModel.print3D ? 0x0 : DIR_HI_Z_BIT) | (transNeighbor ? 0x0 : DIR_LO_Z_BIT), 5, 11, 0, 12 + zLowWall * 2, 0, 8 - hasPost * 4);
                 firstFace = 0;
             }
             if (zHighWall > 0.0f) {
                 // this wall connects to the neighboring block, so output the wall piece
-                neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+                neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
                 transNeighbor = (gBlockDefinitions[neighborType].flags & BLF_TRANSPARENT) || individualBlocks || (type != neighborType) || (zHighWall == 2.0f);
                 saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc, firstFace, (gModel.print3D ? 0x0 : DIR_LO_Z_BIT) | (transNeighbor ? 0x0 : DIR_HI_Z_BIT), 5, 11, 0, 12 + zHighWall * 2, 8 + hasPost * 4, 16);
                 firstFace = 0;	// not necessary, but for safety in case new code is added below  // cppcheck-suppress 563
@@ -5901,7 +6415,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & BIT_32) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_TOP]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_TOP]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType)) ? 16.0f : 13.0f;
         //tricky: when extended, cap it only if 3D printing and the neighbor is NOT the same type; i.e. we want caps when it's a flower or end stone.
@@ -5914,7 +6428,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & BIT_16) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_BOTTOM]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_BOTTOM]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType) || (BLOCK_END_STONE == neighborType)) ? 0.0f : 3.0f;
         saveBoxGeometry(boxIndex, type, dataVal, 0, (((!gModel.print3D && (newHeight == 0)) || (type == neighborType)) ? DIR_BOTTOM_BIT : 0x0) | DIR_TOP_BIT, 4, 12, newHeight, 4, 4, 12);
@@ -5943,7 +6457,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & 0x2) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType)) ? 0.0f : 3.0f;
         // four cases:
@@ -5972,7 +6486,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & 0x8) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType)) ? 16.0f : 13.0f;
         if (newHeight == 13.0f) {
@@ -5996,7 +6510,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & 0x4) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType)) ? 0.0f : 3.0f;
         // four cases:
@@ -6025,7 +6539,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             neighborType = (dataVal & 0x1) ? type : 0;
         }
         else {
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
         }
         newHeight = ((type == neighborType) || (BLOCK_CHORUS_FLOWER == neighborType)) ? 16.0f : 13.0f;
         if (newHeight == 13.0f) {
@@ -6105,7 +6619,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         // (ALMOST) SAME AS CODE IN NEXT case BLOCK:
         // if printing and the location below the plate is empty, then don't make plate (it'll be too thin)
         if (gModel.print3D &&
-            (gBoxData[boxIndex - 1].origType == BLOCK_AIR))
+            (gBoxOrigType[boxIndex - 1] == BLOCK_AIR))
         {
             gMinorBlockCount--;
             return 0;
@@ -6127,7 +6641,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
     case BLOCK_WEIGHTED_PRESSURE_PLATE_HEAVY:
         // if printing and the location below the plate is empty, then don't make plate (it'll be too thin)
         if (gModel.print3D &&
-            (gBoxData[boxIndex - 1].origType == BLOCK_AIR))
+            (gBoxOrigType[boxIndex - 1] == BLOCK_AIR))
         {
             gMinorBlockCount--;
             return 0;
@@ -6147,7 +6661,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
     case BLOCK_CARPET:						// saveBillboardOrGeometry
         // if printing and the location below the carpet is empty, then don't make carpet (it'll be too thin)
         if (gModel.print3D &&
-            (gBoxData[boxIndex - 1].origType == BLOCK_AIR))
+            (gBoxOrigType[boxIndex - 1] == BLOCK_AIR))
         {
             gMinorBlockCount--;
             return 0;
@@ -6173,7 +6687,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         if (dataVal & 0x1) {
             // process bottom
             if (gModel.print3D &&
-                (gBoxData[boxIndex - 1].origType == BLOCK_AIR))
+                (gBoxOrigType[boxIndex - 1] == BLOCK_AIR))
             {
                 // ignore floating thin carpet, definitely can't output that for 3d printing
                 gMinorBlockCount--;
@@ -6195,28 +6709,28 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 switch (i) {
                 case 0:
                     // north
-                    if (dv2 || (gBoxData[boxIndex - gBoxSize[Y]].type == BLOCK_AMETHYST && (gBoxData[boxIndex - gBoxSize[Y]].data & 0x7f) == 60)) {
+                    if (dv2 || (gBoxType[boxIndex - gBoxSize[Y]] == BLOCK_AMETHYST && (gBoxDataVal[boxIndex - gBoxSize[Y]] & 0x7f) == 60)) {
                         saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc + dv2 + 1, firstFace, DIR_BOTTOM_BIT | DIR_LO_X_BIT | DIR_HI_X_BIT | DIR_LO_Z_BIT | DIR_TOP_BIT, 0, 16, 0, 16, 0.25f, 0.25f);
                         firstFace = 0;
                     }
                     break;
                 case 1:
                     // east
-                    if (dv2 || (gBoxData[boxIndex + gBoxSizeYZ].type == BLOCK_AMETHYST && (gBoxData[boxIndex + gBoxSizeYZ].data & 0x7f) == 60)) {
+                    if (dv2 || (gBoxType[boxIndex + gBoxSizeYZ] == BLOCK_AMETHYST && (gBoxDataVal[boxIndex + gBoxSizeYZ] & 0x7f) == 60)) {
                         saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc + dv2 + 1, firstFace, DIR_BOTTOM_BIT | DIR_HI_X_BIT | DIR_LO_Z_BIT | DIR_HI_Z_BIT | DIR_TOP_BIT, 16 - 0.25f, 16 - 0.25f, 0, 16, 0, 16);
                         firstFace = 0;
                     }
                     break;
                 case 2:
                     // south
-                    if (dv2 || (gBoxData[boxIndex + gBoxSize[Y]].type == BLOCK_AMETHYST && (gBoxData[boxIndex + gBoxSize[Y]].data & 0x7f) == 60)) {
+                    if (dv2 || (gBoxType[boxIndex + gBoxSize[Y]] == BLOCK_AMETHYST && (gBoxDataVal[boxIndex + gBoxSize[Y]] & 0x7f) == 60)) {
                         saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc + dv2 + 1, firstFace, DIR_BOTTOM_BIT | DIR_LO_X_BIT | DIR_HI_X_BIT | DIR_HI_Z_BIT | DIR_TOP_BIT, 0, 16, 0, 16, 16 - 0.25f, 16 - 0.25f);
                         firstFace = 0;
                     }
                     break;
                 case 3:
                     // west
-                    if (dv2 || (gBoxData[boxIndex - gBoxSizeYZ].type == BLOCK_AMETHYST && (gBoxData[boxIndex - gBoxSizeYZ].data & 0x7f) == 60)) {
+                    if (dv2 || (gBoxType[boxIndex - gBoxSizeYZ] == BLOCK_AMETHYST && (gBoxDataVal[boxIndex - gBoxSizeYZ] & 0x7f) == 60)) {
                         saveBoxTileGeometry(boxIndex, type, dataVal, swatchLoc + dv2 + 1, firstFace, DIR_BOTTOM_BIT | DIR_LO_X_BIT | DIR_LO_Z_BIT | DIR_HI_Z_BIT | DIR_TOP_BIT, 0.25f, 0.25f, 0, 16, 0, 16);
                         firstFace = 0;
                     }
@@ -6402,10 +6916,10 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                     if (northSouth) {
                         // Goes north-south.
                         // Check north neighbor.
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
                         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS) {
                             // northern neighbor is stairs
-                            neighborData = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].data;
+                            neighborData = gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
                             if (neighborData == dataVal) {
                                 // the data values match - but, do the stair masks match?
                                 if (getStairMask(boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z], neighborData) == origStepMask) {
@@ -6415,10 +6929,10 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                             }
                         }
                         // Check south neighbor.
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
                         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS) {
                             // southern neighbor is stairs
-                            neighborData = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].data;
+                            neighborData = gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
                             if (neighborData == dataVal) {
                                 // the data values match - but, do the stair masks match?
                                 if (getStairMask(boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z], neighborData) == origStepMask) {
@@ -6431,10 +6945,10 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                     else {
                         // Goes east-west
                         // Check west neighbor.
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
                         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS) {
                             // western neighbor is stairs
-                            neighborData = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].data;
+                            neighborData = gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
                             if (neighborData == dataVal) {
                                 // the data values match - but, do the stair masks match?
                                 if (getStairMask(boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X], neighborData) == origStepMask) {
@@ -6444,10 +6958,10 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                             }
                         }
                         // Check east neighbor.
-                        neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+                        neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
                         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS) {
                             // eastern neighbor is stairs
-                            neighborData = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].data;
+                            neighborData = gBoxDataVal[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
                             if (neighborData == dataVal) {
                                 // the data values match - but, do the stair masks match?
                                 if (getStairMask(boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X], neighborData) == origStepMask) {
@@ -7434,7 +7948,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         //{
         //	// if printing, and door is down, check if there's air below.
         //	// if so, don't print it! Too thin.
-        //	if ( gBoxData[boxIndex-1].type == BLOCK_AIR)
+        //	if ( gBoxType[boxIndex-1] == BLOCK_AIR)
         //		return 0;
         //}
         gUsingTransform = 1;
@@ -7742,13 +8256,13 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             // get bottom dataVal - if bottom of door is cut off, this will be 0 and door will be wrong
             // (who cares, it's half a door)
             topDataVal = dataVal;
-            bottomDataVal = gBoxData[boxIndex - 1].data;
+            bottomDataVal = gBoxDataVal[boxIndex - 1];
         }
         else
         {
             // bottom of door - switch to that for sides
             swatchLoc = bottomSwatchLoc;
-            topDataVal = gBoxData[boxIndex + 1].data;
+            topDataVal = gBoxDataVal[boxIndex + 1];
             bottomDataVal = dataVal;
         }
 
@@ -7827,7 +8341,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         // This should only happen if the snow is at the lowest level, which means that the object below would
         // not exist. In this case, we check "type" and not "origType", as origType may well exist due to reading it in.
         if (gModel.print3D &&
-            ((gBoxData[boxIndex - 1].origType == BLOCK_AIR) || (gBoxData[boxIndex - 1].type == BLOCK_AIR)))
+            ((gBoxOrigType[boxIndex - 1] == BLOCK_AIR) || (gBoxType[boxIndex - 1] == BLOCK_AIR)))
         {
             gMinorBlockCount--;
             return 0;
@@ -7903,7 +8417,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         if (gModel.print3D)
         {
             // if we're print, and there is something above this farmland, don't shift the farmland down (it would just make a gap)
-            if (gBoxData[boxIndex + 1].origType != BLOCK_AIR)
+            if (gBoxOrigType[boxIndex + 1] != BLOCK_AIR)
             {
                 gMinorBlockCount--;
                 return 0;
@@ -8034,11 +8548,11 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 if (dataVal & 0x1)
                 {
                     // open west/east
-                    shiftGate = (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType == BLOCK_COBBLESTONE_WALL) || (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType == BLOCK_COBBLESTONE_WALL);
+                    shiftGate = (gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] == BLOCK_COBBLESTONE_WALL) || (gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] == BLOCK_COBBLESTONE_WALL);
                 }
                 else {
                     // open north/south
-                    shiftGate = (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType == BLOCK_COBBLESTONE_WALL) || (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType == BLOCK_COBBLESTONE_WALL);
+                    shiftGate = (gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] == BLOCK_COBBLESTONE_WALL) || (gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] == BLOCK_COBBLESTONE_WALL);
                 }
             }
             if (shiftGate)
@@ -8689,9 +9203,9 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         individualBlocks = (gModel.options->exportFlags & EXPT_INDIVIDUAL_BLOCKS);
 
         faceMask = 0x0;
-        if ((gBoxData[boxIndex + 1].origType == BLOCK_CACTUS) && !individualBlocks)
+        if ((gBoxOrigType[boxIndex + 1] == BLOCK_CACTUS) && !individualBlocks)
             faceMask |= DIR_TOP_BIT;
-        if ((gBoxData[boxIndex - 1].origType == BLOCK_CACTUS) && !individualBlocks)
+        if ((gBoxOrigType[boxIndex - 1] == BLOCK_CACTUS) && !individualBlocks)
             faceMask |= DIR_BOTTOM_BIT;
         // remember that this gives the top of the block:
         swatchLoc = SWATCH_INDEX(gBlockDefinitions[type].txrX, gBlockDefinitions[type].txrY);
@@ -8765,12 +9279,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 // in the world, but you can't see or interact with the chests.
             case 2: // facing north
                 // is neighbor to west also a chest?
-                if (gBoxData[boxIndex - gBoxSizeYZ].origType == type)
+                if (gBoxOrigType[boxIndex - gBoxSizeYZ] == type)
                 {
                     chestType = 1;
                     neighborIndex = -gBoxSizeYZ;
                 }
-                else if (gBoxData[boxIndex + gBoxSizeYZ].origType == type)
+                else if (gBoxOrigType[boxIndex + gBoxSizeYZ] == type)
                 {
                     chestType = 2;
                     neighborIndex = gBoxSizeYZ;
@@ -8779,13 +9293,13 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 break;
             case 3: // facing south
                 // is neighbor to east also a chest?
-                if (gBoxData[boxIndex + gBoxSizeYZ].origType == type)
+                if (gBoxOrigType[boxIndex + gBoxSizeYZ] == type)
                 {
                     chestType = 1;
                     neighborIndex = gBoxSizeYZ;
                 }
                 // else, is neighbor to west also a chest?
-                else if (gBoxData[boxIndex - gBoxSizeYZ].origType == type)
+                else if (gBoxOrigType[boxIndex - gBoxSizeYZ] == type)
                 {
                     chestType = 2;
                     neighborIndex = -gBoxSizeYZ;
@@ -8793,12 +9307,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 angle = 0;
                 break;
             case 4: // facing west
-                if (gBoxData[boxIndex - gBoxSize[Y]].origType == type)
+                if (gBoxOrigType[boxIndex - gBoxSize[Y]] == type)
                 {
                     chestType = 2;
                     neighborIndex = -gBoxSize[Y];
                 }
-                else if (gBoxData[boxIndex + gBoxSize[Y]].origType == type)
+                else if (gBoxOrigType[boxIndex + gBoxSize[Y]] == type)
                 {
                     chestType = 1;
                     neighborIndex = gBoxSize[Y];
@@ -8806,12 +9320,12 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 angle = 90;
                 break;
             case 5: // facing east
-                if (gBoxData[boxIndex + gBoxSize[Y]].origType == type)
+                if (gBoxOrigType[boxIndex + gBoxSize[Y]] == type)
                 {
                     chestType = 2;
                     neighborIndex = gBoxSize[Y];
                 }
-                else if (gBoxData[boxIndex - gBoxSize[Y]].origType == type)
+                else if (gBoxOrigType[boxIndex - gBoxSize[Y]] == type)
                 {
                     chestType = 1;
                     neighborIndex = -gBoxSize[Y];
@@ -8939,7 +9453,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             }
             // Check if neighboring half of chest is actually there, and we're showing border faces.
             // If half of check is outside of the export area (type != origType, basically type == AIR), then faceMask here should be 0x0
-            if (gModel.options->pEFD->chkBlockFacesAtBorders && (gBoxData[boxIndex + neighborIndex].type == 0)) {
+            if (gModel.options->pEFD->chkBlockFacesAtBorders && (gBoxType[boxIndex + neighborIndex] == 0)) {
                 faceMask = 0x0;
             }
             else {
@@ -8980,7 +9494,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             }
             // Check if neighboring half of chest is actually there, and we're showing border faces.
             // If half of check is outside of the export area (type != origType, basically type == AIR), then faceMask here should be 0x0
-            if (gModel.options->pEFD->chkBlockFacesAtBorders && (gBoxData[boxIndex + neighborIndex].type == 0)) {
+            if (gModel.options->pEFD->chkBlockFacesAtBorders && (gBoxType[boxIndex + neighborIndex] == 0)) {
                 faceMask = 0x0;
             }
             else {
@@ -9385,7 +9899,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         default:
             assert(0);
         }
-        neighborType = gBoxData[boxIndex + gFaceOffset[dir]].origType;
+        neighborType = gBoxOrigType[boxIndex + gFaceOffset[dir]];
         assert((neighborType == BLOCK_PISTON_HEAD) || (neighborType == BLOCK_AIR));
 
         totalVertexCount = gModel.vertexCount;
@@ -9468,7 +9982,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             assert(0);
         }
         // look at neighboring piston block to know what kind of piston head we are.
-        neighborType = gBoxData[boxIndex + gFaceOffset[dir]].origType;
+        neighborType = gBoxOrigType[boxIndex + gFaceOffset[dir]];
         assert((neighborType == BLOCK_PISTON) || (neighborType == BLOCK_STICKY_PISTON) || (neighborType == BLOCK_AIR));
 
         totalVertexCount = gModel.vertexCount;
@@ -9784,7 +10298,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         else {
             // which neighboring blocks have something that attaches to a glass pane? Things that attach:
             // whole blocks, glass panes, iron bars, walls
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
             if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                 (neighborType == BLOCK_COBBLESTONE_WALL) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -9794,7 +10308,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 filled |= 0x1;
                 faceMask |= DIR_LO_Z_BIT;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
             if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                 (neighborType == BLOCK_COBBLESTONE_WALL) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -9804,7 +10318,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 filled |= 0x2;
                 faceMask |= DIR_HI_X_BIT;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
             if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                 (neighborType == BLOCK_COBBLESTONE_WALL) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -9814,7 +10328,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
                 filled |= 0x4;
                 faceMask |= DIR_HI_Z_BIT;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
             if ((neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) ||
                 (neighborType == BLOCK_COBBLESTONE_WALL) ||
                 (neighborType == BLOCK_COPPER_BARS) || (neighborType == BLOCK_WAXED_COPPER_BARS) ||
@@ -9827,7 +10341,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         }
 
         // in 1.9 addition of posts made glass and bars merge differently
-        //neighborType = gBoxData[boxIndex+gFaceOffset[DIRECTION_BLOCK_BOTTOM]].origType;
+        //neighborType = gBoxOrigType[boxIndex+gFaceOffset[DIRECTION_BLOCK_BOTTOM]];
         //if ( (neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || 
         //    (gBlockDefinitions[neighborType].flags & BLF_WHOLE) )
         //{
@@ -9836,7 +10350,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         //    tbFaceMask |= DIR_BOTTOM_BIT;
         //}
 
-        //neighborType = gBoxData[boxIndex+gFaceOffset[DIRECTION_BLOCK_TOP]].origType;
+        //neighborType = gBoxOrigType[boxIndex+gFaceOffset[DIRECTION_BLOCK_TOP]];
         //if ( (neighborType == BLOCK_IRON_BARS) || (neighborType == BLOCK_GLASS_PANE) || (neighborType == BLOCK_STAINED_GLASS_PANE) || 
         //    (gBlockDefinitions[neighborType].flags & BLF_WHOLE) )
         //{
@@ -11367,19 +11881,19 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
             // north/south?
             int ns = 0;
             int ew = 0;
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]];
             if ((neighborType == BLOCK_NETHER_PORTAL) || (neighborType == BLOCK_OBSIDIAN)) {
                 ew += (neighborType == BLOCK_NETHER_PORTAL) ? 10 : 1;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]];
             if ((neighborType == BLOCK_NETHER_PORTAL) || (neighborType == BLOCK_OBSIDIAN)) {
                 ew += (neighborType == BLOCK_NETHER_PORTAL) ? 10 : 1;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]];
             if ((neighborType == BLOCK_NETHER_PORTAL) || (neighborType == BLOCK_OBSIDIAN)) {
                 ns += (neighborType == BLOCK_NETHER_PORTAL) ? 10 : 1;
             }
-            neighborType = gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].origType;
+            neighborType = gBoxOrigType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]];
             if ((neighborType == BLOCK_NETHER_PORTAL) || (neighborType == BLOCK_OBSIDIAN)) {
                 ns += (neighborType == BLOCK_NETHER_PORTAL) ? 10 : 1;
             }
@@ -11827,7 +12341,7 @@ static int saveBillboardOrGeometry(int boxIndex, int type)
         saveBoxMultitileGeometry(boxIndex, type, dataVal, swatchLoc+3, swatchLoc, swatchLoc+4, 1, 0x0, 0x0, 1, 15, 0, 16, 1, 15);
 
         // the top of the decorated pot goes into the cube above. If that cube is solid and opaque OR 3d printing is in use, don't make the pot top, since it will be hidden.
-        if (!(gBlockDefinitions[gBoxData[boxIndex + 1].type].flags & BLF_WHOLE) || (!gModel.print3D && (gBlockDefinitions[gBoxData[boxIndex + 1].type].flags & (BLF_TRANSPARENT | BLF_CUTOUTS | BLF_LEAF_PART)))) {
+        if (!(gBlockDefinitions[gBoxType[boxIndex + 1]].flags & BLF_WHOLE) || (!gModel.print3D && (gBlockDefinitions[gBoxType[boxIndex + 1]].flags & (BLF_TRANSPARENT | BLF_CUTOUTS | BLF_LEAF_PART)))) {
             // output the top, since it's visible
             gUsingTransform = 1;
             totalVertexCount = gModel.vertexCount;
@@ -12809,12 +13323,12 @@ static unsigned int getStairMask(int boxIndex, int dataVal)
             return 0x0;
         }
         //int neighborIndex = boxIndex + gFaceOffset[stairs[stepDir].backDir];
-        int neighborType = gBoxData[neighborIndex].origType;
+        int neighborType = gBoxOrigType[neighborIndex];
         bool subtractedBlock = false;
         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS)
         {
             // get the data value and check it
-            neighborDataVal = gBoxData[neighborIndex].data;
+            neighborDataVal = gBoxDataVal[neighborIndex];
 
             // first, are slabs on same level?
             if ((neighborDataVal & 0x4) == stepLevel)
@@ -12833,12 +13347,12 @@ static unsigned int getStairMask(int boxIndex, int dataVal)
                         return 0x0;
                     }
                     assert(neighborIndex != boxIndex);
-                    neighborType = gBoxData[neighborIndex].origType;
+                    neighborType = gBoxOrigType[neighborIndex];
                     // is there a stairs to the key side of us?
                     if (gBlockDefinitions[neighborType].flags & BLF_STAIRS)
                     {
                         // get the data value and check it
-                        neighborDataVal = gBoxData[neighborIndex].data;
+                        neighborDataVal = gBoxDataVal[neighborIndex];
 
                         // first, are slabs on same level?
                         if ((neighborDataVal & 0x4) == stepLevel)
@@ -12872,12 +13386,12 @@ static unsigned int getStairMask(int boxIndex, int dataVal)
             if (badNeighborTest(neighborIndex, boxIndex, (stairs[stepDir].backDir + 3) % 6)) {
                 return 0x0;
             }
-            neighborType = gBoxData[neighborIndex].origType;
+            neighborType = gBoxOrigType[neighborIndex];
             // is there a stairs in front of us?
             if (gBlockDefinitions[neighborType].flags & BLF_STAIRS)
             {
                 // get the data value and check it
-                neighborDataVal = gBoxData[neighborIndex].data;
+                neighborDataVal = gBoxDataVal[neighborIndex];
 
                 // first, are slabs on same level?
                 if ((neighborDataVal & 0x4) == stepLevel)
@@ -12896,12 +13410,12 @@ static unsigned int getStairMask(int boxIndex, int dataVal)
                         }
                         //neighborIndex = boxIndex + gFaceOffset[(stairs[stepDir].sideDir[(neighborDataVal & 0x3)] + 3) % 6];
                         assert(neighborIndex != boxIndex);
-                        neighborType = gBoxData[neighborIndex].origType;
+                        neighborType = gBoxOrigType[neighborIndex];
                         // is there a stairs to the key side of us?
                         if (gBlockDefinitions[neighborType].flags & BLF_STAIRS)
                         {
                             // get the data value and check it
-                            neighborDataVal = gBoxData[neighborIndex].data;
+                            neighborDataVal = gBoxDataVal[neighborIndex];
 
                             // first, are slabs on same level?
                             if ((neighborDataVal & 0x4) == stepLevel)
@@ -13544,42 +14058,42 @@ static int saveBoxAlltileGeometry(int boxIndex, int type, int dataVal, int swatc
 
                 // check flattening flags
                 int special = 0;
-                if (gBoxData[boxIndex].flatFlags)
+                if (gBoxFlatFlags[boxIndex])
                 {
                     switch (faceDirection)
                     {
                     case DIRECTION_BLOCK_TOP:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_ABOVE)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_ABOVE)
                         {
                             special = 1;
                         }
                         break;
                     case DIRECTION_BLOCK_BOTTOM:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_BELOW)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_BELOW)
                         {
                             special = 1;
                         }
                         break;
                     case DIRECTION_BLOCK_SIDE_LO_X:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_LO_X)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_LO_X)
                         {
                             special = 1;
                         }
                         break;
                     case DIRECTION_BLOCK_SIDE_HI_X:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_HI_X)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_HI_X)
                         {
                             special = 1;
                         }
                         break;
                     case DIRECTION_BLOCK_SIDE_LO_Z:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_LO_Z)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_LO_Z)
                         {
                             special = 1;
                         }
                         break;
                     case DIRECTION_BLOCK_SIDE_HI_Z:
-                        if (gBoxData[boxIndex].flatFlags & FLAT_FACE_HI_Z)
+                        if (gBoxFlatFlags[boxIndex] & FLAT_FACE_HI_Z)
                         {
                             special = 1;
                         }
@@ -13719,7 +14233,7 @@ static int lesserNeighborCoversRectangle(int faceDirection, int boxIndex, float
     neighborBoxIndex = boxIndex + gFaceOffset[faceDirection];
     // old comment: in this case we use the actual type (not origType), since we're checking coverage
     // But that is wrong for, say, snow, where the type gets set to 0 after its output and so can't be used to tell what disappears.
-    neighborType = gBoxData[neighborBoxIndex].origType;
+    neighborType = gBoxOrigType[neighborBoxIndex];
     // super-quick out: is neighbor air? Common enough case, let's test for it.
     if (neighborType == BLOCK_AIR)
         return 0;
@@ -13771,7 +14285,7 @@ static int lesserNeighborCoversRectangle(int faceDirection, int boxIndex, float
 
     // check for easy case: if neighbor is a full block, neighbor covers all, so return 1
     // (or, for printing, return 1 if the block being covered *exactly* matches)
-    type = gBoxData[boxIndex].type;
+    type = gBoxType[boxIndex];
     if (gBlockDefinitions[neighborType].flags & BLF_WHOLE)
     {
         // special cases for viewing (rendering), having to do with semitransparency or cutouts
@@ -13907,11 +14421,11 @@ static int getFaceRect(int faceDirection, int boxIndex, int view3D, float faceRe
         (faceDirection != DIRECTION_BLOCK_TOP))
     {
         // we have partial blocks possible. Check if neighbor's original type exists at all
-        int origType = gBoxData[boxIndex].origType;
+        int origType = gBoxOrigType[boxIndex];
         // not air?
         if (origType > BLOCK_AIR)
         {
-            int dataVal = gBoxData[boxIndex].data;
+            int dataVal = gBoxDataVal[boxIndex];
             float setBottom = 0;
             // The idea here is that setTop is set by the various minor blocks below
             float setTop = 0;
@@ -14233,7 +14747,7 @@ static int saveBoxFaceUVs(int type, int dataVal, int faceDirection, int markFirs
 // 3) for each face, set the loop, the vertex indices, the normal indices (really, just face direction), and the texture indices
 static int saveBillboardFaces(int boxIndex, int type, int billboardType)
 {
-    return saveBillboardFacesExtraData(boxIndex, type, billboardType, gBoxData[boxIndex].data, 1, false);
+    return saveBillboardFacesExtraData(boxIndex, type, billboardType, gBoxDataVal[boxIndex], 1, false);
 }
 
 static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType, int dataVal, int firstFace, bool dontWobbleOverride /*= false*/)
@@ -14483,10 +14997,10 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
             // fully mature, change height to 10 if the proper fruit is next door
             matchType = (type == BLOCK_PUMPKIN_STEM) ? BLOCK_PUMPKIN : BLOCK_MELON;
             if ((dataVal & 0x8) ||  // the new way - if there's an attachment, https://minecraft.wiki/w/Pumpkin_Seeds#Metadata
-                (gBoxData[boxIndex - gBoxSizeYZ].origType == matchType) ||
-                (gBoxData[boxIndex + gBoxSizeYZ].origType == matchType) ||
-                (gBoxData[boxIndex - gBoxSize[Y]].origType == matchType) ||
-                (gBoxData[boxIndex + gBoxSize[Y]].origType == matchType)) {
+                (gBoxOrigType[boxIndex - gBoxSizeYZ] == matchType) ||
+                (gBoxOrigType[boxIndex + gBoxSizeYZ] == matchType) ||
+                (gBoxOrigType[boxIndex - gBoxSize[Y]] == matchType) ||
+                (gBoxOrigType[boxIndex + gBoxSize[Y]] == matchType)) {
                 height = -9.0 / 16.0f;
             }
         }
@@ -14569,7 +15083,7 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
         else {
             // full check: is dataVal == 0 (means only a vine above) or is there a solid block above?
             // Note that the solid block must actually exist, vs. "origType"
-            if ((dataVal == 0) || (dataVal == BIT_16) || (dataVal == BIT_32) || (gBlockDefinitions[gBoxData[boxIndex + 1].type].flags & BLF_WHOLE)) {
+            if ((dataVal == 0) || (dataVal == BIT_16) || (dataVal == BIT_32) || (gBlockDefinitions[gBoxType[boxIndex + 1]].flags & BLF_WHOLE)) {
                 vineUnderBlock = true;
             }
         }
@@ -14727,10 +15241,10 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
                 // row 19 (#18) has these
                 // old code, before we shoved the dataVal from the bottom half (if available) into the top half (around line 2812), in extractChunk.
                 // But, should work the same, so don't mess with it.
-                swatchLoc = SWATCH_INDEX(gBoxData[boxIndex - 1].data * 2 + 3, 18);
+                swatchLoc = SWATCH_INDEX(gBoxDataVal[boxIndex - 1] * 2 + 3, 18);
                 // for material differentiation set the dataVal to the bottom half
-                origDataVal = gBoxData[boxIndex - 1].data;
-                if (gBoxData[boxIndex - 1].data == 0)
+                origDataVal = gBoxDataVal[boxIndex - 1];
+                if (gBoxDataVal[boxIndex - 1] == 0)
                 {
                     foundSunflowerTop = 1;
                 }
@@ -14749,7 +15263,7 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
             // top half of plant
             swatchLoc = SWATCH_INDEX(15, 33);
             // for material differentiation set the dataVal to the bottom half
-            origDataVal = gBoxData[boxIndex - 1].data;
+            origDataVal = gBoxDataVal[boxIndex - 1];
         }
         //else
         //{
@@ -14764,7 +15278,7 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
             // use short half of plant - twisting vines?
             swatchLoc = (dataVal & 0x1) ? swatchLoc + 15 : swatchLoc - 1;
             // for material differentiation set the dataVal to the bottom half
-            origDataVal = gBoxData[boxIndex - 1].data;
+            origDataVal = gBoxDataVal[boxIndex - 1];
         }
         else {
             // full plant; is it twisting vines or hanging roots instead?
@@ -14850,9 +15364,9 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
             // get neighbor's flatFlags in that direction.
             int neighborBoxIndex = boxIndex + gFaceOffset[faceDirection];
             // is the corresponding flag set to point at the redstone?
-            if (gBoxData[neighborBoxIndex].flatFlags & gFlagPointsTo[faceDirection]) {
+            if (gBoxFlatFlags[neighborBoxIndex] & gFlagPointsTo[faceDirection]) {
                 // yes it is - clear flat flag, and output redstone
-                gBoxData[neighborBoxIndex].flatFlags &= ~gFlagPointsTo[faceDirection];
+                gBoxFlatFlags[neighborBoxIndex] &= ~gFlagPointsTo[faceDirection];
 
                 // direction of neighbor
                 switch (faceDirection)
@@ -15804,7 +16318,7 @@ static int saveBillboardFacesExtraData(int boxIndex, int type, int billboardType
 
     // special case:
     // for vines, return 0 (flatten to face) if there is a block above it
-    if (CHECK_COMPOSITE_OVERLAY && (billboardType == BB_SIDE) && (gBlockDefinitions[gBoxData[boxIndex + 1].type].flags & BLF_WHOLE))
+    if (CHECK_COMPOSITE_OVERLAY && (billboardType == BB_SIDE) && (gBlockDefinitions[gBoxType[boxIndex + 1]].flags & BLF_WHOLE))
     {
         return 0;
     }
@@ -15907,54 +16421,63 @@ static int findGroups()
     // We test *all* cells, including surrounding air, for connectivity to others. The idea here is to have the surrounding air group
     // be created first, and find all connecting air. Note that the tunnel sealing, above, will stop this percolation of air along the sides and
     // bottom, as those cells will already have a group.
-    for (loc[X] = gAirBox.min[X]; loc[X] <= gAirBox.max[X]; loc[X]++)
+    // For 3D printing a cell's solidity is simply its type, so the groups can be found a column run at a time instead.
+    if (!gModel.print3D || !findGroupsByRuns(retCode))
     {
-        for (loc[Z] = gAirBox.min[Z]; loc[Z] <= gAirBox.max[Z]; loc[Z]++)
+        for (loc[X] = gAirBox.min[X]; loc[X] <= gAirBox.max[X]; loc[X]++)
         {
-            // IMPORTANT: Note that we start at the top and work down, as we want to ensure that outside air is the top group.
-            boxIndex = BOX_INDEX(loc[X], gAirBox.max[Y], loc[Z]);
-            for (loc[Y] = gAirBox.max[Y]; loc[Y] >= gAirBox.min[Y]; loc[Y]--, boxIndex--)
+            for (loc[Z] = gAirBox.min[Z]; loc[Z] <= gAirBox.max[Z]; loc[Z]++)
             {
-                // check if the object has no group
-                if (gBoxData[boxIndex].group == NO_GROUP_SET)
+                // IMPORTANT: Note that we start at the top and work down, as we want to ensure that outside air is the top group.
+                boxIndex = BOX_INDEX(loc[X], gAirBox.max[Y], loc[Z]);
+                for (loc[Y] = gAirBox.max[Y]; loc[Y] >= gAirBox.min[Y]; loc[Y]--, boxIndex--)
                 {
-                    gGroupCount++;
-                    retCode |= checkGroupListSize();
-                    if (retCode >= MW_BEGIN_ERRORS) return retCode;
+                    // check if the object has no group
+                    if (gBoxGroup[boxIndex] == NO_GROUP_SET)
+                    {
+                        gGroupCount++;
+                        retCode |= checkGroupListSize();
+                        if (retCode >= MW_BEGIN_ERRORS) return retCode;
 
-                    // no group, so make a new seed.
-                    // Note that group index 0 is not used at all.
-                    pGroup = &gGroupList[gGroupCount];
-                    pGroup->groupID = gGroupCount;
-                    pGroup->population = (gGroupCount == SURROUND_AIR_GROUP) ? pGroup->population + 1 : 1;   // the solid air group might already exist with a population
-                    // the solid air group will need to have its bounds fixed at the end if tunnel sealing is going on
-                    Vec2Op(pGroup->bounds.min, =, loc);
-                    Vec2Op(pGroup->bounds.max, =, loc);
-                    pGroup->solid = (gBoxData[boxIndex].type > BLOCK_AIR);
-
-                    gBoxData[boxIndex].group = gGroupCount;
-                    if (pGroup->solid)
-                        gSolidGroups++;
-                    else
-                        gAirGroups++;
-                    // propagate seed: make neighbors with same type (solid or air) and no group to be this group.
-                    propagateSeed(loc, pGroup, &seedStack, &seedSize, &seedCount);
+                        // no group, so make a new seed.
+                        // Note that group index 0 is not used at all.
+                        pGroup = &gGroupList[gGroupCount];
+                        pGroup->groupID = gGroupCount;
+                        pGroup->population = (gGroupCount == SURROUND_AIR_GROUP) ? pGroup->population + 1 : 1;   // the solid air group might already exist with a population
+                        // the solid air group will need to have its bounds fixed at the end if tunnel sealing is going on
+                        Vec2Op(pGroup->bounds.min, =, loc);
+                        Vec2Op(pGroup->bounds.max, =, loc);
+                        pGroup->solid = (gBoxType[boxIndex] > BLOCK_AIR);
+
+                        gBoxGroup[boxIndex] = gGroupCount;
+                        if (pGroup->solid)
+                            gSolidGroups++;
+                        else
+                            gAirGroups++;
+                        // propagate seed: make neighbors with same type (solid or air) and no group to be this group.
+                        propagateSeed(loc, pGroup, &seedStack, &seedSize, &seedCount);
 
-                    // When this is done, seedStack has a list of seeds that had no ID before and now have one.
-                    // Each of these seeds' neighbors needs to be tested .
+                        // When this is done, seedStack has a list of seeds that had no ID before and now have one.
+                        // Each of these seeds' neighbors needs to be tested .
 
-                    // while seedCount > 0, propagate
-                    while (seedCount > 0)
-                    {
-                        // copy test point over, so we don't trample it when seedStack gets increased
-                        seedCount--;
-                        Vec2Op(seedLoc, =, seedStack[seedCount]);
-                        propagateSeed(seedLoc, pGroup, &seedStack, &seedSize, &seedCount);
+                        // while seedCount > 0, propagate
+                        while (seedCount > 0)
+                        {
+                            // copy test point over, so we don't trample it when seedStack gets increased
+                            seedCount--;
+                            Vec2Op(seedLoc, =, seedStack[seedCount]);
+                            propagateSeed(seedLoc, pGroup, &seedStack, &seedSize, &seedCount);
+                        }
                     }
                 }
             }
         }
     }
+    else if (retCode >= MW_BEGIN_ERRORS)
+    {
+        free(seedStack);
+        return retCode;
+    }
 
     if (gModel.options->exportFlags & EXPT_SEAL_SIDE_TUNNELS)
     {
@@ -15968,6 +16491,206 @@ static int findGroups()
 }
 
 
+// Find the groups by splitting each column into runs of solid or air cells, linking each run to the runs it touches
+// in the neighboring column at -X and at -Z, then numbering the linked sets in the same order the seed-by-seed
+// flood fill in findGroups would find them: scan order of each set's first cell. Only valid when a cell's solidity
+// does not depend on the seed it's reached from, i.e., for 3D printing. Returns false, with cells left unset,
+// if there's not enough memory for the runs, so that the flood fill can be used instead.
+static bool findGroupsByRuns(int& retCode)
+{
+    int boxIndex, neighborIndex;
+    int run, prevRun, groupID, faceDirection;
+    IPoint loc, newPt;
+    BoxGroup* pGroup;
+    bool solid, entrance;
+    bool sealEntrances = (gModel.options->exportFlags & EXPT_SEAL_ENTRANCES) ? true : false;
+
+    // start with room for a couple of runs per column
+    int runCount = 0;
+    int runSize = 2 * (gAirBox.max[X] - gAirBox.min[X] + 1) * (gAirBox.max[Z] - gAirBox.min[Z] + 1);
+    GroupRun* runs = (GroupRun*)malloc(runSize * sizeof(GroupRun));
+    if (runs == NULL)
+        return false;
+
+    // First pass: make the runs and link touching runs of the same sort.
+    for (loc[X] = gAirBox.min[X]; loc[X] <= gAirBox.max[X]; loc[X]++)
+    {
+        for (loc[Z] = gAirBox.min[Z]; loc[Z] <= gAirBox.max[Z]; loc[Z]++)
+        {
+            prevRun = -1;
+            boxIndex = BOX_INDEX(loc[X], gAirBox.max[Y], loc[Z]);
+            for (loc[Y] = gAirBox.max[Y]; loc[Y] >= gAirBox.min[Y]; loc[Y]--, boxIndex--)
+            {
+                // cells already in a group (sealed sides) are not part of any run
+                if (gBoxGroup[boxIndex] != NO_GROUP_SET)
+                {
+                    prevRun = -1;
+                    continue;
+                }
+                solid = (gBoxType[boxIndex] > BLOCK_AIR);
+                // see propagateSeed: an entrance is added to a group, but the group does not spread past it
+                entrance = sealEntrances && !solid &&
+                    (gBlockDefinitions[gBoxOrigType[boxIndex]].flags & BLF_ENTRANCE) && notAirEdge(loc);
+
+                if (prevRun < 0 || entrance || runs[prevRun].entrance || runs[prevRun].solid != solid)
+                {
+                    if (runCount == runSize)
+                    {
+                        GroupRun* moreRuns;
+                        runSize = (int)(runSize * 1.4 + 1);
+                        moreRuns = (GroupRun*)realloc(runs, runSize * sizeof(GroupRun));
+                        if (moreRuns == NULL)
+                        {
+                            // put the cells back the way they were
+                            for (boxIndex = 0; boxIndex < gBoxSizeXYZ; boxIndex++)
+                            {
+                                if (gBoxGroup[boxIndex] < NO_GROUP_SET)
+                                    gBoxGroup[boxIndex] = NO_GROUP_SET;
+                            }
+                            free(runs);
+                            return false;
+                        }
+                        runs = moreRuns;
+                    }
+                    runs[runCount].parent = runCount;
+                    runs[runCount].groupID = NO_GROUP_SET;
+                    runs[runCount].boxIndex = boxIndex;
+                    runs[runCount].solid = solid;
+                    runs[runCount].entrance = entrance;
+                    prevRun = runCount++;
+                }
+                gBoxGroup[boxIndex] = RUN_GROUP_LABEL(prevRun);
+
+                if (!entrance)
+                {
+                    if (loc[X] > gAirBox.min[X])
+                        joinRuns(runs, prevRun, boxIndex - gBoxSizeYZ);
+                    if (loc[Z] > gAirBox.min[Z])
+                        joinRuns(runs, prevRun, boxIndex - gBoxSize[Y]);
+                }
+            }
+        }
+    }
+
+    // Second pass: make a group for each set of runs when its root, its earliest run, is reached. Runs are
+    // made in scan order, so groups get the same IDs as the flood fill gives them.
+    for (run = 0; run < runCount; run++)
+    {
+        groupID = NO_GROUP_SET;
+        if (runs[run].entrance)
+        {
+            // the flood fill adds an entrance to the earliest group made before it that touches it, else starts a group there
+            boxIndexToLoc(loc, runs[run].boxIndex);
+            for (faceDirection = 0; faceDirection < 6; faceDirection++)
+            {
+                Vec2Op(newPt, =, loc);
+                if (getNeighbor(faceDirection, newPt))
+                {
+                    neighborIndex = BOX_INDEXV(newPt);
+                    if (gBoxGroup[neighborIndex] < NO_GROUP_SET)
+                    {
+                        int neighborRun = RUN_GROUP_LABEL(gBoxGroup[neighborIndex]);
+                        if (!runs[neighborRun].entrance && !runs[neighborRun].solid)
+                        {
+                            // only roots made before this entrance have an ID yet
+                            int neighborGroupID = runs[findRunRoot(runs, neighborRun)].groupID;
+                            if (neighborGroupID != NO_GROUP_SET && (groupID == NO_GROUP_SET || neighborGroupID < groupID))
+                                groupID = neighborGroupID;
+                        }
+                    }
+                }
+            }
+        }
+        else if (runs[run].parent != run)
+        {
+            // part of a set made earlier
+            continue;
+        }
+
+        if (groupID == NO_GROUP_SET)
+        {
+            gGroupCount++;
+            retCode |= checkGroupListSize();
+            if (retCode >= MW_BEGIN_ERRORS)
+            {
+                free(runs);
+                return true;
+            }
+
+            // Note that group index 0 is not used at all.
+            pGroup = &gGroupList[gGroupCount];
+            pGroup->groupID = gGroupCount;
+            // the surrounding air group might already exist with a population; the rest is counted below
+            if (gGroupCount != SURROUND_AIR_GROUP)
+                pGroup->population = 0;
+            boxIndexToLoc(loc, runs[run].boxIndex);
+            Vec2Op(pGroup->bounds.min, =, loc);
+            Vec2Op(pGroup->bounds.max, =, loc);
+            pGroup->solid = runs[run].solid;
+            if (pGroup->solid)
+                gSolidGroups++;
+            else
+                gAirGroups++;
+            groupID = gGroupCount;
+        }
+        runs[run].groupID = groupID;
+    }
+
+    // Third pass: give the cells their groups and total up the groups' populations and bounds.
+    for (loc[X] = gAirBox.min[X]; loc[X] <= gAirBox.max[X]; loc[X]++)
+    {
+        for (loc[Z] = gAirBox.min[Z]; loc[Z] <= gAirBox.max[Z]; loc[Z]++)
+        {
+            boxIndex = BOX_INDEX(loc[X], gAirBox.max[Y], loc[Z]);
+            for (loc[Y] = gAirBox.max[Y]; loc[Y] >= gAirBox.min[Y]; loc[Y]--, boxIndex--)
+            {
+                if (gBoxGroup[boxIndex] < NO_GROUP_SET)
+                {
+                    run = RUN_GROUP_LABEL(gBoxGroup[boxIndex]);
+                    // entrances are never linked, so are their own roots
+                    groupID = runs[findRunRoot(runs, run)].groupID;
+                    gBoxGroup[boxIndex] = groupID;
+                    pGroup = &gGroupList[groupID];
+                    pGroup->population++;
+                    addBounds(loc, &pGroup->bounds);
+                }
+            }
+        }
+    }
+
+    free(runs);
+    return true;
+}
+
+// Find the root of a run's set, halving the path along the way.
+static int findRunRoot(GroupRun* runs, int run)
+{
+    while (runs[run].parent != run)
+    {
+        runs[run].parent = runs[runs[run].parent].parent;
+        run = runs[run].parent;
+    }
+    return run;
+}
+
+// Link a run to the run holding the neighboring cell, if that cell is in a run of the same sort. The earlier root is kept.
+static void joinRuns(GroupRun* runs, int run, int neighborIndex)
+{
+    int neighborRun;
+    if (gBoxGroup[neighborIndex] >= NO_GROUP_SET)
+        return;
+    neighborRun = RUN_GROUP_LABEL(gBoxGroup[neighborIndex]);
+    if (runs[neighborRun].entrance || runs[neighborRun].solid != runs[run].solid)
+        return;
+    run = findRunRoot(runs, run);
+    neighborRun = findRunRoot(runs, neighborRun);
+    if (neighborRun < run)
+        runs[run].parent = neighborRun;
+    else if (run < neighborRun)
+        runs[neighborRun].parent = run;
+}
+
+
 // Add a volume of space to a group. Group is assumed to exist, have solidity assigned, blocks are assumed to not be in a group already.
 static void addVolumeToGroup(int groupID, int minx, int miny, int minz, int maxx, int maxy, int maxz)
 {
@@ -15991,10 +16714,10 @@ static void addVolumeToGroup(int groupID, int minx, int miny, int minz, int maxx
             // Note that we start at the top and work down, as we want to ensure that outside air is the top group.
             for (loc[Y] = miny; loc[Y] <= maxy; loc[Y]++, boxIndex++)
             {
-                assert(gBoxData[boxIndex].group == NO_GROUP_SET);
+                assert(gBoxGroup[boxIndex] == NO_GROUP_SET);
 
                 pGroup->population++;   // the solid air group might already exist with a population
-                gBoxData[boxIndex].group = groupID;
+                gBoxGroup[boxIndex] = groupID;
             }
         }
     }
@@ -16031,10 +16754,10 @@ static void propagateSeed(IPoint point, BoxGroup* pGroup, IPoint** pSeedStack, i
     if ( (gModel.options->exportFlags & EXPT_SEAL_ENTRANCES) && !pGroup->solid)
     {
         boxIndex = BOX_INDEXV(point);
-        if ((gBlockDefinitions[gBoxData[boxIndex].origType].flags & BLF_ENTRANCE) && notAirEdge(point))
+        if ((gBlockDefinitions[gBoxOrigType[boxIndex]].flags & BLF_ENTRANCE) && notAirEdge(point))
             // In this way, you can use things like snow blocks set to display an alpha of 0 to seal off entrances,
             // and the hole will be visible at the end.  TODO: document - removed, too obscure!!!
-            //if ( gBoxData[boxIndex].origType > BLOCK_AIR )
+            //if ( gBoxOrigType[boxIndex] > BLOCK_AIR )
         {
             // This air block was actually something (like a ladder) that got culled out early on. Use it to seal the entrance.
             // Old code: This air block is actually an entrance, so don't propagate it further.
@@ -16052,24 +16775,24 @@ static void propagateSeed(IPoint point, BoxGroup* pGroup, IPoint** pSeedStack, i
         {
             newBoxIndex = BOX_INDEXV(newPt);
             // is neighbor not in a group, and the same sort of thing as our seed (solid or not)?
-            if (gBoxData[newBoxIndex].group == NO_GROUP_SET) {
+            if (gBoxGroup[newBoxIndex] == NO_GROUP_SET) {
                 if (gModel.print3D) {
                     // For 3D printing, only check fully-filled cells (which is all that are left at this point).
                     // Test: is this a solid block (survivded billboard export) and a solid group, or an air block and an air group?
-                    if ((gBoxData[newBoxIndex].type > BLOCK_AIR) != pGroup->solid) {
+                    if ((gBoxType[newBoxIndex] > BLOCK_AIR) != pGroup->solid) {
                         continue;
                     }
                 }
                 else {
                     // For rendering:
                     // Is this a non-air block of any type, including billboards, and is not an "air edge" block?
-                    if (((gBoxData[newBoxIndex].origType > BLOCK_AIR) && notAirEdge(newPt)) != pGroup->solid) {
+                    if (((gBoxOrigType[newBoxIndex] > BLOCK_AIR) && notAirEdge(newPt)) != pGroup->solid) {
                         continue;
                     }
                 }
 
                 // note the block is a part of this group now
-                gBoxData[newBoxIndex].group = pGroup->groupID;
+                gBoxGroup[newBoxIndex] = pGroup->groupID;
                 // update the group's population, and check if this one touches a side.
                 pGroup->population++;
                 addBounds(newPt, &pGroup->bounds);
@@ -16176,25 +16899,25 @@ static void coatSurfaces()
             for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
             {
                 // air?
-                if (gBoxData[boxIndex].type == BLOCK_AIR)
+                if (gBoxType[boxIndex] == BLOCK_AIR)
                 {
                     // Are the two neighbors on each side solid? Could be a door or window.
                     static int rule = 2;
                     switch (rule) {
                     default:
                     case 1:
-                        if (((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].type > BLOCK_AIR)) ||
-                            ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].type > BLOCK_AIR)))
-                            gBoxData[boxIndex].type = BLOCK_FAKE;
+                        if (((gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] > BLOCK_AIR)) ||
+                            ((gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] > BLOCK_AIR)))
+                            gBoxType[boxIndex] = BLOCK_FAKE;
                         break;
 
                         // We could also test if the two in the other direction *are* air. This will not plug holes in the roof, though, so let's not.
                     case 2:
-                        if (((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].type > BLOCK_AIR) &&
-                            (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].type == BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].type == BLOCK_AIR)) ||
-                            ((gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]].type == BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]].type == BLOCK_AIR) &&
-                            (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]].type > BLOCK_AIR)))
-                            gBoxData[boxIndex].type = BLOCK_FAKE;
+                        if (((gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] > BLOCK_AIR) &&
+                            (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] == BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] == BLOCK_AIR)) ||
+                            ((gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_X]] == BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_X]] == BLOCK_AIR) &&
+                            (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_LO_Z]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[DIRECTION_BLOCK_SIDE_HI_Z]] > BLOCK_AIR)))
+                            gBoxType[boxIndex] = BLOCK_FAKE;
                         break;
 
                         // Are the two neighbors on each side solid, or solid on both ends with one air block in between? Could be a door or window.
@@ -16206,8 +16929,8 @@ static void coatSurfaces()
                             if (x - xlo >= gSolidBox.min[X] - 1) {
                                 for (int xhi = 1; xhi < 3 && !madeFake; xhi++) {
                                     if (x + xhi <= gSolidBox.max[X] + 1 && xlo + xhi < 4) {
-                                        if ((gBoxData[boxIndex + gFaceOffset[xlo * DIRECTION_BLOCK_SIDE_LO_X]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[xhi * DIRECTION_BLOCK_SIDE_HI_X]].type > BLOCK_AIR)) {
-                                            gBoxData[boxIndex].type = BLOCK_FAKE;
+                                        if ((gBoxType[boxIndex + gFaceOffset[xlo * DIRECTION_BLOCK_SIDE_LO_X]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[xhi * DIRECTION_BLOCK_SIDE_HI_X]] > BLOCK_AIR)) {
+                                            gBoxType[boxIndex] = BLOCK_FAKE;
                                             madeFake = true;
                                         }
                                     }
@@ -16219,8 +16942,8 @@ static void coatSurfaces()
                                 if (z - zlo >= gSolidBox.min[Z] - 1) {
                                     for (int zhi = 1; zhi < 3 && !madeFake; zhi++) {
                                         if (z + zhi <= gSolidBox.max[Z] + 1 && zlo + zhi < 4) {
-                                            if ((gBoxData[boxIndex + gFaceOffset[zlo * DIRECTION_BLOCK_SIDE_LO_Z]].type > BLOCK_AIR) && (gBoxData[boxIndex + gFaceOffset[zhi * DIRECTION_BLOCK_SIDE_HI_Z]].type > BLOCK_AIR)) {
-                                                gBoxData[boxIndex].type = BLOCK_FAKE;
+                                            if ((gBoxType[boxIndex + gFaceOffset[zlo * DIRECTION_BLOCK_SIDE_LO_Z]] > BLOCK_AIR) && (gBoxType[boxIndex + gFaceOffset[zhi * DIRECTION_BLOCK_SIDE_HI_Z]] > BLOCK_AIR)) {
+                                                gBoxType[boxIndex] = BLOCK_FAKE;
                                                 madeFake = true;
                                             }
                                         }
@@ -16250,11 +16973,11 @@ static void removeCoatingAndGroups()
             boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
             for (y = gAirBox.min[Y]; y <= gAirBox.max[Y]; y++, boxIndex++)
             {
-                gBoxData[boxIndex].group = 0;
+                gBoxGroup[boxIndex] = 0;
                 // turn fake blocks back to air
-                if (gBoxData[boxIndex].type == BLOCK_FAKE)
+                if (gBoxType[boxIndex] == BLOCK_FAKE)
                 {
-                    gBoxData[boxIndex].type = BLOCK_AIR;
+                    gBoxType[boxIndex] = BLOCK_AIR;
                 }
             }
         }
@@ -16406,7 +17129,7 @@ static void findNeighboringGroups(IBox* bounds, int groupID, int* neighborGroups
             boxIndex = BOX_INDEX(x, bounds->min[Y], z);
             for (y = bounds->min[Y]; y <= bounds->max[Y]; y++, boxIndex++)
             {
-                if (gBoxData[boxIndex].group == groupID)
+                if (gBoxGroup[boxIndex] == groupID)
                 {
                     // mark the neighbors
                     for (faceDirection = 0; faceDirection < 6; faceDirection++)
@@ -16415,7 +17138,7 @@ static void findNeighboringGroups(IBox* bounds, int groupID, int* neighborGroups
                         // and set this as a group that touches the group specified. Simply set them
                         // all, again and again, brute force.
                         // Note that we don't have to check if a neighbor block location is valid! They're all inside air.
-                        neighborGroups[gBoxData[boxIndex + gFaceOffset[faceDirection]].group] = 1;
+                        neighborGroups[gBoxGroup[boxIndex + gFaceOffset[faceDirection]]] = 1;
                     }
                 }
             }
@@ -16451,7 +17174,7 @@ static void findNeighboringGroups(IBox* bounds, int groupID, int* neighborGroups
 //            for ( loc[Y] = gSolidBox.min[Y]; loc[Y] <= gSolidBox.max[Y]; loc[Y]++, boxIndex++ )
 //            {
 //				// get the group of the block
-//				groupIndex = gBoxData[boxIndex].group;
+//				groupIndex = gBoxGroup[boxIndex];
 //				assert(groupIndex >= SURROUND_AIR_GROUP );
 //				if ( groupIndex > SURROUND_AIR_GROUP )
 //				{
@@ -16489,10 +17212,10 @@ static void fillGroups(IBox* bounds, int masterGroupID, bool solid, int fillType
             for (y = bounds->min[Y]; y <= bounds->max[Y]; y++, boxIndex++)
             {
                 // is this group one that should get filled by the master group?
-                if (targetGroupIDs[gBoxData[boxIndex].group] > 0)
+                if (targetGroupIDs[gBoxGroup[boxIndex]] > 0)
                 {
                     // found one to fill, transfer it to master group
-                    pGroup = &gGroupList[gBoxData[boxIndex].group];
+                    pGroup = &gGroupList[gBoxGroup[boxIndex]];
                     if (pGroup->solid != solid)
                     {
                         // target and master differ in solidity
@@ -16511,12 +17234,12 @@ static void fillGroups(IBox* bounds, int masterGroupID, bool solid, int fillType
                             {
                                 int index = boxIndex + gFaceOffset[i];
                                 // leaf found?
-                                if (gBlockDefinitions[gBoxData[index].type].flags & BLF_LEAF_PART)
+                                if (gBlockDefinitions[gBoxType[index]].flags & BLF_LEAF_PART)
                                 {
                                     leafFound = 1;
-                                    leafData = gBoxData[index].data;
+                                    leafData = gBoxDataVal[index];
                                 }
-                                else if (!(gBlockDefinitions[gBoxData[index].type].flags & BLF_TREE_PART) && gBoxData[index].type != BLOCK_AIR)
+                                else if (!(gBlockDefinitions[gBoxType[index]].flags & BLF_TREE_PART) && gBoxType[index] != BLOCK_AIR)
                                 {
                                     // not a leaf, log, or air, so we won't fill it in.
                                     woodSearch = 0;
@@ -16525,27 +17248,27 @@ static void fillGroups(IBox* bounds, int masterGroupID, bool solid, int fillType
                             if (woodSearch && leafFound)
                             {
                                 // leaf fill
-                                gBoxData[boxIndex].type = BLOCK_LEAVES;
-                                gBoxData[boxIndex].data = leafData;
+                                gBoxType[boxIndex] = BLOCK_LEAVES;
+                                gBoxDataVal[boxIndex] = leafData;
                             }
                             else
                             {
                                 // normal fill
-                                gBoxData[boxIndex].type = (unsigned char)fillType;
-                                gBoxData[boxIndex].data = 0x0;
+                                gBoxType[boxIndex] = (unsigned char)fillType;
+                                gBoxDataVal[boxIndex] = 0x0;
                             }
                         }
                         else
                         {
-                            gBoxData[boxIndex].type = (unsigned char)fillType;
-                            gBoxData[boxIndex].data = 0x0;
+                            gBoxType[boxIndex] = (unsigned char)fillType;
+                            gBoxDataVal[boxIndex] = 0x0;
                         }
                         // no real reason to clear data field, and we may
                         // in fact want to check it later with origType:
-                        // NO NO NO: gBoxData[boxIndex].data = 0x0;
+                        // NO NO NO: gBoxDataVal[boxIndex] = 0x0;
                     }
                     // transfer to master group
-                    gBoxData[boxIndex].group = masterGroupID;
+                    gBoxGroup[boxIndex] = masterGroupID;
 
                     // note that this will make this group's bounds invalid,
                     // but since the group is going away, it doesn't matter
@@ -16615,10 +17338,10 @@ static int connectCornerTips()
                 boxIndex = BOX_INDEX(x, y, z);
 
                 // check if it's solid - if so, we'll check if the spot below is air
-                if (gBoxData[boxIndex].type > BLOCK_AIR)
+                if (gBoxType[boxIndex] > BLOCK_AIR)
                 {
                     // quick out: if -Y cell is air, then continue checking, else we're done!
-                    if (gBoxData[boxIndex - 1].type == BLOCK_AIR)
+                    if (gBoxType[boxIndex - 1] == BLOCK_AIR)
                     {
                         int hasCorner = checkForCorner(boxIndex, -1, -1);
                         if (!hasCorner)
@@ -16634,10 +17357,10 @@ static int connectCornerTips()
                             // add cell to group above
                             IPoint loc;
                             int airBoxIndex = boxIndex - 1;
-                            assert(gBoxData[airBoxIndex].type == BLOCK_AIR);
+                            assert(gBoxType[airBoxIndex] == BLOCK_AIR);
                             if (gModel.options->exportFlags & EXPT_DEBUG_SHOW_WELDS)
                             {
-                                gBoxData[airBoxIndex].type = DEBUG_CORNER_TOUCH_TYPE;
+                                gBoxType[airBoxIndex] = DEBUG_CORNER_TOUCH_TYPE;
                             }
                             else
                             {
@@ -16647,19 +17370,19 @@ static int connectCornerTips()
                                 // and the original block was already output as true connector geometry.
                                 // Basically, we're crossing fingers that the original block can connect
                                 // the blocks together. TODO...?
-                                gBoxData[airBoxIndex].type = gBoxData[boxIndex].type;
-                                gBoxData[airBoxIndex].data = gBoxData[boxIndex].data;
+                                gBoxType[airBoxIndex] = gBoxType[boxIndex];
+                                gBoxDataVal[airBoxIndex] = gBoxDataVal[boxIndex];
                             }
                             gStats.blocksCornertipWelded++;
 
                             // we don't know which item on the group list is the air block's
                             // group, so can't easily subtract one from its population. But, we
                             // don't really care about the air group populations, ever.
-                            gBoxData[airBoxIndex].group = gBoxData[boxIndex].group;
-                            assert(gGroupList[gBoxData[boxIndex].group].solid);
-                            gGroupList[gBoxData[boxIndex].group].population++;
+                            gBoxGroup[airBoxIndex] = gBoxGroup[boxIndex];
+                            assert(gGroupList[gBoxGroup[boxIndex]].solid);
+                            gGroupList[gBoxGroup[boxIndex]].population++;
                             Vec3Scalar(loc, =, x, y - 1, z);
-                            addBounds(loc, &gGroupList[gBoxData[boxIndex].group].bounds);
+                            addBounds(loc, &gGroupList[gBoxGroup[boxIndex]].bounds);
 
                             filledTip = 1;
                         }
@@ -16679,8 +17402,8 @@ static int checkForCorner(int boxIndex, int offx, int offz)
     // If so, check if the groups do not match (meaning they are disconnected parts, like
     // a balloon string).
     // If so, continue search, as these two could get joined.
-    if ((gBoxData[tipCornerIndex].type != BLOCK_AIR) &&
-        (gBoxData[tipCornerIndex].group != gBoxData[boxIndex].group))
+    if ((gBoxType[tipCornerIndex] != BLOCK_AIR) &&
+        (gBoxGroup[tipCornerIndex] != gBoxGroup[boxIndex]))
     {
         // solid, so now check 2x2x2 to see if there are just two filled cells (which must be the original
         // and the diagonal ones).
@@ -16693,7 +17416,7 @@ static int checkForCorner(int boxIndex, int offx, int offz)
             int y = ((i % 4) >= 2);
             int z = i % 2;
 
-            if (gBoxData[boxIndex + x * offx * gBoxSizeYZ - y + z * offz * gBoxSize[Y]].type != BLOCK_AIR)
+            if (gBoxType[boxIndex + x * offx * gBoxSizeYZ - y + z * offz * gBoxSize[Y]] != BLOCK_AIR)
                 // one of the six is not air - return
                 return 0;
         }
@@ -16737,6 +17460,9 @@ static int fixTouchingEdges()
     gTouchGrid = (TouchCell*)calloc(gBoxSizeXYZ, sizeof(TouchCell));
     //memset((void*)gTouchGrid, 0, gBoxSizeXYZ * sizeof(TouchCell));
 
+    // find how hidden every cell is at once, instead of searching outwards from each cell found
+    computeObscurityGrid();
+
     gTouchSize = 0;
 
     VecScalar(avgLoc, =, 0.0f);
@@ -16751,7 +17477,7 @@ static int fixTouchingEdges()
             {
                 // check if it's solid - if so, add to average center computations,
                 // and then see if there are any edges that touch
-                if (gBoxData[boxIndex].type > BLOCK_AIR)
+                if (gBoxType[boxIndex] > BLOCK_AIR)
                 {
                     // TODO: this just averages all solid blocks purely by position.
                     // Some other weighting from center of air space might be better?
@@ -16766,7 +17492,7 @@ static int fixTouchingEdges()
                     // we will never examine cells for solidity that have already been touched.
 
                     // quick out: if +X cell is air, +X face edges are processed, else all can be ignored
-                    if (gBoxData[boxIndex + gBoxSizeYZ].type == BLOCK_AIR)
+                    if (gBoxType[boxIndex + gBoxSizeYZ] == BLOCK_AIR)
                     {
                         checkForTouchingEdge(boxIndex, 1, -1, 0);
                         checkForTouchingEdge(boxIndex, 1, 0, -1);
@@ -16774,7 +17500,7 @@ static int fixTouchingEdges()
                         checkForTouchingEdge(boxIndex, 1, 0, 1);
                     }
                     // quick out, if +Z cell is air, the two +Z face edges are processed, else all can be ignored
-                    if (gBoxData[boxIndex + gBoxSize[Y]].type == BLOCK_AIR)
+                    if (gBoxType[boxIndex + gBoxSize[Y]] == BLOCK_AIR)
                     {
                         checkForTouchingEdge(boxIndex, 0, -1, 1);
                         checkForTouchingEdge(boxIndex, 0, 1, 1);
@@ -16826,7 +17552,7 @@ static int fixTouchingEdges()
                     touchList[touchCount].obscurity = gTouchGrid[boxIndex].obscurity;
                     touchList[touchCount].count = gTouchGrid[boxIndex].count;
                     touchList[touchCount].boxIndex = boxIndex;
-                    assert(gBoxData[boxIndex].type == BLOCK_AIR);
+                    assert(gBoxType[boxIndex] == BLOCK_AIR);
 
                     Vec3Scalar(floc, = (float), x, y, z);
                     touchList[touchCount].distance = computeHidingDistance(floc, avgLoc, norm);
@@ -16884,12 +17610,12 @@ static int fixTouchingEdges()
             for (i = 0; i < 6; i++)
             {
                 int index = boxIndex + gFaceOffset[i];
-                foundBlock = (gBoxData[index].type > BLOCK_AIR);
+                foundBlock = (gBoxType[index] > BLOCK_AIR);
                 if (foundBlock)
                 {
                     int j;
                     int foundGroup = 0;
-                    int groupID = gBoxData[index].group;
+                    int groupID = gBoxGroup[index];
                     if (boxMtlIndex < 0)
                         // store away the index of the first material found
                         boxMtlIndex = index;
@@ -16928,10 +17654,10 @@ static int fixTouchingEdges()
 
             // tada! The actual work: the air block is now filled
             // if weld debugging is going on, we should make these some special color - what?
-            assert(gBoxData[boxIndex].type == BLOCK_AIR);
+            assert(gBoxType[boxIndex] == BLOCK_AIR);
             if (gModel.options->exportFlags & EXPT_DEBUG_SHOW_WELDS)
             {
-                gBoxData[boxIndex].type = DEBUG_EDGE_TOUCH_TYPE;
+                gBoxType[boxIndex] = DEBUG_EDGE_TOUCH_TYPE;
             }
             else
             {
@@ -16939,15 +17665,15 @@ static int fixTouchingEdges()
                 // and the original block was already output as true connector geometry.
                 // Basically, we're crossing fingers that the original block can connect
                 // the blocks together. TODO...?
-                gBoxData[boxIndex].type = gBoxData[boxMtlIndex].type;
-                gBoxData[boxIndex].data = gBoxData[boxMtlIndex].data;
+                gBoxType[boxIndex] = gBoxType[boxMtlIndex];
+                gBoxDataVal[boxIndex] = gBoxDataVal[boxMtlIndex];
             }
             gStats.blocksManifoldWelded++;
 
             // we don't know which item on the group list is the air block's
             // group, so can't easily subtract one from its population. But, we
             // don't really care about the air group populations, ever.
-            gBoxData[boxIndex].group = masterGroupID;
+            gBoxGroup[boxIndex] = masterGroupID;
             gGroupList[masterGroupID].population++;
             boxIndexToLoc(loc, boxIndex);
             addBounds(loc, &gGroupList[masterGroupID].bounds);
@@ -17005,6 +17731,10 @@ FreeMemory:
         free(gTouchGrid);
         gTouchGrid = NULL;
     }
+    if (gObscurityGrid) {
+        free(gObscurityGrid);
+        gObscurityGrid = NULL;
+    }
     gStats.numberManifoldPasses++;
 
     return touchCount ? 1 : 0;
@@ -17020,7 +17750,7 @@ static int touchRecordCompare(void* context, const void* str1, const void* str2)
     // Blocks that had something in them originally (e.g. rails, redstone, or other things that got flattened)
     // are more significant than blocks of air, so the air should get covered up first so the rails aren't covered.
     // if the blocks are both air, or were both solid, then we need a different thing to test on.
-    if ((gBoxData[t1->boxIndex].origType == BLOCK_AIR) == (gBoxData[t2->boxIndex].origType == BLOCK_AIR))
+    if ((gBoxOrigType[t1->boxIndex] == BLOCK_AIR) == (gBoxOrigType[t2->boxIndex] == BLOCK_AIR))
     {
         // both elements are air or both are not air
         // elements that are in more of a crevice (more faces covered by solid neighbors) get filled first
@@ -17037,7 +17767,7 @@ static int touchRecordCompare(void* context, const void* str1, const void* str2)
         else return ((t1->obscurity > t2->obscurity) ? -1 : 1);
     }
     // one element is air, so favor filling it first
-    else return ((gBoxData[t1->boxIndex].origType < gBoxData[t2->boxIndex].origType) ? -1 : 1);
+    else return ((gBoxOrigType[t1->boxIndex] < gBoxOrigType[t2->boxIndex]) ? -1 : 1);
 }
 
 
@@ -17045,12 +17775,12 @@ static void checkForTouchingEdge(int boxIndex, int offx, int offy, int offz)
 {
     // we assume the location itself is solid. Check if diagonal is solid
     int otherSolidIndex = boxIndex + offx * gBoxSizeYZ + offy + offz * gBoxSize[Y];
-    if (gBoxData[otherSolidIndex].type > BLOCK_AIR)
+    if (gBoxType[otherSolidIndex] > BLOCK_AIR)
     {
         // so far so good, both are solid, so we have two diagonally-opposite blocks;
         // do we want to connect all diagonals (usually a bad option), or do the groups differ?
         if ((gModel.options->exportFlags & EXPT_CONNECT_ALL_EDGES) ||
-            (gBoxData[boxIndex].group != gBoxData[otherSolidIndex].group))
+            (gBoxGroup[boxIndex] != gBoxGroup[otherSolidIndex]))
         {
             // groups differ (or all edges should be connected)
             int n1index = UNINITIALIZED_INT;
@@ -17065,7 +17795,7 @@ static void checkForTouchingEdge(int boxIndex, int offx, int offy, int offz)
                 // So just use the other two offsets to check if the other direction is air.
 
                 // so begins the brute force. There's probably some clever way to do this...
-                if (gBoxData[boxIndex + offy + offz * gBoxSize[Y]].type == BLOCK_AIR)
+                if (gBoxType[boxIndex + offy + offz * gBoxSize[Y]] == BLOCK_AIR)
                 {
                     // manifold found! So, mark the two air blocks, +X and y/z offset, and put the proper
                     // TOUCH_ flags in the touch grid.
@@ -17106,7 +17836,7 @@ static void checkForTouchingEdge(int boxIndex, int offx, int offy, int offz)
             {
                 // we're on the +Z face, just need to test the Y offset for AIR
                 assert(offz == 1);
-                if (gBoxData[boxIndex + offy].type == BLOCK_AIR)
+                if (gBoxType[boxIndex + offy] == BLOCK_AIR)
                 {
                     foundPair = 1;
                     assert(offx == 0);
@@ -17183,6 +17913,9 @@ static void checkForTouchingEdge(int boxIndex, int offx, int offy, int offz)
 // count how many of the six directions for this cell are blocked by something solid
 static int computeObscurity(int boxIndex)
 {
+    if (gObscurityGrid)
+        return gObscurityGrid[boxIndex];
+
     int obscurity = gTouchGrid[boxIndex].obscurity;
 
     // we know that obscurity must be 2 or more; so 0 means "not set"
@@ -17234,7 +17967,7 @@ static int computeObscurity(int boxIndex)
             // now check the stretch of cells in the given direction
             for (i = 0, cellIndex = start; i < cellsToLoop && !hit; i++, cellIndex += incr)
             {
-                if (gBoxData[cellIndex].type > BLOCK_AIR)
+                if (gBoxType[cellIndex] > BLOCK_AIR)
                     hit = 1;
             }
             obscurity += hit;
@@ -17244,6 +17977,119 @@ static int computeObscurity(int boxIndex)
     return obscurity;
 }
 
+// Find the obscurity of every cell in the air box, the same count computeObscurity() would find by searching each
+// direction: a cell is blocked in a direction if there's a solid cell anywhere past it along that line. Each line
+// is scanned forwards and backwards once, noting whether a solid cell has been seen yet. The Y and Z scans are done
+// per X slab, the X scans per Z row, each in parallel. Lines are swept a Y column at a time, with the "seen" flags
+// for the whole column kept side by side, so the inner loops are simple and branch-free.
+// If there's not enough memory, gObscurityGrid is left NULL and each cell is searched as needed.
+static void computeObscurityGrid()
+{
+    ObscurityScan scan;
+
+    gObscurityGrid = (unsigned char*)malloc(gBoxSizeXYZ * sizeof(unsigned char));
+    scan.seen = (unsigned char*)malloc(GetWorkerCount() * gBoxSize[Y] * sizeof(unsigned char));
+    if (gObscurityGrid == NULL || scan.seen == NULL)
+    {
+        if (gObscurityGrid)
+        {
+            free(gObscurityGrid);
+            gObscurityGrid = NULL;
+        }
+        if (scan.seen)
+            free(scan.seen);
+        return;
+    }
+
+    // the slab scans set each cell's count, then the row scans add to it, so these must be done in this order
+    RunWorkerTasks(gAirBox.max[X] - gAirBox.min[X] + 1, obscuritySlabTask, &scan);
+    RunWorkerTasks(gAirBox.max[Z] - gAirBox.min[Z] + 1, obscurityRowTask, &scan);
+
+    free(scan.seen);
+}
+
+// Set the obscurity from the -Y, +Y, -Z and +Z directions for the cells in X slab gAirBox.min[X] + taskIndex.
+static void obscuritySlabTask(int taskIndex, int workerIndex, void* userData)
+{
+    ObscurityScan* pScan = (ObscurityScan*)userData;
+    unsigned char* seen = pScan->seen + workerIndex * gBoxSize[Y];
+    int x = gAirBox.min[X] + taskIndex;
+    int yCount = gAirBox.max[Y] - gAirBox.min[Y] + 1;
+    int z, i, boxIndex;
+    unsigned char solid;
+
+    // Y: up and down each column
+    for (z = gAirBox.min[Z]; z <= gAirBox.max[Z]; z++)
+    {
+        boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
+        solid = 0;
+        for (i = 0; i < yCount; i++)
+        {
+            gObscurityGrid[boxIndex + i] = solid;
+            solid |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+        solid = 0;
+        for (i = yCount - 1; i >= 0; i--)
+        {
+            gObscurityGrid[boxIndex + i] += solid;
+            solid |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+    }
+
+    // Z: sweep the columns forwards, then backwards
+    memset(seen, 0, yCount);
+    for (z = gAirBox.min[Z]; z <= gAirBox.max[Z]; z++)
+    {
+        boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
+        for (i = 0; i < yCount; i++)
+        {
+            gObscurityGrid[boxIndex + i] += seen[i];
+            seen[i] |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+    }
+    memset(seen, 0, yCount);
+    for (z = gAirBox.max[Z]; z >= gAirBox.min[Z]; z--)
+    {
+        boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
+        for (i = 0; i < yCount; i++)
+        {
+            gObscurityGrid[boxIndex + i] += seen[i];
+            seen[i] |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+    }
+}
+
+// Add the obscurity from the -X and +X directions for the cells in Z row gAirBox.min[Z] + taskIndex.
+static void obscurityRowTask(int taskIndex, int workerIndex, void* userData)
+{
+    ObscurityScan* pScan = (ObscurityScan*)userData;
+    unsigned char* seen = pScan->seen + workerIndex * gBoxSize[Y];
+    int z = gAirBox.min[Z] + taskIndex;
+    int yCount = gAirBox.max[Y] - gAirBox.min[Y] + 1;
+    int x, i, boxIndex;
+
+    memset(seen, 0, yCount);
+    for (x = gAirBox.min[X]; x <= gAirBox.max[X]; x++)
+    {
+        boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
+        for (i = 0; i < yCount; i++)
+        {
+            gObscurityGrid[boxIndex + i] += seen[i];
+            seen[i] |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+    }
+    memset(seen, 0, yCount);
+    for (x = gAirBox.max[X]; x >= gAirBox.min[X]; x--)
+    {
+        boxIndex = BOX_INDEX(x, gAirBox.min[Y], z);
+        for (i = 0; i < yCount; i++)
+        {
+            gObscurityGrid[boxIndex + i] += seen[i];
+            seen[i] |= (unsigned char)(gBoxType[boxIndex + i] > BLOCK_AIR);
+        }
+    }
+}
+
 // given location, turn off neighbors from grid
 static void decrementNeighbors(int boxIndex)
 {
@@ -17452,15 +18298,15 @@ static void processFloatingGroups(bool trulyDelete)
                         for (y = pGroup->bounds.min[Y]; deleteGroup && y <= pGroup->bounds.max[Y]; y++, boxIndex++)
                         {
                             // is this group one that should get filled by the master group?
-                            if (gBoxData[boxIndex].group == i)
+                            if (gBoxGroup[boxIndex] == i)
                             {
                                 // group matches: is it a tree part? Or is it a glass bubble that is
                                 // is surrounded by tree bits? (this can happen, some trees grow funny)
-                                if ((gBlockDefinitions[gBoxData[boxIndex].type].flags & BLF_TREE_PART) ||
-                                    (gBoxData[boxIndex].origType == BLOCK_AIR) || (gBoxData[boxIndex].origType == BLOCK_VINES))
+                                if ((gBlockDefinitions[gBoxType[boxIndex]].flags & BLF_TREE_PART) ||
+                                    (gBoxOrigType[boxIndex] == BLOCK_AIR) || (gBoxOrigType[boxIndex] == BLOCK_VINES))
                                 {
                                     // tree part, mark which parts
-                                    treeParts |= gBlockDefinitions[gBoxData[boxIndex].type].flags;
+                                    treeParts |= gBlockDefinitions[gBoxType[boxIndex]].flags;
                                 }
                                 else
                                 {
@@ -17569,6 +18415,15 @@ static int determineScaleAndHollowAndMelt()
     //    bottom up. Option: delete a block at the base if it has neighboring blocks in all 8 positions on this level
     //    and all 9 positions on the level above. This may be overconservative in some cases, but is safe. Mark all
     //    these positions, working up the object, then delete.
+    // Hollowing and melting both mark cells with groups, so make sure those exist (e.g., if no groups were found)
+    if ((gModel.options->exportFlags & EXPT_HOLLOW_BOTTOM) || gModel.options->pEFD->chkMeltSnow)
+    {
+        if (allocBoxGroups() >= MW_BEGIN_ERRORS)
+        {
+            return MW_WORLD_EXPORT_TOO_LARGE;
+        }
+    }
+
     // Now hollow - should be the last thing done, as we always want to build up before deleting
     if (gModel.options->exportFlags & EXPT_HOLLOW_BOTTOM)
     {
@@ -17622,7 +18477,7 @@ static float computeMachineVolume()
                     for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
                     {
                         // The melting option melts away snow built as supports or whatever
-                        if (gBoxData[boxIndex].origType != BLOCK_AIR)
+                        if (gBoxOrigType[boxIndex] != BLOCK_AIR)
                         {
                             if (y < minSolid)
                             {
@@ -17745,25 +18600,25 @@ static void hollowBottomOfModel()
                     {
                         survived = 0;
                         // brute force the 3x3 above and 3x3 in the middle layer: all solid?
-                        if (gBoxData[boxIndex - 1].type == BLOCK_AIR &&    // if block below is air
-                            gBoxData[boxIndex].type != BLOCK_AIR &&    // if block is solid
-                            gBoxData[boxIndex + 1].type != BLOCK_AIR &&   // +Y
-                            gBoxData[boxIndex - gBoxSizeYZ].type != BLOCK_AIR &&  // -X
-                            gBoxData[boxIndex + gBoxSizeYZ].type != BLOCK_AIR &&  // +X
-                            gBoxData[boxIndex - gBoxSize[Y]].type != BLOCK_AIR &&  // -Z
-                            gBoxData[boxIndex + gBoxSize[Y]].type != BLOCK_AIR &&  // +Z
-                            gBoxData[boxIndex - gBoxSizeYZ - gBoxSize[Y]].type != BLOCK_AIR &&  // -X-Z
-                            gBoxData[boxIndex + gBoxSizeYZ - gBoxSize[Y]].type != BLOCK_AIR &&  // +X-Z
-                            gBoxData[boxIndex - gBoxSizeYZ + gBoxSize[Y]].type != BLOCK_AIR &&  // -X+Z
-                            gBoxData[boxIndex + gBoxSizeYZ + gBoxSize[Y]].type != BLOCK_AIR &&  // +X+Z
-                            gBoxData[boxIndex - gBoxSizeYZ + 1].type != BLOCK_AIR &&  // -X+Y
-                            gBoxData[boxIndex + gBoxSizeYZ + 1].type != BLOCK_AIR &&  // +X+Y
-                            gBoxData[boxIndex - gBoxSize[Y] + 1].type != BLOCK_AIR &&  // -Z+Y
-                            gBoxData[boxIndex + gBoxSize[Y] + 1].type != BLOCK_AIR &&  // +Z+Y
-                            gBoxData[boxIndex - gBoxSizeYZ - gBoxSize[Y] + 1].type != BLOCK_AIR &&  // -X-Z+Y
-                            gBoxData[boxIndex + gBoxSizeYZ - gBoxSize[Y] + 1].type != BLOCK_AIR &&  // +X-Z+Y
-                            gBoxData[boxIndex - gBoxSizeYZ + gBoxSize[Y] + 1].type != BLOCK_AIR &&  // -X+Z+Y
-                            gBoxData[boxIndex + gBoxSizeYZ + gBoxSize[Y] + 1].type != BLOCK_AIR)  // +X+Z+Y
+                        if (gBoxType[boxIndex - 1] == BLOCK_AIR &&    // if block below is air
+                            gBoxType[boxIndex] != BLOCK_AIR &&    // if block is solid
+                            gBoxType[boxIndex + 1] != BLOCK_AIR &&   // +Y
+                            gBoxType[boxIndex - gBoxSizeYZ] != BLOCK_AIR &&  // -X
+                            gBoxType[boxIndex + gBoxSizeYZ] != BLOCK_AIR &&  // +X
+                            gBoxType[boxIndex - gBoxSize[Y]] != BLOCK_AIR &&  // -Z
+                            gBoxType[boxIndex + gBoxSize[Y]] != BLOCK_AIR &&  // +Z
+                            gBoxType[boxIndex - gBoxSizeYZ - gBoxSize[Y]] != BLOCK_AIR &&  // -X-Z
+                            gBoxType[boxIndex + gBoxSizeYZ - gBoxSize[Y]] != BLOCK_AIR &&  // +X-Z
+                            gBoxType[boxIndex - gBoxSizeYZ + gBoxSize[Y]] != BLOCK_AIR &&  // -X+Z
+                            gBoxType[boxIndex + gBoxSizeYZ + gBoxSize[Y]] != BLOCK_AIR &&  // +X+Z
+                            gBoxType[boxIndex - gBoxSizeYZ + 1] != BLOCK_AIR &&  // -X+Y
+                            gBoxType[boxIndex + gBoxSizeYZ + 1] != BLOCK_AIR &&  // +X+Y
+                            gBoxType[boxIndex - gBoxSize[Y] + 1] != BLOCK_AIR &&  // -Z+Y
+                            gBoxType[boxIndex + gBoxSize[Y] + 1] != BLOCK_AIR &&  // +Z+Y
+                            gBoxType[boxIndex - gBoxSizeYZ - gBoxSize[Y] + 1] != BLOCK_AIR &&  // -X-Z+Y
+                            gBoxType[boxIndex + gBoxSizeYZ - gBoxSize[Y] + 1] != BLOCK_AIR &&  // +X-Z+Y
+                            gBoxType[boxIndex - gBoxSizeYZ + gBoxSize[Y] + 1] != BLOCK_AIR &&  // -X+Z+Y
+                            gBoxType[boxIndex + gBoxSizeYZ + gBoxSize[Y] + 1] != BLOCK_AIR)  // +X+Z+Y
                         {
                             survived = 1;
                             // OK, this one can be deleted. Now check extra width, if any
@@ -17783,7 +18638,7 @@ static void hollowBottomOfModel()
                                         {
                                             neighborIndex = BOX_INDEXV(loc);
                                             // is neighbor not in a group, and the same sort of thing as our seed (solid or not)?
-                                            if (gBoxData[neighborIndex].type == BLOCK_AIR)
+                                            if (gBoxType[neighborIndex] == BLOCK_AIR)
                                             {
                                                 survived = 0;
                                             }
@@ -17811,8 +18666,8 @@ static void hollowBottomOfModel()
                         // do this to only solid objects. This is done until we hit air.
                         // TODO: when we hit air we could continue, not sure that helps...
                         if (!hollowDone[x * gBoxSize[Z] + z])
-                            if (gBoxData[boxIndex].type > BLOCK_AIR)
-                                gBoxData[boxIndex].group = HOLLOW_AIR_GROUP;
+                            if (gBoxType[boxIndex] > BLOCK_AIR)
+                                gBoxGroup[boxIndex] = HOLLOW_AIR_GROUP;
                             else
                                 // stop making a post if we hit air. This OK? TODO
                                 hollowDone[x * gBoxSize[Z] + z] = (unsigned char)y;
@@ -17831,11 +18686,11 @@ static void hollowBottomOfModel()
                 // note at this point we're not messing with populations, since hollow is the very last operation.
                 // If this changes, need to decrement and add to populations here, and we'd need to get the new bounds
                 // for any groups that lost anything (and gained anything), etc.
-                gBoxData[listToChange[listCount]].type = BLOCK_AIR;
+                gBoxType[listToChange[listCount]] = BLOCK_AIR;
                 // must track block count now, as it's been computed
                 gModel.blockCount--;
                 // special use of group 0 - for hollow
-                gBoxData[listToChange[listCount]].group = HOLLOW_AIR_GROUP;
+                gBoxGroup[listToChange[listCount]] = HOLLOW_AIR_GROUP;
                 gStats.blocksHollowed++;
             }
         }
@@ -17913,7 +18768,7 @@ static void hollowSeed(int x, int y, int z, IPoint** pSeedList, int* seedSize, i
     int boxIndex = BOX_INDEX(x, y, z);
 
     // first, is it already empty? or marked as part of hollow (as the posts are)?
-    if (gBoxData[boxIndex].type != BLOCK_AIR && gBoxData[boxIndex].group != HOLLOW_AIR_GROUP)
+    if (gBoxType[boxIndex] != BLOCK_AIR && gBoxGroup[boxIndex] != HOLLOW_AIR_GROUP)
     {
         // OK, it can be tested and could spawn more seeds
         int neighborBoxIndex, dir;
@@ -17929,8 +18784,8 @@ static void hollowSeed(int x, int y, int z, IPoint** pSeedList, int* seedSize, i
                 neighborBoxIndex = BOX_INDEX(loc[X], y - 1, loc[Z]);
                 for (loc[Y] = y - 1; ok && loc[Y] <= y + 1; loc[Y]++, neighborBoxIndex++)
                 {
-                    if (gBoxData[neighborBoxIndex].type == BLOCK_AIR &&
-                        gBoxData[neighborBoxIndex].group != HOLLOW_AIR_GROUP)
+                    if (gBoxType[neighborBoxIndex] == BLOCK_AIR &&
+                        gBoxGroup[neighborBoxIndex] != HOLLOW_AIR_GROUP)
                     {
                         // outside air found, so can't grow that direction
                         ok = 0;
@@ -17959,8 +18814,8 @@ static void hollowSeed(int x, int y, int z, IPoint** pSeedList, int* seedSize, i
                 {
                     neighborBoxIndex = BOX_INDEXV(loc);
                     // is neighbor not in a group, and the same sort of thing as our seed (solid or not)?
-                    if (gBoxData[neighborBoxIndex].type == BLOCK_AIR &&
-                        gBoxData[neighborBoxIndex].group != HOLLOW_AIR_GROUP)
+                    if (gBoxType[neighborBoxIndex] == BLOCK_AIR &&
+                        gBoxGroup[neighborBoxIndex] != HOLLOW_AIR_GROUP)
                     {
                         ok = 0;
                     }
@@ -17988,8 +18843,8 @@ static void hollowSeed(int x, int y, int z, IPoint** pSeedList, int* seedSize, i
 
             seedList = *pSeedList;
 
-            gBoxData[boxIndex].type = BLOCK_AIR;
-            gBoxData[boxIndex].group = HOLLOW_AIR_GROUP;
+            gBoxType[boxIndex] = BLOCK_AIR;
+            gBoxGroup[boxIndex] = HOLLOW_AIR_GROUP;
             gStats.blocksSuperHollowed++;
             // must track block count now, as it's been computed
             gModel.blockCount--;
@@ -18017,14 +18872,14 @@ static void meltSnow()
             for (y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
             {
                 // The melting option melts away snow built as supports or whatever
-                if (gBoxData[boxIndex].type == BLOCK_SNOW_BLOCK)
+                if (gBoxType[boxIndex] == BLOCK_SNOW_BLOCK)
                 {
                     // melting time
-                    gBoxData[boxIndex].type = BLOCK_AIR;
+                    gBoxType[boxIndex] = BLOCK_AIR;
                     // We don't know if it's true that this is the right air group, but who cares,
                     // it's the last operation before exporting the model itself. Still, give it some
                     // group, just in case...
-                    gBoxData[boxIndex].group = SURROUND_AIR_GROUP;
+                    gBoxGroup[boxIndex] = SURROUND_AIR_GROUP;
                     gStats.blocksHollowed++;
                 }
             }
@@ -18144,59 +18999,124 @@ static int generateBlockDataAndStatistics(IBox* tightWorldBox, IBox* worldBox)
 
     // At this point all partial blocks have been output, and their type set to BLOCK_AIR. Now output the fully solid blocks.
     // Go through blocks and see which is solid; output these solid blocks.
+    // Which faces of which blocks are to be made, the bulk of the work, is found ahead of time for a band of X slabs at
+    // once, one slab per task. The faces are then made in the same order as always, so vertex, texture coordinate and
+    // face numbering is unchanged. Instancing makes a block's faces once, so doesn't bother.
+    // When simplifying, each band's faces are instead merged as they are made, see meshFaceBand(); the band is then a
+    // multiple of the largest merged face's width, if memory allows, so that rows of like faces break where they would anyway.
     IPoint origin = { 0,0,0 };
-    for (loc[X] = gSolidBox.min[X]; loc[X] <= gSolidBox.max[X]; loc[X]++)
+    // same tests as for calling decimateMesh(), below
+    bool simplifyMesh = gModel.options->pEFD->chkDecimate && gModel.exportTiles && !gModel.print3D && !(gModel.options->exportFlags & EXPT_INDIVIDUAL_BLOCKS);
+    bool meshFaces = simplifyMesh && !gModel.instancing;
+    int meshSavings = 0;
+    FaceMaskBand band;
+    band.zCount = gSolidBox.max[Z] - gSolidBox.min[Z] + 1;
+    band.yCount = gSolidBox.max[Y] - gSolidBox.min[Y] + 1;
+    band.mask = NULL;
+    int bandSlabs = 0;
+    int slabBytes = band.zCount * band.yCount;
+    if (!gModel.instancing && slabBytes > 0) {
+        bandSlabs = max(1, min(gSolidBox.max[X] - gSolidBox.min[X] + 1, max(FACE_MASK_BAND_BYTES / slabBytes, meshFaces ? SIMPLIFY_MAX_DIMENSION : 1)));
+        if (meshFaces && bandSlabs < gSolidBox.max[X] - gSolidBox.min[X] + 1)
+            bandSlabs -= bandSlabs % SIMPLIFY_MAX_DIMENSION;
+        band.mask = (unsigned char*)malloc((size_t)bandSlabs * slabBytes);
+        // without the memory, find faces block by block as they're made
+        if (band.mask == NULL)
+            bandSlabs = 0;
+    }
+    if (meshFaces && bandSlabs > 0) {
+        // merged faces left open at the end of one band, and those being left open at the end of the next
+        OpenMergedFaceList openFaces[2];
+        memset(openFaces, 0, sizeof(openFaces));
+        int open = 0;
+        retCode |= allocSimplifyUVGrid();
+        for (band.firstX = gSolidBox.min[X]; band.firstX <= gSolidBox.max[X] && retCode < MW_BEGIN_ERRORS; band.firstX += bandSlabs)
+        {
+            int slabs = min(bandSlabs, gSolidBox.max[X] - band.firstX + 1);
+            bool lastBand = (band.firstX + slabs > gSolidBox.max[X]);
+            RunWorkerTasks(slabs, findFaceMaskTask, &band);
+            openFaces[1 - open].count = 0;
+            retCode |= meshFaceBand(&band, slabs, &openFaces[open], lastBand ? NULL : &openFaces[1 - open], meshSavings);
+            open = 1 - open;
+        }
+        free(openFaces[0].faces);
+        free(openFaces[1].faces);
+        if (retCode >= MW_BEGIN_ERRORS) {
+            free(band.mask);
+            return retCode;
+        }
+    }
+    else
     {
-        // update on each row of X
-        //UPDATE_PROGRESS(pgFaceStart + pgFaceOffset * ((float)(loc[X] - gSolidBox.min[X] + 1) / (float)(gSolidBox.max[X] - gSolidBox.min[X] + 1)));
-        for (loc[Z] = gSolidBox.min[Z]; loc[Z] <= gSolidBox.max[Z]; loc[Z]++)
+        for (loc[X] = gSolidBox.min[X]; loc[X] <= gSolidBox.max[X]; loc[X]++)
         {
-            boxIndex = BOX_INDEX(loc[X], gSolidBox.min[Y], loc[Z]);
-            for (loc[Y] = gSolidBox.min[Y]; loc[Y] <= gSolidBox.max[Y]; loc[Y]++, boxIndex++)
+            // update on each row of X
+            //UPDATE_PROGRESS(pgFaceStart + pgFaceOffset * ((float)(loc[X] - gSolidBox.min[X] + 1) / (float)(gSolidBox.max[X] - gSolidBox.min[X] + 1)));
+            unsigned char* mask = NULL;
+            if (bandSlabs > 0) {
+                int slab = (loc[X] - gSolidBox.min[X]) % bandSlabs;
+                if (slab == 0) {
+                    band.firstX = loc[X];
+                    RunWorkerTasks(min(bandSlabs, gSolidBox.max[X] - loc[X] + 1), findFaceMaskTask, &band);
+                }
+                mask = band.mask + slab * slabBytes;
+            }
+            for (loc[Z] = gSolidBox.min[Z]; loc[Z] <= gSolidBox.max[Z]; loc[Z]++)
             {
-                // if it's not air (everything too small has been turned into air)
-                // then output it
-                if (gBoxData[boxIndex].type > BLOCK_AIR)
+                boxIndex = BOX_INDEX(loc[X], gSolidBox.min[Y], loc[Z]);
+                for (loc[Y] = gSolidBox.min[Y]; loc[Y] <= gSolidBox.max[Y]; loc[Y]++, boxIndex++)
                 {
-                    // block is solid, may need to output some faces.
-                    if (gModel.instancing) {
-                        // is block already output?
-                        int instanceID;
-                        // is there an instance already for this type and data value? If so, set the instanceID to it.
-                        if (!findInstance(gBoxData[boxIndex].type, gBoxData[boxIndex].data, instanceID)) {
-                            // prepare for new instance - gModel.instanceCount is incremented later when the instance is actually created
-                            instanceID = gModel.instanceCount;
-                            int faceID = gModel.faceCount;
-                            // make the instance at the origin, storing it in the regular database the usual way.
-                            retCode |= checkAndCreateFaces(boxIndex, origin);
-                            if (retCode >= MW_BEGIN_ERRORS)
-                                return retCode;
-
-                            // create a new instance of this block type, storing away the first face ID.
-                            // adjust the scale and location (center at origin) of the instance.
-                            // this method will test the increment gModel.instanceCount.
-                            createInstance(gBoxData[boxIndex].type, gBoxData[boxIndex].data, faceID);
-                        }
-                        // Whatever the case, store the instance location, which is the stored gModel.faceCount,
-                        // which points at the next set of faces
-                        float anchorPt[3];
-                        //anchorPt[X] = (float)((float)iloc[X] - gModel.center[X]) * gModel.scale * gUnitsScale;
-                        //anchorPt[Y] = (float)((float)iloc[Y] - gModel.center[Y]) * gModel.scale * gUnitsScale;
-                        //anchorPt[Z] = (float)((float)iloc[Z] - gModel.center[Z]) * gModel.scale * gUnitsScale;
-                        anchorPt[X] = (float)loc[X];
-                        anchorPt[Y] = (float)loc[Y];
-                        anchorPt[Z] = (float)loc[Z];
-                        // save instance location and ID to a long list. ID points to the created instance, which has the faceID
-                        saveInstanceLocation(anchorPt, instanceID);
+                    int faceMask = 0;
+                    if (mask) {
+                        faceMask = *mask++;
+                        if (faceMask == 0)
+                            continue;
                     }
-                    else {
-                        // the normal thing: create the faces as needed
-                        retCode |= checkAndCreateFaces(boxIndex, loc);
+                    // if it's not air (everything too small has been turned into air)
+                    // then output it
+                    if (gBoxType[boxIndex] > BLOCK_AIR)
+                    {
+                        // block is solid, may need to output some faces.
+                        if (gModel.instancing) {
+                            // is block already output?
+                            int instanceID;
+                            // is there an instance already for this type and data value? If so, set the instanceID to it.
+                            if (!findInstance(gBoxType[boxIndex], gBoxDataVal[boxIndex], instanceID)) {
+                                // prepare for new instance - gModel.instanceCount is incremented later when the instance is actually created
+                                instanceID = gModel.instanceCount;
+                                int faceID = gModel.faceCount;
+                                // make the instance at the origin, storing it in the regular database the usual way.
+                                retCode |= checkAndCreateFaces(boxIndex, origin, findFaceMask(boxIndex));
+                                if (retCode >= MW_BEGIN_ERRORS)
+                                    return retCode;
+
+                                // create a new instance of this block type, storing away the first face ID.
+                                // adjust the scale and location (center at origin) of the instance.
+                                // this method will test the increment gModel.instanceCount.
+                                createInstance(gBoxType[boxIndex], gBoxDataVal[boxIndex], faceID);
+                            }
+                            // Whatever the case, store the instance location, which is the stored gModel.faceCount,
+                            // which points at the next set of faces
+                            float anchorPt[3];
+                            //anchorPt[X] = (float)((float)iloc[X] - gModel.center[X]) * gModel.scale * gUnitsScale;
+                            //anchorPt[Y] = (float)((float)iloc[Y] - gModel.center[Y]) * gModel.scale * gUnitsScale;
+                            //anchorPt[Z] = (float)((float)iloc[Z] - gModel.center[Z]) * gModel.scale * gUnitsScale;
+                            anchorPt[X] = (float)loc[X];
+                            anchorPt[Y] = (float)loc[Y];
+                            anchorPt[Z] = (float)loc[Z];
+                            // save instance location and ID to a long list. ID points to the created instance, which has the faceID
+                            saveInstanceLocation(anchorPt, instanceID);
+                        }
+                        else {
+                            // the normal thing: create the faces as needed
+                            retCode |= checkAndCreateFaces(boxIndex, loc, mask ? faceMask : findFaceMask(boxIndex));
+                        }
                     }
                 }
             }
         }
     }
+    free(band.mask);
 
     UPDATE_PROGRESS(gProgress.start.makeFaces + gProgress.absolute.makeFaces * 0.75f);
 
@@ -18208,17 +19128,17 @@ static int generateBlockDataAndStatistics(IBox* tightWorldBox, IBox* worldBox)
             // for USD, group by actual tile, as we don't care about groups so much
             UPDATE_STATUS(-999.0f, L"Sort by tile IDs");
             if (gModel.options->pEFD->fileType == FILE_TYPE_USD) {
-                qsort_s(gModel.faceList, gModel.faceCount, sizeof(FaceRecord*), tileUSDIdCompare, NULL);
+                sortFaces(gModel.faceList, gModel.faceCount, FACE_ORDER_USD_TILE);
             }
             else {
                 // group by tile type; minimizes material changes
-                qsort_s(gModel.faceList, gModel.faceCount, sizeof(FaceRecord*), tileIdCompare, NULL);
+                sortFaces(gModel.faceList, gModel.faceCount, FACE_ORDER_TILE);
             }
         }
         else {
             // don't bother with swatchLoc sorting
             UPDATE_STATUS(-999.0f, L"Sort by face IDs");
-            qsort_s(gModel.faceList, gModel.faceCount, sizeof(FaceRecord*), faceIdCompare, NULL);
+            sortFaces(gModel.faceList, gModel.faceCount, FACE_ORDER_ID);
         }
     }
     // else we are exporting by block, so no sorting is done.
@@ -18227,18 +19147,20 @@ static int generateBlockDataAndStatistics(IBox* tightWorldBox, IBox* worldBox)
     // Faces that get merged into new, larger faces are "deleted" by marking the normalIndex to HAS_BEEN_MERGED,
     // just to save room that would be needed for a flag.
     // Guard rails added so that no one gets clever and tries to turn on decimation for 3D printing, or for mosaics, or for individual block export.
-    if (gModel.options->pEFD->chkDecimate && gModel.exportTiles && !gModel.print3D && !(gModel.options->exportFlags & EXPT_INDIVIDUAL_BLOCKS)) {
+    if (simplifyMesh) {
         assert(gModel.exportTiles);
         retCode |= decimateMesh();
         if (retCode & MW_WORLD_EXPORT_TOO_LARGE)
             return retCode;
 
         // If we added any faces, remove extra stuff at this point.
-        if (gModel.simplifyFaceSavings > 0) {
+        // Merging faces as they were made leaves the corner blocks' other vertices unused.
+        if (gModel.simplifyFaceSavings > 0 || meshSavings > 0) {
             // only really needed for OBJ, which has unified sets of vertices, but we clean up for USD anyway, just to make it easier to keep track of stats.
             //((gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_ABS_OBJ) || (gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_REL_OBJ))) {
             removeUnusedFacesAndVertices();
         }
+        gModel.simplifyFaceSavings += meshSavings;
     }
 
     // Do the scaling and rotations to place
@@ -18607,6 +19529,47 @@ static int faceIdCompare(void* context, const void* str1, const void* str2)
     else return ((f1->materialType < f2->materialType) ? -1 : 1);
 }
 
+// Sort faces as qsort_s() with the comparison function for the order would, but by radix sort on keys made from the
+// fields compared. The face index tie break is sorted on first, as the sort is stable. If out of memory, use qsort_s().
+static void sortFaces(FaceRecord** faceList, int faceCount, int order)
+{
+    unsigned long long* keys = (unsigned long long*)malloc(faceCount * sizeof(unsigned long long));
+    if (keys == NULL || !radixSortFaces(faceList, keys, faceCount, order)) {
+        qsort_s(faceList, faceCount, sizeof(FaceRecord*),
+            (order == FACE_ORDER_ID) ? faceIdCompare : ((order == FACE_ORDER_TILE) ? tileIdCompare : tileUSDIdCompare), NULL);
+    }
+    free(keys);
+}
+
+// The radix sort for sortFaces(), using keys for faceCount keys. Returns false if out of memory.
+static bool radixSortFaces(FaceRecord** faceList, unsigned long long* keys, int faceCount, int order)
+{
+    int i;
+    for (i = 0; i < faceCount; i++)
+        keys[i] = RadixKeyInt(faceList[i]->faceIndex);
+    if (!RadixSortByKey((void**)faceList, keys, faceCount))
+        return false;
+
+    for (i = 0; i < faceCount; i++) {
+        FaceRecord* pFace = faceList[i];
+        unsigned long long typeData = ((unsigned long long)RadixKeyShort(pFace->materialType) << 16) | pFace->materialDataVal;
+        switch (order) {
+        default:
+            assert(0);
+        case FACE_ORDER_ID:
+            keys[i] = typeData;
+            break;
+        case FACE_ORDER_TILE:
+            keys[i] = (typeData << 32) | RadixKeyInt(gModel.uvIndexList[pFace->uvIndex[0]].swatchLoc);
+            break;
+        case FACE_ORDER_USD_TILE:
+            keys[i] = ((unsigned long long)RadixKeyInt(gModel.uvIndexList[pFace->uvIndex[0]].swatchLoc) << 32) | typeData;
+            break;
+        }
+    }
+    return RadixSortByKey((void**)faceList, keys, faceCount);
+}
+
 // sort by instance hash
 static int instanceUSDCompare(void* context, const void* str1, const void* str2)
 {
@@ -18649,7 +19612,7 @@ static int getDimensionsAndCount(Point dimensions)
             for (loc[Y] = gAirBox.min[Y]; loc[Y] <= gAirBox.max[Y]; loc[Y]++, boxIndex++)
             {
                 // if it's not air, then it's valid - update bounds
-                if (gBoxData[boxIndex].type > BLOCK_AIR)
+                if (gBoxType[boxIndex] > BLOCK_AIR)
                 {
                     // block is solid, may need to output some faces.
                     addBounds(loc, &bounds);
@@ -18712,12 +19675,46 @@ static void rotateLocation(Point pt)
     }
 }
 
-// check if a solid block is next to something that causes a face to be created
-static int checkAndCreateFaces(int boxIndex, IPoint loc)
+// Which faces of the solid block at boxIndex should be made, one bit per direction. Reads the box cells only, so can run on
+// any thread.
+static int findFaceMask(int boxIndex)
+{
+    int type = gBoxType[boxIndex];
+    int view3D = !gModel.print3D;
+    int testPartial = gModel.options->pEFD->chkExportAll;
+    int faceMask = 0;
+    for (int faceDirection = 0; faceDirection < 6; faceDirection++)
+    {
+        int neighborBoxIndex = boxIndex + gFaceOffset[faceDirection];
+        if (checkMakeFace(type, gBoxType[neighborBoxIndex], view3D, testPartial, faceDirection, boxIndex, neighborBoxIndex, false))
+            faceMask |= (1 << faceDirection);
+    }
+    return faceMask;
+}
+
+// Fill in the face masks for the X slab band.firstX + taskIndex.
+static void findFaceMaskTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    FaceMaskBand* pBand = (FaceMaskBand*)userData;
+    unsigned char* mask = pBand->mask + taskIndex * pBand->zCount * pBand->yCount;
+    int x = pBand->firstX + taskIndex;
+    for (int z = gSolidBox.min[Z]; z <= gSolidBox.max[Z]; z++)
+    {
+        int boxIndex = BOX_INDEX(x, gSolidBox.min[Y], z);
+        for (int y = gSolidBox.min[Y]; y <= gSolidBox.max[Y]; y++, boxIndex++)
+        {
+            *mask++ = (unsigned char)((gBoxType[boxIndex] > BLOCK_AIR) ? findFaceMask(boxIndex) : 0);
+        }
+    }
+}
+
+// Make the faces of the solid block at boxIndex given by faceMask, from findFaceMask().
+static int checkAndCreateFaces(int boxIndex, IPoint loc, int faceMask)
 {
     int faceDirection;
     int neighborType;
-    int type = gBoxData[boxIndex].type;
+    int type = gBoxType[boxIndex];
     int computeHeights = 1;
     int isFullBlock = 0;	// to make compiler happy
     float heights[4];
@@ -18731,7 +19728,7 @@ static int checkAndCreateFaces(int boxIndex, IPoint loc)
     for (faceDirection = 0; faceDirection < 6; faceDirection++)
     {
         int neighborBoxIndex = boxIndex + gFaceOffset[faceDirection];
-        neighborType = gBoxData[neighborBoxIndex].type;
+        neighborType = gBoxType[neighborBoxIndex];
 
         // Could be added someday:
         // Check here if the face faces down and is on the border.
@@ -18753,7 +19750,7 @@ static int checkAndCreateFaces(int boxIndex, IPoint loc)
         // TODO: do we care if two transparent objects are touching each other? (Ice & water?)
         // Right now water and ice touching will generate no faces, which I think is fine.
         // so, create a face?
-        if (checkMakeFace(type, neighborType, !gModel.print3D, testPartial, faceDirection, boxIndex, neighborBoxIndex, false))
+        if (faceMask & (1 << faceDirection))
         {
             // Air (or water, or portal) found next to solid block: time to write it out.
             // First write out any vertices that are needed (this may do nothing, if they're
@@ -18814,6 +19811,245 @@ static int checkAndCreateFaces(int boxIndex, IPoint loc)
     return retCode;
 }
 
+// What a face of a full block must match in its plane's neighbors for them to be merged into one face, or NO_MESH_FACE if
+// it must be made by itself. Same tests as decimateMesh() uses on faces already made, which groups them by swatch alone.
+static int meshFaceKey(int boxIndex, int faceDirection)
+{
+    int type = gBoxType[boxIndex];
+    // fluid faces have their own heights and texture coordinates, so are made as always; decimateMesh() merges them
+    if (IS_FLUID(type, boxIndex))
+        return NO_MESH_FACE;
+
+    short materialType;
+    unsigned short materialDataVal;
+    int dataVal;
+    if (getFaceMaterial(boxIndex, faceDirection, materialType, materialDataVal, dataVal) != MW_NO_ERROR)
+        return NO_MESH_FACE;
+
+    int uvIndices[4];
+    int swatchLoc = getSwatch(materialType, dataVal, faceDirection, boxIndex, uvIndices);
+    if (swatchLoc < 0)
+        return NO_MESH_FACE;
+    short uvIndex[4];
+    for (int i = 0; i < 4; i++)
+        uvIndex[i] = (short)uvIndices[i];
+    if (!materialCanTile(materialType, swatchLoc, uvIndex))
+        return NO_MESH_FACE;
+    return swatchLoc;
+}
+
+// Make the faces of the solid blocks in the band's first slabs, whose face masks are found. Rather than making every face
+// and then having decimateMesh() sort and merge them, each plane of faces is merged greedily as it's made, as
+// mergeSimplifySet() does: from each corner face in turn, the rectangle of faces with the same key is grown by a column
+// and then a row, alternating, until neither fits or a side reaches SIMPLIFY_MAX_DIMENSION, and is made as a single face.
+// A rectangle stopped by the band's far X edge is added to pNextOpen instead, if not NULL; those in pOpen, from the band
+// before, are first widened into this one. savings is increased by the number of faces that didn't have to be made.
+static int meshFaceBand(FaceMaskBand* pBand, int slabs, OpenMergedFaceList* pOpen, OpenMergedFaceList* pNextOpen, int& savings)
+{
+    // plane X and Y axes for each normal axis, as extractZXYfromNormalAndBounds() has them
+    static const int planeAxes[3][2] = { { Z, Y }, { X, Z }, { X, Y } };
+    int retCode = MW_NO_ERROR;
+    int extent[3];
+    extent[X] = slabs;
+    extent[Y] = pBand->yCount;
+    extent[Z] = pBand->zCount;
+    int planeSize = max(extent[Z] * extent[Y], max(extent[X] * extent[Z], extent[X] * extent[Y]));
+    int* keys = (int*)malloc(planeSize * sizeof(int));
+    if (keys == NULL)
+        return MW_WORLD_EXPORT_TOO_LARGE;
+    int openIndex = 0;
+
+    for (int faceDirection = 0; faceDirection < 6; faceDirection++)
+    {
+        int normalAxis = faceDirection % 3;
+        int uAxis = planeAxes[normalAxis][0];
+        int vAxis = planeAxes[normalAxis][1];
+        int uCount = extent[uAxis];
+        int vCount = extent[vAxis];
+        int u, v, i, j;
+        IPoint bandLoc;
+        IPoint loc;
+        for (bandLoc[normalAxis] = 0; bandLoc[normalAxis] < extent[normalAxis]; bandLoc[normalAxis]++)
+        {
+            // find the key for each face in the plane; faces that can't merge are made right away
+            for (v = 0; v < vCount; v++)
+            {
+                for (u = 0; u < uCount; u++)
+                {
+                    int key = NO_MESH_FACE;
+                    bandLoc[uAxis] = u;
+                    bandLoc[vAxis] = v;
+                    if (pBand->mask[(bandLoc[X] * extent[Z] + bandLoc[Z]) * extent[Y] + bandLoc[Y]] & (1 << faceDirection))
+                    {
+                        loc[X] = pBand->firstX + bandLoc[X];
+                        loc[Y] = gSolidBox.min[Y] + bandLoc[Y];
+                        loc[Z] = gSolidBox.min[Z] + bandLoc[Z];
+                        int boxIndex = BOX_INDEXV(loc);
+                        key = meshFaceKey(boxIndex, faceDirection);
+                        if (key == NO_MESH_FACE)
+                        {
+                            retCode |= checkAndCreateFaces(boxIndex, loc, 1 << faceDirection);
+                            if (retCode >= MW_BEGIN_ERRORS)
+                                goto Exit;
+                        }
+                    }
+                    keys[v * uCount + u] = key;
+                }
+            }
+
+            // widen the faces left open in this plane by the band before, column by column, then make them; they were
+            // added in the same face direction and plane order as this loop's
+            int planeLoc = (normalAxis == X ? pBand->firstX : gSolidBox.min[normalAxis]) + bandLoc[normalAxis];
+            while (openIndex < pOpen->count && pOpen->faces[openIndex].faceDirection == faceDirection && pOpen->faces[openIndex].loc[normalAxis] == planeLoc)
+            {
+                OpenMergedFace* pFace = &pOpen->faces[openIndex++];
+                v = pFace->loc[vAxis] - gSolidBox.min[vAxis];
+                assert(pFace->loc[X] + pFace->xlen == pBand->firstX);
+                for (u = 0; (u < uCount) && (pFace->xlen < SIMPLIFY_MAX_DIMENSION); u++, pFace->xlen++)
+                {
+                    for (j = 0; (j < pFace->ylen) && (keys[(v + j) * uCount + u] == pFace->key); j++)
+                        ;
+                    if (j < pFace->ylen)
+                        break;
+                    for (j = 0; j < pFace->ylen; j++)
+                        keys[(v + j) * uCount + u] = NO_MESH_FACE;
+                }
+                retCode |= saveMergedFace(pFace->loc, faceDirection, uAxis, vAxis, pFace->xlen, pFace->ylen, savings);
+                if (retCode >= MW_BEGIN_ERRORS)
+                    goto Exit;
+            }
+
+            // merge and make the rest
+            for (v = 0; v < vCount; v++)
+            {
+                for (u = 0; u < uCount; u++)
+                {
+                    int key = keys[v * uCount + u];
+                    if (key == NO_MESH_FACE)
+                        continue;
+                    keys[v * uCount + u] = NO_MESH_FACE;
+                    bool testX = true;
+                    bool testY = true;
+                    bool atEdge = false;
+                    int xlen = 1;
+                    int ylen = 1;
+                    do {
+                        if (testX) {
+                            // the column to the right must match all the way down
+                            if (u + xlen >= uCount) {
+                                testX = false;
+                                atEdge = true;
+                            }
+                            else {
+                                for (j = 0; (j < ylen) && (keys[(v + j) * uCount + u + xlen] == key); j++)
+                                    ;
+                                if (j < ylen) {
+                                    testX = false;
+                                }
+                                else {
+                                    for (j = 0; j < ylen; j++)
+                                        keys[(v + j) * uCount + u + xlen] = NO_MESH_FACE;
+                                    xlen++;
+                                }
+                            }
+                        }
+                        if (testY) {
+                            // the row below must match all the way across
+                            if (v + ylen >= vCount) {
+                                testY = false;
+                            }
+                            else {
+                                int* row = &keys[(v + ylen) * uCount + u];
+                                for (i = 0; (i < xlen) && (row[i] == key); i++)
+                                    ;
+                                if (i < xlen) {
+                                    testY = false;
+                                }
+                                else {
+                                    for (i = 0; i < xlen; i++)
+                                        row[i] = NO_MESH_FACE;
+                                    ylen++;
+                                }
+                            }
+                        }
+                    } while ((testX || testY) && (xlen < SIMPLIFY_MAX_DIMENSION) && (ylen < SIMPLIFY_MAX_DIMENSION));
+
+                    bandLoc[uAxis] = u;
+                    bandLoc[vAxis] = v;
+                    loc[X] = pBand->firstX + bandLoc[X];
+                    loc[Y] = gSolidBox.min[Y] + bandLoc[Y];
+                    loc[Z] = gSolidBox.min[Z] + bandLoc[Z];
+                    if (atEdge && (uAxis == X) && (pNextOpen != NULL) && (xlen < SIMPLIFY_MAX_DIMENSION) && (ylen < SIMPLIFY_MAX_DIMENSION))
+                    {
+                        // may go on into the next band
+                        if (pNextOpen->count == pNextOpen->size)
+                        {
+                            int size = max(1024, 2 * pNextOpen->size);
+                            OpenMergedFace* faces = (OpenMergedFace*)realloc(pNextOpen->faces, size * sizeof(OpenMergedFace));
+                            if (faces == NULL)
+                            {
+                                retCode |= MW_WORLD_EXPORT_TOO_LARGE;
+                                goto Exit;
+                            }
+                            pNextOpen->faces = faces;
+                            pNextOpen->size = size;
+                        }
+                        OpenMergedFace* pFace = &pNextOpen->faces[pNextOpen->count++];
+                        Vec2Op(pFace->loc, =, loc);
+                        pFace->faceDirection = faceDirection;
+                        pFace->key = key;
+                        pFace->xlen = xlen;
+                        pFace->ylen = ylen;
+                        continue;
+                    }
+                    retCode |= saveMergedFace(loc, faceDirection, uAxis, vAxis, xlen, ylen, savings);
+                    if (retCode >= MW_BEGIN_ERRORS)
+                        goto Exit;
+                }
+            }
+        }
+    }
+    assert(openIndex == pOpen->count);
+
+Exit:
+    free(keys);
+    return retCode;
+}
+
+// Make the face of the block at loc, covering the xlen by ylen faces in its plane starting there.
+static int saveMergedFace(IPoint loc, int faceDirection, int uAxis, int vAxis, int xlen, int ylen, int& savings)
+{
+    // corners of the merged face, in plane X,Y steps, in the order setMergedFace() wants them
+    static const int cornerSteps[4][2] = { { 0, 1 }, { 1, 1 }, { 1, 0 }, { 0, 0 } };
+    int boxIndex = BOX_INDEXV(loc);
+
+    // the face of the corner block is made as usual, then stretched over the rest
+    int retCode = saveVertices(boxIndex, faceDirection, loc);
+    if (retCode >= MW_BEGIN_ERRORS) return retCode;
+    int faceCount = gModel.faceCount;
+    retCode |= saveFaceLoop(boxIndex, faceDirection, NULL, NULL, (faceDirection == 0));
+    if (retCode >= MW_BEGIN_ERRORS || gModel.faceCount == faceCount || (xlen == 1 && ylen == 1))
+        return retCode;
+
+    int vertexIndex[4];
+    for (int i = 0; i < 4; i++)
+    {
+        IPoint corner;
+        Vec2Op(corner, =, loc);
+        // faces toward +X, +Y or +Z are on the far side of the block
+        corner[faceDirection % 3] += (faceDirection >= DIRECTION_BLOCK_SIDE_HI_X) ? 1 : 0;
+        corner[uAxis] += cornerSteps[i][0] * xlen;
+        corner[vAxis] += cornerSteps[i][1] * ylen;
+        int gridIndex = BOX_INDEXV(corner);
+        retCode |= saveGridVertex(gridIndex, corner);
+        if (retCode >= MW_BEGIN_ERRORS) return retCode;
+        vertexIndex[i] = gModel.vertexIndices[gridIndex];
+    }
+    setMergedFace(gModel.faceList[gModel.faceCount - 1], vertexIndex, xlen, ylen);
+    savings += xlen * ylen - 1;
+    return retCode;
+}
+
 // Called for lava and water faces 
 // Assumes the following: billboards and lesser stuff has been output and their blocks made into air -
 //   this then means that if any neighbor is found, it must be a full block and so will cover the face.
@@ -19002,11 +20238,11 @@ static int neighborMayCoverFace(int neighborType, int view3D, int testPartial, i
 static int lesserBlockCoversWholeFace(int faceDirection, int neighborBoxIndex, int view3D)
 {
     // we have partial blocks possible. Check if neighbor's type exists at all
-    int type = gBoxData[neighborBoxIndex].type;
+    int type = gBoxType[neighborBoxIndex];
     // not air?
     if (type > BLOCK_AIR)
     {
-        int neighborDataVal = gBoxData[neighborBoxIndex].data;
+        int neighborDataVal = gBoxDataVal[neighborBoxIndex];
         // a minor block exists, so check its coverage given the face direction
         switch (type)
         {
@@ -19317,7 +20553,7 @@ static int cornerHeights(int boxIndex, float heights[4])
         // OK, compute heights.
         int i;
         // hmmmm, not sure what this was for, but dataHeight is no longer accessed...
-        //int dataHeight = gBoxData[boxIndex].data;
+        //int dataHeight = gBoxDataVal[boxIndex];
         //if ( dataHeight >= 8 )
         //{
         //    dataHeight = 0;
@@ -19364,7 +20600,7 @@ static float computeUpperCornerHeight(int boxIndex, int x, int z)
         if (sameFluid(boxIndex, neighbor[i]))
         {
             // matches, so get neighbor's stored height
-            int neighborDataVal = gBoxData[neighbor[i]].data;
+            int neighborDataVal = gBoxDataVal[neighbor[i]];
 
             // if height is "full", add it times 10
             if (neighborDataVal >= 8 || neighborDataVal == 0)
@@ -19383,7 +20619,7 @@ static float computeUpperCornerHeight(int boxIndex, int x, int z)
             weight++;
         }
         // if neighbor is not considered solid, add one more
-        else if ((gBoxData[neighbor[i]].origType == BLOCK_AIR) || (gBlockDefinitions[gBoxData[neighbor[i]].origType].flags & BLF_DNE_FLUID))
+        else if ((gBoxOrigType[neighbor[i]] == BLOCK_AIR) || (gBlockDefinitions[gBoxOrigType[neighbor[i]]].flags & BLF_DNE_FLUID))
         {
             heightSum += 1.0f;
             weight++;
@@ -19418,13 +20654,13 @@ static float getFluidHeightPercent(int dataVal)
 static int sameFluid(int fluidBI, int typeBI)
 {
     // I think this is likely overkill, but the waterlogged and invisible edge of block code is so convoluted at this point, I'm testing both types, just to be safe
-    if (IS_WATER(gBoxData[fluidBI].type, fluidBI) || IS_WATER(gBoxData[fluidBI].origType, fluidBI)) {
-        return (IS_WATER(gBoxData[typeBI].type, typeBI) || IS_WATER(gBoxData[typeBI].origType, typeBI));
+    if (IS_WATER(gBoxType[fluidBI], fluidBI) || IS_WATER(gBoxOrigType[fluidBI], fluidBI)) {
+        return (IS_WATER(gBoxType[typeBI], typeBI) || IS_WATER(gBoxOrigType[typeBI], typeBI));
     }
     else
     {
-        assert((gBoxData[fluidBI].origType == BLOCK_LAVA) || (gBoxData[fluidBI].origType == BLOCK_STATIONARY_LAVA));
-        return ((gBoxData[typeBI].origType == BLOCK_LAVA) || (gBoxData[typeBI].origType == BLOCK_STATIONARY_LAVA));
+        assert((gBoxOrigType[fluidBI] == BLOCK_LAVA) || (gBoxOrigType[fluidBI] == BLOCK_STATIONARY_LAVA));
+        return ((gBoxOrigType[typeBI] == BLOCK_LAVA) || (gBoxOrigType[typeBI] == BLOCK_STATIONARY_LAVA));
     }
 }
 
@@ -19518,7 +20754,7 @@ static int saveVertices(int boxIndex, int faceDirection, IPoint loc)
     int vertexIndex;  // cppcheck-suppress 398
     int i;
     IPoint offset;
-    float* pt;
+    IPoint corner;
     int retCode = MW_NO_ERROR;
 
     // four vertices to output, check that they exist
@@ -19533,44 +20769,159 @@ static int saveVertices(int boxIndex, int faceDirection, IPoint loc)
             offset[Y] +
             offset[Z] * gBoxSize[Y];
 
-        // just to feel super-safe, check we're OK - should not be needed...
-        if (vertexIndex < 0 || vertexIndex > gBoxSizeXYZ)
-        {
-            assert(0);
-            return retCode | MW_INTERNAL_ERROR;
-        }
+        Vec3Op(corner, =, loc, +, offset);
+        retCode |= saveGridVertex(vertexIndex, corner);
+        if (retCode >= MW_BEGIN_ERRORS) return retCode;
+    }
+    return retCode;
+}
 
-        if (gModel.vertexIndices[vertexIndex] == NO_INDEX_SET)
-        {
-            // need to give an index and write out vertex location
-            retCode |= checkVertexListSize();
-            if (retCode >= MW_BEGIN_ERRORS) return retCode;
+// Make sure the vertex at grid corner vertexIndex, which is at loc, has been output.
+static int saveGridVertex(int vertexIndex, IPoint loc)
+{
+    float* pt;
+    int retCode = MW_NO_ERROR;
 
-            gModel.vertexIndices[vertexIndex] = gModel.vertexCount;
-            pt = (float*)gModel.vertices[gModel.vertexCount];
+    // just to feel super-safe, check we're OK - should not be needed...
+    if (vertexIndex < 0 || vertexIndex > gBoxSizeXYZ)
+    {
+        assert(0);
+        return retCode | MW_INTERNAL_ERROR;
+    }
 
-            // for now, we use exactly the same coordinates as Minecraft does.
-            //xOut = (float)(1-gWorld2BoxOffset[X] + xloc + xoff);
-            //yOut = (float)(1-gWorld2BoxOffset[Y] + yloc + yoff);
-            //zOut = (float)(1-gWorld2BoxOffset[Z] + zloc + zoff);
-            // centered on origin, good for Blender import. I put Y==0, X & Z centered
-            pt[X] = (float)(loc[X] + offset[X]);
-            pt[Y] = (float)(loc[Y] + offset[Y]);
-            pt[Z] = (float)(loc[Z] + offset[Z]);
+    if (gModel.vertexIndices[vertexIndex] == NO_INDEX_SET)
+    {
+        // need to give an index and write out vertex location
+        retCode |= checkVertexListSize();
+        if (retCode >= MW_BEGIN_ERRORS) return retCode;
 
-            gModel.vertexCount++;
-            assert(gModel.vertexCount <= gModel.vertexListSize);
-        }
+        gModel.vertexIndices[vertexIndex] = gModel.vertexCount;
+        pt = (float*)gModel.vertices[gModel.vertexCount];
+
+        // for now, we use exactly the same coordinates as Minecraft does.
+        //xOut = (float)(1-gWorld2BoxOffset[X] + xloc + xoff);
+        //yOut = (float)(1-gWorld2BoxOffset[Y] + yloc + yoff);
+        //zOut = (float)(1-gWorld2BoxOffset[Z] + zloc + zoff);
+        // centered on origin, good for Blender import. I put Y==0, X & Z centered
+        pt[X] = (float)loc[X];
+        pt[Y] = (float)loc[Y];
+        pt[Z] = (float)loc[Z];
+
+        gModel.vertexCount++;
+        assert(gModel.vertexCount <= gModel.vertexListSize);
     }
     return retCode;
 }
 
+// Find the material for a face of a block, as saveFaceLoop() stores it. dataVal is the data value the swatch is found from.
+static int getFaceMaterial(int boxIndex, int faceDirection, short& materialType, unsigned short& materialDataVal, int& dataVal)
+{
+    unsigned short originalType = gBoxType[boxIndex];
+    dataVal = 0;
+    // for debugging: instead of outputting material, output group ID
+    // as the material
+    if (gModel.options->exportFlags & EXPT_DEBUG_SHOW_GROUPS)
+    {
+        materialType = (short)getMaterialUsingGroup(gBoxGroup ? gBoxGroup[boxIndex] : NO_GROUP_SET);
+        materialDataVal = 0;
+    }
+    else
+    {
+        // if we're doing FLATTOP compression, the topId and dataVal for the block will
+        // have been set to what is above the block before now (in the filter code).
+        // If the value is not 0 (air), use that material instead
+        int special = 0;
+        if (gBoxFlatFlags[boxIndex])
+        {
+            switch (faceDirection)
+            {
+            case DIRECTION_BLOCK_TOP:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_ABOVE)
+                {
+                    materialType = gBoxOrigType[boxIndex + 1];
+                    dataVal = gBoxDataVal[boxIndex + 1];    // this should still be intact, even if neighbor block is cleared to air
+                    special = 1;
+                }
+                break;
+            case DIRECTION_BLOCK_BOTTOM:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_BELOW)
+                {
+                    materialType = gBoxOrigType[boxIndex - 1];
+                    dataVal = gBoxDataVal[boxIndex - 1];    // this should still be intact, even if neighbor block is cleared to air
+                    special = 1;
+                }
+                break;
+            case DIRECTION_BLOCK_SIDE_LO_X:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_LO_X)
+                {
+                    materialType = gBoxOrigType[boxIndex - gBoxSizeYZ];
+                    dataVal = gBoxDataVal[boxIndex - gBoxSizeYZ];
+                    special = 1;
+                }
+                break;
+            case DIRECTION_BLOCK_SIDE_HI_X:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_HI_X)
+                {
+                    materialType = gBoxOrigType[boxIndex + gBoxSizeYZ];
+                    dataVal = gBoxDataVal[boxIndex + gBoxSizeYZ];
+                    special = 1;
+                }
+                break;
+            case DIRECTION_BLOCK_SIDE_LO_Z:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_LO_Z)
+                {
+                    materialType = gBoxOrigType[boxIndex - gBoxSize[Y]];
+                    dataVal = gBoxDataVal[boxIndex - gBoxSize[Y]];
+                    special = 1;
+                }
+                break;
+            case DIRECTION_BLOCK_SIDE_HI_Z:
+                if (gBoxFlatFlags[boxIndex] & FLAT_FACE_HI_Z)
+                {
+                    materialType = gBoxOrigType[boxIndex + gBoxSize[Y]];
+                    dataVal = gBoxDataVal[boxIndex + gBoxSize[Y]];
+                    special = 1;
+                }
+                break;
+            default:
+                // only direction left is down, and nothing gets merged with those faces
+                break;
+            }
+        }
+        // did flattening happen?
+        if (!special)
+        {
+            // no flattening, normal storage.
+            materialType = originalType;
+            dataVal = gBoxDataVal[boxIndex];
+            materialDataVal = getSignificantMaterial(materialType, dataVal);
+        }
+        else
+        {
+            // A flattening has happened.
+            // Test just in case something's wedged
+            if (materialType == BLOCK_AIR)
+            {
+                assert(0);
+                materialType = originalType;
+                dataVal = gBoxDataVal[boxIndex];
+                materialDataVal = getSignificantMaterial(materialType, dataVal);
+                return MW_INTERNAL_ERROR;
+            }
+            else {
+                // normal case, flattening found and so save material data value
+                materialDataVal = getSignificantMaterial(materialType, dataVal);
+            }
+        }
+    }
+    return MW_NO_ERROR;
+}
+
 static int saveFaceLoop(int boxIndex, int faceDirection, float heights[4], int heightIndices[4], int firstFace)
 {
     int i;
     FaceRecord* face;
     int dataVal = 0;
-    unsigned short originalType = gBoxData[boxIndex].type;
     int computedSpecialUVs = 0;
     int specialUVindices[4];
     int regularUVindices[4];
@@ -19650,7 +21001,7 @@ static int saveFaceLoop(int boxIndex, int faceDirection, float heights[4], int h
                             v = 0.0f;
                         }
 
-                        type = gBoxData[boxIndex].type;
+                        type = gBoxType[boxIndex];
                         if (gModel.options->exportFlags & EXPT_OUTPUT_TEXTURE_SWATCHES)
                             // we used to check if the block had no textures, but now all blocks have textures, or are invisible
                             //    !( gBlockDefinitions[type].flags & BLF_IMAGE_TEXTURE) )
@@ -19665,7 +21016,7 @@ static int saveFaceLoop(int boxIndex, int faceDirection, float heights[4], int h
                             if (IS_WATER(type, boxIndex)) {
                                 if ((faceDirection != DIRECTION_BLOCK_BOTTOM) && (faceDirection != DIRECTION_BLOCK_TOP))
                                 {
-                                    int neighborType = gBoxData[boxIndex + gFaceOffset[faceDirection]].origType;
+                                    int neighborType = gBoxOrigType[boxIndex + gFaceOffset[faceDirection]];
                                     swatchLoc = ((neighborType == BLOCK_GLASS) || (neighborType == BLOCK_STAINED_GLASS)) ? SWATCH_INDEX(15, 25) : SWATCH_INDEX(8, 26);
                                 }
                             }
@@ -19694,102 +21045,9 @@ static int saveFaceLoop(int boxIndex, int faceDirection, float heights[4], int h
 
     if (gModel.options->exportFlags & (EXPT_OUTPUT_MATERIALS | EXPT_OUTPUT_TEXTURE))
     {
-        // for debugging: instead of outputting material, output group ID
-        // as the material
-        if (gModel.options->exportFlags & EXPT_DEBUG_SHOW_GROUPS)
-        {
-            face->materialType = (short)getMaterialUsingGroup(gBoxData[boxIndex].group);
-            face->materialDataVal = 0;
-        }
-        else
-        {
-            // if we're doing FLATTOP compression, the topId and dataVal for the block will
-            // have been set to what is above the block before now (in the filter code).
-            // If the value is not 0 (air), use that material instead
-            int special = 0;
-            if (gBoxData[boxIndex].flatFlags)
-            {
-                switch (faceDirection)
-                {
-                case DIRECTION_BLOCK_TOP:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_ABOVE)
-                    {
-                        face->materialType = gBoxData[boxIndex + 1].origType;
-                        dataVal = gBoxData[boxIndex + 1].data;    // this should still be intact, even if neighbor block is cleared to air
-                        special = 1;
-                    }
-                    break;
-                case DIRECTION_BLOCK_BOTTOM:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_BELOW)
-                    {
-                        face->materialType = gBoxData[boxIndex - 1].origType;
-                        dataVal = gBoxData[boxIndex - 1].data;    // this should still be intact, even if neighbor block is cleared to air
-                        special = 1;
-                    }
-                    break;
-                case DIRECTION_BLOCK_SIDE_LO_X:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_LO_X)
-                    {
-                        face->materialType = gBoxData[boxIndex - gBoxSizeYZ].origType;
-                        dataVal = gBoxData[boxIndex - gBoxSizeYZ].data;
-                        special = 1;
-                    }
-                    break;
-                case DIRECTION_BLOCK_SIDE_HI_X:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_HI_X)
-                    {
-                        face->materialType = gBoxData[boxIndex + gBoxSizeYZ].origType;
-                        dataVal = gBoxData[boxIndex + gBoxSizeYZ].data;
-                        special = 1;
-                    }
-                    break;
-                case DIRECTION_BLOCK_SIDE_LO_Z:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_LO_Z)
-                    {
-                        face->materialType = gBoxData[boxIndex - gBoxSize[Y]].origType;
-                        dataVal = gBoxData[boxIndex - gBoxSize[Y]].data;
-                        special = 1;
-                    }
-                    break;
-                case DIRECTION_BLOCK_SIDE_HI_Z:
-                    if (gBoxData[boxIndex].flatFlags & FLAT_FACE_HI_Z)
-                    {
-                        face->materialType = gBoxData[boxIndex + gBoxSize[Y]].origType;
-                        dataVal = gBoxData[boxIndex + gBoxSize[Y]].data;
-                        special = 1;
-                    }
-                    break;
-                default:
-                    // only direction left is down, and nothing gets merged with those faces
-                    break;
-                }
-            }
-            // did flattening happen?
-            if (!special)
-            {
-                // no flattening, normal storage.
-                face->materialType = originalType;
-                dataVal = gBoxData[boxIndex].data;
-                face->materialDataVal = getSignificantMaterial(face->materialType, dataVal);
-            }
-            else
-            {
-                // A flattening has happened.
-                // Test just in case something's wedged
-                if (face->materialType == BLOCK_AIR)
-                {
-                    assert(0);
-                    face->materialType = originalType;
-                    dataVal = gBoxData[boxIndex].data;
-                    face->materialDataVal = getSignificantMaterial(face->materialType, dataVal);
-                    return retCode | MW_INTERNAL_ERROR;
-                }
-                else {
-                    // normal case, flattening found and so save material data value
-                    face->materialDataVal = getSignificantMaterial(face->materialType, dataVal);
-                }
-            }
-        }
+        int materialCode = getFaceMaterial(boxIndex, faceDirection, face->materialType, face->materialDataVal, dataVal);
+        if (materialCode != MW_NO_ERROR)
+            return retCode | materialCode;
 
         assert(face->materialType);
     }
@@ -20120,7 +21378,7 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
             SWATCH_SWITCH_SIDE_BOTTOM(faceDirection, 3, 0, 2, 0);
             // check if block above is snow (or flagged as "snowy"); if so, use snow side tile; note we
             // check against the original type, since the snow block is likely to be flattened
-            if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxData[backgroundIndex + 1].origType == BLOCK_SNOW))
+            if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxOrigType[backgroundIndex + 1] == BLOCK_SNOW))
             {
                 if (faceDirection != DIRECTION_BLOCK_TOP && faceDirection != DIRECTION_BLOCK_BOTTOM)
                 {
@@ -20154,7 +21412,7 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                 // same as grass block: switch to snow covered look
                 // check if block above is snow (or flagged as "snowy"); if so, use snow side tile; note we
                 // check against the original type, since the snow block is likely to be flattened
-                if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxData[backgroundIndex + 1].origType == BLOCK_SNOW))
+                if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxOrigType[backgroundIndex + 1] == BLOCK_SNOW))
                 {
                     if (faceDirection != DIRECTION_BLOCK_TOP && faceDirection != DIRECTION_BLOCK_BOTTOM)
                     {
@@ -22249,11 +23507,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     if (faceDirection == DIRECTION_BLOCK_SIDE_LO_Z)
                     {
                         swatchLoc = SWATCH_INDEX(11, 1);
-                        if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
@@ -22262,11 +23520,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     {
                         // back of chest, on possibly long face
                         // is neighbor to north a chest, too?
-                        if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
@@ -22274,11 +23532,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     else if (faceDirection == DIRECTION_BLOCK_TOP || faceDirection == DIRECTION_BLOCK_BOTTOM) // top or bottom
                     {
                         // back of chest, on possibly long face - keep it a "side" unless changed by neighbor
-                        if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 14);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 14);
                         }
@@ -22291,12 +23549,12 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                         // front of chest, on possibly long face
                         swatchLoc = SWATCH_INDEX(11, 1);	// front
                         // is neighbor to east also a chest?
-                        if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
                         // else, is neighbor to west also a chest?
-                        else if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
@@ -22304,11 +23562,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     else if (faceDirection == DIRECTION_BLOCK_SIDE_LO_Z) // north
                     {
                         // back of chest, on possibly long face - keep it a "side" unless changed by neighbor
-                        if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
@@ -22316,11 +23574,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     else if (faceDirection == DIRECTION_BLOCK_TOP || faceDirection == DIRECTION_BLOCK_BOTTOM) // top or bottom
                     {
                         // back of chest, on possibly long face - keep it a "side" unless changed by neighbor
-                        if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 14);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 14);
                         }
@@ -22330,11 +23588,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     if (faceDirection == DIRECTION_BLOCK_SIDE_LO_X) // west
                     {
                         swatchLoc = SWATCH_INDEX(11, 1);
-                        if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
@@ -22343,11 +23601,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     {
                         // back of chest, on possibly long face
                         // is neighbor to north a chest, too?
-                        if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
@@ -22355,11 +23613,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     else if (faceDirection == DIRECTION_BLOCK_TOP || faceDirection == DIRECTION_BLOCK_BOTTOM) // top or bottom
                     {
                         // back of chest, on possibly long face - keep it a "side" unless changed by neighbor
-                        if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 14);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 14);
                         }
@@ -22370,11 +23628,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     if (faceDirection == DIRECTION_BLOCK_SIDE_HI_X)
                     {
                         swatchLoc = SWATCH_INDEX(11, 1);
-                        if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
@@ -22383,11 +23641,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     {
                         // back of chest, on possibly long face
                         // is neighbor to north a chest, too?
-                        if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
@@ -22395,11 +23653,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     else if (faceDirection == DIRECTION_BLOCK_TOP || faceDirection == DIRECTION_BLOCK_BOTTOM) // top or bottom
                     {
                         // back of chest, on possibly long face - keep it a "side" unless changed by neighbor
-                        if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 14);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 14);
                         }
@@ -22413,11 +23671,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     // We leave this code here for older worlds encountered.
                     if (faceDirection == DIRECTION_BLOCK_SIDE_LO_Z)
                     {
-                        if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
@@ -22426,22 +23684,22 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     {
                         // back of chest, on possibly long face
                         // is neighbor to north a chest, too?
-                        if (gBoxData[backgroundIndex - gBoxSizeYZ].origType == type)
+                        if (gBoxOrigType[backgroundIndex - gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
-                        else if (gBoxData[backgroundIndex + gBoxSizeYZ].origType == type)
+                        else if (gBoxOrigType[backgroundIndex + gBoxSizeYZ] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
                     }
                     else if (faceDirection == DIRECTION_BLOCK_SIDE_HI_X)
                     {
-                        if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 2);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 2);
                         }
@@ -22450,11 +23708,11 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
                     {
                         // back of chest, on possibly long face
                         // is neighbor to north a chest, too?
-                        if (gBoxData[backgroundIndex + gBoxSize[Y]].origType == type)
+                        if (gBoxOrigType[backgroundIndex + gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(9, 3);
                         }
-                        else if (gBoxData[backgroundIndex - gBoxSize[Y]].origType == type)
+                        else if (gBoxOrigType[backgroundIndex - gBoxSize[Y]] == type)
                         {
                             swatchLoc = SWATCH_INDEX(10, 3);
                         }
@@ -23042,7 +24300,7 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
         case BLOCK_VINES:						// getSwatch
             // special case (and I'm still not sure about this), if background is air, then
             // just use the default vine, whatever it is
-            if (gBoxData[backgroundIndex].type == BLOCK_AIR || gBoxData[backgroundIndex].type == BLOCK_VINES)
+            if (gBoxType[backgroundIndex] == BLOCK_AIR || gBoxType[backgroundIndex] == BLOCK_VINES)
             {
                 swatchLoc = SWATCH_INDEX(15, 8);
             }
@@ -23185,7 +24443,7 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
             // same as grass block: switch to snow covered look
             // check if block above is snow (or flagged as "snowy"); if so, use snow side tile; note we
             // check against the original type, since the snow block is likely to be flattened
-            if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxData[backgroundIndex + 1].origType == BLOCK_SNOW))
+            if (gIs13orNewer ? (dataVal & SNOWY_BIT) : (gBoxOrigType[backgroundIndex + 1] == BLOCK_SNOW))
             {
                 if (faceDirection != DIRECTION_BLOCK_TOP && faceDirection != DIRECTION_BLOCK_BOTTOM)
                 {
@@ -23786,7 +25044,7 @@ static int getSwatch(int type, int dataVal, int faceDirection, int backgroundInd
             // if sides are next to a glass block, use overlay water instead.
             if ((faceDirection != DIRECTION_BLOCK_BOTTOM) && (faceDirection != DIRECTION_BLOCK_TOP))
             {
-                neighborType = gBoxData[backgroundIndex + gFaceOffset[faceDirection]].origType;
+                neighborType = gBoxOrigType[backgroundIndex + gFaceOffset[faceDirection]];
                 swatchLoc = ((neighborType == BLOCK_GLASS) || (neighborType == BLOCK_STAINED_GLASS)) ? SWATCH_INDEX(15, 25) : SWATCH_INDEX(8, 26);
             }
             break;
@@ -25084,7 +26342,7 @@ static int getCompositeSwatch(int swatchLoc, int backgroundIndex, int faceDirect
     else
     {
         gModel.alreadyAskedForComposite = true;
-        backgroundSwatchLoc = getSwatch(gBoxData[backgroundIndex].type, gBoxData[backgroundIndex].data, faceDirection, backgroundIndex, NULL);
+        backgroundSwatchLoc = getSwatch(gBoxType[backgroundIndex], gBoxDataVal[backgroundIndex], faceDirection, backgroundIndex, NULL);
     }
 
 
@@ -25333,6 +26591,57 @@ static void freeModel(Model* pModel)
 {
     int catIndex;
 
+    freeModelGeometry(pModel);
+
+    for (catIndex = 0; catIndex < TOTAL_CATEGORIES; catIndex++) {
+        if (pModel->pInputTerrainImage[catIndex])
+        {
+            readpng_cleanup(1, gModel.pInputTerrainImage[catIndex]);
+            delete pModel->pInputTerrainImage[catIndex];
+            pModel->pInputTerrainImage[catIndex] = NULL;
+        }
+    }
+
+    if (pModel->instance)
+    {
+        free(pModel->instance);
+        pModel->instance = NULL;
+    }
+    if (pModel->instanceLoc)
+    {
+        free(pModel->instanceLoc);
+        pModel->instanceLoc = NULL;
+    }
+
+    if (pModel->pPNGtexture)
+    {
+        writepng_cleanup(pModel->pPNGtexture);
+        delete pModel->pPNGtexture;
+        pModel->pPNGtexture = NULL;
+    }
+
+    for (int cat = 1; cat < TOTAL_CATEGORIES; cat++) {
+        if (pModel->pPBRtexture[cat]) {
+            writepng_cleanup(pModel->pPBRtexture[cat]);
+            delete pModel->pPBRtexture[cat];
+            pModel->pPBRtexture[cat] = NULL;
+        }
+    }
+
+    SwatchComposite* pSwatch = gModel.swatchCompositeList;
+    while (pSwatch)
+    {
+        SwatchComposite* pSwatchNext = pSwatch->next;
+        free(pSwatch);
+
+        pSwatch = pSwatchNext;
+    }
+    gModel.swatchCompositeList = gModel.swatchCompositeListEnd = NULL;
+}
+
+// Free the faces, vertices and texture coordinates made for output, leaving the output texture and the rest.
+static void freeModelGeometry(Model* pModel)
+{
     if (pModel->vertices)
     {
         free(pModel->vertices);
@@ -25386,55 +26695,11 @@ static void freeModel(Model* pModel)
         pModel->faceSize = 0;
     }
 
-    for (catIndex = 0; catIndex < TOTAL_CATEGORIES; catIndex++) {
-        if (pModel->pInputTerrainImage[catIndex])
-        {
-            readpng_cleanup(1, gModel.pInputTerrainImage[catIndex]);
-            delete pModel->pInputTerrainImage[catIndex];
-            pModel->pInputTerrainImage[catIndex] = NULL;
-        }
-    }
-
-    if (pModel->instance)
-    {
-        free(pModel->instance);
-        pModel->instance = NULL;
-    }
-    if (pModel->instanceLoc)
-    {
-        free(pModel->instanceLoc);
-        pModel->instanceLoc = NULL;
-    }
-
-    if (pModel->pPNGtexture)
-    {
-        writepng_cleanup(pModel->pPNGtexture);
-        delete pModel->pPNGtexture;
-        pModel->pPNGtexture = NULL;
-    }
-
-    for (int cat = 1; cat < TOTAL_CATEGORIES; cat++) {
-        if (pModel->pPBRtexture[cat]) {
-            writepng_cleanup(pModel->pPBRtexture[cat]);
-            delete pModel->pPBRtexture[cat];
-            pModel->pPBRtexture[cat] = NULL;
-        }
-    }
-
-    SwatchComposite* pSwatch = gModel.swatchCompositeList;
-    while (pSwatch)
-    {
-        SwatchComposite* pSwatchNext = pSwatch->next;
-        free(pSwatch);
-
-        pSwatch = pSwatchNext;
-    }
-    gModel.swatchCompositeList = gModel.swatchCompositeListEnd = NULL;
-
     // simplify
-    if (gModel.simplifyUVGridList)
+    if (pModel->simplifyUVGridList)
     {
-        free(gModel.simplifyUVGridList);
+        free(pModel->simplifyUVGridList);
+        pModel->simplifyUVGridList = NULL;
     }
 }
 
@@ -25951,32 +27216,285 @@ static int mosaicUVtoSeparateUV()
 // return 0 if no write
 static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC)
 {
-    // set to 1 if you want absolute (positive) indices used in the faces
-    int absoluteIndices = (gModel.options->exportFlags & EXPT_OUTPUT_OBJ_REL_COORDINATES) ? 0 : 1;
+    memset(&gOBJState, 0, sizeof(OBJOutputState));
+    int retCode = writeOBJHeader(pWorldGuide, worldBox, tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
 
-    wchar_t objFileNameWithSuffix[MAX_PATH_AND_FILE];
+    retCode |= writeOBJGeometry();
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
 
-    char outputString[MAX_PATH_AND_FILE];
-    char mtlName[MAX_PATH_AND_FILE];
-    mtlName[0] = 0; // initialize to avoid warnings
+    retCode |= writeOBJFinish();
+    return retCode;
+}
+
+// Size, in blocks, of the square tiles of chunks that a rendering export to OBJ is read, processed and written out in,
+// or 0 if the export is done all at once. The model must be scaled by block, as other scalings depend on the whole model.
+static int getExportTileSize(int fileType, IBox* worldBox)
+{
+    // tiles are whole chunks
+    int tileSize = 16 * ((gModel.options->exportTileSize + 15) / 16);
+    if (tileSize <= 0 ||
+        ((fileType != FILE_TYPE_WAVEFRONT_REL_OBJ) && (fileType != FILE_TYPE_WAVEFRONT_ABS_OBJ)) ||
+        gModel.print3D ||
+        !gModel.options->pEFD->radioScaleByBlock)
+    {
+        return 0;
+    }
+    // not worth it if the export fits in a single tile
+    if (((int)floor((float)worldBox->min[X] / (float)tileSize) == (int)floor((float)worldBox->max[X] / (float)tileSize)) &&
+        ((int)floor((float)worldBox->min[Z] / (float)tileSize) == (int)floor((float)worldBox->max[Z] / (float)tileSize)))
+    {
+        return 0;
+    }
+    return tileSize;
+}
+
+// Export to OBJ a tile of chunks at a time, so that only one tile's blocks, faces and vertices are in memory at once.
+// Each tile is read in, filtered, made into faces and appended to a scratch file, then freed. populateBox() reads
+// in a block past a tile's side when there's something at that side, so faces at the seams between tiles are removed
+// and blocks that depend on their neighbors are made just as they would be without tiles. Once all tiles are done, the
+// OBJ file is written with the statistics for the whole export at the top, then the scratch file is copied in after
+// them. The tile at the center of the export is done first, so the texture is made with the biome found there.
+static int writeOBJTiles(WorldGuide* pWorldGuide, IBox* worldBox, int tileSize, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC)
+{
+    int retCode = MW_NO_ERROR;
+    char outputString[256];
+    wchar_t statusString[1024];
+
+    int firstTileX = (int)floor((float)worldBox->min[X] / (float)tileSize) * tileSize;
+    int firstTileZ = (int)floor((float)worldBox->min[Z] / (float)tileSize) * tileSize;
+    int numTilesZ = (worldBox->max[Z] - firstTileZ) / tileSize + 1;
+    int numTiles = ((worldBox->max[X] - firstTileX) / tileSize + 1) * numTilesZ;
+    gpTiledExportBox = worldBox;
+    // the tile holding the center that createBaseMaterialTexture() takes the biome from
+    int centerTile = ((getTiledExportCenter(X) - firstTileX) / tileSize) * numTilesZ + (getTiledExportCenter(Z) - firstTileZ) / tileSize;
+    bool anyTile = false;
+
+    // totals over all the tiles, for the statistics
+    int vertexCount = 0;
+    int faceCount = 0;
+    int blockCount = 0;
+    int billboardCount = 0;
+    int simplifyFaceSavings = 0;
+    IBox tightenedWorldBox;
+    VecScalar(tightenedWorldBox.min, =, INT_MAX);
+    VecScalar(tightenedWorldBox.max, =, INT_MIN);
+
+    wchar_t partFileName[MAX_PATH_AND_FILE];
+    concatFileName3(partFileName, gOutputFilePath, gOutputFileRoot, L".obj.part");
+    gModelFile = OutCreate(partFileName);
+    if (gModelFile == INVALID_HANDLE_VALUE)
+    {
+        gpTiledExportBox = NULL;
+        return MW_CANNOT_CREATE_FILE;
+    }
+    bool partFileOpen = true;
+    memset(&gOBJState, 0, sizeof(OBJOutputState));
+
+    gXformScale = 1.0f;
+    gProgressNumTiles = numTiles;
+
+    for (int tileCount = 0; tileCount < numTiles && retCode < MW_BEGIN_ERRORS; tileCount++)
+    {
+        // the center tile first, then the rest in order
+        int tile = (tileCount == 0) ? centerTile : ((tileCount <= centerTile) ? tileCount - 1 : tileCount);
+        int tileX = firstTileX + (tile / numTilesZ) * tileSize;
+        int tileZ = firstTileZ + (tile % numTilesZ) * tileSize;
+
+        gProgressTile = tileCount;
+        swprintf_s(statusString, 1024, L"Export tile %d of %d", tileCount + 1, numTiles);
+        UPDATE_STATUS(gProgress.start.readBlocks, statusString);
 
-    int i, j, groupCount, index;
+        IBox tileBox;
+        initializeWorldData(&tileBox, max(worldBox->min[X], tileX), worldBox->min[Y], max(worldBox->min[Z], tileZ),
+            min(worldBox->max[X], tileX + tileSize - 1), worldBox->max[Y], min(worldBox->max[Z], tileZ + tileSize - 1));
 
-    unsigned char outputMaterial[NUM_BLOCKS];
+        // each tile's geometry starts afresh
+        gModel.vertexCount = 0;
+        gModel.uvIndexCount = 0;
+        gModel.uvGridListCount = 0;
+        memset(gModel.uvGridList, 0, sizeof(gModel.uvGridList));
+        gModel.faceCount = 0;
+        gModel.faceSize = 0;
+        gModel.triangleCount = 0;
+        gModel.billboardCount = 0;
+        gModel.simplifyFaceSavings = 0;
+        gModel.simplifyVertexSavings = 0;
 
+        int tileRetCode = writeOBJTile(pWorldGuide, &tileBox, worldBox, pCBC, partFileOpen);
+        if (tileRetCode < MW_BEGIN_NOTHING_TO_DO)
+        {
+            anyTile = true;
+            vertexCount += gModel.vertexCount;
+            faceCount += gModel.faceCount;
+            blockCount += gModel.blockCount;
+            billboardCount += gModel.billboardCount;
+            simplifyFaceSavings += gModel.simplifyFaceSavings;
+            for (int axis = X; axis <= Z; axis++)
+            {
+                tightenedWorldBox.min[axis] = min(tightenedWorldBox.min[axis], tileBox.min[axis]);
+                tightenedWorldBox.max[axis] = max(tightenedWorldBox.max[axis], tileBox.max[axis]);
+            }
+            retCode |= tileRetCode;
+        }
+        else if (tileRetCode >= MW_BEGIN_ERRORS)
+        {
+            retCode |= tileRetCode;
+        }
+        else
+        {
+            // nothing in this tile, so skip it, keeping any warnings
+            retCode |= tileRetCode & (MW_BEGIN_NOTHING_TO_DO - 1);
+        }
+
+        freeModelGeometry(&gModel);
+        freeBoxCells();
+        if (gBiomeArray)
+            free(gBiomeArray);
+        gBiomeArray = NULL;
+    }
+
+    gpTiledExportBox = NULL;
+    gProgressNumTiles = 0;
+
+    if (partFileOpen && OutClose(gModelFile))
+        retCode |= MW_CANNOT_WRITE_TO_FILE;
+    if (retCode >= MW_BEGIN_ERRORS || !anyTile)
+    {
+        DeleteFile(partFileName);
+        // nothing in any tile?
+        return anyTile ? retCode : (retCode | MW_NO_BLOCKS_FOUND);
+    }
+
+    gModel.vertexCount = vertexCount;
+    gModel.faceCount = faceCount;
+    gModel.blockCount = blockCount;
+    gModel.billboardCount = billboardCount;
+    gModel.simplifyFaceSavings = simplifyFaceSavings;
+
+    retCode |= writeOBJHeader(pWorldGuide, worldBox, &tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
+    if (retCode < MW_BEGIN_ERRORS)
+    {
+        sprintf_s(outputString, 256, "\n# Exported in %d tiles of %d by %d blocks\n", numTiles, tileSize, tileSize);
+        if (OutWrite(gModelFile, outputString, strlen(outputString)))
+        {
+            OutClose(gModelFile);
+            retCode |= MW_CANNOT_WRITE_TO_FILE;
+        }
+        else
+        {
+            retCode |= appendToOBJFile(partFileName);
+        }
+    }
+    DeleteFile(partFileName);
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
+
+    retCode |= writeOBJFinish();
+    return retCode;
+}
+
+// World X or Z coordinate at the center of the tiled export, where a single export would take the biome from.
+static int getTiledExportCenter(int axis)
+{
+    assert(gpTiledExportBox);
+    // as for gBoxSize[axis] / 2, in box coordinates, of a box around the whole export
+    return gpTiledExportBox->min[axis] - 1 + (gpTiledExportBox->max[axis] - gpTiledExportBox->min[axis] + 3) / 2;
+}
+
+// Read in, filter and make faces for one tile of a tiled OBJ export, then append them to the open scratch OBJ file.
+// tileBox comes back with the solid bounds of the tile. partFileOpen is cleared if a write error closes the file.
+static int writeOBJTile(WorldGuide* pWorldGuide, IBox* tileBox, IBox* worldBox, ChangeBlockCommand* pCBC, bool& partFileOpen)
+{
+    int retCode = populateBox(pWorldGuide, pCBC, tileBox);
+    if (retCode >= MW_BEGIN_NOTHING_TO_DO)
+        return retCode;
+
+    // the texture is set up just once, for the first tile with something in it, normally the center one
+    if (gModel.textureResolution == 0)
+    {
+        retCode |= prepareExportTexture();
+        if (retCode >= MW_BEGIN_ERRORS)
+            return retCode;
+    }
+
+    retCode |= initializeModelData();
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
+
+    retCode |= filterBox(pCBC);
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
+
+    retCode |= determineScaleAndHollowAndMelt();
+    if (retCode >= MW_BEGIN_NOTHING_TO_DO)
+        return retCode;
+    if (!(gModel.options->exportFlags & EXPT_DEBUG_SHOW_GROUPS))
+    {
+        freeBoxGroups();
+    }
+
+    // the model is placed by the whole export volume, so the tiles line up
+    retCode |= generateBlockDataAndStatistics(tileBox, worldBox);
+    if (retCode >= MW_BEGIN_ERRORS)
+        return retCode;
+
+    retCode |= writeOBJGeometry();
+    if (retCode >= MW_BEGIN_ERRORS)
+        partFileOpen = false;
+    return retCode;
+}
+
+// Copy the file to the end of the open OBJ file. As with WERROR_MODEL(), the OBJ file is closed if there's an error.
+static int appendToOBJFile(const wchar_t* fileName)
+{
+    DWORD br;
+    PORTAFILE fh = PortaOpen(fileName);
+    char* buffer = (char*)malloc(APPEND_BUFFER_SIZE);
     int retCode = MW_NO_ERROR;
+    if (fh == INVALID_HANDLE_VALUE || buffer == NULL)
+    {
+        retCode = (buffer == NULL) ? MW_WORLD_EXPORT_TOO_LARGE : MW_CANNOT_WRITE_TO_FILE;
+    }
+    else
+    {
+        for (;;)
+        {
+            if (PortaRead(fh, buffer, APPEND_BUFFER_SIZE))
+            {
+                retCode = MW_CANNOT_WRITE_TO_FILE;
+                break;
+            }
+            if (br == 0)
+                break;
+            if (OutWrite(gModelFile, buffer, br))
+            {
+                retCode = MW_CANNOT_WRITE_TO_FILE;
+                break;
+            }
+        }
+    }
+    if (fh != INVALID_HANDLE_VALUE)
+        PortaClose(fh);
+    free(buffer);
+    if (retCode != MW_NO_ERROR)
+        OutClose(gModelFile);
+    return retCode;
+}
 
-    char worldNameUnderlined[MAX_PATH_AND_FILE];
-    int prevType;
+// Create the OBJ file and write its comments, material library and object name. As with WERROR_MODEL(),
+// the file is closed if there's an error.
+static int writeOBJHeader(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC)
+{
+    wchar_t objFileNameWithSuffix[MAX_PATH_AND_FILE];
 
-    FaceRecord* pFace;
+    char outputString[MAX_PATH_AND_FILE];
 
-    int vt[4];
+    int retCode = MW_NO_ERROR;
 
-#define OUTPUT_NORMALS
-#ifdef OUTPUT_NORMALS
-    int outputFaceDirection;
-#endif
+    char worldNameUnderlined[MAX_PATH_AND_FILE];
 
     int exportMaterials = gModel.options->exportFlags & EXPT_OUTPUT_MATERIALS;
 
@@ -25984,7 +27502,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
 
     // create the Wavefront OBJ file
     //DeleteFile(objFileNameWithSuffix);
-    gModelFile = PortaCreate(objFileNameWithSuffix);
+    gModelFile = OutCreate(objFileNameWithSuffix);
     addOutputFilenameToList(objFileNameWithSuffix);
     if (gModelFile == INVALID_HANDLE_VALUE)
         return retCode | MW_CANNOT_CREATE_FILE;
@@ -25994,11 +27512,11 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
     UPDATE_STATUS(-999.0f, statusString);
 
     sprintf_s(outputString, 256, "# Wavefront OBJ file made by Mineways version %d.%02d, http://mineways.com\n", gMinewaysMajorVersion, gMinewaysMinorVersion);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     retCode |= writeStatistics(gModelFile, NULL, pWorldGuide, worldBox, tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
     if (retCode >= MW_BEGIN_ERRORS)
-        goto Exit;
+        return retCode;
 
     // If we use materials, say where the file is
     if (exportMaterials)
@@ -26007,7 +27525,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
         sprintf_s(justMtlFileName, MAX_PATH_AND_FILE, "%s.mtl", gOutputFileRootCleanChar);
 
         sprintf_s(outputString, 256, "\nmtllib %s\n", justMtlFileName);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
 
     convertWcharPathUnderlined(worldNameUnderlined, pWorldGuide->world, false);
@@ -26019,15 +27537,56 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
         sprintf_s(outputString, 256, "\no %s__%d_%d_%d_to_%d_%d_%d\n", worldNameUnderlined,
             worldBox->min[X], worldBox->min[Y], worldBox->min[Z],
             worldBox->max[X], worldBox->max[Y], worldBox->max[Z]);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
 
+    return retCode;
+}
+
+// Write the model's normals, texture coordinates, vertices and faces to the open OBJ file. The indices written
+// follow on from those of any tile output before. As with WERROR_MODEL(), the file is closed if there's an error.
+static int writeOBJGeometry()
+{
+    // set to 1 if you want absolute (positive) indices used in the faces
+    int absoluteIndices = (gModel.options->exportFlags & EXPT_OUTPUT_OBJ_REL_COORDINATES) ? 0 : 1;
+
+    char outputString[MAX_PATH_AND_FILE];
+    char mtlName[MAX_PATH_AND_FILE];
+    mtlName[0] = 0; // initialize to avoid warnings
+
+    int i, j, index;
+
+    int retCode = MW_NO_ERROR;
+
+    int prevType;
+
+    FaceRecord* pFace;
+
+    int vt[4];
+
+#define OUTPUT_NORMALS
+#ifdef OUTPUT_NORMALS
+    int outputFaceDirection;
+#endif
+
+    int exportMaterials = gModel.options->exportFlags & EXPT_OUTPUT_MATERIALS;
+    int mkGroupsObjs = (gModel.options->exportFlags & EXPT_OUTPUT_OBJ_MAKE_GROUPS_OBJECTS);
+    wchar_t statusString[1024];
+
 #ifdef OUTPUT_NORMALS
     // write out normals, texture coordinates, vertices, and then faces grouped by material
     for (i = 0; i < gModel.normalListCount; i++)
     {
-        sprintf_s(outputString, 256, "vn %g %g %g\n", gModel.normals[i][0], gModel.normals[i][1], gModel.normals[i][2]);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        // "vn %g %g %g\n"
+        char* pOut = outputString;
+        *pOut++ = 'v';
+        *pOut++ = 'n';
+        for (int axis = X; axis <= Z; axis++) {
+            *pOut++ = ' ';
+            pOut = OutFormatFloat(pOut, gModel.normals[i][axis]);
+        }
+        *pOut++ = '\n';
+        WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
     }
 #endif
 
@@ -26038,7 +27597,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
             // happily, all coordinates are powers of two, so this process is lossless
             retCode = mosaicUVtoSeparateUV();
             if (retCode >= MW_BEGIN_ERRORS)
-                goto Exit;
+                return retCode;
         }
         else {
             // just output as-is
@@ -26048,7 +27607,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                 retCode |= writeOBJTextureUV(gModel.uvIndexList[i].uc, gModel.uvIndexList[i].vc, prevSwatch != gModel.uvIndexList[i].swatchLoc, gModel.uvIndexList[i].swatchLoc);
                 prevSwatch = gModel.uvIndexList[i].swatchLoc;
                 if (retCode >= MW_BEGIN_ERRORS)
-                    goto Exit;
+                    return retCode;
             }
         }
     }
@@ -26066,17 +27625,22 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
             UPDATE_STATUS(gProgress.start.output + gProgress.absolute.output * 0.5f * ((float)i / (float)gModel.vertexCount), statusString);
         }
 
-        sprintf_s(outputString, 256, "v %g %g %g\n", gModel.vertices[i][X], gModel.vertices[i][Y], gModel.vertices[i][Z]);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        // "v %g %g %g\n"
+        char* pOut = outputString;
+        *pOut++ = 'v';
+        for (int axis = X; axis <= Z; axis++) {
+            *pOut++ = ' ';
+            pOut = OutFormatFloat(pOut, gModel.vertices[i][axis]);
+        }
+        *pOut++ = '\n';
+        WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
     }
 
     prevType = -1;
     int prevDataVal = -1;
     int prevSwatchLoc = -1;
-    groupCount = 0;
-    // outputMaterial notes when a material is used for the first time;
+    // gOBJState.outputMaterial notes when a material is used for the first time;
     // should only be needed for when objects are not sorted by material (grouped by block).
-    memset(outputMaterial, 0, sizeof(outputMaterial));
 
     // test for a single material output. If so, do it now and reset materials in general
     if (exportMaterials)
@@ -26085,7 +27649,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
         if (!(gModel.options->exportFlags & EXPT_OUTPUT_OBJ_MATERIAL_PER_BLOCK) && !gModel.exportTiles)
         {
             sprintf_s(outputString, 256, "\nusemtl %s\n", MINECRAFT_SINGLE_MATERIAL);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         }
     }
 
@@ -26161,11 +27725,11 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                                 // Since the material can vary and repeat, use block names.
                                 // New group for each block (materials not sorted)
                                 if (mkGroupsObjs) {
-                                    sprintf_s(outputString, 256, "o block_%05d\n", groupCount + 1);   // don't increment it here
-                                    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                                    sprintf_s(outputString, 256, "o block_%05d\n", gOBJState.groupCount + 1);   // don't increment it here
+                                    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                                 }
-                                sprintf_s(outputString, 256, "g block_%05d\n", ++groupCount);
-                                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                                sprintf_s(outputString, 256, "g block_%05d\n", ++gOBJState.groupCount);
+                                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             }
 
                             // new material per tile ID
@@ -26174,7 +27738,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                             // TODO: could someday store mtlName in this same table; no need to convert every time
                             WcharToChar(gTilesTable[prevSwatchLoc].filename, mtlName, MAX_PATH_AND_FILE);
                             sprintf_s(outputString, 256, "usemtl %s\n", mtlName);
-                            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             // note in an array that this separate tile should be output as a material
                             gModel.tileList[CATEGORY_RGBA][prevSwatchLoc] = true;  // means has a texture
                         }
@@ -26185,40 +27749,25 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                                 // new group for objects of same type (which are sorted)
                                 if (mkGroupsObjs) {
                                     sprintf_s(outputString, 256, "o %s\n", mtlName);
-                                    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                                    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                                 }
                                 sprintf_s(outputString, 256, "g %s\n", mtlName);
-                                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             }
                             sprintf_s(outputString, 256, "\nusemtl %s\n", mtlName);
-                            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             if (subtypeMaterial) {
                                 // We can't use outputMaterial, a simple array of types. We need to
                                 // instead check the whole previous list and see if the material's
-                                // already on it. Check from last to first for speed, I hope.
-                                // NODO: slightly better (though slower) would be to add by name, vs. typeData;
-                                // there are materials with different typeData's but that actually have the same name,
-                                // such as Purpur Block, but these show up only in the test world, so don't bother.
-                                int curCount = (int)gMtlList.size() - 1;
-                                unsigned int typeData = prevType << 8 | prevDataVal;
-                                while (curCount >= 0) {
-                                    if (gMtlList[curCount--] == typeData) {
-                                        // found it; exit loop
-                                        curCount = -999;
-                                    }
-                                }
-                                // did we find it?
-                                if (curCount != -999) {
-                                    // did not find type/data combination - add it to list
-                                    gMtlList.push_back(typeData);
-                                }
+                                // already on it.
+                                addToMtlList(prevType << 8 | prevDataVal);
                             }
                             else {
                                 // note which material is to be output, if not output already
-                                if (outputMaterial[prevType] == 0)
+                                if (gOBJState.outputMaterial[prevType] == 0)
                                 {
                                     gMtlList.push_back((prevType << 8) | prevDataVal);
-                                    outputMaterial[prevType] = 1;
+                                    gOBJState.outputMaterial[prevType] = 1;
                                 }
                             }
                         }
@@ -26227,7 +27776,7 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                     {
                         // don't output by individual block: output by group, and/or by material, or by tile, or none at all (one material for scene)
                         strcpy_s(outputString, 256, "\n");
-                        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
                         // don't output group if just the tile ID differed and the block type didn't
                         if ((gModel.options->exportFlags & EXPT_OUTPUT_OBJ_SEPARATE_TYPES) && newGroupPossible)
@@ -26235,10 +27784,10 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                             // new group for objects of same type (which are sorted)
                             if (mkGroupsObjs) {
                                 sprintf_s(outputString, 256, "o %s\n", mtlName);
-                                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             }
                             sprintf_s(outputString, 256, "g %s\n", mtlName);
-                            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                         }
                         if (gModel.exportTiles) {
                             // new material per tile ID
@@ -26247,16 +27796,16 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                             WcharToChar(gTilesTable[prevSwatchLoc].filename, mtlName, MAX_PATH_AND_FILE);
                             assert(strlen(mtlName));    // if hit, means a bad swatchLoc was assigned
                             sprintf_s(outputString, 256, "usemtl %s\n", mtlName);
-                            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                             // note in an array that this separate tile should be output as a material
                             gModel.tileList[CATEGORY_RGBA][prevSwatchLoc] = true;  // means has a texture
                         }
                         else if (gModel.options->exportFlags & EXPT_OUTPUT_OBJ_MATERIAL_PER_BLOCK)
                         {
-                            // new material per family
+                            // new material per family; an earlier tile may have already used it
                             sprintf_s(outputString, 256, "usemtl %s\n", mtlName);
-                            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
-                            gMtlList.push_back((prevType << 8) | prevDataVal);
+                            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
+                            addToMtlList((prevType << 8) | prevDataVal);
                         }
                         // else don't output material, there's only one for the whole scene
                     }
@@ -26292,21 +27841,21 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
             }
             // with number: sprintf_s(outputString, 256, "# type: %s %d\n", typeName, groupCount + 1);
             sprintf_s(outputString, 256, "# type: %s\n", typeName);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             if (mkGroupsObjs) {
-                sprintf_s(outputString, 256, "o block_%05d\n", groupCount + 1);   // don't increment it here
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                sprintf_s(outputString, 256, "o block_%05d\n", gOBJState.groupCount + 1);   // don't increment it here
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             }
-            sprintf_s(outputString, 256, "g block_%05d\n", ++groupCount);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            sprintf_s(outputString, 256, "g block_%05d\n", ++gOBJState.groupCount);
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         }
 
 #ifdef OUTPUT_NORMALS
         assert(pFace->normalIndex >= 0);
         if (absoluteIndices)
         {
-            outputFaceDirection = pFace->normalIndex + 1;
+            outputFaceDirection = gOBJState.normalBase + pFace->normalIndex + 1;
         }
         else
         {
@@ -26317,7 +27866,6 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
         // First, are there texture coordinates?
         if (gModel.exportTexture)
         {
-#ifdef OUTPUT_NORMALS
             // if output per tile, then we use the UV values to find the index to the new index in the grid
             if (gModel.exportTiles) {
                 // decode swatch coordinates into a canonical index
@@ -26342,228 +27890,99 @@ static int writeOBJBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedW
                     vt[j] = pFace->uvIndex[j] + 1;
                 }
             }
-
-            // with normals - not really needed by most renderers, but good to include;
-            // GLC, for example, does smoothing if normals are not present.
-            // Check if last two vertices match - if so, output a triangle instead 
-            if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
-            {
-                // triangle
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                        pFace->vertexIndex[0] + 1, vt[0], outputFaceDirection,
-                        pFace->vertexIndex[1] + 1, vt[1], outputFaceDirection,
-                        pFace->vertexIndex[2] + 1, vt[2], outputFaceDirection
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount, vt[0] - gModel.uvIndexCount - 1, outputFaceDirection,
-                        pFace->vertexIndex[1] - gModel.vertexCount, vt[1] - gModel.uvIndexCount - 1, outputFaceDirection,
-                        pFace->vertexIndex[2] - gModel.vertexCount, vt[2] - gModel.uvIndexCount - 1, outputFaceDirection
-                    );
-                }
-            }
-            else
-            {
-                // Output a quad
-                // if normal sums negative, rotate order by one so that dumb tessellators
-                // match up the faces better, which should make matching face removal work better. I hope.
-                int offset = 0;
-                assert(pFace->normalIndex >= 0);
-                int idx = pFace->normalIndex;
-                if (gModel.normals[idx][X] + gModel.normals[idx][Y] + gModel.normals[idx][Z] < 0.0f)
-                    offset = 1;
-
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                        pFace->vertexIndex[offset] + 1, vt[offset], outputFaceDirection,
-                        pFace->vertexIndex[offset + 1] + 1, vt[offset + 1], outputFaceDirection,
-                        pFace->vertexIndex[offset + 2] + 1, vt[offset + 2], outputFaceDirection,
-                        pFace->vertexIndex[(offset + 3) % 4] + 1, vt[(offset + 3) % 4], outputFaceDirection
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                        pFace->vertexIndex[offset] - gModel.vertexCount, vt[offset] - gModel.uvIndexCount - 1, outputFaceDirection,
-                        pFace->vertexIndex[offset + 1] - gModel.vertexCount, vt[offset + 1] - gModel.uvIndexCount - 1, outputFaceDirection,
-                        pFace->vertexIndex[offset + 2] - gModel.vertexCount, vt[offset + 2] - gModel.uvIndexCount - 1, outputFaceDirection,
-                        pFace->vertexIndex[(offset + 3) % 4] - gModel.vertexCount, vt[(offset + 3) % 4] - gModel.uvIndexCount - 1, outputFaceDirection
-                    );
-                }
-            }
-#else
-            // check if last two vertices match - if so, output a triangle instead 
-            if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
-            {
-                // triangle
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d/%d %d/%d %d/%d\n",
-                        pFace->vertexIndex[0] + 1, vt[0],
-                        pFace->vertexIndex[1] + 1, vt[1],
-                        pFace->vertexIndex[2] + 1, vt[2]
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d/%d %d/%d %d/%d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount, vt[0] - gModel.uvIndexCount - 1,
-                        pFace->vertexIndex[1] - gModel.vertexCount, vt[1] - gModel.uvIndexCount - 1,
-                        pFace->vertexIndex[2] - gModel.vertexCount, vt[2] - gModel.uvIndexCount - 1
-                    );
-                }
-            }
-            else
-            {
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d/%d %d/%d %d/%d %d/%d\n",
-                        pFace->vertexIndex[0] + 1, vt[0],
-                        pFace->vertexIndex[1] + 1, vt[1],
-                        pFace->vertexIndex[2] + 1, vt[2],
-                        pFace->vertexIndex[3] + 1, vt[3]
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d/%d %d/%d %d/%d %d/%d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount, vt[0] - gModel.uvIndexCount - 1,
-                        pFace->vertexIndex[1] - gModel.vertexCount, vt[1] - gModel.uvIndexCount - 1,
-                        pFace->vertexIndex[2] - gModel.vertexCount, vt[2] - gModel.uvIndexCount - 1,
-                        pFace->vertexIndex[3] - gModel.vertexCount, vt[3] - gModel.uvIndexCount - 1
-                    );
-                }
-            }
-#endif
         }
-        else
-        {
+
+        // Check if last two vertices match - if so, output a triangle instead
+        int cornerCount = (pFace->vertexIndex[2] == pFace->vertexIndex[3]) ? 3 : 4;
+        int offset = 0;
 #ifdef OUTPUT_NORMALS
-            // check if last two vertices match - if so, output a triangle instead 
-            if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
-            {
-                // triangle
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d//%d %d//%d %d//%d\n",
-                        pFace->vertexIndex[0] + 1, outputFaceDirection,
-                        pFace->vertexIndex[1] + 1, outputFaceDirection,
-                        pFace->vertexIndex[2] + 1, outputFaceDirection
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d//%d %d//%d %d//%d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount, outputFaceDirection,
-                        pFace->vertexIndex[1] - gModel.vertexCount, outputFaceDirection,
-                        pFace->vertexIndex[2] - gModel.vertexCount, outputFaceDirection
-                    );
-                }
-            }
-            else
-            {
-                // Output a quad
-                // if normal sums negative, rotate order by one so that dumb tessellators
-                // match up the faces better, which should make matching face removal work better. I hope.
-                int offset = 0;
-                assert(pFace->normalIndex >= 0);
-                int idx = pFace->normalIndex;
-                if (gModel.normals[idx][X] + gModel.normals[idx][Y] + gModel.normals[idx][Z] < 0.0f)
-                    offset = 1;
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d//%d %d//%d %d//%d %d//%d\n",
-                        pFace->vertexIndex[offset] + 1, outputFaceDirection,
-                        pFace->vertexIndex[offset + 1] + 1, outputFaceDirection,
-                        pFace->vertexIndex[offset + 2] + 1, outputFaceDirection,
-                        pFace->vertexIndex[(offset + 3) % 4] + 1, outputFaceDirection
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d//%d %d//%d %d//%d %d//%d\n",
-                        pFace->vertexIndex[offset] - gModel.vertexCount, outputFaceDirection,
-                        pFace->vertexIndex[offset + 1] - gModel.vertexCount, outputFaceDirection,
-                        pFace->vertexIndex[offset + 2] - gModel.vertexCount, outputFaceDirection,
-                        pFace->vertexIndex[(offset + 3) % 4] - gModel.vertexCount, outputFaceDirection
-                    );
-                }
-            }
-#else
-            // check if last two vertices match - if so, output a triangle instead 
-            if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
+        if (cornerCount == 4)
+        {
+            // Output a quad
+            // if normal sums negative, rotate order by one so that dumb tessellators
+            // match up the faces better, which should make matching face removal work better. I hope.
+            assert(pFace->normalIndex >= 0);
+            int idx = pFace->normalIndex;
+            if (gModel.normals[idx][X] + gModel.normals[idx][Y] + gModel.normals[idx][Z] < 0.0f)
+                offset = 1;
+        }
+#endif
+        // "f %d/%d/%d %d/%d/%d...\n", or "%d//%d" for each corner with no texture, "%d/%d" or "%d" with no normals
+        char* pOut = outputString;
+        *pOut++ = 'f';
+        for (j = 0; j < cornerCount; j++)
+        {
+            int corner = (offset + j) % 4;
+            *pOut++ = ' ';
+            pOut = OutFormatInt(pOut, absoluteIndices ? gOBJState.vertexBase + pFace->vertexIndex[corner] + 1 : pFace->vertexIndex[corner] - gModel.vertexCount);
+            if (gModel.exportTexture)
             {
-                // triangle
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d %d %d\n",
-                        pFace->vertexIndex[0] + 1,
-                        pFace->vertexIndex[1] + 1,
-                        pFace->vertexIndex[2] + 1
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d %d %d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount,
-                        pFace->vertexIndex[1] - gModel.vertexCount,
-                        pFace->vertexIndex[2] - gModel.vertexCount
-                    );
-                }
+                *pOut++ = '/';
+                pOut = OutFormatInt(pOut, absoluteIndices ? gOBJState.uvBase + vt[corner] : vt[corner] - gModel.uvIndexCount - 1);
             }
+#ifdef OUTPUT_NORMALS
             else
             {
-                if (absoluteIndices)
-                {
-                    sprintf_s(outputString, 256, "f %d %d %d %d\n",
-                        pFace->vertexIndex[0] + 1,
-                        pFace->vertexIndex[1] + 1,
-                        pFace->vertexIndex[2] + 1,
-                        pFace->vertexIndex[3] + 1
-                    );
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "f %d %d %d %d\n",
-                        pFace->vertexIndex[0] - gModel.vertexCount,
-                        pFace->vertexIndex[1] - gModel.vertexCount,
-                        pFace->vertexIndex[2] - gModel.vertexCount,
-                        pFace->vertexIndex[3] - gModel.vertexCount
-                    );
-                }
+                *pOut++ = '/';
             }
+            *pOut++ = '/';
+            pOut = OutFormatInt(pOut, outputFaceDirection);
 #endif
         }
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        *pOut++ = '\n';
+        WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
     }
 
-Exit:
-    PortaClose(gModelFile);
+    // the next tile's indices follow on from these
+    gOBJState.normalBase += gModel.normalListCount;
+    gOBJState.vertexBase += gModel.vertexCount;
+    gOBJState.uvBase = gOBJState.uvCount;
 
-    // should we call it a day here?
-    if (retCode >= MW_BEGIN_ERRORS) return retCode;
+    return retCode;
+}
+
+// Close the OBJ file and write its materials file.
+static int writeOBJFinish()
+{
+    int retCode = MW_NO_ERROR;
+
+    if (OutClose(gModelFile))
+        return MW_CANNOT_WRITE_TO_FILE;
 
     // write materials file
-    if (exportMaterials)
+    if (gModel.options->exportFlags & EXPT_OUTPUT_MATERIALS)
     {
         // write material file
         retCode |= writeOBJMtlFile();
-        if (retCode >= MW_BEGIN_ERRORS) return retCode;
     }
 
     return retCode;
 }
 
+// Add the type and data value to the materials to output, if it's not already on the list.
+// Check from last to first for speed, I hope.
+// NODO: slightly better (though slower) would be to add by name, vs. typeData;
+// there are materials with different typeData's but that actually have the same name,
+// such as Purpur Block, but these show up only in the test world, so don't bother.
+static void addToMtlList(unsigned int typeData)
+{
+    for (int i = (int)gMtlList.size() - 1; i >= 0; i--) {
+        if (gMtlList[i] == typeData) {
+            // found it
+            return;
+        }
+    }
+    // did not find type/data combination - add it to list
+    gMtlList.push_back(typeData);
+}
+
 
 static int writeOBJTextureUV(float u, float v, int addComment, int swatchLoc)
 {
     char outputString[1024];
 
+    gOBJState.uvCount++;
+
     // we go a bit nuts with the precision here, not sure it helps, but can't hurt; used to use just "%g"
     if (addComment)
     {
@@ -26584,10 +28003,19 @@ static int writeOBJTextureUV(float u, float v, int addComment, int swatchLoc)
     }
     else
     {
-        sprintf_s(outputString, 1024, "vt %.9f %.9f\n",
-            u, v);
+        // "vt %.9f %.9f\n"
+        char* pOut = outputString;
+        *pOut++ = 'v';
+        *pOut++ = 't';
+        *pOut++ = ' ';
+        pOut = OutFormatFixed(pOut, u, 9);
+        *pOut++ = ' ';
+        pOut = OutFormatFixed(pOut, v, 9);
+        *pOut++ = '\n';
+        WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
+        return MW_NO_ERROR;
     }
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return MW_NO_ERROR;
 }
@@ -26613,7 +28041,7 @@ static int writeOBJMtlFile()
     swprintf_s(statusString, 1024, L"Writing MTL file %s", getFilename(mtlFileName));
     UPDATE_STATUS(-999.0f, statusString);
 
-    gMtlFile = PortaCreate(mtlFileName);
+    gMtlFile = OutCreate(mtlFileName);
     addOutputFilenameToList(mtlFileName);
     if (gMtlFile == INVALID_HANDLE_VALUE)
         return MW_CANNOT_CREATE_FILE;
@@ -26631,7 +28059,7 @@ static int writeOBJMtlFile()
         num = ((gModel.options->exportFlags & EXPT_OUTPUT_OBJ_MATERIAL_PER_BLOCK) || gModel.exportTiles) ? (int)gMtlList.size() : 1;
     }
     sprintf_s(outputString, 2048, "# Wavefront OBJ material file\n# Contains %d materials\n", num);
-    WERROR_SPECIFY(PortaWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
+    WERROR_SPECIFY(OutWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
 
     if (gModel.exportTexture && !gModel.exportTiles)
     {
@@ -26675,7 +28103,7 @@ static int writeOBJMtlFile()
                 ,
                 MINECRAFT_SINGLE_MATERIAL,
                 gModel.usesRGB ? textureRGB : textureRGBA);
-            WERROR_SPECIFY(PortaWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
+            WERROR_SPECIFY(OutWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
 
             // With G3D, map_d for individual textures will reuse the RGBA image and G3D will misinterpret map_d
             // as the red channel, I believe. So, we set map_d only when we have a separate pure-alpha texture.
@@ -26686,7 +28114,7 @@ static int writeOBJMtlFile()
             if (gModel.usesAlpha) {
                 sprintf_s(outputString, 2048,
                     "map_d %s\n", textureAlpha);
-                WERROR_SPECIFY(PortaWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
+                WERROR_SPECIFY(OutWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
             }
         }
         else
@@ -26697,7 +28125,7 @@ static int writeOBJMtlFile()
                 "Ks 0 0 0\n"
                 ,
                 MINECRAFT_SINGLE_MATERIAL);
-            WERROR_SPECIFY(PortaWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
+            WERROR_SPECIFY(OutWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
         }
     }
     else
@@ -26776,7 +28204,7 @@ static int writeOBJMtlFile()
         }
     }
 
-    PortaClose(gMtlFile);
+    OutClose(gMtlFile);
 
     return MW_NO_ERROR;
 }
@@ -27126,7 +28554,7 @@ static int writeOBJFullMtlDescription(char* mtlName, int type, int dataVal, char
             (float)(1.0f - alpha),
             fullMtl, tfString);
     }
-    WERROR_SPECIFY(PortaWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
+    WERROR_SPECIFY(OutWrite(gMtlFile, outputString, strlen(outputString)), gMtlFile);
 
     return MW_NO_ERROR;
 }
@@ -27657,6 +29085,15 @@ static int createBaseMaterialTexture()
             {
                 // get foliage and grass color from center biome: half X and half Z
                 idx = (int)(gBoxSize[X] / 2) * gBoxSize[Z] + gBoxSize[Z] / 2;
+                if (gpTiledExportBox != NULL)
+                {
+                    // writeOBJTiles() reads in the tile with the whole export's center first; if that tile is empty,
+                    // this is the first tile with anything in it, so use its center
+                    int centerX = getTiledExportCenter(X) + gWorld2BoxOffset[X];
+                    int centerZ = getTiledExportCenter(Z) + gWorld2BoxOffset[Z];
+                    if (centerX >= 0 && centerX < gBoxSize[X] && centerZ >= 0 && centerZ < gBoxSize[Z])
+                        idx = centerX * gBoxSize[Z] + centerZ;
+                }
                 gModel.biomeIndex = gBiomeArray[idx];
             }
             else {
@@ -28256,7 +29693,7 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
     concatFileName3(stlFileNameWithSuffix, gOutputFilePath, gOutputFileRoot, L".stl");
 
     // create the STL file
-    gModelFile = PortaCreate(stlFileNameWithSuffix);
+    gModelFile = OutCreate(stlFileNameWithSuffix);
     addOutputFilenameToList(stlFileNameWithSuffix);
     if (gModelFile == INVALID_HANDLE_VALUE)
         return MW_CANNOT_CREATE_FILE;
@@ -28270,11 +29707,11 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
         // make it all 0x20 as we will output exactly 80 characters
         strcpy_s(outputString, 256, "COLOR=");
         // start to write file
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, 6));
-        WERROR_MODEL(PortaWrite(gModelFile, &allFF, 4));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, 6));
+        WERROR_MODEL(OutWrite(gModelFile, &allFF, 4));
         // in the example file, all the rest was 0x20's (space)
         memset(outputString, 0x20, 256);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, 70));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, 70));
     }
     else
     {
@@ -28285,11 +29722,11 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
             worldBox->min[X], worldBox->min[Y], worldBox->min[Z],
             worldBox->max[X], worldBox->max[Y], worldBox->max[Z]);
         // start to write file
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, 80));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, 80));
     }
 
     // number of triangles in model, unsigned int
-    WERROR_MODEL(PortaWrite(gModelFile, &numTri, 4));
+    WERROR_MODEL(OutWrite(gModelFile, &numTri, 4));
 
     int noteProgress = 1 + (int)((float)gModel.faceCount / (gProgress.absolute.output / 0.04f));
 
@@ -28330,12 +29767,12 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
         for (i = 0; i < faceTriCount; i++)
         {
             // 3 float normals
-            WERROR_MODEL(PortaWrite(gModelFile, &gModel.normals[pFace->normalIndex], 12));
+            WERROR_MODEL(OutWrite(gModelFile, &gModel.normals[pFace->normalIndex], 12));
 
             // two triangles: 0 1 2 and 0 2 3 (or 1 2 3 and 1 3 0)
-            WERROR_MODEL(PortaWrite(gModelFile, vertex[offset], 12));
-            WERROR_MODEL(PortaWrite(gModelFile, vertex[offset + i + 1], 12));
-            WERROR_MODEL(PortaWrite(gModelFile, vertex[(offset + i + 2) % 4], 12));
+            WERROR_MODEL(OutWrite(gModelFile, vertex[offset], 12));
+            WERROR_MODEL(OutWrite(gModelFile, vertex[offset + i + 1], 12));
+            WERROR_MODEL(OutWrite(gModelFile, vertex[(offset + i + 2) % 4], 12));
 
             if (writeColor)
             {
@@ -28367,17 +29804,17 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
                     outColor = (1 << 15) | (r << 10) | (g << 5) | b;
                 }
             }
-            WERROR_MODEL(PortaWrite(gModelFile, &outColor, 2));
+            WERROR_MODEL(OutWrite(gModelFile, &outColor, 2));
         }
     }
 
     // if not ok, then we will have closed the file earlier
-    PortaClose(gModelFile);
+    OutClose(gModelFile);
 
     concatFileName3(statsFileName, gOutputFilePath, gOutputFileRoot, L".txt");
 
     // write the stats to a separate file
-    statsFile = PortaCreate(statsFileName);
+    statsFile = OutCreate(statsFileName);
     addOutputFilenameToList(statsFileName);
     if (statsFile == INVALID_HANDLE_VALUE)
         return retCode | MW_CANNOT_CREATE_FILE;
@@ -28386,7 +29823,7 @@ static int writeBinarySTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tigh
     retCode |= writeStatistics(statsFile, NULL, pWorldGuide, worldBox, tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
     if (retCode >= MW_BEGIN_ERRORS) return retCode;
 
-    PortaClose(statsFile);
+    OutClose(statsFile);
 
     return retCode;
 }
@@ -28412,7 +29849,7 @@ static int writeAsciiSTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tight
     concatFileName3(stlFileNameWithSuffix, gOutputFilePath, gOutputFileRoot, L".stl");
 
     // create the STL file
-    gModelFile = PortaCreate(stlFileNameWithSuffix);
+    gModelFile = OutCreate(stlFileNameWithSuffix);
     addOutputFilenameToList(stlFileNameWithSuffix);
     if (gModelFile == INVALID_HANDLE_VALUE)
         return MW_CANNOT_CREATE_FILE;
@@ -28424,7 +29861,7 @@ static int writeAsciiSTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tight
         worldBox->min[X], worldBox->min[Y], worldBox->min[Z],
         worldBox->max[X], worldBox->max[Y], worldBox->max[Z]);
     // start to write file
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     char facetNormalString[NORMAL_LIST_SIZE][256];
     for (i = 0; i < gModel.normalListCount; i++)
@@ -28481,34 +29918,34 @@ static int writeAsciiSTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tight
 
         for (i = 0; i < faceTriCount; i++)
         {
-            WERROR_MODEL(PortaWrite(gModelFile, facetNormalString[normalIndex], strlen(facetNormalString[normalIndex])));
-            WERROR_MODEL(PortaWrite(gModelFile, "outer loop\n", strlen("outer loop\n")));
+            WERROR_MODEL(OutWrite(gModelFile, facetNormalString[normalIndex], strlen(facetNormalString[normalIndex])));
+            WERROR_MODEL(OutWrite(gModelFile, "outer loop\n", strlen("outer loop\n")));
 
             // two triangles: 0 1 2 and 0 2 3 (or 1 2 3 and 1 3 0)
             pt = vertex[offset];
             sprintf_s(outputString, 256, "vertex  %e %e %e\n", (double)((*pt)[X]), (double)((*pt)[Y]), (double)((*pt)[Z]));
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             pt = vertex[(offset + i + 1) % 4];	// shouldn't need % 4, but let's be safe, and makes cppcheck happy
             sprintf_s(outputString, 256, "vertex  %e %e %e\n", (double)((*pt)[X]), (double)((*pt)[Y]), (double)((*pt)[Z]));
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             pt = vertex[(offset + i + 2) % 4];  // cppcheck-suppress 457 - no, this really is initialized
             sprintf_s(outputString, 256, "vertex  %e %e %e\n", (double)((*pt)[X]), (double)((*pt)[Y]), (double)((*pt)[Z]));
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
-            WERROR_MODEL(PortaWrite(gModelFile, "endloop\nendfacet\n", strlen("endloop\nendfacet\n")));
+            WERROR_MODEL(OutWrite(gModelFile, "endloop\nendfacet\n", strlen("endloop\nendfacet\n")));
         }
     }
 
     sprintf_s(outputString, 256, "endsolid %s\n", worldNameUnderlined);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // if not ok, then we will have closed the file earlier
-    PortaClose(gModelFile);
+    OutClose(gModelFile);
 
     concatFileName3(statsFileName, gOutputFilePath, gOutputFileRoot, L".txt");
 
     // write the stats to a separate file
-    statsFile = PortaCreate(statsFileName);
+    statsFile = OutCreate(statsFileName);
     addOutputFilenameToList(statsFileName);
     if (statsFile == INVALID_HANDLE_VALUE)
         return retCode | MW_CANNOT_CREATE_FILE;
@@ -28517,7 +29954,7 @@ static int writeAsciiSTLBox(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tight
     retCode |= writeStatistics(statsFile, NULL, pWorldGuide, worldBox, tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
     if (retCode >= MW_BEGIN_ERRORS) return retCode;
 
-    PortaClose(statsFile);
+    OutClose(statsFile);
 
     return retCode;
 }
@@ -28559,7 +29996,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
     concatFileName3(wrlFileNameWithSuffix, gOutputFilePath, gOutputFileRoot, L".wrl");
 
     // create the VRML wrl file
-    gModelFile = PortaCreate(wrlFileNameWithSuffix);
+    gModelFile = OutCreate(wrlFileNameWithSuffix);
     addOutputFilenameToList(wrlFileNameWithSuffix);
     if (gModelFile == INVALID_HANDLE_VALUE)
         return retCode | MW_CANNOT_CREATE_FILE;
@@ -28573,7 +30010,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
     justWorldFileName = removePathChar(worldChar);
 
     sprintf_s(outputString, 256, "#VRML V2.0 utf8\n\n# VRML 97 (VRML2) file made by Mineways version %d.%02d, http://mineways.com\n", gMinewaysMajorVersion, gMinewaysMinorVersion);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     retCode |= writeStatistics(gModelFile, NULL, pWorldGuide, worldBox, tightenedWorldBox, curDir, terrainFileName, cullSchemeSelected, pCBC);
     if (retCode >= MW_BEGIN_ERRORS)
@@ -28588,7 +30025,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
     //for ( i = 0; i < 6; i++ )
     //{
     //    sprintf_s(outputString,256,"vn %g %g %g\n", gModel.normals[i][0], gModel.normals[i][1], gModel.normals[i][2]);
-    //    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     //}
 
     // output vertex coordinate loops
@@ -28629,14 +30066,14 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
             gModel.print3D ? "TRUE" : "FALSE",
             firstShape ? "DEF" : "USE",
             firstShape ? " Coordinate" : "");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
         // if first shape, output coords and texture coords
         if (firstShape)
         {
             // Note that we just dump everything to a single indexed face set coordinate list, which then gets reused
             strcpy_s(outputString, 256, "        {\n          point\n          [\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             int noteProgress = 1 + (int)((float)gModel.vertexCount / (0.5f * gProgress.absolute.output / 0.04f));
             for (j = 0; j < gModel.vertexCount; j++)
@@ -28645,16 +30082,18 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                     UPDATE_PROGRESS(gProgress.start.output + gProgress.absolute.output * 0.5f * ((float)j / (float)gModel.vertexCount));
                 }
 
-                if (j == gModel.vertexCount - 1)
-                {
-                    // no comma at end
-                    sprintf_s(outputString, 256, "            %g %g %g\n", gModel.vertices[j][X], gModel.vertices[j][Y], gModel.vertices[j][Z]);
-                }
-                else
-                {
-                    sprintf_s(outputString, 256, "            %g %g %g,\n", gModel.vertices[j][X], gModel.vertices[j][Y], gModel.vertices[j][Z]);
+                // "            %g %g %g,\n", no comma at end
+                char* pOut = outputString + 12;
+                memset(outputString, ' ', 12);
+                for (int axis = X; axis <= Z; axis++) {
+                    if (axis != X)
+                        *pOut++ = ' ';
+                    pOut = OutFormatFloat(pOut, gModel.vertices[j][axis]);
                 }
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                if (j != gModel.vertexCount - 1)
+                    *pOut++ = ',';
+                *pOut++ = '\n';
+                WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
             }
 
             // textures need texture coordinates output, only needed when texturing
@@ -28663,7 +30102,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                 int prevSwatch = -1;
                 int k;
                 strcpy_s(outputString, 256, "          ]\n        }\n        texCoord DEF texCoord_Craft TextureCoordinate\n        {\n          point\n          [\n");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
                 for (k = 0; k < gModel.uvIndexCount; k++)
                 {
@@ -28675,14 +30114,14 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
             }
             // close up coordinates themselves
             strcpy_s(outputString, 256, "          ]\n        }\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         }
         else
         {
             if (gModel.exportTexture)
             {
                 strcpy_s(outputString, 256, "        texCoord USE texCoord_Craft\n");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             }
         }
 
@@ -28691,7 +30130,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
         dataVal = exportSingleMaterial ? 0x0 : gModel.faceList[currentFace]->materialDataVal;
 
         strcpy_s(outputString, 256, "        coordIndex\n        [\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
         // output face loops until next material is found, or all, if exporting no material
         while ((currentFace < gModel.faceCount) &&
@@ -28701,19 +30140,15 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                 UPDATE_PROGRESS(gProgress.start.output + gProgress.absolute.output * 0.5f * (1.0f + ((float)currentFace / (float)gModel.faceCount)));
             }
 
-            char commaString[256];
-            strcpy_s(commaString, 256, (currentFace == gModel.faceCount - 1 || (currentType != gModel.faceList[currentFace + 1]->materialType)) ? "" : ",");
+            bool lastOfType = (currentFace == gModel.faceCount - 1 || (currentType != gModel.faceList[currentFace + 1]->materialType));
 
             pFace = gModel.faceList[currentFace];
 
+            char* pOut;
             if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
             {
                 // export triangle
-                sprintf_s(outputString, 256, "          %d,%d,%d,-1%s\n",
-                    pFace->vertexIndex[0],
-                    pFace->vertexIndex[1],
-                    pFace->vertexIndex[2],
-                    commaString);
+                pOut = formatVRMLIndexLoop(outputString, pFace->vertexIndex, 3, 0, ',', lastOfType ? "\n" : ",\n");
             }
             else
             {
@@ -28725,14 +30160,9 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                 int i = pFace->normalIndex;
                 if (gModel.normals[i][X] + gModel.normals[i][Y] + gModel.normals[i][Z] < 0.0f)
                     offset = 1;
-                sprintf_s(outputString, 256, "          %d,%d,%d,%d,-1%s\n",
-                    pFace->vertexIndex[offset],
-                    pFace->vertexIndex[offset + 1],
-                    pFace->vertexIndex[offset + 2],
-                    pFace->vertexIndex[(offset + 3) % 4],
-                    commaString);
+                pOut = formatVRMLIndexLoop(outputString, pFace->vertexIndex, 4, offset, ',', lastOfType ? "\n" : ",\n");
             }
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
 
             currentFace++;
         }
@@ -28741,7 +30171,7 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
         if (gModel.exportTexture)
         {
             strcpy_s(outputString, 256, "        ]\n        texCoordIndex\n        [\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             endIndex = currentFace;
 
@@ -28751,12 +30181,11 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                 // output the face loop
                 pFace = gModel.faceList[currentFace];
 
+                int uvIndex[4] = { pFace->uvIndex[0], pFace->uvIndex[1], pFace->uvIndex[2], pFace->uvIndex[3] };
+                char* pOut;
                 if (pFace->uvIndex[2] == pFace->uvIndex[3])
                 {
-                    sprintf_s(outputString, 256, "          %d %d %d -1\n",
-                        pFace->uvIndex[0],
-                        pFace->uvIndex[1],
-                        pFace->uvIndex[2]);
+                    pOut = formatVRMLIndexLoop(outputString, uvIndex, 3, 0, ' ', "\n");
                 }
                 else
                 {
@@ -28768,19 +30197,15 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
                     int i = pFace->normalIndex;
                     if (gModel.normals[i][X] + gModel.normals[i][Y] + gModel.normals[i][Z] < 0.0f)
                         offset = 1;
-                    sprintf_s(outputString, 256, "          %d %d %d %d -1\n",
-                        pFace->uvIndex[offset],
-                        pFace->uvIndex[offset + 1],
-                        pFace->uvIndex[offset + 2],
-                        pFace->uvIndex[(offset + 3) % 4]);
+                    pOut = formatVRMLIndexLoop(outputString, uvIndex, 4, offset, ' ', "\n");
                 }
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
             }
         }
 
         // close up the geometry
         strcpy_s(outputString, 256, "        ]\n      }\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
         // now output material
         // - if a single material or if textures are output, we use the GENERIC_MATERIAL for the type to output
@@ -28796,17 +30221,17 @@ static int writeVRML2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightene
 
         // close up shape
         strcpy_s(outputString, 256, "    }\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
         firstShape = 0;
     }
 
     // close up Transform children
     strcpy_s(outputString, 256, "  ]\n}\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
 Exit:
-    PortaClose(gModelFile);
+    OutClose(gModelFile);
 
     return retCode;
 }
@@ -28824,7 +30249,7 @@ static int writeVRMLAttributeShapeSplit(int type, int dataVal, char* mtlName, ch
     float ka, kd, ks, ke;      // cppcheck-suppress 398
     float alpha;
 
-    WERROR_MODEL(PortaWrite(gModelFile, attributeString, strlen(attributeString)));
+    WERROR_MODEL(OutWrite(gModelFile, attributeString, strlen(attributeString)));
 
     if (type == GENERIC_MATERIAL)
     {
@@ -28891,20 +30316,37 @@ static int writeVRMLAttributeShapeSplit(int type, int dataVal, char* mtlName, ch
         tfString
     );
 
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     if (textureOutputString != NULL)
     {
-        WERROR_MODEL(PortaWrite(gModelFile, textureOutputString, strlen(textureOutputString)));
+        WERROR_MODEL(OutWrite(gModelFile, textureOutputString, strlen(textureOutputString)));
     }
 
     // close up appearance
     strcpy_s(outputString, 256, "      }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return MW_NO_ERROR;
 }
 
+// A face's index loop, "          %d,%d,%d,-1" with the given separator, starting at corner offset, then the ending.
+// Returns where it stopped.
+static char* formatVRMLIndexLoop(char* dst, const int* indices, int count, int offset, char separator, const char* ending)
+{
+    memset(dst, ' ', 10);
+    dst += 10;
+    for (int i = 0; i < count; i++) {
+        dst = OutFormatInt(dst, indices[(offset + i) % 4]);
+        *dst++ = separator;
+    }
+    *dst++ = '-';
+    *dst++ = '1';
+    size_t length = strlen(ending);
+    memcpy(dst, ending, length);
+    return dst + length;
+}
+
 static int writeVRMLTextureUV(float u, float v, int addComment, int swatchLoc)
 {
     char outputString[1024];
@@ -28928,10 +30370,17 @@ static int writeVRMLTextureUV(float u, float v, int addComment, int swatchLoc)
     }
     else
     {
-        sprintf_s(outputString, 1024, "            %g %g\n",
-            u, v);
+        // "            %g %g\n"
+        char* pOut = outputString + 12;
+        memset(outputString, ' ', 12);
+        pOut = OutFormatFloat(pOut, u);
+        *pOut++ = ' ';
+        pOut = OutFormatFloat(pOut, v);
+        *pOut++ = '\n';
+        WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
+        return MW_NO_ERROR;
     }
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return MW_NO_ERROR;
 }
@@ -29062,7 +30511,7 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
 
     // topmost Xform
     sprintf_s(outputString, 256, "\ndef Xform \"%s\"\n{\n", defaultPrim);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // add camera - add it only if lights are export
     if (gModel.options->pEFD->scaleLightsVal > 0.0f) {
@@ -29090,28 +30539,28 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
     //        (float)tightenedWorldBox->max[X],
     //        (float)tightenedWorldBox->max[Y],
     //        (float)tightenedWorldBox->max[Z] );
-    //    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     //}
 
     strcpy_s(outputString, 256, "\n    def Xform \"Geom\"\n    {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     if (gXformScale != 1.0f) {
         strcpy_s(outputString, 256, "        double3 xformOp:rotateXYZ = (0, 0, 0)\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         sprintf_s(outputString,256, "        double3 xformOp:scale = (%f, %f, %f)\n", gXformScale, gXformScale, gXformScale);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "        double3 xformOp:translate = (0, 0, 0)\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "        uniform token[] xformOpOrder = [\"xformOp:translate\", \"xformOp:rotateXYZ\", \"xformOp:scale\"]\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
 
     // if we're instancing, we need to simply write out the instance locations and what blocks they refer to
     if (gModel.instancing) {
         // for output in file
         char blockLibraryName[MAX_PATH_AND_FILE];
-        // for actually opening with PortaCreate()
+        // for actually opening with OutCreate()
         wchar_t blockLibraryNameWithSuffix[MAX_PATH_AND_FILE];
         char materialLibraryName[MAX_PATH_AND_FILE];
         wchar_t materialLibraryNameWithSuffix[MAX_PATH_AND_FILE];
@@ -29142,7 +30591,7 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
         // material library creation assumes everything's sorted by material, so do that now
         // TODO USD - may not really be needed, but could be more efficient
         UPDATE_STATUS(-999.0f, L"Sort by tile IDs");
-        qsort_s(gModel.faceList, gModel.faceCount, sizeof(FaceRecord*), tileUSDIdCompare, NULL);
+        sortFaces(gModel.faceList, gModel.faceCount, FACE_ORDER_USD_TILE);
 
         // create material library
         if (retCode |= createMaterialsUSD(texturePath, "", materialLibraryNameWithSuffix, singleTerrainFile, noExtraPath)) {
@@ -29169,9 +30618,9 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
         if (gModel.instanceChunkSize == 0) {
             // just one chunk
             strcpy_s(outputString, 256, "        def PointInstancer \"pointinstancer\" {\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            point3f[] positions = [");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             InstanceLocation* pil = gModel.instanceLoc;
             for (i = 0; i < gModel.instanceLocCount; i++) {
@@ -29180,13 +30629,13 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
                     UPDATE_PROGRESS(gProgress.start.output + gProgress.absolute.output * ((float)i / doubleCount));
                     progressTick += progressIncrement;
                 }
-                sprintf_s(outputString, 256, "(%g, %g, %g)%s", pil->location[X], pil->location[Y], pil->location[Z], (i == gModel.instanceLocCount - 1) ? "]\n" : ",");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                char* pOut = formatUSDTuple(outputString, pil->location, 3, (i == gModel.instanceLocCount - 1) ? "]\n" : ",");
+                WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
                 pil++;
             }
 
             strcpy_s(outputString, 256, "            int[] protoIndices = [");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             // reset and count second half
             progressTick = progressIncrement;
             pil = gModel.instanceLoc;
@@ -29196,14 +30645,14 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
                     UPDATE_PROGRESS(gProgress.start.output + gProgress.absolute.output * ((float)(i + gModel.instanceLocCount) / doubleCount));
                     progressTick += progressIncrement;
                 }
-                sprintf_s(outputString, 256, "%d%s", blockIndex[pil->index], (i == gModel.instanceLocCount - 1) ? "]\n" : ",");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                char* pOut = formatUSDInt(outputString, blockIndex[pil->index], (i == gModel.instanceLocCount - 1) ? "]\n" : ",");
+                WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
                 pil++;
             }
 
             // output all instance names
             strcpy_s(outputString, 256, "            prepend rel prototypes = [");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             char instanceNameString[MAX_PATH_AND_FILE];
             for (i = 0; i < gModel.instanceCount; i++) {
                 //char instanceNameUnderlined[MAX_PATH_AND_FILE];
@@ -29214,13 +30663,13 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
 
                 //sprintf_s(outputString, 256, "<Blocks/%s>%s", instanceNameUnderlined, (i == gModel.instanceCount - 1) ? "]" : ",");
                 sprintf_s(outputString, 256, "<Blocks/%s>%s", instanceNameString, (i == gModel.instanceCount - 1) ? "]\n" : ",");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             }
 
             sprintf_s(outputString, 256, "            over \"Blocks\" (references = @./%s%s@) {}\n", gMaterialFileSubdirChar, blockLibraryName);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "        }\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         }
         else {
             // The more involved "by chunk" instancer output
@@ -29230,22 +30679,22 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
             qsort_s(gModel.instanceLoc, gModel.instanceLocCount, sizeof(InstanceLocation), chunkUSDCompare, NULL);
 
             strcpy_s(outputString, 256, "        def Xform \"VoxelMap\" (\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            prepend apiSchemas = [\"InfiniteVoxelMapAPI\"]\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "        )\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "        {\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "            int3 chunkSize = (%d, %d, %d)\n\n", gModel.instanceChunkSize, gModel.instanceChunkSize, gModel.instanceChunkSize);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             strcpy_s(outputString, 256, "            def BlockLib \"BlockLib\"\n        {\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                over \"Blocks\" (references = @./%s%s@) {}\n", gMaterialFileSubdirChar, blockLibraryName);
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            }\n\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             int* localBlockIndex = (int*)malloc(gModel.instanceCount * sizeof(int));
             int* absoluteIndex = (int*)malloc(gModel.instanceCount * sizeof(int));
@@ -29290,32 +30739,32 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
                 }
 
                 sprintf_s(outputString, 256, "            def PointInstancer \"Chunk_%s\" {\n", chunkLocation);
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                point3f[] positions = [");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
                 pil = &gModel.instanceLoc[startInstance];
                 for (i = startInstance; i < endInstance; i++) {
-                    sprintf_s(outputString, 256, "(%g, %g, %g)%s", pil->location[X], pil->location[Y], pil->location[Z], (i == endInstance - 1) ? "]\n" : ",");
-                    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                    char* pOut = formatUSDTuple(outputString, pil->location, 3, (i == endInstance - 1) ? "]\n" : ",");
+                    WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
                     pil++;
                 }
 
                 strcpy_s(outputString, 256, "                int[] protoIndices = [");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                 // reset and count second half
                 progressTick = progressIncrement;
                 pil = &gModel.instanceLoc[startInstance];
                 for (i = startInstance; i < endInstance; i++) {
                     assert(localBlockIndex[pil->index] >= 0);
-                    sprintf_s(outputString, 256, "%d%s", localBlockIndex[pil->index], (i == endInstance - 1) ? "]\n" : ",");
-                    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                    char* pOut = formatUSDInt(outputString, localBlockIndex[pil->index], (i == endInstance - 1) ? "]\n" : ",");
+                    WERROR_MODEL(OutWrite(gModelFile, outputString, pOut - outputString));
                     pil++;
                 }
 
                 // output all instance names
                 strcpy_s(outputString, 256, "                rel prototypes = [\n");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                 char instanceNameString[MAX_PATH_AND_FILE];
                 for (i = 0; i < relIndex; i++) {
                     // get the particular instance out of the long list
@@ -29325,19 +30774,19 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
 
                     //sprintf_s(outputString, 256, "<Blocks/%s>%s\n", instanceNameUnderlined, (i == gModel.instanceCount - 1) ? "]" : ",");
                     sprintf_s(outputString, 256, "                <../BlockLib/Blocks/%s>%s\n", instanceNameString, (i == relIndex - 1) ? "]" : ",");
-                    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                 }
                 //sprintf_s(outputString, 256, "            over \"Blocks\" (references = @./%s@) {}\n", blockLibraryName);
-                //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            }\n");
-                WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
                 // and get ready for next instance
                 startInstance = endInstance;
             }
             // close VoxelMap
             strcpy_s(outputString, 256, "        } # close VoxelMap Xform\n");
-            WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
             free(absoluteIndex);
             free(localBlockIndex);
@@ -29353,7 +30802,7 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
 
     // close the Geom Xform
     strcpy_s(outputString, 256, "    } # close Geom Xform\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // export the materials to the main file
     if (!gModel.instancing) {
@@ -29374,7 +30823,7 @@ static int writeUSD2Box(WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightened
 
     // close topmost world Xform
     sprintf_s(outputString, 256, "} # close %s Xform\n\n", defaultPrim);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
 Exit:
     if (retCode |= closeUSDFile(gModelFile)) {
@@ -29452,13 +30901,13 @@ static void nameFromHash(int hash, char* instanceNameString)
 static int openUSDFile(wchar_t* destination, PORTAFILE & modelFile)
 {
     char outputString[256];
-    modelFile = PortaCreate(destination);
+    modelFile = OutCreate(destination);
     addOutputFilenameToList(destination);
     if (modelFile == INVALID_HANDLE_VALUE)
         return MW_CANNOT_CREATE_FILE;
 
     strcpy_s(outputString, 256, "#usda 1.0\n(\n");
-    WERROR_MODEL(PortaWrite(modelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(modelFile, outputString, strlen(outputString)));
 
     return 0;
 }
@@ -29478,10 +30927,10 @@ static int writeCommentUSD(char* commentString)
             *curOut++ = *curIn++;
         } while (*curIn);
         *curOut = (char)0;
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
     else {
-        WERROR_MODEL(PortaWrite(gModelFile, commentString, strlen(commentString)));
+        WERROR_MODEL(OutWrite(gModelFile, commentString, strlen(commentString)));
     }
 
     return 0;
@@ -29492,124 +30941,124 @@ static int finishCommentsUSD(char* defaultPrim)
     char outputString[256];
     // close comments
     strcpy_s(outputString, 256, "\"\"\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // render settings - could make a separate function
     strcpy_s(outputString, 256, "    customLayerData = {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // Seen in one file, 
     //strcpy_s(outputString, 256, "        string source = '''Converted to usd by Mineways''' = {\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // A way to export a given camera. Maybe add a 3D camera description as a scripting option someday? TODO
     // Currently no 3D view within Mineways itself, of course. This view works well with QMAGNET's texture world
     static boolean exportCamera = true;
     if (exportCamera) {
         strcpy_s(outputString, 256, "        dictionary cameraSettings = {\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         sprintf_s(outputString, 256, "            string boundCamera = \"/%s/Camera\"\n", defaultPrim);
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "        }\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
     strcpy_s(outputString, 256, "        # hints for NVIDIA's USD Composer's rendering system:\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        dictionary renderSettings = {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     /* not supported any more, AFAIK
     strcpy_s(outputString, 256, "            double \"rtx:ambientOcclusion:rayLength\" = 1\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            bool \"rtx:indirectDiffuse:enabled\" = 1\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // no longer used
     //strcpy_s(outputString, 256, "            bool \"rtx:pathtracing:cached:enabled\" = 1\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double \"rtx:pathtracing:fireflyFilter:maxIntensityPerSample\" = 50000\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            bool \"rtx:pathtracing:lightcache:cached:enabled\" = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double \"rtx:pathtracing:maxBounces\" = 10\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double \"rtx:pathtracing:maxSpecularAndTransmissionBounces\" = 10\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     */
     // fog, if depth shading is on
     if (gModel.options->worldType & DEPTHSHADING) {
         strcpy_s(outputString, 256, "            double \"rtx:pathtracing:ptfog:asymmetry\" = -0.0828634\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "            double \"rtx:pathtracing:ptfog:density\" = 0.52\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "            bool \"rtx:pathtracing:ptfog:enabled\" = 1\n");
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     }
 
     // GI is good for the real-time version - should always be on, IMO:
     // But, this is now the default, under Real-Time renderer, Ray Tracing, Indirect Diffuse Lighting, Indirect Diffuse GI:
     //strcpy_s(outputString, 256, "            bool \"rtx:indirectDiffuse:enabled\" = 1\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // 0 means run forever - best to call it a day at some point, so it doesn't run forever
     // No longer needed - the default has been made 64 or 512 or whatever.
     //strcpy_s(outputString, 256, "            int \"rtx:pathtracing:totalSpp\" = 1000\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // no longer used
     //strcpy_s(outputString, 256, "            double \"rtx:post:aa:op\" = 3\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     /* not supported any more, AFAIK
     strcpy_s(outputString, 256, "            double \"rtx:post:dlss:execMode\" = 1\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     */
     /* not supported any more, AFAIK
     strcpy_s(outputString, 256, "            double \"rtx:post:lensFlares:cutoffFuzziness\" = 0.506608\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     */
     // Not really needed, turns lens flare on. Let the user figure that out instead...
     //strcpy_s(outputString, 256, "            bool \"rtx:post:lensFlares:enabled\" = 1\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     //strcpy_s(outputString, 256, "            double \"rtx:post:lensFlares:flareScale\" = 0.1\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     //strcpy_s(outputString, 256, "            double \"rtx:post:lensFlares:focalLength\" = 250\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // Used only because we make the light sources "reasonable", with an emission of 30 and 6 for Sun and DomeLight,
     // 1000 for nits for emission. See https://github.com/erich666/McUsd#omniverse-adjustments for a way to delete these
     // and use the "true" emission values: 1550, 310, and 53000.
     //strcpy_s(outputString, 256, "            double \"rtx:post:tonemap:cameraShutter\" = 10\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     //strcpy_s(outputString, 256, "            double \"rtx:post:tonemap:filmIso\" = 1000\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // If fireflies are suppressed in the path tracer, the result is considerably dimmer. OM-74000
     // Adjusting the emissives to a reasonable range seems to solve this one, so not necessary
     //strcpy_s(outputString, 256, "            bool \"rtx:pathtracing:fireflyFilter:enabled\" = 0\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // Slows performance down massively in real-time rendering mode (like 3X), but without it, semitransparent objects
     // do not display correctly. This is documented in Mineways' docs about OV Create.
     // A little more info at: https://github.com/erich666/McUsd#omniverse-adjustments
     // Found in Real-Time, Ray Tracing, Translucency area.
     strcpy_s(outputString, 256, "            bool \"rtx:raytracing:fractionalCutoutOpacity\" = 1\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // Reinhard gives a different look to HDR, sometimes better
     //strcpy_s(outputString, 256, "            double \"rtx:post:tonemap:op\" = 2\n");
-    //WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    //WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     strcpy_s(outputString, 256, "            token \"rtx:rendermode\" = \"PathTracing\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // Normally washes things out. Find this setting in Omniverse in the upper right, under
     // Render Settings tab, Renderer: Real-Time, Ray Tracing, Indirect Diffuse Light, Ambient Light Intensity
     strcpy_s(outputString, 256, "            float3 \"rtx:sceneDb:ambientLightColor\" = (0, 0, 0)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "    }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     sprintf_s(outputString, 256, "    defaultPrim = \"%s\"\n", defaultPrim);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // let's never touch metersPerUnit, it leads to confusion, e.g., https://github.com/erich666/McUsd/issues/3
     sprintf_s(outputString, 256, "    metersPerUnit = 0.01\n    upAxis = \"%s\"\n)\n", gModel.options->pEFD->chkMakeZUp[gModel.options->pEFD->fileType] ? "Z" : "Y");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return 0;
 }
@@ -29635,59 +31084,59 @@ static int addCameraUSD()
     Vec2Op(loc, =, (float)(1.0/sqrt(3.0f)) * maxSize + 100.0f * center);
 
     strcpy_s(outputString, 256, "    def Camera \"Camera\" (\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        hide_in_stage_window = false\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        no_delete = false\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "    )\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "    {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float4[] clippingPlanes = []\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float2 clippingRange = (1, 10000000)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float focalLength = 18.147562\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float focusDistance = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float fStop = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float horizontalAperture = 20.955\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float horizontalApertureOffset = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     sprintf_s(outputString, 256, "        custom vector3d omni:kit:centerOfInterest = (0, 0, %f)\n", -maxSize);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        token projection = \"perspective\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        uniform token purpose = \"default\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        double shutter:close = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        double shutter:open = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        uniform token stereoRole = \"mono\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float verticalAperture = 15.2908\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float verticalApertureOffset = 0\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        token visibility = \"inherited\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     // really don't like YXZ here and below, ZXY is better, with -45,45,0. But this preserves the translations
     // For some reason, most files I've seen use float3 for (just) the camera for (just) rotate and scale
     strcpy_s(outputString, 256, "        float3 xformOp:rotateZXY = (-38, 45, 0)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        float3 xformOp:scale = (1, 1, 1)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     sprintf_s(outputString, 256, "        double3 xformOp:translate = (%f, %f, %f)\n", loc[0], loc[1], loc[2]);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        uniform token[] xformOpOrder = [\"xformOp:translate\", \"xformOp:rotateZXY\", \"xformOp:scale\"]\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "    }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return 0;
 }
@@ -29921,23 +31370,23 @@ static int createMeshesUSD(wchar_t* blockLibraryPath, char *materialLibrary, boo
         // write comments for Import Settings and write globals
         // openUSDFile does this first line, always:
         //strcpy_s(outputString, 256, "    (\n");
-        //WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        //WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "defaultPrim=\"Blocks\"\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         sprintf_s(outputString, 256, "subLayers = [ @%s@ ]\n", materialLibrary);
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "    metersPerUnit = 1\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "    upAxis = \"Y\"\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, ")\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "def Scope \"Blocks\"\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "{\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
 
         // Go through all instances.
         // Sort each set of faces by the material.
@@ -29960,24 +31409,24 @@ static int createMeshesUSD(wchar_t* blockLibraryPath, char *materialLibrary, boo
             const char* subName = RetrieveBlockSubname(type, dataVal);
 
             sprintf_s(outputString, 256, "\n    def Xform \"Block_%d_%d\"\n    {\n", type, dataVal);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "        int blockType = %d\n", type);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "        int blockSubType = %d\n", dataVal);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "        string typeName = \"%s\"\n", gBlockDefinitions[type].name);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "        string subTypeName = \"%s\"\n", subName);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "        int blockFlags = %d\n\n", (int)gBlockDefinitions[type].flags);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             /* old, non-sorted method, without metadata
             char blockName[MAX_PATH_AND_FILE];
             nameFromHash(gModel.instance[i].hash, blockName);
             char blockNameUnderlined[MAX_PATH_AND_FILE];
             convertCharPathUnderlined(blockNameUnderlined, blockName, true);
             sprintf_s(outputString, 256, "\n    def Xform \"%s\"\n{\n", blockNameUnderlined);
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
             */
 
             int firstFaceNumber = gModel.instance[i].faceNumber;
@@ -29988,7 +31437,7 @@ static int createMeshesUSD(wchar_t* blockLibraryPath, char *materialLibrary, boo
 
             // sort
             UPDATE_STATUS(-999.0f, L"Sort by ID");
-            qsort_s(&gModel.faceList[firstFaceNumber], numFaces, sizeof(FaceRecord*), tileUSDIdCompare, NULL);
+            sortFaces(&gModel.faceList[firstFaceNumber], numFaces, FACE_ORDER_USD_TILE);
 
             startRun = firstFaceNumber;
             // output meshes for the given block
@@ -29999,11 +31448,11 @@ static int createMeshesUSD(wchar_t* blockLibraryPath, char *materialLibrary, boo
             }
 
             strcpy_s(outputString, 256, "    }\n");
-            WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
         }
 
         strcpy_s(outputString, 256, "\n} # end Blocks\n");
-        WERROR_MODEL(PortaWrite(blockFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(blockFile, outputString, strlen(outputString)));
 
         if (retCode |= closeUSDFile(blockFile)) {
             // failed to quit - really, we're done, so nothing to do, but left in case someday we add more code below.
@@ -30032,6 +31481,32 @@ static int createMeshesUSD(wchar_t* blockLibraryPath, char *materialLibrary, boo
     return retCode;
 }
 
+// One element of a USD array, as sprintf_s(outputString, 256, "%d%s", value, separator) would write it. Returns where it stopped.
+static char* formatUSDInt(char* dst, int value, const char* separator)
+{
+    dst = OutFormatInt(dst, value);
+    size_t length = strlen(separator);
+    memcpy(dst, separator, length);
+    return dst + length;
+}
+
+// Same, for "(%g, %g, %g)%s" or "(%g, %g)%s".
+static char* formatUSDTuple(char* dst, const float* values, int count, const char* separator)
+{
+    *dst++ = '(';
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            *dst++ = ',';
+            *dst++ = ' ';
+        }
+        dst = OutFormatFloat(dst, values[i]);
+    }
+    *dst++ = ')';
+    size_t length = strlen(separator);
+    memcpy(dst, separator, length);
+    return dst + length;
+}
+
 static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int numVerts, char* prefixLook, char *slashDefaultPrim, char* mtlName, int& progressTick, int progressIncrement, bool singleTerrainFile, int type, int dataVal)
 {
     // Go through data and make arrays
@@ -30149,7 +31624,7 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
         // consolidated mesh: name is mtlName_uniqueId
         sprintf_s(outputString, 256, "\n        def Mesh \"%s_%d\" (\n            prepend apiSchemas = [\"MaterialBindingAPI\"]\n        )\n        {\n", mtlName, gModel.uniqueMeshVal++);
     }
-    WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
     // is mesh two-sided? If it's interior to an opaque, it doesn't have to be, which can be a bit faster to render.
     // Only Sketchfab cares, AFAIK. TODO - should test material.
@@ -30157,22 +31632,22 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
     unsigned int mtlFlags = gBlockDefinitions[gModel.faceList[startingFace]->materialType].flags;
     if (mtlFlags & (BLF_CUTOUTS | BLF_TRANSPARENT)) {
         strcpy_s(outputString, 256, "            bool doubleSided = 1\n");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
     }
 
     if (gModel.instancing) {
         strcpy_s(outputString, 256, "            int[] faceVertexCounts = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numFaces; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.faceVertexCounts[i], (i == numFaces - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.faceVertexCounts[i], (i == numFaces - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         strcpy_s(outputString, 256, "            int[] faceVertexIndices = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.indices[i], (i == numVerts - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.indices[i], (i == numVerts - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         // define SINGLE_MATERIAL to export a single white material
@@ -30181,17 +31656,17 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
         //#define WHITE_MATERIAL
 #ifdef SINGLE_MATERIAL
         sprintf_s(outputString, 256, "            rel material:binding = <%s%s/Looks/basic>\n", (prefixLook == NULL) ? "" : prefixLook, slashDefaultPrim);
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 #else
         sprintf_s(outputString, 256, "            rel material:binding = <%s%s/Looks/%s>\n", (prefixLook == NULL) ? "" : prefixLook, slashDefaultPrim, mtlName);
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 #endif
 
         strcpy_s(outputString, 256, "            normal3f[] normals = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
-            sprintf_s(outputString, 256, "(%g, %g, %g)%s", gOutData.normals[i][X], gOutData.normals[i][Y], gOutData.normals[i][Z], (i == numVerts - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, gOutData.normals[i], 3, (i == numVerts - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         // if we're writing out a huge array, take a moment and update the progress
@@ -30200,18 +31675,18 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
 
         // if ever needed: uniform token orientation = "rightHanded"
         strcpy_s(outputString, 256, "            point3f[] points = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
-            sprintf_s(outputString, 256, "(%g, %g, %g)%s", gOutData.points[i][X], gOutData.points[i][Y], gOutData.points[i][Z], (i == numVerts - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, gOutData.points[i], 3, (i == numVerts - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         strcpy_s(outputString, 256, "            texCoord2f[] primvars:st = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
             // "interpolation = "vertex"" is the default, see https://www.openusd.org/release/api/class_usd_geom_point_based.html#ae0ac6f60f8135799ba42a16fe466f89b 
-            sprintf_s(outputString, 256, "(%g, %g)%s", gOutData.uvs[i][X], gOutData.uvs[i][Y], (i == numVerts - 1) ? "] (\n            interpolation = \"vertex\"\n        )\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, gOutData.uvs[i], 2, (i == numVerts - 1) ? "] (\n            interpolation = \"vertex\"\n        )\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
     }
@@ -30230,20 +31705,20 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
             (float)box.max[X],
             (float)box.max[Y],
             (float)box.max[Z] );
-        WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
         strcpy_s(outputString, 256, "            int[] faceVertexCounts = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numFaces; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.faceVertexCounts[i], (i == numFaces - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.faceVertexCounts[i], (i == numFaces - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         strcpy_s(outputString, 256, "            int[] faceVertexIndices = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.indicesWelded[i], (i == numVerts - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.indicesWelded[i], (i == numVerts - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         // define SINGLE_MATERIAL to export a single white material
@@ -30252,17 +31727,17 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
         //#define WHITE_MATERIAL
 #ifdef SINGLE_MATERIAL
         sprintf_s(outputString, 256, "            rel material:binding = <%s%s/Looks/basic>\n", (prefixLook == NULL) ? "" : prefixLook, slashDefaultPrim);
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 #else
         sprintf_s(outputString, 256, "            rel material:binding = <%s%s/Looks/%s>\n", (prefixLook == NULL) ? "" : prefixLook, slashDefaultPrim, mtlName);
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 #endif
 
         strcpy_s(outputString, 256, "            point3f[] points = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < gOutData.vertCountWelded; i++) {
-            sprintf_s(outputString, 256, "(%g, %g, %g)%s", (gOutData.welded[i])[0][X], (gOutData.welded[i])[0][Y], (gOutData.welded[i])[0][Z], (i == gOutData.vertCountWelded - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, (gOutData.welded[i])[0], 3, (i == gOutData.vertCountWelded - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
 
         removeDuplicateNormals();
@@ -30270,22 +31745,22 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
         // I learned that "uniform" is a better way to specify this than "faceVarying", since there's actually no varying going on. - ASWF Slack discussion 1/6/2026
         // This also means the number of normal indices must match the number of faces, not the number of vertices.
         strcpy_s(outputString, 256, "            normal3f[] primvars:normals = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < gOutData.vertCountWelded; i++) {
             //sprintf_s(outputString, 256, "(%g, %g, %g)%s", (gOutData.welded[i])[0][X], (gOutData.welded[i])[0][Y], (gOutData.welded[i])[0][Z], (i == gOutData.vertCountWelded - 1) ? "] (\n                interpolation = \"faceVarying\"\n            )\n" : ", ");
-            sprintf_s(outputString, 256, "(%g, %g, %g)%s", (gOutData.welded[i])[0][X], (gOutData.welded[i])[0][Y], (gOutData.welded[i])[0][Z], (i == gOutData.vertCountWelded - 1) ? "] (\n                interpolation = \"uniform\"\n            )\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, (gOutData.welded[i])[0], 3, (i == gOutData.vertCountWelded - 1) ? "] (\n                interpolation = \"uniform\"\n            )\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
         strcpy_s(outputString, 256, "            int[] primvars:normals:indices = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         //for (i = 0; i < numVerts; i++) {
         //    sprintf_s(outputString, 256, "%d%s", gOutData.indicesWelded[i], (i == numVerts - 1) ? "]\n" : ", ");
-        //    WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        //    WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         //}
         iv = 0;
         for (i = 0; i < numFaces; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.indicesWelded[iv], (i == numFaces - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.indicesWelded[iv], (i == numFaces - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
             iv += gOutData.faceVertexCounts[i];
         }
 
@@ -30296,18 +31771,18 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
         removeDuplicateTextureSTs();
 
         strcpy_s(outputString, 256, "            texCoord2f[] primvars:st = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < gOutData.vertCountWelded; i++) {
             // "interpolation = "vertex"" is the default, see https://www.openusd.org/release/api/class_usd_geom_point_based.html#ae0ac6f60f8135799ba42a16fe466f89b 
             //sprintf_s(outputString, 256, "(%g, %g)%s", gOutData.uvs[i][X], gOutData.uvs[i][Y], (i == numVerts - 1) ? "] (\n            interpolation = \"vertex\"\n        )\n" : ", ");
-            sprintf_s(outputString, 256, "(%g, %g)%s", (gOutData.welded[i])[0][X], (gOutData.welded[i])[0][Y], (i == gOutData.vertCountWelded - 1) ? "] (\n                interpolation = \"faceVarying\"\n            )\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDTuple(outputString, (gOutData.welded[i])[0], 2, (i == gOutData.vertCountWelded - 1) ? "] (\n                interpolation = \"faceVarying\"\n            )\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
         strcpy_s(outputString, 256, "            int[] primvars:st:indices = [");
-        WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
         for (i = 0; i < numVerts; i++) {
-            sprintf_s(outputString, 256, "%d%s", gOutData.indicesWelded[i], (i == numVerts - 1) ? "]\n" : ", ");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            char* pOut = formatUSDInt(outputString, gOutData.indicesWelded[i], (i == numVerts - 1) ? "]\n" : ", ");
+            WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
         }
     }
 
@@ -30315,10 +31790,10 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
     // (I'm told 90% of the meshes in films are subdiv surfaces). See https://openusd.org/dev/api/class_usd_geom_mesh.html
     // A bug was reported and I thought this might be a problem, https://github.com/erich666/Mineways/issues/151 but it looks like a Blender rendering error.
     strcpy_s(outputString, 256, "            uniform token subdivisionScheme = \"none\"\n");
-    WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
     strcpy_s(outputString, 256, "        }\n");
-    WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
 #ifdef SPLIT_STRATEGY
     }
@@ -30334,35 +31809,35 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
 
             // output mesh's arrays
             sprintf_s(outputString, 256, "%s        def Mesh \"%s__%d\"\n    {\n", startingFace ? "\n" : "", mtlName, m);
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
             strcpy_s(outputString, 256, "            int[] faceVertexCounts = [");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
             for (i = 0; i < numSegFaces; i++) {
-                sprintf_s(outputString, 256, "%d%s", gOutData.faceVertexCounts[i + startFace], (i == numSegFaces - 1) ? "]\n" : ", ");
-                WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+                char* pOut = formatUSDInt(outputString, gOutData.faceVertexCounts[i + startFace], (i == numSegFaces - 1) ? "]\n" : ", ");
+                WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
 
                 // we also use this loop to count up how many vertices we'll output
                 numSegVertices += gOutData.faceVertexCounts[i];
             }
 
             strcpy_s(outputString, 256, "            int[] faceVertexIndices = [");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
             for (i = 0; i < numSegVertices; i++) {
                 // we could really just substitute "i" for the whole gOutData.indices list, since this is always 0,1,2,3...
                 // but, do this way, just in case
-                sprintf_s(outputString, 256, "%d%s", gOutData.indices[i + startVertex] - startVertex, (i == numSegVertices - 1) ? "]\n" : ", ");
-                WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+                char* pOut = formatUSDInt(outputString, gOutData.indices[i + startVertex] - startVertex, (i == numSegVertices - 1) ? "]\n" : ", ");
+                WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
             }
 
             sprintf_s(outputString, 256, "            rel material:binding = <%s%s/Looks/%s>\n", (prefixLook == NULL) ? "" : prefixLook, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
             strcpy_s(outputString, 256, "            normal3f[] normals = [");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
             for (i = 0; i < numSegVertices; i++) {
-                sprintf_s(outputString, 256, "(%g, %g, %g)%s", gOutData.normals[i + startVertex][X], gOutData.normals[i + startVertex][Y], gOutData.normals[i + startVertex][Z], (i == numSegVertices - 1) ? "]\n" : ", ");
-                WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+                char* pOut = formatUSDTuple(outputString, gOutData.normals[i + startVertex], 3, (i == numSegVertices - 1) ? "]\n" : ", ");
+                WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
             }
 
             // if we're writing out a huge array, take a moment and update the progress
@@ -30370,21 +31845,21 @@ static int outputUSDMesh(PORTAFILE file, int startingFace, int numFaces, int num
                 UPDATE_PROGRESS(gProgress.start.output + gProgress.absolute.output * ((float)startFace / (float)gModel.faceCount));
 
             strcpy_s(outputString, 256, "            point3f[] points = [");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
             for (i = 0; i < numSegVertices; i++) {
-                sprintf_s(outputString, 256, "(%g, %g, %g)%s", gOutData.points[i + startVertex][X], gOutData.points[i + startVertex][Y], gOutData.points[i + startVertex][Z], (i == numSegVertices - 1) ? "]\n" : ", ");
-                WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+                char* pOut = formatUSDTuple(outputString, gOutData.points[i + startVertex], 3, (i == numSegVertices - 1) ? "]\n" : ", ");
+                WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
             }
 
             strcpy_s(outputString, 256, "            texCoord2f[] primvars:st = [");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
             for (i = 0; i < numSegVertices; i++) {
-                sprintf_s(outputString, 256, "(%g, %g)%s", gOutData.uvs[i + startVertex][X], gOutData.uvs[i + startVertex][Y], (i == numSegVertices - 1) ? "] (\n            interpolation = \"vertex\"\n        )\n" : ", ");
-                WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+                char* pOut = formatUSDTuple(outputString, gOutData.uvs[i + startVertex], 2, (i == numSegVertices - 1) ? "] (\n            interpolation = \"vertex\"\n        )\n" : ", ");
+                WERROR_MODEL(OutWrite(file, outputString, pOut - outputString));
             }
 
             strcpy_s(outputString, 256, "        }\n");
-            WERROR_MODEL(PortaWrite(file, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(file, outputString, strlen(outputString)));
 
             // compute next starting locations
             startVertex += numSegVertices;
@@ -30787,23 +32262,23 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
             goto Exit;
         }
         strcpy_s(outputString, 256, "defaultPrim=\"Blocks\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "    metersPerUnit = 1\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "    upAxis = \"Y\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, ")\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "def Scope \"Blocks\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "{\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     }
 
     strcpy_s(outputString, 256, "\n    def Scope \"Looks\" (\n        kind = \"model\"\n    )\n    {\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
     // spin out all the shaders, one per tile.
 
@@ -30818,35 +32293,35 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
     isTileValueConstant(0, 0, value);
     tileAlphaStatus(0);
     strcpy_s(outputString, 256, "        def Material \"basic\"\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        {\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     sprintf_s(outputString, 256, "            token outputs:surface.connect = <%s/Looks/basic/PreviewSurface.outputs:surface>\n", slashDefaultPrim);
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "\n            def Shader \"PreviewSurface\"\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            {\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                uniform token info:id = \"UsdPreviewSurface\"\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                color3f inputs:diffuseColor = (1.0, 1.0, 1.0)\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                float inputs:metallic = 0\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                float inputs:opacity = 1\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                float inputs:roughness = 1\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                int inputs:useSpecularWorkflow = 0\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                token outputs:out\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "                token outputs:surface\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            }\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        }\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 #else
     char mtlName[MAX_PATH_AND_FILE];
 
@@ -31006,9 +32481,9 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
         bool hasRoughness = singleTerrainFile ? gModel.hasPBRmosaic[CATEGORY_ROUGHNESS] : gModel.tileList[CATEGORY_ROUGHNESS][swatchLoc];
 
         sprintf_s(outputString, 256, "%s        def Material \"%s\"\n", startRun ? "\n" : "", mtlName);
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "        {\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 #ifdef WHITE_MATERIAL
         // make compiler happy
         mdlPath;
@@ -31019,74 +32494,74 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
         tileIsAnEmitter(0, 0);
 
         sprintf_s(outputString, 256, "            token outputs:surface.connect = <%s/Looks/%s/PreviewSurface.outputs:surface>\n", slashDefaultPrim, mtlName);
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "\n            def Shader \"PreviewSurface\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "            {\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                uniform token info:id = \"UsdPreviewSurface\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                color3f inputs:diffuseColor = (1.0, 1.0, 1.0)\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                float inputs:metallic = 0\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                float inputs:opacity = 1\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                float inputs:roughness = 1\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                int inputs:useSpecularWorkflow = 0\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                token outputs:out\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "                token outputs:surface\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         strcpy_s(outputString, 256, "            }\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 #else
         // we normally output MDL descriptions, etc. Allow turning this off, so that UsdPreview (only) materials are used.
         if (gModel.exportMDL) {
             // displacement_connect seems to be something MDL likes to have, e.g., https://developer.nvidia.com/usd/mdlschema
             sprintf_s(outputString, 256, "            token outputs:mdl:displacement.connect = <%s%s/Looks/%s/Shader.outputs:out>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "            token outputs:mdl:surface.connect = <%s%s/Looks/%s/Shader.outputs:out>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "            token outputs:mdl:volume.connect = <%s%s/Looks/%s/Shader.outputs:out>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         }
         // put this one in alphabetical order for the MDL
         if (usePreviewSurface) {
             // I don't think this is needed - it's not hooked up
             //sprintf_s(outputString, 256, "        token outputs:displacement.connect = <%s%s/Looks/%s/PreviewSurface.outputs:displacement>\n", prefixPath, slashDefaultPrim, mtlName);
-            //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "            token outputs:surface.connect = <%s%s/Looks/%s/PreviewSurface.outputs:surface>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         }
         // continue
         if (gModel.exportMDL) {
             strcpy_s(outputString, 256, "\n            def Shader \"Shader\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            {\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                uniform token info:implementationSource = \"sourceAsset\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             // don't use any custom material for semitransparent (glass, water) materials
             if (gModel.customMaterial && !isSemitransparent) {
                 // TODOUSD UberNN, or make a MinecraftGlass.mdl file as a wrapper?
                 //sprintf_s(outputString, 256, "                uniform asset info:mdl:sourceAsset = @%s%s.mdl@\n", mdlPath, isSemitransparent ? "OmniSurfaceUber" : "Mineways");
-                //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 //sprintf_s(outputString, 256, "                uniform token info:mdl:sourceAsset:subIdentifier = \"%s\"\n", isSemitransparent ? "OmniSurfaceUber" : "Mineways");
-                //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                uniform asset info:mdl:sourceAsset = @./%sMineways.mdl@\n", mdlPath);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                uniform token info:mdl:sourceAsset:subIdentifier = \"Mineways\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             else {
                 // NOTE: no mdlPath, as OmniGlass, OmniPBR, and OmniPBR_Opacity are built-in MDL files
                 sprintf_s(outputString, 256, "                uniform asset info:mdl:sourceAsset = @Omni%s.mdl@\n", isSemitransparent ? "Glass" : (isCutout ? "PBR_Opacity" : "PBR"));
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                uniform token info:mdl:sourceAsset:subIdentifier = \"Omni%s\"\n", isSemitransparent ? "Glass" : (isCutout ? "PBR_Opacity" : "PBR"));
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // if true, then normals and roughness are output here and so don't need to be output later
@@ -31108,246 +32583,246 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                     // normal map?
                     if (hasNormals) {
                         sprintf_s(outputString, 256, "                asset inputs:coat_normal_image = @%s/%s%s.png@ (\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_NORMALS]);
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n"); // "raw" is the right choice for normals - see Absolution.
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayGroup = \"Coat\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Normal Map Image\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                float inputs:coat_weight = 0.5 (\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayGroup = \"Coat\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Weight\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
 
                     sprintf_s(outputString, 256, "                asset inputs:diffuse_reflection_color_image = @%s/%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"auto\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Base\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Color Image\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     sprintf_s(outputString, 256, "                asset inputs:specular_reflection_color_image = @%s/%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"auto\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Specular\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Color Image\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     sprintf_s(outputString, 256, "                float inputs:specular_reflection_ior = %g (\n", ior);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 1.5\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 2.0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Specular\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"IOR\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     // if there is a specular roughness map, set roughness to 1 as it acts as a influence for the roughness map
                     sprintf_s(outputString, 256, "                float inputs:specular_reflection_roughness = %g (\n", hasRoughness ? 1.0f : specRoughness);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0.2\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Specular\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Roughness\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     if (hasRoughness) {
                         sprintf_s(outputString, 256, "                asset inputs:specular_reflection_roughness_image = @%s/%s%s.png@ (\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_ROUGHNESS]);
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    colorSpace = \"auto\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        asset default = @@\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Specular\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Roughness Image\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                         strcpy_s(outputString, 256, "                int inputs:specular_reflection_roughness_image_alpha_mode = 1 (\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        int default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayGroup = \"Specular\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Roughness Image Alpha Mode\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    renderType = \"OmniImage::alpha_mode\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    sdrMetadata = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        string __SDR__enum_value = \"alpha_default\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        string options = \"alpha_default:0|alpha_red:1|alpha_green:2|alpha_blue:3|alpha_white:4|alpha_black:5|alpha_luminanace:6|alpha_average:7\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
 
                     sprintf_s(outputString, 256, "                asset inputs:specular_transmission_color_image = @%s/%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"auto\"\n");  should not be auto, probably
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Transmission\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Color Image\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     sprintf_s(outputString, 256, "                float inputs:specular_transmission_scattering_depth = %g (\n", depth);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 3.4028235e38\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Transmission\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Depth\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                float inputs:specular_transmission_weight = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Transmission\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Weight\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 else {
                 */
@@ -31355,54 +32830,54 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                 // Standard transmitter material (doesn't include blocky look
                 // when meters, 0.001 is pretty good, the default
                 strcpy_s(outputString, 256, "                float inputs:depth = 0.001 (\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        float default = 0.001\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float max = 1000\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float min = 0\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Color\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Volume Absorption Scale\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                 sprintf_s(outputString, 256, "                float inputs:frosting_roughness = %g (\n", specRoughness);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        float default = 0\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float max = 1\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float min = 0\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Roughness\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Glass Roughness\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                 // hack: the very blue water color is way too much - tone it down
                 if (isWater) {
@@ -31414,29 +32889,29 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                         g = 255;
                 }
                 sprintf_s(outputString, 256, "                color3f inputs:glass_color = (%g, %g, %g) (\n", (float)r / 255.0f, (float)g / 255.0f, (float)b / 255.0f);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        float3 default = (1, 1, 1)\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float3 max = (0, 0, 0)\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float3 min = (0, 0, 0)\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Color\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Glass Color\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                 // don't output the water texture, as it becomes way too blue
                 if (!isWater) {
@@ -31445,87 +32920,87 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
 
                     // currently not alphabetized - TODO - kind of messy to do so
                     sprintf_s(outputString, 256, "                asset inputs:cutout_opacity_texture = @./%s/%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"auto\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Opacity Map\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     //
                     strcpy_s(outputString, 256, "                bool inputs:enable_opacity = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        bool default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Enable Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     //
                     sprintf_s(outputString, 256, "                asset inputs:glass_color_texture = @./%s/%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"sRGB\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Color\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Glass Color Texture\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
 
                 sprintf_s(outputString, 256, "                float inputs:glass_ior = %g (\n", ior);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        float default = 1.491\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float max = 4\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                            float min = 1\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Refraction\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Glass IOR\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 //}
             }
             else {
@@ -31533,23 +33008,23 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
 
                 // add the "_y" if synthesized - material name differs from tile file name in this case
                 sprintf_s(outputString, 256, "                asset inputs:diffuse_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags& SBIT_SYNTHESIZED)) ? "_y" : "");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    colorSpace = \"sRGB\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        asset default = @@\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Albedo\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Diffuse Texture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                 // emitter?
                 if (tileIsAnEmitter(pFace->materialType, swatchLoc)) {
@@ -31599,77 +33074,77 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                         //if (b < 25)
                         //    b = 25;
                         sprintf_s(outputString, 256, "                color3f inputs:emissive_color = (%g, %g, %g) (\n", (float)r / 255.0f, (float)g / 255.0f, (float)b / 255.0f);
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        float3 default = (1, 0.1, 0.1)\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                            float3 max = (10000, 10000, 10000)\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                            float3 min = (0, 0, 0)\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Emissive\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Emissive Color\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                         // same as the diffuse texture
                         sprintf_s(outputString, 256, "                asset inputs:emissive_color_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    colorSpace = \"sRGB\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        asset default = @@\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Emissive\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Emissive Color map\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                         // Omniverse rejiggers stuff and the emissive intensity needs to get multiplied by 90;
                         // I don't want all those 0's in the interface
                         //sprintf_s(outputString, 256, "                float inputs:emissive_intensity = %g (\n", gModel.options->pEFD->scaleEmittersVal * emission * 90.0f);
                         sprintf_s(outputString, 256, "                float inputs:emissive_intensity = %g (\n", gModel.options->pEFD->scaleEmittersVal * emission * 50.0f * 90.0f);
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        float default = 90000\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                            float max = 1000000\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                            float min = 0\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Emissive\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Emissive Intensity\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                         // if there's a specific emitter texture available, use it, adding the "_e" suffix.
 #ifdef GENERATE_EMISSION_TILES
@@ -31681,42 +33156,42 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                         //sprintf_s(outputString, 256, "                asset inputs:emissive_mask_texture = @./%s%s%s.png@ (\n", texturePath, mtlName,
                         //    hasEmission ? "_e" : 
                         //        (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                         strcpy_s(outputString, 256, "                    colorSpace = \"sRGB\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
 
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        asset default = @@\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Emissive\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Emissive Mask map\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                bool inputs:enable_emission = 1 (\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
 
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        bool default = 0\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Emissive\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Enable Emission\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                 }
 
@@ -31724,130 +33199,130 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                 if (isCutout) {
                     // cutout or transparent
                     strcpy_s(outputString, 256, "                bool inputs:enable_opacity = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
 
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        bool default = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Enable Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     // not actually needed by custom material Mineways.mdl. Warning given if set.
                     if (!gModel.customMaterial) {
                         strcpy_s(outputString, 256, "                bool inputs:enable_opacity_texture = 1 (\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         if (outputCustomData) {
 
                             strcpy_s(outputString, 256, "                    customData = {\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                        bool default = 0\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                             strcpy_s(outputString, 256, "                    }\n");
-                            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         }
                         strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    displayName = \"Enable Opacity Texture\"\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                )\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                 }
 
                 // normals? If custom material, output the normal strength UI
                 if (gModel.customMaterial && hasNormals) {
                     strcpy_s(outputString, 256, "                float inputs:geometry_normal_strength = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 10\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = -10\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Normal\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Normal Map Strength\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
 
                 // metallic?
                 if (hasMetallic) {
                     sprintf_s(outputString, 256, "                asset inputs:metallic_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_METALLIC]);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
 
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Metallic Map\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                float inputs:metallic_texture_influence = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
 
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Metallic Map Influence\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 else {
                     // the default is 0 metallic
                     sprintf_s(outputString, 256, "                float inputs:metallic_constant = %g (\n", metallic);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Metallic Amount\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
             }
 
@@ -31862,45 +33337,45 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
             if (isSemitransparent) {
                 // slightly different naming - good times! Add "./" if the texture actually exists, else "@@"
                 sprintf_s(outputString, 256, "                asset inputs:normal_map_texture = @%s%s@ (\n", strlen(textureString) > 0 ? "./" : "", textureString);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        asset default = @@\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Normal\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Normal Map Texture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             else {
                 // Note how spelling is different, which is annoying: normal_map_texture above, normalmap_texture here.
                 // Yes, I've verified it: if you change the spelling, the load fails and gives a console warning.
                 sprintf_s(outputString, 256, "                asset inputs:normalmap_texture = @%s%s@ (\n", strlen(textureString) > 0 ? "./" : "", textureString);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n"); // must be raw. "auto" gives the bad result of patterning, see Absolution grass blocks for example.
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        asset default = @@\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Normal\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Normal Map\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // cutout? Part 2
@@ -31908,86 +33383,86 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                 // not actually needed by custom material Mineways.mdl. Warning given if set.
                 if (!gModel.customMaterial) {
                     strcpy_s(outputString, 256, "                int inputs:opacity_mode = 0 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
 
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        int default = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Opacity Mono Source\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    renderType = \"::base::mono_mode\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    sdrMetadata = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        string __SDR__enum_value = \"mono_average\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        string options = \"mono_alpha:0|mono_average:1|mono_luminance:2|mono_maximum:3\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
 
                 sprintf_s(outputString, 256, "                asset inputs:opacity_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags& SBIT_SYNTHESIZED)) ? "_y" : "");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 if (outputCustomData) {
 
                     strcpy_s(outputString, 256, "                    customData = {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                        asset default = @@\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Opacity Map\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                 // opacity threshold is 0.5 for cutouts (not used when glass?)
                 // only available in generic OmniPBR_Opacity.mdl, not in Minecraft.mdl currently
                 //if (!gModel.customMaterial) {
                 if (!gModel.customMaterial && isCutout) {
                     strcpy_s(outputString, 256, "                float inputs:opacity_threshold = 0.5 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Opacity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Opacity Threshold\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    doc = \"If negative, disable cutout_opacity; if 0, use fractional opacity values 'as is'; if > 0, remap opacity values to 1 when >= threshold and to 0 otherwise\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    hidden = false\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
             }
 
@@ -31996,81 +33471,81 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                 if (isSemitransparent) {
                     // slightly different naming - good times!
                     sprintf_s(outputString, 256, "                asset inputs:roughness_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_ROUGHNESS]);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Roughness\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Roughness Texture\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
                 else {
                     strcpy_s(outputString, 256, "                float inputs:reflection_roughness_texture_influence = 1 (\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        float default = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        dictionary range = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float max = 1\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                            float min = 0\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Roughness Map Influence\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     sprintf_s(outputString, 256, "                asset inputs:reflectionroughness_texture = @./%s%s%s.png@ (\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_ROUGHNESS]);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    colorSpace = \"raw\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     if (outputCustomData) {
 
                         strcpy_s(outputString, 256, "                    customData = {\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                        asset default = @@\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                         strcpy_s(outputString, 256, "                    }\n");
-                        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     }
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Roughness Map\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
             }
             else {
                 // only in Minecraft.mdl and OmniPBR.mdl, not in OmniGlass.mdl
                 if (!isSemitransparent) {
                     sprintf_s(outputString, 256, "                float inputs:reflection_roughness_constant = %g (\n", roughness);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayGroup = \"Reflectivity\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                    displayName = \"Roughness Amount\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                )\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
             }
 
@@ -32079,16 +33554,16 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
             // and they cause z-fighting.
             if (gModel.customMaterial && isCutout && emission > 0.0f) {
                 strcpy_s(outputString, 256, "                bool inputs:thin_walled = 1 (\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                    displayName = \"Thin-walled Material\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                )\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             strcpy_s(outputString, 256, "                token outputs:out\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            }\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         }
 
         // see https://graphics.pixar.com/usd/docs/UsdPreviewSurface-Proposal.html#UsdPreviewSurfaceProposal-TextureReader
@@ -32111,22 +33586,22 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
             bool tRepeat = (gTilesTable[swatchLoc].flags & SBIT_REPEAT_TOP_BOTTOM) ? true : false;
 
             strcpy_s(outputString, 256, "\n            def Shader \"PreviewSurface\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            {\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                uniform token info:id = \"UsdPreviewSurface\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
             // - diffuse input - we output both, just in case the texture is missing or the interpret can't figure it out.
             sprintf_s(outputString, 256, "                color3f inputs:diffuseColor = (%g, %g, %g)\n", (float)r / 255.0f, (float)g / 255.0f, (float)b / 255.0f);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                color3f inputs:diffuseColor.connect = <%s%s/Looks/%s/diffuse_texture.outputs:rgb>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
             // - emissive input
             if (tileIsAnEmitter(pFace->materialType, swatchLoc)) {
                 sprintf_s(outputString, 256, "                color3f inputs:emissiveColor.connect = <%s%s/Looks/%s/emissive_texture.outputs:rgb>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // - ior input
@@ -32137,24 +33612,24 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                 //float specRoughness = isSlime ? 0.34f : 0.0f;   // TODOUSD - could also add ice someday and make it cloudy like this?
 
                 sprintf_s(outputString, 256, "                float inputs:ior = %g\n", ior);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // - metallic input
             if (hasMetallic) {
                 sprintf_s(outputString, 256, "                float inputs:metallic.connect = <%s%s/Looks/%s/metallic_texture.outputs:r>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             else {
                 sprintf_s(outputString, 256, "                float inputs:metallic = %g\n", metallic);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // - normal input
             if (hasNormals) {
                 // was normal3f, which works, but is not strictly correct
                 sprintf_s(outputString, 256, "                float3 inputs:normal.connect = <%s%s/Looks/%s/normal_texture.outputs:rgb>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // - opacity input - this could be removed for textures without alphas, but for simplicity we always connect it
@@ -32167,164 +33642,164 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
             // 0.5 looks best, giving a nicer interpolation for the RTX Real-time renderer, for example, with smoother interpolation
             if (isCutout || isSemitransparent) {
                 sprintf_s(outputString, 256, "                float inputs:opacity.connect = <%s%s/Looks/%s/diffuse_texture.outputs:a>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                float inputs:opacityThreshold = %f\n", isSemitransparent ? 0.0f : 0.5f );
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             else {
                 // Possible addition: could output this (and roughness and metalness) as numbers
                 // anyway, just in case the textures are not found. But, I'd rather the user
                 // knew that the textures were not found.
                 sprintf_s(outputString, 256, "                float inputs:opacity = 1\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // - roughness input
             if (hasRoughness) {
                 sprintf_s(outputString, 256, "                float inputs:roughness.connect = <%s%s/Looks/%s/roughness_texture.outputs:r>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             else {
                 sprintf_s(outputString, 256, "                float inputs:roughness = %g\n", roughness);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             strcpy_s(outputString, 256, "                int inputs:useSpecularWorkflow = 0\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
             // I don't think this is needed
             //strcpy_s(outputString, 256, "                token outputs:out\n");
-            //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                token outputs:surface\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            }\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));            
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));            
 
             // UV Reader
 
             // Generic primvar reader used in this case to read uv coordinates for required UsdUvTextures
 
             strcpy_s(outputString, 256, "\n            def Shader \"uv_reader\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            {\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                uniform token info:id = \"UsdPrimvarReader_float2\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                float2 inputs:fallback = (0, 0)\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                token inputs:varname = \"st\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                float2 outputs:result\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            }\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
             // Roughness
 
             if (hasRoughness) {
                 strcpy_s(outputString, 256, "\n            def Shader \"roughness_texture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            {\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                uniform token info:id = \"UsdUVTexture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_ROUGHNESS]);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                token inputs:sourceColorSpace = \"raw\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                float2 inputs:st.connect = <%s%s/Looks/%s/uv_reader.outputs:result>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapS = \"%s\"\n", sRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapT = \"%s\"\n", tRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                float outputs:r\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            }\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // Normals
 
             if (hasNormals) {
                 strcpy_s(outputString, 256, "\n            def Shader \"normal_texture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            {\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                uniform token info:id = \"UsdUVTexture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                float4 inputs:bias = (-1, 1, -1, -1)\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_NORMALS]);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 // yes, this scale of Y=-2 (and bias of 1.0 in the next line) seems weird to me, too, but seems to work. I don't love it.
                 strcpy_s(outputString, 256, "                float4 inputs:scale = (2, -2, 2, 2)\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                token inputs:sourceColorSpace = \"raw\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                float2 inputs:st.connect = <%s%s/Looks/%s/uv_reader.outputs:result>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapS = \"%s\"\n", sRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapT = \"%s\"\n", tRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                float3 outputs:rgb\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            }\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // Metallic
 
             if (hasMetallic) {
                 strcpy_s(outputString, 256, "\n            def Shader \"metallic_texture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            {\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                uniform token info:id = \"UsdUVTexture\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_METALLIC]);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                token inputs:sourceColorSpace = \"raw\"\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                float2 inputs:st.connect = <%s%s/Looks/%s/uv_reader.outputs:result>\n", prefixPath, slashDefaultPrim, mtlName);
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapS = \"%s\"\n", sRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 sprintf_s(outputString, 256, "                token inputs:wrapT = \"%s\"\n", tRepeat ? "repeat" : "clamp");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "                float outputs:r\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 strcpy_s(outputString, 256, "            }\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
 
             // Diffuse Texture
 
             strcpy_s(outputString, 256, "\n            def Shader \"diffuse_texture\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            {\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                uniform token info:id = \"UsdUVTexture\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, (gModel.exportTiles && (gTilesTable[swatchLoc].flags & SBIT_SYNTHESIZED)) ? "_y" : "");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "                token inputs:sourceColorSpace = \"sRGB\"\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                float2 inputs:st.connect = <%s%s/Looks/%s/uv_reader.outputs:result>\n", prefixPath, slashDefaultPrim, mtlName);
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                token inputs:wrapS = \"%s\"\n", sRepeat ? "repeat" : "clamp");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             sprintf_s(outputString, 256, "                token inputs:wrapT = \"%s\"\n", tRepeat ? "repeat" : "clamp");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             if (isCutout || isSemitransparent) {
                 strcpy_s(outputString, 256, "                float outputs:a\n");
-                WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             }
             strcpy_s(outputString, 256, "                float3 outputs:rgb\n");    // was color3f, which works, but is not strictly correct
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
             strcpy_s(outputString, 256, "            }\n");
-            WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+            WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
             // Emissive Texture
 
@@ -32356,17 +33831,17 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                     b = (unsigned char)(0.5f + ((float)b * 255.0f / max));
 
                     strcpy_s(outputString, 256, "\n            def Shader \"emissive_texture\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "            {\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                uniform token info:id = \"UsdUVTexture\"\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 #ifdef GENERATE_EMISSION_TILES
                     sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_EMISSION]);
 #else
                     sprintf_s(outputString, 256, "                asset inputs:file = @./%s%s%s.png@\n", texturePath, mtlName, gCatStrSuffixes[CATEGORY_RGBA]);
 #endif
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     // the emissive texture is a grayscale texture, so we (sadly) need to "add the color back in". This is a limitation of Minecraft's texture
                     // pack system, where the emissive texture is expected to be a grayscale image. We could take corrective actions, e.g.,
@@ -32375,14 +33850,14 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                     //float escale = gModel.options->pEFD->scaleEmittersVal * emission * 0.02f;   // UsdPrevSurface was rebalanced to be about 20 as a good scale for lava.
                     float escale = gModel.options->pEFD->scaleEmittersVal * emission;   // UsdPrevSurface was rebalanced to be about 20 as a good scale for lava.
                     sprintf_s(outputString, 256, "                float4 inputs:scale = (%g, %g, %g, 1.0)\n", escale, escale, escale);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     // do not use sRGB for the emitter color space - this generates an error in UsdView, which makes sense;
                     // it's a one-channel emitter that should get multiplied by the albedo texture
                     //strcpy_s(outputString, 256, "                token inputs:sourceColorSpace = \"sRGB\"\n");
-                    //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     sprintf_s(outputString, 256, "                float2 inputs:st.connect = <%s%s/Looks/%s/uv_reader.outputs:result>\n", prefixPath, slashDefaultPrim, mtlName);
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     // for when emitter textures are grayscale:
                     //float escale = gModel.options->pEFD->scaleEmittersVal * emission / 255.0f;
@@ -32390,22 +33865,22 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
                     // not this:
                     //float escale = 1000.0f * emission;
                     //sprintf_s(outputString, 256, "                float4 inputs:scale = (%g, %g, %g, 1.0)\n", escale, escale, escale);
-                    //WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    //WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
                     sprintf_s(outputString, 256, "                token inputs:wrapS = \"%s\"\n", sRepeat ? "repeat" : "clamp");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     sprintf_s(outputString, 256, "                token inputs:wrapT = \"%s\"\n", tRepeat ? "repeat" : "clamp");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "                float3 outputs:rgb\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                     strcpy_s(outputString, 256, "            }\n");
-                    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+                    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
                 }
             }
         }
 #endif
         strcpy_s(outputString, 256, "        }\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
         // go to next group
         startRun = nextStart;
@@ -32419,12 +33894,12 @@ static int createMaterialsUSD(char *texturePath, char *mdlPath, wchar_t *mtlLibr
 #endif
 
     strcpy_s(outputString, 256, "    }\n");
-    WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
 
     // doing instancing?
     if (mtlLibraryFilename != NULL) {
         strcpy_s(outputString, 256, "} # close Scope \"Blocks\"\n");
-        WERROR_MODEL(PortaWrite(materialFile, outputString, strlen(outputString)));
+        WERROR_MODEL(OutWrite(materialFile, outputString, strlen(outputString)));
         if (retCode |= closeUSDFile(materialFile)) {
             // failed to quit - really, we're done, so nothing to do, but left in case someday we add more code below.
         }
@@ -32694,52 +34169,52 @@ static int createLightingUSD(char *texturePath)
     char outputString[256];
     boolean nightLight = (gModel.options->worldType & LIGHTING) ? true : false;
     strcpy_s(outputString, 256, "\n    def Xform \"Lights\"\n    {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     strcpy_s(outputString, 256, nightLight ? "        def DistantLight \"Moon\" (\n" : "        def DistantLight \"Sun\" (\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            prepend apiSchemas = [\"ShapingAPI\"]\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            kind = \"model\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        )\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:angle = 1\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // scale everything up by 52.0f, as we are no longer adjusting the camera's exposure, etc.
     float lightIntensity = (float)(gModel.options->pEFD->scaleLightsVal * 52.0f * (nightLight ? 2.0 / 30.0 : 30.0 / 30.0));
     sprintf_s(outputString, 256, "            float inputs:intensity = %f\n", lightIntensity);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:cone:angle = 180\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:cone:softness\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:focus\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            color3f inputs:shaping:focusTint\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            asset inputs:shaping:ies:file\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double3 xformOp:rotateZXY = (235, 325, 0)\n");  // x is altitude, y is azimuth, z does nothing
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double3 xformOp:translate = (0, 0, 0)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            uniform token[] xformOpOrder = [\"xformOp:translate\", \"xformOp:rotateZXY\"]\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     strcpy_s(outputString, 256, "\n        def DomeLight \"DomeLight\" (\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            prepend apiSchemas = [\"ShapingAPI\"]\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        )\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        {\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // low for the nighttime sky, but making it higher makes the background surrounding map too bright.
     // used to multiply by 52.0f - let's not
@@ -32748,21 +34223,21 @@ static int createLightingUSD(char *texturePath)
     lightIntensity = (float)(gModel.options->pEFD->scaleLightsVal / 15.0f) * (nightLight ? 0.5f : 1.0f);
 
     sprintf_s(outputString, 256, "            float inputs:intensity = %f\n", lightIntensity);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:cone:angle = 180\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:cone:softness\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            float inputs:shaping:focus\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            color3f inputs:shaping:focusTint\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            asset inputs:shaping:ies:file\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     sprintf_s(outputString, 256, nightLight ? "            asset inputs:texture:file = @./%s_domelight_night.png@\n" : "            asset inputs:texture:file = @./%s_domelight.png@\n", texturePath);
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            token inputs:texture:format = \"latlong\"\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     // TODO: someday should rotate this light and the previous light around X if Z is up axis:
     // if (gModel.options->pEFD->chkMakeZUp[gModel.options->pEFD->fileType])
@@ -32770,16 +34245,16 @@ static int createLightingUSD(char *texturePath)
     // transform is left in so as to be easy to "fix" for USD Composer, just set X to 270
     strcpy_s(outputString, 256, "            double3 xformOp:rotateZXY = (0, 0, 0)\n");
     //strcpy_s(outputString, 256, "            double3 xformOp:rotateZXY = (270, 0, 0)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            double3 xformOp:translate = (0, 0, 0)\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "            uniform token[] xformOpOrder = [\"xformOp:translate\", \"xformOp:rotateZXY\"]\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
     strcpy_s(outputString, 256, "        }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     strcpy_s(outputString, 256, "    }\n");
-    WERROR_MODEL(PortaWrite(gModelFile, outputString, strlen(outputString)));
+    WERROR_MODEL(OutWrite(gModelFile, outputString, strlen(outputString)));
 
     return MW_NO_ERROR;
 }
@@ -32791,7 +34266,7 @@ static int writeMDLforUSD(wchar_t* filePath)
     while (mdlFileContents[fcount] != NULL) {
         wchar_t outputFile[MAX_PATH_AND_FILE];
         concatFileName2(outputFile, filePath, mdlFileNames[fcount]);
-        PORTAFILE mdlFile = PortaCreate(outputFile);
+        PORTAFILE mdlFile = OutCreate(outputFile);
         addOutputFilenameToList(outputFile);
         if (mdlFile == INVALID_HANDLE_VALUE)
             return MW_CANNOT_CREATE_FILE;
@@ -32800,10 +34275,10 @@ static int writeMDLforUSD(wchar_t* filePath)
         // loop through lines in file and write
         const char** fileContents = mdlFileContents[fcount];
         for (int i = 0; i < fileLines; i++) {
-            WERROR_MODEL(PortaWrite(mdlFile, fileContents[i], strlen(fileContents[i])));
+            WERROR_MODEL(OutWrite(mdlFile, fileContents[i], strlen(fileContents[i])));
         }
 
-        PortaClose(mdlFile);
+        OutClose(mdlFile);
 
         fcount++;
     }
@@ -32814,7 +34289,7 @@ static int writeMDLforUSD(wchar_t* filePath)
 
 static int closeUSDFile(PORTAFILE& modelFile)
 {
-    PortaClose(modelFile);
+    OutClose(modelFile);
     return 0;
 }
 
@@ -33077,14 +34552,14 @@ static int writeSchematicBox()
                 }
 
                 // if you're storing 1.13+ types, you're out of luck - converted to grass
-                if (gBoxData[boxIndex].type < 256) {
-                    type = (unsigned char)gBoxData[boxIndex].type;
-                    data = gBoxData[boxIndex].data;
+                if (gBoxType[boxIndex] < 256) {
+                    type = (unsigned char)gBoxType[boxIndex];
+                    data = gBoxDataVal[boxIndex];
 
                     // for 1.13+ we properly use all the bits (separate faces) for huge mushrooms, instead of the old 0-15
                     // system in 1.12 and earlier. To keep it simple here, if a 1.13+ huge mushroom is found, we convert as possible
                     // here. May not work - we're crunching 64 possibilities down to 16.
-                    if (gIs13orNewer && (gBoxData[boxIndex].type == BLOCK_HUGE_BROWN_MUSHROOM || (gBoxData[boxIndex].type == BLOCK_HUGE_RED_MUSHROOM))) {
+                    if (gIs13orNewer && (gBoxType[boxIndex] == BLOCK_HUGE_BROWN_MUSHROOM || (gBoxType[boxIndex] == BLOCK_HUGE_RED_MUSHROOM))) {
                         // stem?
                         if (data & 0x40) {
                             // top or not?
@@ -33170,10 +34645,10 @@ static int writeSchematicBox()
                 }
                 // ignore or turn into bedrock if at end of list of valid blocks
                 // for this old-fashioned schematic file format.
-                if (gBoxData[boxIndex].type >= BLOCK_UNKNOWN)
+                if (gBoxType[boxIndex] >= BLOCK_UNKNOWN)
                 {
                     // unknown block?
-                    if (gBoxData[boxIndex].type == BLOCK_UNKNOWN)
+                    if (gBoxType[boxIndex] == BLOCK_UNKNOWN)
                     {
                         // convert to whatever "Set unknown block ID" is set to (default is 7 - Bedrock)
                         data = 0x0;
@@ -33450,7 +34925,7 @@ static int writeSpongeSchematicBox()
     int offset[3] = { 0, 0, 0 };
     CHECK_SPONGE_QUIT(schematicWriteIntArrayTag(gz, "Offset", offset, 3));
 
-    // ===== Pass 1: walk gBoxData, build the palette, and encode BlockData varints into a buffer =====
+    // ===== Pass 1: walk the box cells, build the palette, and encode BlockData varints into a buffer =====
     //
     // Sponge voxel ordering is i = x + z*W + y*W*L (X innermost, Y outermost) and matches the
     // existing legacy schematic loop. The palette is a string→int map; we cache assigned indices per
@@ -33499,8 +34974,8 @@ static int writeSpongeSchematicBox()
                     ? BOX_INDEX(loc[Z], loc[Y], loc[X])
                     : BOX_INDEX(loc[X], loc[Y], loc[Z]);
 
-                int type = (int)gBoxData[boxIndex].type;
-                int dataVal = (int)gBoxData[boxIndex].data;
+                int type = (int)gBoxType[boxIndex];
+                int dataVal = (int)gBoxDataVal[boxIndex];
 
                 int lookupKey = (type & 0x1FF) * 256 + (dataVal & 0xFF);
                 if (lookupKey < 0 || lookupKey >= NUM_BLOCKS_DEFINED * 256) {
@@ -33583,6 +35058,25 @@ static int writeSpongeSchematicBox()
     return retCode;
 }
 
+// Runs on a worker thread, so must not touch anything shared other than to read it
+static void writeTileTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    TileWriteTask* pTask = &((TileWriteTask*)userData)[taskIndex];
+    if (pTask->category == CATEGORY_RGBA || pTask->clampLevel > 0) {
+        // color output - to go back to grayscale for emitters, simply change next-to-last arg from false to true
+        pTask->rc = writeTileFromMasterOutput(pTask->filename, gModel.pPNGtexture, pTask->swatchLoc, gModel.swatchSize, gModel.swatchesPerRow, false, pTask->clampLevel);
+    }
+    // special case: if there's an emissive texture, it's grayscale (just the way Minecraft RTX defines it).
+    // But, these look bad in some DCC apps. So, we do this crazy thing: hue of diffuse times grayscale.
+    else if (pTask->category == CATEGORY_EMISSION) {
+        pTask->rc = writeEmissiveScaledTile(pTask->filename, pTask->swatchLoc);
+    }
+    else {
+        pTask->rc = writeTileFromCategoryInput(pTask->filename, pTask->swatchLoc, pTask->category);
+    }
+}
+
 static int writeEmissiveScaledTile(wchar_t* filename, int index)
 {
     int rc = MW_NO_ERROR;
@@ -33675,8 +35169,8 @@ static int writeEmissiveScaledTile(wchar_t* filename, int index)
         }
     }
 
-    rc |= writepng(&dst, numChannels, filename);
-    addOutputFilenameToList(filename);
+    // on a worker thread already, so compress serially, and the caller lists the file
+    rc |= writepng(&dst, numChannels, filename, false);
 
     writepng_cleanup(&dst);
 
@@ -33752,8 +35246,8 @@ static int writeTileFromCategoryInput(wchar_t *filename, int index, int category
     }
 #endif
 
-    rc |= writepng(&dst, numChannels, filename);
-    addOutputFilenameToList(filename);
+    // on a worker thread already, so compress serially, and the caller lists the file
+    rc |= writepng(&dst, numChannels, filename, false);
 
     writepng_cleanup(&dst);
 
@@ -33868,7 +35362,7 @@ static int writeLines(HANDLE file, char** textLines, int lines)
     int i;
     for (i = 0; i < lines; i++)
     {
-        WERROR_SPECIFY(PortaWrite(file, textLines[i], strlen(textLines[i])), file);
+        WERROR_SPECIFY(OutWrite(file, textLines[i], strlen(textLines[i])), file);
     }
 
     return MW_NO_ERROR;
@@ -33903,7 +35397,7 @@ static float min3(Point pt)
         } \
     } \
     else { \
-        WERROR_FH(PortaWrite(fh, outputString, strlen(outputString))); \
+        WERROR_FH(OutWrite(fh, outputString, strlen(outputString))); \
     }
 
 static int writeStatistics(HANDLE fh, int (*printFunc)(char *), WorldGuide* pWorldGuide, IBox* worldBox, IBox* tightenedWorldBox, const wchar_t* curDir, const wchar_t* terrainFileName, const wchar_t* cullSchemeSelected, ChangeBlockCommand* pCBC)
@@ -34321,7 +35815,7 @@ static int writeStatistics(HANDLE fh, int (*printFunc)(char *), WorldGuide* pWor
 
     // now always on by default
     //sprintf_s(outputString,256,"# Merge flat blocks with neighbors: %s\n", gModel.options->pEFD->chkMergeFlattop ? "YES" : "no" );
-    //WERROR_FH(PortaWrite(fh, outputString, strlen(outputString) ));
+    //WERROR_FH(OutWrite(fh, outputString, strlen(outputString) ));
 
     if (gModel.options->pEFD->radioRotate0)
         angle = 0;
@@ -35855,8 +37349,8 @@ GenerateEmitter:
     }
 
 WriteEmitter:
-    rc |= writepng(&dst, numChannels, filename);
-    addOutputFilenameToList(filename);
+    // on a worker thread already, so compress serially, and the caller lists the file
+    rc |= writepng(&dst, numChannels, filename, false);
 
     writepng_cleanup(&dst);
 
@@ -36282,7 +37776,7 @@ static int analyzeChunk(WorldGuide* pWorldGuide, Options* pOptions, int bx, int
                 // ignore solid voxels, continue from the first "hollow" empty area
                 for (; adj_maxy >= miny; adj_maxy--) {
                     assert((chunkIndex >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
-                    int type = block->grid[chunkIndex];
+                    int type = block_type(block, chunkIndex);
 
                     // always ignore air; if we ignore transparent, then anything with alpha < 1.0 is ignored, else alpha == 0.0 only is ignored
                     if ((type == BLOCK_AIR) || (gBlockDefinitions[type].alpha == 0.0)) {
@@ -36293,7 +37787,7 @@ static int analyzeChunk(WorldGuide* pWorldGuide, Options* pOptions, int bx, int
             }
             for (y = adj_maxy; y >= miny; y--) {
                 assert((chunkIndex >> 8) <= block->maxFilledHeight);  // if block is reduced in size, make sure it's in bounds
-                int type = block->grid[chunkIndex];
+                int type = block_type(block, chunkIndex);
 
                 // always ignore air; if we ignore transparent, then anything with alpha < 1.0 is ignored, else alpha == 0.0 only is ignored
                 // TODO: we might also want to ignore tree leaves or other things with cutouts.
@@ -36349,13 +37843,9 @@ static int decimateMesh()
     gModel.simplifyFaceRecordPool->count = 0;
     gModel.simplifyFaceRecordPool->pNext = NULL;
     gModel.headSimplifyFaceRecordPool = gModel.simplifyFaceRecordPool;
-    // only needed for OBJ export; USD keeps its own UV coordinates per mesh
-    if ((gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_ABS_OBJ) || (gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_REL_OBJ)) {
-        gModel.simplifyUVGridList = (int*)malloc((SIMPLIFY_MAX_DIMENSION + 1) * (SIMPLIFY_MAX_DIMENSION + 1) * sizeof(int));
-        if (gModel.simplifyUVGridList == NULL) {
-            return MW_WORLD_EXPORT_TOO_LARGE;
-        }
-        memset(gModel.simplifyUVGridList, 0, (SIMPLIFY_MAX_DIMENSION + 1) * (SIMPLIFY_MAX_DIMENSION + 1) * sizeof(int));
+    int retCode = allocSimplifyUVGrid();
+    if (retCode != MW_NO_ERROR) {
+        return retCode;
     }
 
     int sameFaceCount = 0;
@@ -36452,22 +37942,9 @@ static int decimateMesh()
     return 0x0;
  }
 
-static bool faceCanTile(int faceId)
+// Can a face of this material, swatch and texture coordinates be merged with its neighbors into a larger face?
+static bool materialCanTile(short materialType, int swatchLoc, const short uvIndex[4])
 {
-    FaceRecord* pFace = gModel.faceList[faceId];
-
-    // Simple checks for if this is a useful face:
-    // Is the normal 0-5 ID? We check only on the 6 major axes. Rotated stuff is likely to be bad at aligning anyway
-    if (pFace->normalIndex < 0 || pFace->normalIndex >= 6) {
-        return false;
-    }
-
-    // check if last two vertices match - if so, it's a triangle, so can be ignored
-    if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
-    {
-        return false;
-    }
-
     int i;
 
     // Is the type forbidden, for whatever reason?
@@ -36476,7 +37953,7 @@ static bool faceCanTile(int faceId)
     // likely a few where, for example, the face should be flipped when vertical and so doesn't fit the norms here.
     // Note that this check doesn't really check the block type itself, rather the "type" here is actually just for the material family
     // or similar. For example, a beacon can have a glass material, beacon material, and obsidian base material.
-    switch (pFace->materialType) {
+    switch (materialType) {
     // Forbidden because they do have UV's that go 0-1 and aligned normals, but don't actually align by their coordinates
     case BLOCK_WHEAT:
     case BLOCK_NETHER_WART:
@@ -36649,7 +38126,7 @@ static bool faceCanTile(int faceId)
     // earlier rules above.
     // Faster to test here than have to inquire all four pairs of UV coordinates.
     // TODO: could make these tile property, TILE_DONT_SIMPLIFY
-    switch (gModel.uvIndexList[gModel.faceList[faceId]->uvIndex[0]].swatchLoc) {
+    switch (swatchLoc) {
     case 4 + 1 * 16:        //logs
     case 4 + 7 * 16:        //logs
     case 5 + 7 * 16:        //logs
@@ -36744,23 +38221,66 @@ static bool faceCanTile(int faceId)
     // are rectangular. So, we can test just the opposite corners, i += 2, to make sure they have UVs that are 0.0 or 1.0 (which is 0 or 16 in the normalized set here).
     for (i = 0; i < 4; i+=2) {
         // X texture coordinate, unscrambled, range 0-16 (divided by 16. These are the texel locations in the standard 16x16 grid)
-        int itc = (int)((((int)(gModel.uvIndexList[pFace->uvIndex[i]].uc * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale);
+        int itc = (int)((((int)(gModel.uvIndexList[uvIndex[i]].uc * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale);
         if (itc != 0 && itc != 16) {
             return false;
         }
         // Y texture coordinate
         // full, true unscramble - not needed: itc = ((((int)((1.0f - gModel.uvIndexList[pFace->uvIndex[j]].vc) * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale));
         //itc = (int)(16 - ((((int)((1.0f - gModel.uvIndexList[pFace->uvIndex[j]].vc) * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale));
-        itc = (int)((((int)((1.0f - gModel.uvIndexList[pFace->uvIndex[i]].vc) * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale);
+        itc = (int)((((int)((1.0f - gModel.uvIndexList[uvIndex[i]].vc) * (float)gModel.textureResolution) % gModel.swatchSize) - 1.0f) * gModel.resScale);
         if (itc != 0 && itc != 16) {
             return false;
         }
     }
+    return true;
+}
+
+// Make the grid of merged face texture coordinates, if not made yet by meshFaceBand().
+static int allocSimplifyUVGrid()
+{
+    // only needed for OBJ export; USD keeps its own UV coordinates per mesh
+    if ((gModel.simplifyUVGridList == NULL) &&
+        ((gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_ABS_OBJ) || (gModel.options->pEFD->fileType == FILE_TYPE_WAVEFRONT_REL_OBJ))) {
+        gModel.simplifyUVGridList = (int*)malloc((SIMPLIFY_MAX_DIMENSION + 1) * (SIMPLIFY_MAX_DIMENSION + 1) * sizeof(int));
+        if (gModel.simplifyUVGridList == NULL) {
+            return MW_WORLD_EXPORT_TOO_LARGE;
+        }
+        memset(gModel.simplifyUVGridList, 0, (SIMPLIFY_MAX_DIMENSION + 1) * (SIMPLIFY_MAX_DIMENSION + 1) * sizeof(int));
+    }
+    return MW_NO_ERROR;
+}
+
+static bool faceCanTile(int faceId)
+{
+    FaceRecord* pFace = gModel.faceList[faceId];
+
+    // Simple checks for if this is a useful face:
+    // Is the normal 0-5 ID? We check only on the 6 major axes. Rotated stuff is likely to be bad at aligning anyway
+    if (pFace->normalIndex < 0 || pFace->normalIndex >= 6) {
+        return false;
+    }
+
+    // check if last two vertices match - if so, it's a triangle, so can be ignored
+    if (pFace->vertexIndex[2] == pFace->vertexIndex[3])
+    {
+        return false;
+    }
+
+    // made by meshFaceBand() as a merged face already
+    if (pFace->uvIndex[2] < 0) {
+        return false;
+    }
+
+    if (!materialCanTile(pFace->materialType, gModel.uvIndexList[pFace->uvIndex[0]].swatchLoc, pFace->uvIndex)) {
+        return false;
+    }
 
 #ifdef _DEBUG
     // Final check, just for debug to make sure we didn't let anything through: are all coordinates (not in normal direction) non-fractional, 0-1'ish? Chests, I believe, get their texture squished to their dimension.
     // Things like wheat, nether wart, etc. do not go fully across the tile, OR may get randomized and so won't line up.
     Vector loc;
+    int i;
     for (i = 0; i < 4; i++) {
         Vec3Scalar(loc, =, gModel.vertices[pFace->vertexIndex[i]][X], gModel.vertices[pFace->vertexIndex[i]][Y], gModel.vertices[pFace->vertexIndex[i]][Z]);
         switch(pFace->normalIndex % 3) {
@@ -36824,7 +38344,7 @@ static void simplifyFaceSet(int faceCount, SimplifyFaceRecord **ppSFR)
         return;
     }
 
-    qsort_s(ppSFR, faceCount, sizeof(SimplifyFaceRecord*), simplifyFaceCompareYminor, NULL);
+    sortSimplifyFaces(ppSFR, faceCount, true);
     // Sort by normal direction sort key value, then by X, then by Y.
     // Walk through matching normals and matching X's and attach the neighboring Y's together in single-linked lists, ascending.
     // (That is: this record points at the next record if the next record's normal dir, normal distance, X match and Y is +1.)
@@ -36903,6 +38423,40 @@ static int simplifyFaceCompareXminor(void* context, const void* str1, const void
     //else return ((f1->normalDirection < f2->normalDirection) ? -1 : 1);
 }
 
+// Sort as qsort_s() with simplifyFaceCompareYminor() or simplifyFaceCompareXminor() would, by radix sort. If out of
+// memory, use qsort_s().
+static void sortSimplifyFaces(SimplifyFaceRecord** ppSFR, int faceCount, bool yMinor)
+{
+    unsigned long long* keys = (unsigned long long*)malloc(faceCount * sizeof(unsigned long long));
+    if (keys == NULL || !radixSortSimplifyFaces(ppSFR, keys, faceCount, yMinor)) {
+        qsort_s(ppSFR, faceCount, sizeof(SimplifyFaceRecord*), yMinor ? simplifyFaceCompareYminor : simplifyFaceCompareXminor, NULL);
+    }
+    free(keys);
+}
+
+// The radix sort for sortSimplifyFaces(), using keys for faceCount keys. Returns false if out of memory.
+static bool radixSortSimplifyFaces(SimplifyFaceRecord** ppSFR, unsigned long long* keys, int faceCount, bool yMinor)
+{
+    int i;
+    for (i = 0; i < faceCount; i++) {
+        SimplifyFaceRecord* pSFR = ppSFR[i];
+        keys[i] = yMinor ?
+            (((unsigned long long)RadixKeyFloat(pSFR->xll) << 32) | RadixKeyFloat(pSFR->yll)) :
+            (((unsigned long long)RadixKeyFloat(pSFR->yll) << 32) | RadixKeyFloat(pSFR->xll));
+    }
+    if (!RadixSortByKey((void**)ppSFR, keys, faceCount))
+        return false;
+    if (yMinor) {
+        // then by plane, for which the X minor sort is called on faces already sharing one
+        for (i = 0; i < faceCount; i++) {
+            SimplifyFaceRecord* pSFR = ppSFR[i];
+            keys[i] = ((unsigned long long)RadixKeyInt(pSFR->normalDirection) << 32) | RadixKeyFloat(pSFR->normalDistance);
+        }
+        return RadixSortByKey((void**)ppSFR, keys, faceCount);
+    }
+    return true;
+}
+
 static void mergeSimplifySet(SimplifyFaceRecord** ppSFR, int faceCount)
 {
     if (faceCount <= 1) {
@@ -36912,7 +38466,7 @@ static void mergeSimplifySet(SimplifyFaceRecord** ppSFR, int faceCount)
 
     // Now sort again: ..., but then by *Y*, then by X. Now the Y's are connected (by the previous sort) and the X's are adjacent.
     // Note we know that the normals and normal distances match, so don't sort by them.
-    qsort_s(ppSFR, faceCount, sizeof(SimplifyFaceRecord*), simplifyFaceCompareXminor, NULL);
+    sortSimplifyFaces(ppSFR, faceCount, false);
 
     // We have to then link up the X's, as we'll walk from record to record (this is also easier to think about!).
     SimplifyFaceRecord* pCurSFR = ppSFR[0];
@@ -37044,66 +38598,7 @@ static void mergeSimplifySet(SimplifyFaceRecord** ppSFR, int faceCount)
                 vertexIndex[2] = getVertexIDmatching(pUpperRightSFR->pFace, pUpperRightSFR->xll + 1.0f, pUpperRightSFR->yll);
                 vertexIndex[3] = getVertexIDmatching(pCornerSFR->pFace, pCornerSFR->xll, pCornerSFR->yll);   // MUST do this one first, since it uses the vertexIndex of the original face!
 
-                // The new UV indices are 0,0 to xlen,ylen.
-                // Negative indices means "negate and use this value-1 as an X & Y indexed location"
-                // Typical UV order is 0,0 / 1,0 / 1,1 / 1,0 (basically, V = 1 - Y above in order
-                short uvIndex[4];
-                uvIndex[0] = findUVinIndex(pCornerSFR->pFace,0.0f,0.0f); // is always 0,0
-                if (xlen == 1) {
-                    uvIndex[1] = findUVinIndex(pCornerSFR->pFace, 1.0f, 0.0f);
-                } else {
-                    uvIndex[1] = (short)(-1 - xlen);
-                }
-                // this one cannot be 1,1:
-                uvIndex[2] = (short)(-1 - ylen * (SIMPLIFY_MAX_DIMENSION+1) - xlen);
-                if (ylen == 1) {
-                    uvIndex[3] = findUVinIndex(pCornerSFR->pFace, 0.0f, 1.0f);
-                } 
-                else {
-                    uvIndex[3] = (short)(-1 - ylen * (SIMPLIFY_MAX_DIMENSION + 1));
-                }
-
-                // all set, so copy them over
-                // key thing: uvIndex[0] must be 0,0 and never be moved around! It's used for retrieving the swatchLoc.
-                // flips are used to get the vertex order right for culling properly
-                switch (pFace->normalIndex) {
-                case DIRECTION_BLOCK_TOP:
-                    break;
-                case DIRECTION_BLOCK_BOTTOM:
-                    {
-                        // flip direction texture goes
-                        flipIndicesLeftRight(vertexIndex);
-                        rotateIndices(vertexIndex, 180);
-                        // used to do this flip - now not needed
-                        //short tmp = uvIndex[1];
-                        //uvIndex[1] = uvIndex[3];
-                        //uvIndex[3] = tmp;
-                    }
-                    break;
-                case DIRECTION_BLOCK_SIDE_LO_X:
-                case DIRECTION_BLOCK_SIDE_HI_Z:
-                    rotateIndices(vertexIndex, 180);
-                    flipIndicesLeftRight(vertexIndex);
-                    break;
-                case DIRECTION_BLOCK_SIDE_HI_X:
-                case DIRECTION_BLOCK_SIDE_LO_Z:
-                    rotateIndices(vertexIndex, 180);
-                    break;
-                }
-                for (j = 0; j < 4; j++) {
-                    pFace->vertexIndex[j] = vertexIndex[j];
-                    pFace->uvIndex[j] = uvIndex[j];
-                }
-
-                // record the four UV coordinates in the giant grid as being used (for OBJ unified output only)
-                if (gModel.simplifyUVGridList != NULL) {
-                    //gModel.simplifyUVGridList[0]++; - not needed, 0,0 is always available already
-                    if (xlen > 1)
-                        gModel.simplifyUVGridList[xlen]++;
-                    gModel.simplifyUVGridList[ylen * (SIMPLIFY_MAX_DIMENSION + 1) + xlen]++;
-                    if (ylen > 1)
-                        gModel.simplifyUVGridList[ylen * (SIMPLIFY_MAX_DIMENSION + 1)]++;
-                }
+                setMergedFace(pFace, vertexIndex, xlen, ylen);
 
                 // not needed - we added it in place:
                 //gModel.faceList[gModel.faceCount++] = pFace;
@@ -37135,6 +38630,74 @@ static void mergeSimplifySet(SimplifyFaceRecord** ppSFR, int faceCount)
     // are used along the way.
 }
 
+// Turn pFace, the lower left corner of an xlen by ylen set of full faces, into the face covering them all.
+// vertexIndex is the corners, in plane X,Y order: lower left at Y+ylen, then X+xlen,Y+ylen, X+xlen,Y, and X,Y.
+static void setMergedFace(FaceRecord* pFace, int vertexIndex[4], int xlen, int ylen)
+{
+    int j;
+
+    // The new UV indices are 0,0 to xlen,ylen.
+    // Negative indices means "negate and use this value-1 as an X & Y indexed location"
+    // Typical UV order is 0,0 / 1,0 / 1,1 / 1,0 (basically, V = 1 - Y above in order
+    short uvIndex[4];
+    uvIndex[0] = findUVinIndex(pFace,0.0f,0.0f); // is always 0,0
+    if (xlen == 1) {
+        uvIndex[1] = findUVinIndex(pFace, 1.0f, 0.0f);
+    } else {
+        uvIndex[1] = (short)(-1 - xlen);
+    }
+    // this one cannot be 1,1:
+    uvIndex[2] = (short)(-1 - ylen * (SIMPLIFY_MAX_DIMENSION+1) - xlen);
+    if (ylen == 1) {
+        uvIndex[3] = findUVinIndex(pFace, 0.0f, 1.0f);
+    } 
+    else {
+        uvIndex[3] = (short)(-1 - ylen * (SIMPLIFY_MAX_DIMENSION + 1));
+    }
+
+    // all set, so copy them over
+    // key thing: uvIndex[0] must be 0,0 and never be moved around! It's used for retrieving the swatchLoc.
+    // flips are used to get the vertex order right for culling properly
+    switch (pFace->normalIndex) {
+    case DIRECTION_BLOCK_TOP:
+        break;
+    case DIRECTION_BLOCK_BOTTOM:
+        {
+            // flip direction texture goes
+            flipIndicesLeftRight(vertexIndex);
+            rotateIndices(vertexIndex, 180);
+            // used to do this flip - now not needed
+            //short tmp = uvIndex[1];
+            //uvIndex[1] = uvIndex[3];
+            //uvIndex[3] = tmp;
+        }
+        break;
+    case DIRECTION_BLOCK_SIDE_LO_X:
+    case DIRECTION_BLOCK_SIDE_HI_Z:
+        rotateIndices(vertexIndex, 180);
+        flipIndicesLeftRight(vertexIndex);
+        break;
+    case DIRECTION_BLOCK_SIDE_HI_X:
+    case DIRECTION_BLOCK_SIDE_LO_Z:
+        rotateIndices(vertexIndex, 180);
+        break;
+    }
+    for (j = 0; j < 4; j++) {
+        pFace->vertexIndex[j] = vertexIndex[j];
+        pFace->uvIndex[j] = uvIndex[j];
+    }
+
+    // record the four UV coordinates in the giant grid as being used (for OBJ unified output only)
+    if (gModel.simplifyUVGridList != NULL) {
+        //gModel.simplifyUVGridList[0]++; - not needed, 0,0 is always available already
+        if (xlen > 1)
+            gModel.simplifyUVGridList[xlen]++;
+        gModel.simplifyUVGridList[ylen * (SIMPLIFY_MAX_DIMENSION + 1) + xlen]++;
+        if (ylen > 1)
+            gModel.simplifyUVGridList[ylen * (SIMPLIFY_MAX_DIMENSION + 1)]++;
+    }
+}
+
 static short findUVinIndex(FaceRecord* pFace, float bx, float by)
 {
     int i;
@@ -2387,6 +2387,7 @@ class TZip
   ZRESULT Create(void *z,unsigned int len,DWORD flags);
   static unsigned sflush(void *param,const char *buf, unsigned *size);
   static unsigned swrite(void *param,const char *buf, unsigned size);
+  static unsigned scount(void *param,const char *buf, unsigned size);
   unsigned int write(const char *buf,unsigned int size);
   bool oseek(unsigned int pos);
   ZRESULT GetMemory(void **pbuf, unsigned long *plen);
@@ -2416,6 +2417,7 @@ class TZip
 
   ZRESULT ideflate(TZipFileInfo *zfi);
   ZRESULT istore();
+  ZRESULT isource(ZIPDEFLATESOURCE *psrc);
 
   ZRESULT Add(const char *odstzn, void *src,unsigned int len, DWORD flags);
   ZRESULT AddCentral();
@@ -2758,6 +2760,23 @@ ZRESULT TZip::ideflate(TZipFileInfo *zfi)
 	return zr;
 }
 
+// writes data compressed by the caller, counting it as compressed output
+unsigned TZip::scount(void *param,const char *buf, unsigned size)
+{ // static
+  TZip *zip = (TZip*)param;
+  unsigned int cout = zip->write(buf,size);
+  zip->csize += cout;
+  return cout;
+}
+
+ZRESULT TZip::isource(ZIPDEFLATESOURCE *psrc)
+{ csize=0;
+  unsigned long len=0;
+  if (!psrc->deflate(psrc->param, scount, this, &crc, &len)) return ZR_FLATE;
+  ired=len; // so iclose() can check it against the file's size
+  return ZR_OK;
+}
+
 ZRESULT TZip::istore()
 { ulg size=0;
   for (;;)
@@ -2793,7 +2812,7 @@ ZRESULT TZip::Add(const char *odstzn, void *src,unsigned int len, DWORD flags)
 	bool isdir = (flags==ZIP_FOLDER);
 	bool needs_trailing_slash = (isdir && dstzn[strlen(dstzn)-1]!='/');
 	int method=DEFLATE; 
-	if (isdir || HasZipSuffix(dstzn)) 
+	if (isdir || (HasZipSuffix(dstzn) && flags!=ZIP_DEFLATED)) 
 		method=STORE;
 
 	// now open whatever was our input source:
@@ -2806,6 +2825,8 @@ ZRESULT TZip::Add(const char *odstzn, void *src,unsigned int len, DWORD flags)
 		openres=open_mem(src,len);
 	else if (flags==ZIP_FOLDER) 
 		openres=open_dir();
+	else if (flags==ZIP_DEFLATED) 
+		openres=open_file(((ZIPDEFLATESOURCE*)src)->filename);
 	else return ZR_ARGS;
 	if (openres!=ZR_OK) 
 		return openres;
@@ -2887,7 +2908,9 @@ ZRESULT TZip::Add(const char *odstzn, void *src,unsigned int len, DWORD flags)
 
 	//(2) Write deflated/stored file to zip file
 	ZRESULT writeres=ZR_OK;
-	if (!isdir && method==DEFLATE) 
+	if (flags==ZIP_DEFLATED) 
+		writeres=isource((ZIPDEFLATESOURCE*)src);
+	else if (!isdir && method==DEFLATE) 
 		writeres=ideflate(&zfi);
 	else if (!isdir && method==STORE) 
 		writeres=istore();
@@ -3061,7 +3084,7 @@ ZRESULT ZipAdd(HZIP hz, const TCHAR *dstzn, void *src, unsigned int len, DWORD f
 	TZip *zip = han->zip;
 
 
-	if (flags == ZIP_FILENAME)
+	if (flags == ZIP_FILENAME || flags == ZIP_DEFLATED)
 	{
 		char szDest[MAX_PATH*2];
 		memset(szDest, 0, sizeof(szDest));
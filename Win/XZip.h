@@ -103,6 +103,19 @@ typedef DWORD ZRESULT;		// result codes from any of the zip functions. Listed la
 #define ZIP_FILENAME 2
 #define ZIP_MEMORY   3
 #define ZIP_FOLDER   4
+#define ZIP_DEFLATED 5
+
+// For ZIP_DEFLATED, the caller compresses the file itself, as raw deflate data (no zlib header
+// or trailer), and passes ZipAdd() one of these as src.
+typedef unsigned (*ZIPWRITEFUNC)(void *zip, const char *buf, unsigned size);
+typedef struct ZIPDEFLATESOURCE
+{
+	const TCHAR *filename;	// the file compressed, which gives the entry its attributes and times
+	// Write the compressed data with write(zip,...), and return the crc-32 and length of the
+	// uncompressed data. Return false on failure.
+	bool (*deflate)(void *param, ZIPWRITEFUNC write, void *zip, unsigned long *crc, unsigned long *len);
+	void *param;
+} ZIPDEFLATESOURCE;
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -172,6 +185,7 @@ ZRESULT ZipAdd(HZIP hz, const TCHAR *dstzn, void *src, unsigned int len, DWORD f
 // from a fname: ZipAdd(hz,"file.dat", "c:\\docs\\origfile.dat",0,ZIP_FILENAME);
 // from memory:  ZipAdd(hz,"subdir\\file.dat", buf,len,ZIP_MEMORY);
 // (folder):     ZipAdd(hz,"subdir",   0,0,ZIP_FOLDER);
+// precompressed: ZipAdd(hz,"file.dat", &zipDeflateSource,0,ZIP_DEFLATED);
 // Note: if adding an item from a pipe, and if also creating the zip file itself
 // to a pipe, then you might wish to pass a non-zero length to the ZipAdd
 // function. This will let the zipfile store the items size ahead of the
@@ -417,6 +417,7 @@ typedef struct Options {
     int exportFlags;		// exporting options
     bool moreExportMemory;   // use more memory for caching or not?
     int currentCacheSize;
+    int exportTileSize;     // if not 0, export large rendering OBJ files in tiles of about this many blocks on a side
     ExportFileData* pEFD;   // print or view option values, etc.
     ///// these are really statistics, but let's shove them in here - so sloppy!
     int dimensions[3];
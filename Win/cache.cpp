@@ -30,302 +30,661 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+
+/* A chunk cache: the table is split into shards, each with its own lock, so that several chunk loading
+** threads can add to it at once. Each shard has an open addressing index (linear probing) of its nodes,
+** and keeps its nodes in a true LRU list: a chunk that is looked up every frame stays in the cache.
+** Memory use is bounded by a budget in bytes, not by a number of entries, since chunks vary a lot in size.
+** The budget is for the cache as a whole, not per shard: when the total goes over, the least recently used
+** chunk of all the shards' tails is thrown out, so any shard may hold more than its share.
+*/
 
-/* a simple cache based on a hashtable with separate chaining */
-
-// these must be powers of two
-#ifndef MINEWAYS_X64
-#define HASH_XDIM 64
-#define HASH_ZDIM 64
+// must be a power of two
+#define CACHE_SHARDS 16
+// starting number of nodes per shard; the node array and index grow as needed
+#define CACHE_SHARD_START_NODES 64
+
+// Bytes per chunk when converting a number of chunks into a budget: the WorldBlock plus dense grid, data and
+// half-byte light arrays for 384 levels, so 6000 chunks is a budget of ~1.5GB. Each chunk is charged what it
+// actually holds, see blockBytes(), so compacted or shorter chunks cost less and more of them fit.
+#define CACHE_BYTES_PER_ENTRY (sizeof(WorldBlock) + 16 * 16 * 384 * 5 / 2)
+
+typedef struct CacheNode {
+    long long key;      // packed bx, bz
+    WorldBlock* data;   // may be NULL: we cache that a chunk is missing, too
+    size_t bytes;       // memory charged against the budget for this chunk
+    long long lastUse;  // gCacheClock when last added or found
+    int prev, next;     // LRU list, most recently used at the head; "next" also chains free nodes
+} CacheNode;
+
+typedef struct CacheShard {
+#ifdef WIN32
+    SRWLOCK lock;
+#endif
+    int* index;         // node index for each slot, -1 if empty
+    int indexSize;      // power of two, at least twice the number of nodes in use
+    CacheNode* nodes;
+    int nodeCapacity;
+    int numNodes;       // number of nodes in use
+    int freeList;       // unused nodes, linked by "next"
+    int head, tail;     // LRU list ends, -1 if empty
+    size_t bytes;       // total for all nodes in use
+} CacheShard;
+
+static CacheShard gCacheShards[CACHE_SHARDS];
+static bool gCacheInitialized = false;
+static size_t gCacheBudget = (size_t)INITIAL_CACHE_SIZE * CACHE_BYTES_PER_ENTRY;
+// total of the shards' bytes
+static volatile long long gCacheBytes = 0;
+// counts adds and finds, to compare when shards' chunks were last used
+static volatile long long gCacheClock = 0;
+
+static bool gMinimizeBlockSize = false; // if compacting fails, shrink the dense arrays instead
+
+#ifdef WIN32
+#define LOCK_SHARD(pShard)      AcquireSRWLockExclusive(&(pShard)->lock)
+#define UNLOCK_SHARD(pShard)    ReleaseSRWLockExclusive(&(pShard)->lock)
+#define ADD_CACHE_BYTES(delta)  InterlockedExchangeAdd64(&gCacheBytes, (delta))
+#define TICK_CACHE_CLOCK()      InterlockedIncrement64(&gCacheClock)
 #else
-#define HASH_XDIM 128
-#define HASH_ZDIM 128
+#define LOCK_SHARD(pShard)
+#define UNLOCK_SHARD(pShard)
+#define ADD_CACHE_BYTES(delta)  (gCacheBytes += (delta))
+#define TICK_CACHE_CLOCK()      (++gCacheClock)
 #endif
-#define HASH_SIZE (HASH_XDIM * HASH_ZDIM)
 
-// arbitrary, let users tune this?
-// 6000 entries translates to Mineways using ~300MB of RAM (on x64)
+static long long packKey(int bx, int bz)
+{
+    return ((long long)(unsigned int)bx << 32) | (long long)(unsigned int)bz;
+}
 
-static int gHashMaxEntries = INITIAL_CACHE_SIZE;   // was 6000, Sean said to increase it - really should be 30000, because export memory toggle now changes it to this
+// Fibonacci hashing: the top bits pick the shard, the bits below them the slot in the shard's index
+static unsigned long long hashKey(long long key)
+{
+    return (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+}
 
-typedef struct block_entry {
-    int x, z;
-    struct block_entry* next;
-    WorldBlock* data;
-} block_entry;
+static CacheShard* shardFor(long long key)
+{
+    return &gCacheShards[hashKey(key) >> 60 & (CACHE_SHARDS - 1)];
+}
 
-typedef struct {
-    int x, z;
-} IPoint2;
+static int homeSlot(CacheShard* pShard, long long key)
+{
+    return (int)(hashKey(key) >> 28) & (pShard->indexSize - 1);
+}
 
-static block_entry** gBlockCache = NULL;
+// memory a cache entry uses, as charged against the budget
+static size_t blockBytes(WorldBlock* block)
+{
+    size_t bytes = sizeof(CacheNode) + 2 * sizeof(int);
+    if (block != NULL) {
+        if (block->sections != NULL)
+            bytes += sizeof(WorldBlock) + block->sectionBytes;
+        else
+            bytes += sizeof(WorldBlock) + (size_t)((block->heightAlloc + 15) / 16) * 16 * 16 * 16 * 5 / 2;
+        if (block->sectionTypes != NULL)
+            bytes += block->summarySections * SECTION_TYPE_WORDS * sizeof(unsigned long long);
+        if (block->columnRuns != NULL)
+            bytes += (257 + (size_t)block->columnRuns[256]) * sizeof(unsigned int);
+        if (block->entities != NULL)
+            bytes += block->numEntities * sizeof(BlockEntity);
+    }
+    return bytes;
+}
 
-static IPoint2* gCacheHistory = NULL;
-static int gCacheN = 0;
-static bool gMinimizeBlockSize = false; // fast and memory hoggy
+static bool overBudget()
+{
+    return (size_t)gCacheBytes > gCacheBudget;
+}
 
-static int hash_coord(int x, int z) {
-    return (x & (HASH_XDIM - 1)) * (HASH_ZDIM)+(z & (HASH_ZDIM - 1));
+// change the bytes held by the shard, which is locked
+static void chargeShard(CacheShard* pShard, long long delta)
+{
+    pShard->bytes += (size_t)delta;
+    ADD_CACHE_BYTES(delta);
 }
 
-static block_entry* hash_new(int x, int z, void* data, block_entry* next) {
-    block_entry* ret = (block_entry*)malloc(sizeof(block_entry));
-    if (ret == NULL) {
-        return NULL;
+static void initCache()
+{
+    for (int i = 0; i < CACHE_SHARDS; i++) {
+        CacheShard* pShard = &gCacheShards[i];
+#ifdef WIN32
+        InitializeSRWLock(&pShard->lock);
+#endif
+        pShard->index = NULL;
+        pShard->indexSize = 0;
+        pShard->nodes = NULL;
+        pShard->nodeCapacity = 0;
+        pShard->numNodes = 0;
+        pShard->freeList = -1;
+        pShard->head = pShard->tail = -1;
+        pShard->bytes = 0;
     }
-    ret->x = x;
-    ret->z = z;
-    ret->data = (WorldBlock*)data;
-    ret->next = next;
-    return ret;
+    gCacheBytes = 0;
+    gCacheInitialized = true;
 }
 
-void Change_Cache_Size(int size)
+// returns the slot holding the key, or the empty slot where it would go
+static int findSlot(CacheShard* pShard, long long key)
 {
-    if (size == gHashMaxEntries)
-    {
-        // no change - why did you call?
-        return;
-    }
-    // mindless, slow, but safe: empty cache and just start again.
-    if (size < gHashMaxEntries) {
-        // weird, we're making it smaller, so kind of have to start from scratch
-        Cache_Empty();
+    int mask = pShard->indexSize - 1;
+    int slot = homeSlot(pShard, key);
+    while (pShard->index[slot] >= 0 && pShard->nodes[pShard->index[slot]].key != key) {
+        slot = (slot + 1) & mask;
     }
-    else {
-        // all's fine as is, the hash table of chunks stays as is, just need to make the gCacheHistory larger
-        // and reset the cache LRU counter
-        IPoint2* newHistory = (IPoint2*)realloc(gCacheHistory, sizeof(IPoint2) * size);
-        if (newHistory == NULL)
-            return;  // allocation failed, keep existing cache unchanged
-        gCacheHistory = newHistory;
-        // We now have more room for entries in the history table, so can allocate more chunks.
-        // To reflect this, set the gCacheN counter to the last free entry of the new history table.
-        // Then Cache_Add will add new chunks and put their locations in this history table, until full
-        // (at which point we'll cycle as usual to put new chunks into the hash table and free the old).
-        if (gCacheN > gHashMaxEntries) {
-            gCacheN = gHashMaxEntries;
+    return slot;
+}
+
+// remove the slot's entry from the index, shifting back any entries that probed past it
+static void removeSlot(CacheShard* pShard, int slot)
+{
+    int mask = pShard->indexSize - 1;
+    int hole = slot;
+    int next = slot;
+    pShard->index[hole] = -1;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (pShard->index[next] < 0)
+            return;
+        int home = homeSlot(pShard, pShard->nodes[pShard->index[next]].key);
+        // the entry can fill the hole if its home is not cyclically within (hole, next]
+        bool movable = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            pShard->index[hole] = pShard->index[next];
+            pShard->index[next] = -1;
+            hole = next;
         }
     }
-    gHashMaxEntries = size;
 }
 
-// "data" here is the WorldBlock
-void Cache_Add(int bx, int bz, void* data)
+static void unlinkNode(CacheShard* pShard, int n)
 {
-    int hash;
-    block_entry* to_del = NULL;
-
-    // Make a hash table gBlockCache that is 128*128 (16384) of entry pointers.
-    // Each entry pointer will point to entries holding chunks, in a linked list.
-    if (gBlockCache == NULL) {
-        gBlockCache = (block_entry**)calloc(HASH_SIZE, sizeof(block_entry*));
-        //memset(gBlockCache, 0, sizeof(block_entry*) * HASH_SIZE);
-        do {
-            // Make a history list of X,Z points of the size of the cache itself,
-            // with each new chunk put in the next available spot, modulo.
-            // This list is purely for knowing which entry to free next if the
-            // cache gets filled.
-            gCacheHistory = (IPoint2*)malloc(sizeof(IPoint2) * gHashMaxEntries);
-            if (gCacheHistory == NULL) {
-                // ruh roh, out of memory! We'll likely run out for reals later,
-                // but might as well try to recover now.
-                gHashMaxEntries /= 2;
-            }
-            // if we get to gHashMaxEntries then we're doomed
-        } while (gCacheHistory == NULL && gHashMaxEntries > 0);
-        // new list, so it's empty:
-        gCacheN = 0;
+    CacheNode* pNode = &pShard->nodes[n];
+    if (pNode->prev >= 0)
+        pShard->nodes[pNode->prev].next = pNode->next;
+    else
+        pShard->head = pNode->next;
+    if (pNode->next >= 0)
+        pShard->nodes[pNode->next].prev = pNode->prev;
+    else
+        pShard->tail = pNode->prev;
+}
+
+static void linkNodeAtHead(CacheShard* pShard, int n)
+{
+    CacheNode* pNode = &pShard->nodes[n];
+    pNode->prev = -1;
+    pNode->next = pShard->head;
+    if (pShard->head >= 0)
+        pShard->nodes[pShard->head].prev = n;
+    pShard->head = n;
+    if (pShard->tail < 0)
+        pShard->tail = n;
+}
+
+// throw out the least recently used chunk in the shard
+static void evictTail(CacheShard* pShard)
+{
+    int n = pShard->tail;
+    if (n < 0)
+        return;
+    CacheNode* pNode = &pShard->nodes[n];
+    removeSlot(pShard, findSlot(pShard, pNode->key));
+    unlinkNode(pShard, n);
+    block_free(pNode->data);
+    pNode->data = NULL;
+    chargeShard(pShard, -(long long)pNode->bytes);
+    pShard->numNodes--;
+    pNode->next = pShard->freeList;
+    pShard->freeList = n;
+}
+
+// rebuild the index at the new size, which must be a power of two
+static bool resizeIndex(CacheShard* pShard, int newSize)
+{
+    int* newIndex = (int*)malloc(newSize * sizeof(int));
+    if (newIndex == NULL)
+        return false;
+    free(pShard->index);
+    pShard->index = newIndex;
+    pShard->indexSize = newSize;
+    for (int i = 0; i < newSize; i++)
+        pShard->index[i] = -1;
+    for (int n = pShard->head; n >= 0; n = pShard->nodes[n].next) {
+        pShard->index[findSlot(pShard, pShard->nodes[n].key)] = n;
+    }
+    return true;
+}
+
+// make sure there's a free node and room in the index for one more entry
+static bool reserveNode(CacheShard* pShard)
+{
+    if (pShard->freeList < 0) {
+        int newCapacity = (pShard->nodeCapacity == 0) ? CACHE_SHARD_START_NODES : 2 * pShard->nodeCapacity;
+        CacheNode* newNodes = (CacheNode*)realloc(pShard->nodes, newCapacity * sizeof(CacheNode));
+        if (newNodes == NULL)
+            return false;
+        pShard->nodes = newNodes;
+        for (int n = newCapacity - 1; n >= pShard->nodeCapacity; n--) {
+            pShard->nodes[n].data = NULL;
+            pShard->nodes[n].next = pShard->freeList;
+            pShard->freeList = n;
+        }
+        pShard->nodeCapacity = newCapacity;
+    }
+    // keep the load factor at or below one half
+    if (2 * (pShard->numNodes + 1) > pShard->indexSize) {
+        if (!resizeIndex(pShard, (pShard->indexSize == 0) ? 2 * CACHE_SHARD_START_NODES : 2 * pShard->indexSize))
+            return false;
     }
+    return true;
+}
 
-    // So, now we have a gCacheHistory list for coordinates, and each of those
-    // coordinate's chunk data itself will go in gBlockCache, with the hash pointing
-    // to the proper spot, then in a linked list from that spot.
-
-    // find index into hash table, based on X and Z
-    hash = hash_coord(bx, bz);
-
-    // Is the list of chunks full at this point?
-    if (gCacheN >= gHashMaxEntries) {
-        // We need to remove an old entry.
-        // Find the coordinates of some old point in the cache.
-        // Note that gCacheN always increases, so as more cached
-        // entries are reused, the cache is cycled through, LRU.
-        IPoint2 coord = gCacheHistory[gCacheN % gHashMaxEntries];
-        int oldhash = hash_coord(coord.x, coord.z);
-
-        // Find the entry in gBlockCache
-        block_entry** cur = &gBlockCache[oldhash];
-        while (*cur != NULL) {
-            if ((**cur).x == coord.x && (**cur).z == coord.z) {
-                to_del = *cur;
-                *cur = to_del->next;
-                // save away the WorldBlock itself for reuse in "last_block"
-                block_free(to_del->data);
-                to_del->data = NULL;    // for safety's sake
-                //free(to_del); // we will re-use this entry below
-                break;
+// While the cache is over budget, throw out the least recently used chunk of all. Call with no shard locked.
+static void evictOverBudget()
+{
+    while (overBudget()) {
+        // find the shard whose tail is oldest
+        CacheShard* pOldest = NULL;
+        long long oldestUse = 0;
+        for (int i = 0; i < CACHE_SHARDS; i++) {
+            CacheShard* pShard = &gCacheShards[i];
+            LOCK_SHARD(pShard);
+            if (pShard->tail >= 0 && (pOldest == NULL || pShard->nodes[pShard->tail].lastUse < oldestUse)) {
+                pOldest = pShard;
+                oldestUse = pShard->nodes[pShard->tail].lastUse;
             }
-            cur = &((**cur).next);
+            UNLOCK_SHARD(pShard);
         }
+        if (pOldest == NULL)
+            return;
+        // another thread may have used or evicted that chunk since; its shard's tail is still a good choice
+        LOCK_SHARD(pOldest);
+        evictTail(pOldest);
+        UNLOCK_SHARD(pOldest);
     }
+}
+
+// Set the most memory the cache may hold as a number of typical chunks, see CACHE_BYTES_PER_ENTRY. Shrinking
+// throws out only the least recently used chunks needed to get under the new budget; the rest stay. Main thread only.
+void Change_Cache_Size(int size)
+{
+    gCacheBudget = (size_t)size * CACHE_BYTES_PER_ENTRY;
+    if (!gCacheInitialized)
+        return;
+    evictOverBudget();
+    // evicted chunks went back to their pools; give the memory back for real
+    block_pools_trim();
+}
+
+// about how many chunks the cache can hold at once
+int Cache_Capacity()
+{
+    return (int)min(gCacheBudget / CACHE_BYTES_PER_ENTRY, (size_t)INT_MAX);
+}
 
-    // if we removed to_del, the entry in the cache that *points* to the WorldBlock,
-    // from the cache itself, we can reuse it.
-    if (to_del != NULL) {
-        // re-use the old entry for the new one
-        to_del->next = gBlockCache[hash];
-        to_del->x = bx;
-        to_del->z = bz;
-        to_del->data = (WorldBlock*)data;
-        gBlockCache[hash] = to_del;
+// "data" here is the WorldBlock. If the chunk is already cached, its old block is replaced and freed.
+// Safe to call from any thread, once the main thread has called Cache_Find() or Cache_Add() (which set up the cache).
+void Cache_Add(int bx, int bz, void* data)
+{
+    if (!gCacheInitialized)
+        initCache();
+
+    long long key = packKey(bx, bz);
+    CacheShard* pShard = shardFor(key);
+    size_t bytes = blockBytes((WorldBlock*)data);
+
+    LOCK_SHARD(pShard);
+    int slot = (pShard->indexSize > 0) ? findSlot(pShard, key) : -1;
+    if (slot >= 0 && pShard->index[slot] >= 0) {
+        // replace the existing entry
+        int n = pShard->index[slot];
+        CacheNode* pNode = &pShard->nodes[n];
+        if (pNode->data != (WorldBlock*)data)
+            block_free(pNode->data);
+        pNode->data = (WorldBlock*)data;
+        chargeShard(pShard, (long long)bytes - (long long)pNode->bytes);
+        pNode->bytes = bytes;
+        pNode->lastUse = TICK_CACHE_CLOCK();
+        unlinkNode(pShard, n);
+        linkNodeAtHead(pShard, n);
+        UNLOCK_SHARD(pShard);
+        evictOverBudget();
+        return;
     }
-    else {
-        // Make a new entry, attach data to it, and put it in the cache
-        gBlockCache[hash] = hash_new(bx, bz, data, gBlockCache[hash]);
-        if (gBlockCache[hash] == NULL) {
-            // game over, out of memory
-            //assert(0);
-            return;
-        }
+
+    if (!reserveNode(pShard)) {
+        // game over, out of memory
+        UNLOCK_SHARD(pShard);
+        block_free((WorldBlock*)data);
+        return;
     }
 
-    // final thing: actually add the new chunk into the history table
-    gCacheHistory[gCacheN % gHashMaxEntries].x = bx;
-    gCacheHistory[gCacheN % gHashMaxEntries].z = bz;
-    // and note a new entry is used
-    gCacheN++;
+    int n = pShard->freeList;
+    CacheNode* pNode = &pShard->nodes[n];
+    pShard->freeList = pNode->next;
+    pNode->key = key;
+    pNode->data = (WorldBlock*)data;
+    pNode->bytes = bytes;
+    pNode->lastUse = TICK_CACHE_CLOCK();
+    pShard->index[findSlot(pShard, key)] = n;
+    linkNodeAtHead(pShard, n);
+    pShard->numNodes++;
+    chargeShard(pShard, (long long)bytes);
+    UNLOCK_SHARD(pShard);
+    // make room, oldest first; the new chunk is the most recent, so it stays
+    evictOverBudget();
 }
 
+// Marks the chunk as most recently used. The WorldBlock returned stays valid until some thread adds to
+// the cache, which might evict it.
 bool Cache_Find(int bx, int bz, void** data)
 {
-    block_entry* entry;
     // in case we assume the block will be found and are not checking the return code
     *data = NULL;
 
-    if (gBlockCache == NULL)
-        return false;
+    // set up here, too, as loaders look for a chunk before they start threads that add it
+    if (!gCacheInitialized)
+        initCache();
+
+    long long key = packKey(bx, bz);
+    CacheShard* pShard = shardFor(key);
+    bool found = false;
+
+    LOCK_SHARD(pShard);
+    if (pShard->indexSize > 0) {
+        int n = pShard->index[findSlot(pShard, key)];
+        if (n >= 0) {
+            *data = (void*)pShard->nodes[n].data;
+            pShard->nodes[n].lastUse = TICK_CACHE_CLOCK();
+            if (pShard->head != n) {
+                unlinkNode(pShard, n);
+                linkNodeAtHead(pShard, n);
+            }
+            found = true;
+        }
+    }
+    UNLOCK_SHARD(pShard);
 
-    // Find the head of the list for this hash and go through the block cache to find it.
-    for (entry = gBlockCache[hash_coord(bx, bz)]; entry != NULL; entry = entry->next) {
-        if (entry->x == bx && entry->z == bz) {
-            *data = (void*)entry->data;
-            return true;
+    return found;
+}
+
+// Charge the cached chunk again for what it holds now, after something was added to or freed from it outside of
+// Cache_Add(), such as its column runs. With evict set, chunks are then thrown out if the cache is over budget,
+// which could free a chunk another thread is drawing; without, that waits for the next Cache_Add() or Cache_Trim().
+void Cache_Recharge(int bx, int bz, bool evict)
+{
+    if (!gCacheInitialized)
+        return;
+
+    long long key = packKey(bx, bz);
+    CacheShard* pShard = shardFor(key);
+
+    LOCK_SHARD(pShard);
+    if (pShard->indexSize > 0) {
+        int n = pShard->index[findSlot(pShard, key)];
+        if (n >= 0) {
+            CacheNode* pNode = &pShard->nodes[n];
+            size_t bytes = blockBytes(pNode->data);
+            chargeShard(pShard, (long long)bytes - (long long)pNode->bytes);
+            pNode->bytes = bytes;
         }
     }
+    UNLOCK_SHARD(pShard);
 
-    return false;
+    if (evict)
+        evictOverBudget();
 }
 
-void Cache_Empty()
+// Throw out the least recently used chunks until the cache is within its budget. Not to be called while
+// other threads are using chunks from the cache.
+void Cache_Trim()
 {
-    int hash;
-    block_entry* entry, * next;
+    if (gCacheInitialized)
+        evictOverBudget();
+}
 
-    if (gBlockCache == NULL)
+// Free every cached chunk. Not to be called while other threads are using the cache.
+void Cache_Empty()
+{
+    if (!gCacheInitialized)
         return;
 
-    for (hash = 0; hash < HASH_SIZE; hash++) {
-        entry = gBlockCache[hash];
-        while (entry != NULL) {
-            next = entry->next;
+    for (int i = 0; i < CACHE_SHARDS; i++) {
+        CacheShard* pShard = &gCacheShards[i];
+        for (int n = pShard->head; n >= 0; n = pShard->nodes[n].next) {
             // so hacky
-            if (entry->data != NULL) {
-                block_force_free(entry->data);
-                entry->data = NULL;
+            if (pShard->nodes[n].data != NULL) {
+                block_free(pShard->nodes[n].data);
+                pShard->nodes[n].data = NULL;
             }
-            free(entry);
-            entry = next;
         }
+        free(pShard->index);
+        free(pShard->nodes);
     }
+    // start over from scratch on the next add
+    initCache();
+    // all chunks are gone, so give their memory back
+    block_pools_trim();
+}
+
+
+/* A slab allocator for chunks. The WorldBlock structs come from one pool; each chunk's grid, data and light
+** arrays are carved together out of a single slot from a pool sized by the chunk's number of 16-high
+** sections. A pool grows by whole slabs of slots, so scrolling the map, which frees and allocates chunks
+** of the same size over and over, is just free list pushes and pops with no heap churn or fragmentation.
+** Chunks taller than the largest pool fall back to malloc.
+*/
+
+// bytes of storage per 16-high section: grid, data, and half-byte light
+#define SECTION_STORAGE_BYTES (16 * 16 * 16 + 16 * 16 * 16 + 16 * 16 * 16 / 2)
+// worlds go up to 4064 high
+#define MAX_POOL_SECTIONS 254
+// at least this many bytes of slots are allocated when a pool grows
+#define SLAB_BYTES (1024 * 1024)
+// each slot starts with a pointer to its slab, padded to keep the rest aligned
+#define SLOT_HEADER_BYTES 16
+
+typedef struct ChunkSlab {
+    struct ChunkSlab* next;
+    int slotsInUse;
+} ChunkSlab;
+
+typedef struct ChunkPool {
+#ifdef WIN32
+    SRWLOCK lock;
+#endif
+    size_t slotBytes;   // including the header
+    int slotsPerSlab;
+    ChunkSlab* slabs;
+    void* freeList;     // free slots, each linked through its first pointer-sized bytes after the header
+    int slots;          // total slots in all slabs
+    int slotsInUse;
+} ChunkPool;
+
+// pool 0 is for the WorldBlock structs, pool N for the storage of N sections
+static ChunkPool gChunkPools[MAX_POOL_SECTIONS + 1];
+static bool gPoolsInitialized = false;
+
+#ifdef WIN32
+#define LOCK_POOL(pPool)      AcquireSRWLockExclusive(&(pPool)->lock)
+#define UNLOCK_POOL(pPool)    ReleaseSRWLockExclusive(&(pPool)->lock)
+#else
+#define LOCK_POOL(pPool)
+#define UNLOCK_POOL(pPool)
+#endif
 
-    free(gBlockCache);
-    free(gCacheHistory);
-    gBlockCache = NULL;
-    gCacheHistory = NULL;
+static void initPool(ChunkPool* pPool, size_t payloadBytes)
+{
+#ifdef WIN32
+    InitializeSRWLock(&pPool->lock);
+#endif
+    pPool->slotBytes = SLOT_HEADER_BYTES + ((payloadBytes + 15) & ~(size_t)15);
+    pPool->slotsPerSlab = (int)max((size_t)1, (SLAB_BYTES - sizeof(ChunkSlab)) / pPool->slotBytes);
+    pPool->slabs = NULL;
+    pPool->freeList = NULL;
+    pPool->slots = 0;
+    pPool->slotsInUse = 0;
 }
 
+// The first block_alloc() is always on the main thread, before any loading threads start.
+static void ensurePools()
+{
+    if (!gPoolsInitialized) {
+        initPool(&gChunkPools[0], sizeof(WorldBlock));
+        for (int sections = 1; sections <= MAX_POOL_SECTIONS; sections++) {
+            initPool(&gChunkPools[sections], (size_t)sections * SECTION_STORAGE_BYTES);
+        }
+        gPoolsInitialized = true;
+    }
+}
 
-/* a simple malloc wrapper, based on the observation that a common
-** behavior pattern for Mineways when the cache is at max capacity
-** is something like:
-**
-**   newBlock = malloc(sizeof(Block));
-**   cacheAdd(newBlock)
-**   free(oldBlock) // same size
-**
-** repeatedly. Recycling the old block can prevent the need for
-** malloc and free.
-**/
+#define SLOT_SLAB(slot)     (*(ChunkSlab**)(slot))
+#define SLOT_PAYLOAD(slot)  ((unsigned char*)(slot) + SLOT_HEADER_BYTES)
+#define PAYLOAD_SLOT(p)     ((unsigned char*)(p) - SLOT_HEADER_BYTES)
+#define SLOT_NEXT_FREE(slot) (*(void**)SLOT_PAYLOAD(slot))
 
-static WorldBlock* last_block = NULL;
+static unsigned char* poolAlloc(ChunkPool* pPool)
+{
+    LOCK_POOL(pPool);
+    if (pPool->freeList == NULL) {
+        // grow by a slab, with the slots laid out right after its header
+        size_t headerBytes = (sizeof(ChunkSlab) + 15) & ~(size_t)15;
+        ChunkSlab* pSlab = (ChunkSlab*)malloc(headerBytes + pPool->slotsPerSlab * pPool->slotBytes);
+        if (pSlab == NULL) {
+            UNLOCK_POOL(pPool);
+            return NULL;
+        }
+        pSlab->slotsInUse = 0;
+        pSlab->next = pPool->slabs;
+        pPool->slabs = pSlab;
+        unsigned char* slot = (unsigned char*)pSlab + headerBytes + (pPool->slotsPerSlab - 1) * pPool->slotBytes;
+        for (int i = 0; i < pPool->slotsPerSlab; i++, slot -= pPool->slotBytes) {
+            SLOT_SLAB(slot) = pSlab;
+            SLOT_NEXT_FREE(slot) = pPool->freeList;
+            pPool->freeList = slot;
+        }
+        pPool->slots += pPool->slotsPerSlab;
+    }
+    unsigned char* slot = (unsigned char*)pPool->freeList;
+    pPool->freeList = SLOT_NEXT_FREE(slot);
+    SLOT_SLAB(slot)->slotsInUse++;
+    pPool->slotsInUse++;
+    UNLOCK_POOL(pPool);
+    return SLOT_PAYLOAD(slot);
+}
 
-WorldBlock* block_alloc(int minHeight, int maxHeight)
+// Give the pool's completely unused slabs back to the heap. The pool must be locked.
+static void poolTrimLocked(ChunkPool* pPool)
 {
-    int height = maxHeight - minHeight + 1;
-    WorldBlock* ret = NULL;
-    // is a cached block available and is it the right size?
-    if (last_block != NULL && last_block->heightAlloc == height)
-    {
-        // use this cached block (clearing out just the optional entity storage first)
-        ret = last_block;
-        if (ret->entities != NULL) {
-            free(ret->entities);
-            ret->entities = NULL;
-            ret->numEntities = 0;
+    // drop the free slots of empty slabs from the free list, then the slabs themselves
+    void** pLink = &pPool->freeList;
+    while (*pLink != NULL) {
+        unsigned char* slot = (unsigned char*)*pLink;
+        if (SLOT_SLAB(slot)->slotsInUse == 0)
+            *pLink = SLOT_NEXT_FREE(slot);
+        else
+            pLink = &SLOT_NEXT_FREE(slot);
+    }
+    ChunkSlab** pSlabLink = &pPool->slabs;
+    while (*pSlabLink != NULL) {
+        ChunkSlab* pSlab = *pSlabLink;
+        if (pSlab->slotsInUse == 0) {
+            *pSlabLink = pSlab->next;
+            free(pSlab);
+            pPool->slots -= pPool->slotsPerSlab;
+        }
+        else {
+            pSlabLink = &pSlab->next;
         }
-        last_block = NULL;
-        return ret;
     }
-    else {
-        // new block needed
-		if (last_block != NULL) {
-			// saved block was wrong size - clear it out, since it's unlikely to be used
-			block_force_free(last_block);
-			last_block = NULL;
-		}
-		// allocate normally
-	    ret = (WorldBlock*)malloc(sizeof(WorldBlock));
-	    if (ret == NULL)
-	        return NULL;
-	    ret->grid = (unsigned char*)malloc(16 * 16 * height * sizeof(unsigned char));
-	    if (ret->grid == NULL)
-	        return NULL;
-	    ret->data = (unsigned char*)malloc(16 * 16 * height * sizeof(unsigned char));
-	    if (ret->data == NULL)
-	        return NULL;
-	    ret->light = (unsigned char*)malloc(16 * 16 * height * sizeof(unsigned char) / 2);
-	    if (ret->light == NULL)
-	        return NULL;
-	    ret->entities = NULL;
-	    ret->numEntities = 0;
-	    ret->heightAlloc = height;    // for some betas of 1.17 it is 384 - change by checking versionID
-        ret->minHeight = minHeight;
-        ret->maxHeight = maxHeight;
-	    ret->maxFilledSectionHeight = ret->maxFilledHeight = EMPTY_MAX_HEIGHT;  // not yet determined
-	    return ret;
-	}
-}
-
-// Given a WorldBlock that is no longer cached, save it away as "last_block" for immediate reuse if possible.
-// If there's already a last_block, get rid of that one and save this one instead (TODO: is there a better tie break?)
-void block_free(WorldBlock* block)
+}
+
+static void poolFree(ChunkPool* pPool, void* payload)
 {
-    // don't bother "caching" an empty WorldBlock - keep the old one in last_block for return some other time
-    if (block == NULL)
+    unsigned char* slot = PAYLOAD_SLOT(payload);
+    LOCK_POOL(pPool);
+    SLOT_NEXT_FREE(slot) = pPool->freeList;
+    pPool->freeList = slot;
+    pPool->slotsInUse--;
+    // When a slab empties, as chunks are evicted, and the pool has at least another slab's worth of slots to
+    // spare, the pool is more than it needs to be: give back its empty slabs. Keeping a slab's worth spare
+    // means a pool the map is scrolling through doesn't free and reallocate a slab over and over.
+    if (--SLOT_SLAB(slot)->slotsInUse == 0 && pPool->slots - pPool->slotsInUse >= 2 * pPool->slotsPerSlab)
+        poolTrimLocked(pPool);
+    UNLOCK_POOL(pPool);
+}
+
+static void poolTrim(ChunkPool* pPool)
+{
+    LOCK_POOL(pPool);
+    poolTrimLocked(pPool);
+    UNLOCK_POOL(pPool);
+}
+
+static int storageSections(int heightAlloc)
+{
+    return (heightAlloc + 15) / 16;
+}
+
+// point grid, data and light into the single storage allocation
+static void setStorage(WorldBlock* block, unsigned char* storage, int sections)
+{
+    block->grid = storage;
+    block->data = storage + sections * 16 * 16 * 16;
+    block->light = storage + 2 * sections * 16 * 16 * 16;
+}
+
+static unsigned char* storageAlloc(int sections)
+{
+    if (sections <= MAX_POOL_SECTIONS)
+        return poolAlloc(&gChunkPools[sections]);
+    return (unsigned char*)malloc((size_t)sections * SECTION_STORAGE_BYTES);
+}
+
+static void storageFree(unsigned char* storage, int sections)
+{
+    if (storage == NULL)
         return;
+    if (sections <= MAX_POOL_SECTIONS)
+        poolFree(&gChunkPools[sections], storage);
+    else
+        free(storage);
+}
 
-    // keep latest freed block available in "last_block", so free the one already there
-    if (last_block != NULL && last_block != block)
-    {
-        block_force_free(last_block);
-    }
+WorldBlock* block_alloc(int minHeight, int maxHeight)
+{
+    int height = maxHeight - minHeight + 1;
+    int sections = storageSections(height);
+    ensurePools();
 
-    last_block = block;
+    WorldBlock* ret = (WorldBlock*)poolAlloc(&gChunkPools[0]);
+    if (ret == NULL)
+        return NULL;
+    unsigned char* storage = storageAlloc(sections);
+    if (storage == NULL) {
+        poolFree(&gChunkPools[0], ret);
+        return NULL;
+    }
+    setStorage(ret, storage, sections);
+    ret->sections = NULL;
+    ret->sectionBytes = 0;
+    ret->sectionTypes = NULL;
+    ret->summarySections = 0;
+    ret->columnRuns = NULL;
+    ret->entities = NULL;
+    ret->numEntities = 0;
+    ret->heightAlloc = height;    // for some betas of 1.17 it is 384 - change by checking versionID
+    ret->minHeight = minHeight;
+    ret->maxHeight = maxHeight;
+    ret->maxFilledSectionHeight = ret->maxFilledHeight = EMPTY_MAX_HEIGHT;  // not yet determined
+    return ret;
 }
 
-// Really free the block, period
-void block_force_free(WorldBlock* block)
+// Given a WorldBlock that is no longer cached, return its memory to the pools.
+void block_free(WorldBlock* block)
 {
     if (block == NULL)
         return;
@@ -335,52 +694,263 @@ void block_force_free(WorldBlock* block)
         block->entities = NULL;
         block->numEntities = 0;
     }
-    if (block->grid != NULL) {
-        free(block->grid);
-        // should be unnecessary, but just in case there's a double free, somehow
-        block->grid = NULL;
+    if (block->sectionTypes != NULL) {
+        free(block->sectionTypes);
+        block->sectionTypes = NULL;
+    }
+    if (block->columnRuns != NULL) {
+        free(block->columnRuns);
+        block->columnRuns = NULL;
+    }
+    // should be unnecessary to clear the pointers, but just in case there's a double free, somehow
+    if (block->sections != NULL) {
+        free(block->sections);
+        block->sections = NULL;
+    }
+    else {
+        storageFree(block->grid, storageSections(block->heightAlloc));
+    }
+    block->grid = block->data = block->light = NULL;
+    poolFree(&gChunkPools[0], block);
+}
+
+// Release all slabs that have no chunks in use, e.g., after the cache is emptied. Not to be called while
+// other threads are allocating.
+void block_pools_trim()
+{
+    if (!gPoolsInitialized)
+        return;
+    for (int i = 0; i <= MAX_POOL_SECTIONS; i++) {
+        if (gChunkPools[i].slabs != NULL)
+            poolTrim(&gChunkPools[i]);
+    }
+}
+
+/* Compacting chunks: Minecraft chunks are mostly sections of air, or of a single block such as stone,
+** and the rest typically use only a handful of different blocks. So each 16-high section is stored as
+** absent, uniform, or as a palette of the type and data pairs used plus a bit-packed index per voxel,
+** as in the 1.16+ BlockStates, with light stored only if it varies. All is in one allocation.
+*/
+
+// open addressing table from type | data << 8 to palette index, at least twice the size of a section
+#define PALETTE_TABLE_SIZE 8192
+
+typedef struct PaletteTable {
+    unsigned int stamp[PALETTE_TABLE_SIZE];  // slot is in use if equal to generation
+    unsigned short key[PALETTE_TABLE_SIZE];
+    unsigned short index[PALETTE_TABLE_SIZE];
+    unsigned int generation;
+} PaletteTable;
+
+// what we learn about a section before storing it
+typedef struct SectionSummary {
+    int paletteSize;
+    unsigned short firstValue;
+    bool lightUniform;
+    unsigned char lightValue;
+    size_t payloadBytes;
+} SectionSummary;
+
+static int paletteLookup(PaletteTable* pTable, unsigned short value, unsigned short* palette, int& paletteSize)
+{
+    unsigned int slot = ((unsigned int)value * 0x9E3779B1u) >> 19;   // top 13 bits
+    while (pTable->stamp[slot] == pTable->generation) {
+        if (pTable->key[slot] == value)
+            return pTable->index[slot];
+        slot = (slot + 1) & (PALETTE_TABLE_SIZE - 1);
+    }
+    pTable->stamp[slot] = pTable->generation;
+    pTable->key[slot] = value;
+    pTable->index[slot] = (unsigned short)paletteSize;
+    if (palette != NULL)
+        palette[paletteSize] = value;
+    return paletteSize++;
+}
+
+static int paletteLog2Bits(int paletteSize)
+{
+    int log2Bits = 0;
+    while ((1 << (1 << log2Bits)) < paletteSize)
+        log2Bits++;
+    return log2Bits;
+}
+
+// voxel value in the dense arrays, with anything above heightAlloc being air
+static unsigned short denseValue(WorldBlock* block, int voxel, int numVoxels)
+{
+    return (voxel < numVoxels) ? (unsigned short)(block->grid[voxel] | (block->data[voxel] << 8)) : 0;
+}
+
+static unsigned char denseLightByte(WorldBlock* block, int index, int numVoxels)
+{
+    return (2 * index < numVoxels) ? block->light[index] : 0;
+}
+
+// Convert the chunk's dense grid, data and light arrays to sections, and free the arrays.
+// Returns false, leaving the chunk as it was, if out of memory. Safe to call from any thread.
+bool block_compact(WorldBlock* block)
+{
+    if (block == NULL || block->sections != NULL)
+        return true;
+
+    int numSections = storageSections(block->heightAlloc);
+    int numVoxels = 16 * 16 * block->heightAlloc;
+    PaletteTable* pTable = (PaletteTable*)malloc(sizeof(PaletteTable));
+    SectionSummary* summaries = (SectionSummary*)malloc(numSections * sizeof(SectionSummary));
+    if (pTable == NULL || summaries == NULL) {
+        free(pTable);
+        free(summaries);
+        return false;
+    }
+    memset(pTable->stamp, 0, sizeof(pTable->stamp));
+    pTable->generation = 0;
+
+    // first pass: how big is each section?
+    size_t totalBytes = numSections * sizeof(BlockSection);
+    for (int sec = 0; sec < numSections; sec++) {
+        SectionSummary* pSummary = &summaries[sec];
+        int base = sec * 4096;
+        pTable->generation++;
+        pSummary->paletteSize = 0;
+        pSummary->firstValue = denseValue(block, base, numVoxels);
+        for (int i = 0; i < 4096; i++) {
+            paletteLookup(pTable, denseValue(block, base + i, numVoxels), NULL, pSummary->paletteSize);
+        }
+
+        unsigned char lightByte = denseLightByte(block, base / 2, numVoxels);
+        pSummary->lightValue = lightByte & 0xf;
+        pSummary->lightUniform = ((lightByte >> 4) == (lightByte & 0xf));
+        for (int i = 1; i < 2048 && pSummary->lightUniform; i++) {
+            pSummary->lightUniform = (denseLightByte(block, base / 2 + i, numVoxels) == lightByte);
+        }
+
+        pSummary->payloadBytes = pSummary->lightUniform ? 0 : 2048;
+        if (pSummary->paletteSize > 1) {
+            // keep everything 8-byte aligned
+            pSummary->payloadBytes += ((pSummary->paletteSize * sizeof(unsigned short) + 7) & ~(size_t)7) +
+                (size_t)(4096 >> (6 - paletteLog2Bits(pSummary->paletteSize))) * sizeof(unsigned long long);
+        }
+        totalBytes += pSummary->payloadBytes;
+    }
+
+    unsigned char* blob = (unsigned char*)malloc(totalBytes);
+    if (blob == NULL) {
+        free(pTable);
+        free(summaries);
+        return false;
     }
-    if (block->data != NULL) {
-        free(block->data);
-        block->data = NULL;
+
+    // second pass: store each section
+    BlockSection* sections = (BlockSection*)blob;
+    unsigned char* payload = blob + numSections * sizeof(BlockSection);
+    for (int sec = 0; sec < numSections; sec++) {
+        SectionSummary* pSummary = &summaries[sec];
+        BlockSection* pSection = &sections[sec];
+        int base = sec * 4096;
+        memset(pSection, 0, sizeof(BlockSection));
+        pSection->lightValue = pSummary->lightValue;
+        if (!pSummary->lightUniform) {
+            pSection->light = payload;
+            for (int i = 0; i < 2048; i++) {
+                payload[i] = denseLightByte(block, base / 2 + i, numVoxels);
+            }
+            payload += 2048;
+        }
+        if (pSummary->paletteSize == 1) {
+            pSection->kind = (pSummary->firstValue == 0 && pSection->light == NULL) ? SECTION_ABSENT : SECTION_UNIFORM;
+            pSection->value = pSummary->firstValue;
+        }
+        else {
+            int log2Bits = paletteLog2Bits(pSummary->paletteSize);
+            int log2PerWord = 6 - log2Bits;
+            pSection->kind = SECTION_PALETTED;
+            pSection->log2Bits = (unsigned char)log2Bits;
+            pSection->paletteSize = (unsigned short)pSummary->paletteSize;
+            pSection->palette = (unsigned short*)payload;
+            payload += (pSummary->paletteSize * sizeof(unsigned short) + 7) & ~(size_t)7;
+            pSection->packed = (unsigned long long*)payload;
+            int numWords = 4096 >> log2PerWord;
+            payload += numWords * sizeof(unsigned long long);
+            memset(pSection->packed, 0, numWords * sizeof(unsigned long long));
+
+            pTable->generation++;
+            int paletteSize = 0;
+            for (int i = 0; i < 4096; i++) {
+                unsigned long long index = (unsigned long long)paletteLookup(pTable, denseValue(block, base + i, numVoxels), pSection->palette, paletteSize);
+                pSection->packed[i >> log2PerWord] |= index << ((i & ((1 << log2PerWord) - 1)) << log2Bits);
+            }
+            assert(paletteSize == pSummary->paletteSize);
+        }
     }
-    if (block->light != NULL) {
-        free(block->light);
-        block->light = NULL;
+    assert(payload == blob + totalBytes);
+
+    free(pTable);
+    free(summaries);
+
+    storageFree(block->grid, numSections);
+    block->grid = block->data = block->light = NULL;
+    block->sections = sections;
+    block->sectionBytes = totalBytes;
+    return true;
+}
+
+// Note which types, see section_type_key(), occur in each section up through maxFilledHeight, while the dense arrays
+// are still around. If out of memory, sectionTypes stays NULL and every section is treated as having every type.
+void block_summarize(WorldBlock* block)
+{
+    if (block == NULL || block->grid == NULL || block->sectionTypes != NULL || block->maxFilledHeight < 0)
+        return;
+
+    int numSections = storageSections(block->maxFilledHeight + 1);
+    unsigned long long* sectionTypes = (unsigned long long*)calloc(numSections * SECTION_TYPE_WORDS, sizeof(unsigned long long));
+    if (sectionTypes == NULL)
+        return;
+
+    for (int sec = 0; sec < numSections; sec++) {
+        unsigned long long* types = sectionTypes + sec * SECTION_TYPE_WORDS;
+        int base = sec * 4096;
+        for (int i = base; i < base + 4096; i++) {
+            int key = section_type_key(block->grid[i], block->data[i]);
+            types[key >> 6] |= 1ULL << (key & 0x3f);
+        }
     }
-    free(block);
+    block->sectionTypes = sectionTypes;
+    block->summarySections = numSections;
 }
 
-// reallocs only if memory minimization is on.
+// chunks that can't be compacted are shrunk only if memory minimization is on.
 void MinimizeCacheBlocks(bool min)
 {
     gMinimizeBlockSize = min;
 }
 
+// Called on every chunk as it is loaded, before it is cached.
 void block_realloc(WorldBlock* block)
 {
     if (block == NULL)
         return;
 
+    // store as sections, usually a small fraction of the size
+    if (block_compact(block))
+        return;
+
     if (gMinimizeBlockSize) {
-        if (block->heightAlloc > block->maxFilledHeight + 1) {
+        // out of memory for that, so at least move the chunk into the pool for the sections it actually fills; even an empty chunk keeps one
+        int sections = max(storageSections(block->maxFilledHeight + 1), 1);
+        int oldSections = storageSections(block->heightAlloc);
+        if (oldSections > sections) {
             // we can make it smaller
-            int heightAlloc = block->maxFilledHeight + 1;
-
-            unsigned char* grid = (unsigned char*)realloc(block->grid, 256 * heightAlloc);
-            if (grid == NULL)
+            unsigned char* storage = storageAlloc(sections);
+            if (storage == NULL)
                 return;  // allocation failed, keep existing block unchanged
-            block->grid = grid;
-
-            unsigned char* data = (unsigned char*)realloc(block->data, 256 * heightAlloc);
-            if (data == NULL)
-                return;
-            block->data = data;
 
-            unsigned char* light = (unsigned char*)realloc(block->light, 128 * heightAlloc);
-            if (light == NULL)
-                return;
-            block->light = light;
+            int heightAlloc = 16 * sections;
+            unsigned char* oldStorage = block->grid;
+            memcpy(storage, block->grid, 256 * heightAlloc);
+            memcpy(storage + 256 * heightAlloc, block->data, 256 * heightAlloc);
+            memcpy(storage + 2 * 256 * heightAlloc, block->light, 128 * heightAlloc);
+            setStorage(block, storage, sections);
+            storageFree(oldStorage, oldSections);
 
             block->heightAlloc = heightAlloc;
         }
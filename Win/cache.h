@@ -43,6 +43,26 @@ THE POSSIBILITY OF SUCH DAMAGE.
 // we track maximum height per chunk. Start at this value; if value found later, chunk is empty
 #define EMPTY_MAX_HEIGHT -1
 
+// Kinds of 16-high sections in a compacted chunk, see block_compact()
+#define SECTION_ABSENT      0   // all air, with the same light throughout; nothing stored
+#define SECTION_UNIFORM     1   // a single type and data value throughout
+#define SECTION_PALETTED    2   // a palette of type and data values, with 16x16x16 bit-packed indices into it
+
+// Words per section in WorldBlock::sectionTypes, a bit for each type | (data & 0x80) << 1, see section_type_key()
+#define SECTION_TYPE_WORDS  8
+
+typedef struct BlockSection {
+    unsigned char kind;
+    unsigned char log2Bits;     // paletted: bits per index are 1 << log2Bits, so 1, 2, 4, 8 or 16; indices don't straddle words
+    unsigned char lightValue;   // light level throughout, if light is NULL
+    unsigned char pad;
+    unsigned short value;       // uniform: type | data << 8
+    unsigned short paletteSize;
+    unsigned short* palette;    // paletted: type | data << 8 for each entry
+    unsigned long long* packed; // paletted: index of voxel y*256 + z*16 + x is at bit ((voxel % perWord) << log2Bits) of word voxel / perWord
+    unsigned char* light;       // 16x16x16/2 half-byte light levels, same layout as WorldBlock::light, or NULL
+} BlockSection;
+
 typedef struct WorldBlock {
     int minHeight;      // 0 for world < 1.17, -64 for some beta 1.17 and for 1.18
     int maxHeight;      // 255 for world < 1.17, 319 for some beta 1.17 and for 1.18
@@ -56,6 +76,21 @@ typedef struct WorldBlock {
     // unsigned char add[16*16*128];   // the Add tag - see http://www.minecraftwiki.net/wiki/Anvil_file_format
     unsigned char *data;  // byte additional data about each block, i.e., subtype such as log type, etc. -> [16 * 16 * 384]
     unsigned char *light; // half-byte lighting data -> [16 * 16 * 384/2]
+    // If the chunk was compacted by block_compact(), grid, data and light are NULL and the chunk is stored here instead,
+    // one per 16 levels of heightAlloc, in a single allocation of sectionBytes. Use block_type() and so on to read either form.
+    BlockSection* sections;
+    size_t sectionBytes;
+    // Which block types occur in each 16-high section, SECTION_TYPE_WORDS words per section, so that whole sections
+    // can be skipped by tests on type. Set by block_summarize() for the first summarySections sections; all above is air.
+    // NULL if not known.
+    unsigned long long* sectionTypes;
+    int summarySections;
+    // Runs of levels in each column that the map could show something of, top down, so that redrawing at another
+    // height can jump past the empty space. 257 offsets, one per column x + z*16 and one for the end, then
+    // top << 16 | bottom for each run. Built by draw() for the view filter and colormap noted; NULL if not built.
+    unsigned int* columnRuns;
+    int runsOpts;
+    unsigned short runsColormap;
 
     unsigned char rendercache[16 * 16 * 4]; // bitmap of last render
     short heightmap[16 * 16]; // height of rendered block [x+z*16]
@@ -77,24 +112,100 @@ typedef struct WorldBlock {
 } WorldBlock;
 
 void Change_Cache_Size(int size);
+int Cache_Capacity();
 bool Cache_Find(int bx, int bz, void** data);
 void Cache_Add(int bx, int bz, void* data);
+void Cache_Recharge(int bx, int bz, bool evict);
+void Cache_Trim();
 void Cache_Empty();
 void MinimizeCacheBlocks(bool min);
 
-/* a simple malloc wrapper, based on the observation that a common
-* behavior pattern for Mineways when the cache is at max capacity
-* is something like:
-*
-* newBlock = malloc(sizeof(Block));
-* cacheAdd(newBlock)
-*  free(oldBlock) // same size
-*
-* Repeated over and over. Recycling the most recently freed block
-* prevents expensive reallocations.
+/* Chunks are allocated from slab pools: one for the WorldBlock structs, and one per number of 16-high
+* sections for the grid, data and light arrays, which share a single allocation. Freed chunks go back to
+* their pool for reuse; a pool gives its empty slabs back to the heap once it has more than a slab's worth
+* of slots to spare, and block_pools_trim() gives back all unused slabs.
 */
 
 WorldBlock* block_alloc(int minHeight, int maxHeight);           // allocate memory for a block
 void block_free(WorldBlock* block); // release memory for a block
-void block_force_free(WorldBlock* block); // no single block cache test - clears the cache, too
-void block_realloc(WorldBlock* block);   // realloc and copy over
+void block_realloc(WorldBlock* block);   // compact; failing that, move to a smaller pool if minimizing memory
+bool block_compact(WorldBlock* block);   // convert to sections, freeing the dense arrays
+void block_summarize(WorldBlock* block);    // note which types are in each section, once the dense arrays are filled
+void block_pools_trim();    // free all slabs with nothing in use
+
+// Accessors for a voxel of either dense or compacted chunks, voxel being y*256 + z*16 + x
+inline unsigned short section_type_data(const BlockSection* pSection, int voxel)
+{
+    switch (pSection->kind) {
+    case SECTION_PALETTED:
+    {
+        int i = voxel & 0xfff;
+        int log2Bits = pSection->log2Bits;
+        int log2PerWord = 6 - log2Bits;
+        unsigned long long word = pSection->packed[i >> log2PerWord];
+        int index = (int)(word >> ((i & ((1 << log2PerWord) - 1)) << log2Bits)) & ((1 << (1 << log2Bits)) - 1);
+        return pSection->palette[index];
+    }
+    case SECTION_UNIFORM:
+        return pSection->value;
+    default:
+        return 0;
+    }
+}
+
+// type | data << 8
+inline unsigned short block_type_data(const WorldBlock* block, int voxel)
+{
+    if (block->grid != NULL)
+        return (unsigned short)(block->grid[voxel] | (block->data[voxel] << 8));
+    return section_type_data(&block->sections[voxel >> 12], voxel);
+}
+
+inline unsigned char block_type(const WorldBlock* block, int voxel)
+{
+    if (block->grid != NULL)
+        return block->grid[voxel];
+    return (unsigned char)section_type_data(&block->sections[voxel >> 12], voxel);
+}
+
+inline unsigned char block_data(const WorldBlock* block, int voxel)
+{
+    if (block->grid != NULL)
+        return block->data[voxel];
+    return (unsigned char)(section_type_data(&block->sections[voxel >> 12], voxel) >> 8);
+}
+
+// Types are summarized with the high bit of the data value, which for 1.13 and on usually means type + 256
+inline int section_type_key(int type, int dataVal)
+{
+    return type | ((dataVal & 0x80) << 1);
+}
+
+// Could the section hold any of the types in the mask, a bit for each section_type_key()?
+inline bool section_has_types(const WorldBlock* block, int section, const unsigned long long* typeMask)
+{
+    if (block->sectionTypes == NULL)
+        return true;
+    if (section >= block->summarySections)
+        return (typeMask[0] & 1) != 0;
+    const unsigned long long* types = block->sectionTypes + section * SECTION_TYPE_WORDS;
+    for (int i = 0; i < SECTION_TYPE_WORDS; i++) {
+        if (types[i] & typeMask[i])
+            return true;
+    }
+    return false;
+}
+
+// light level, 0-15
+inline int block_light(const WorldBlock* block, int voxel)
+{
+    const unsigned char* light = block->light;
+    if (light == NULL) {
+        const BlockSection* pSection = &block->sections[voxel >> 12];
+        if (pSection->light == NULL)
+            return pSection->lightValue;
+        light = pSection->light;
+        voxel &= 0xfff;
+    }
+    return (light[voxel >> 1] >> ((voxel & 1) << 2)) & 0xf;
+}
@@ -29,6 +29,8 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "stdafx.h"
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#include "unpack.h"
 
 // We know we won't run into names longer than 100 characters. The old code was
 // safe, but was also allocating strings all the time - seems slow.
@@ -42,8 +44,21 @@ static int skipList(bfFile* pbf);
 static int skipCompound(bfFile* pbf);
 
 static int readBiomePalette(bfFile* pbf, unsigned char* paletteBiomeEntry, int& entryIndex);
-static int readPalette(int& returnCode, bfFile* pbf, int mcVersion, unsigned char* paletteBlockEntry, unsigned char* paletteDataEntry, int& entryIndex, char* unknownBlock, int unknownBlockID);
+// Remembers, for the length of one chunk load, which BlockTranslations entry the name at each palette position
+// resolved to. Neighboring sections often list the same names in the same order, so a repeated entry then costs
+// a single strcmp against that entry's name, with no hashing.
+#define NAME_MEMO_SIZE 32
+typedef struct NameMemo {
+    short index[NAME_MEMO_SIZE];    // -1 if nothing is remembered for this position
+} NameMemo;
+
+static void initNameMemo(NameMemo* pMemo);
+static int memoFindIndexFromName(NameMemo* pMemo, int position, char* name);
+static int readPalette(int& returnCode, bfFile* pbf, int mcVersion, unsigned char* paletteBlockEntry, unsigned char* paletteDataEntry, int& entryIndex, char* unknownBlock, int unknownBlockID, NameMemo* pMemo);
 static int readBlockData(bfFile* pbf, int& bigbufflen, unsigned char* bigbuff);
+#ifdef _DEBUG
+static void recordPaletteName(int position, const char* name);
+#endif
 
 typedef struct BlockTranslator {
     int hashSum;
@@ -1641,11 +1656,19 @@ BlockTranslator BlockTranslations[NUM_TRANS] = {
  // Note: 140, 144 are reserved for the extra bit needed for BLOCK_FLOWER_POT and BLOCK_HEAD, so don't use these HIGH_BIT values
 };
 
-#define HASH_SIZE 1024
-#define HASH_MASK 0x3ff
+// Block names are found with a minimal perfect hash, built once in makeHashTable(): the name's hash picks a
+// bucket, and the bucket's displacement scrambles the hash into a slot holding exactly one BlockTranslations
+// index. So a lookup is one hash and one strcmp, where the old character-sum hash put anagrams such as
+// oak_log/log_oak, and many *_stairs, in the same chain.
+#define NAME_BUCKETS 512
+#define NAME_BUCKET_MASK (NAME_BUCKETS - 1)
+// highest displacement tried before giving up on a seed; real tables need a few thousand at most
+#define MAX_NAME_DISPLACEMENT 0x10000
 
-int HashLists[HASH_SIZE + NUM_TRANS];
-int* HashArray[HASH_SIZE];
+static unsigned int gNameSeed = 0x811C9DC5;     // FNV offset basis, changed only if a table can't be built
+static unsigned short NameDisplacement[NAME_BUCKETS];
+static short NameSlots[NUM_TRANS];
+static int gNameSlotCount = 0;                  // number of unique names
 
 #define BIOME_HASH_SIZE 256
 #define BIOME_HASH_MASK 0x0ff
@@ -1663,40 +1686,125 @@ int computeHash(const char* name)
     return hashVal;
 }
 
-void makeHashTable()
+// FNV-1a
+static unsigned int nameHash(const char* name)
 {
-    // go through entries and convert to hashes, note how many hashes per array spot
-    int hashPerIndex[HASH_SIZE];
-    memset(hashPerIndex, 0, 4 * HASH_SIZE);
-    int hashStart[HASH_SIZE];
-    int i;
-    // If we really wanted to super-optimize, we could take the "air" entry out of the hash table,
-    // since we special-case that in findIndexFromName. Let's not...
-    // BTW, the hash table built has a maximum of 5 entries in the hashPerIndex table generated, from
-    // watching it (code's not here, not needed normally). This isn't too bad, I think.
+    unsigned int hashVal = gNameSeed;
+    while (*name) {
+        hashVal ^= (unsigned char)*name++;
+        hashVal *= 0x01000193;
+    }
+    return hashVal;
+}
+
+// scramble the name's hash by its bucket's displacement into a slot
+static int nameSlot(unsigned int hashVal, unsigned int displacement)
+{
+    unsigned int h = hashVal ^ (displacement * 0x9E3779B9);
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35;
+    h ^= h >> 16;
+    return (int)(h % (unsigned int)gNameSlotCount);
+}
+
+// Try to build the perfect hash with the current seed. Returns false if the seed won't work:
+// two different names with the same full hash, or a bucket that can't be placed.
+static bool buildNameTable()
+{
+    static short unique[NUM_TRANS];
+    static short bucketMembers[NUM_TRANS];
+    static int slots[NUM_TRANS];
+    int bucketCount[NAME_BUCKETS];
+    int bucketStart[NAME_BUCKETS + 1];
+    int bucketFill[NAME_BUCKETS];
+    short bucketOrder[NAME_BUCKETS];
+    int i, j, k;
+
     for (i = 0; i < NUM_TRANS; i++) {
-        BlockTranslations[i].hashSum = computeHash(BlockTranslations[i].name);
-        hashPerIndex[BlockTranslations[i].hashSum & HASH_MASK]++;
+        BlockTranslations[i].hashSum = (int)nameHash(BlockTranslations[i].name);
     }
-    // OK, have how many per index, so offset appropriately
-    int offset = 0;
-    for (i = 0; i < HASH_SIZE; i++) {
-        hashStart[i] = offset;
-        HashArray[i] = &HashLists[offset];
-        offset += hashPerIndex[i] + 1;
+
+    // unique names only; a duplicated name always resolves to its first entry, as before
+    int numUnique = 0;
+    for (i = 0; i < NUM_TRANS; i++) {
+        bool duplicate = false;
+        for (j = 0; j < numUnique; j++) {
+            if (BlockTranslations[unique[j]].hashSum == BlockTranslations[i].hashSum) {
+                if (strcmp(BlockTranslations[unique[j]].name, BlockTranslations[i].name) != 0)
+                    return false;
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate)
+            unique[numUnique++] = (short)i;
     }
-    if (offset != HASH_SIZE + NUM_TRANS) {
-        // this is an error
-        assert(0);
-        return;
+    gNameSlotCount = numUnique;
+
+    // sort names into buckets
+    memset(bucketCount, 0, sizeof(bucketCount));
+    for (i = 0; i < numUnique; i++) {
+        bucketCount[BlockTranslations[unique[i]].hashSum & NAME_BUCKET_MASK]++;
     }
-    // now populate the hashLists, ending with -1; first just set all to -1
-    for (i = 0; i < HASH_SIZE + NUM_TRANS; i++) {
-        HashLists[i] = -1;
+    bucketStart[0] = 0;
+    for (i = 0; i < NAME_BUCKETS; i++) {
+        bucketStart[i + 1] = bucketStart[i] + bucketCount[i];
+        bucketFill[i] = bucketStart[i];
     }
-    for (i = 0; i < NUM_TRANS; i++) {
-        int index = BlockTranslations[i].hashSum & HASH_MASK;
-        HashLists[hashStart[index]++] = i;
+    for (i = 0; i < numUnique; i++) {
+        bucketMembers[bucketFill[BlockTranslations[unique[i]].hashSum & NAME_BUCKET_MASK]++] = unique[i];
+    }
+
+    // place the biggest buckets first, while there's the most room; insertion sort is fine for this size
+    for (i = 0; i < NAME_BUCKETS; i++) {
+        short bucket = (short)i;
+        for (j = i; j > 0 && bucketCount[bucketOrder[j - 1]] < bucketCount[bucket]; j--)
+            bucketOrder[j] = bucketOrder[j - 1];
+        bucketOrder[j] = bucket;
+    }
+
+    for (i = 0; i < numUnique; i++) {
+        NameSlots[i] = -1;
+    }
+    for (i = 0; i < NAME_BUCKETS; i++) {
+        int bucket = bucketOrder[i];
+        NameDisplacement[bucket] = 0;
+        if (bucketCount[bucket] == 0)
+            continue;
+        // find a displacement that puts all the bucket's names in empty, different slots
+        unsigned int displacement;
+        for (displacement = 0; displacement < MAX_NAME_DISPLACEMENT; displacement++) {
+            for (k = 0; k < bucketCount[bucket]; k++) {
+                int slot = nameSlot(BlockTranslations[bucketMembers[bucketStart[bucket] + k]].hashSum, displacement);
+                if (NameSlots[slot] >= 0)
+                    break;
+                for (j = 0; j < k && slots[j] != slot; j++)
+                    ;
+                if (j < k)
+                    break;
+                slots[k] = slot;
+            }
+            if (k == bucketCount[bucket])
+                break;
+        }
+        if (displacement == MAX_NAME_DISPLACEMENT)
+            return false;
+        NameDisplacement[bucket] = (unsigned short)displacement;
+        for (k = 0; k < bucketCount[bucket]; k++) {
+            NameSlots[slots[k]] = bucketMembers[bucketStart[bucket] + k];
+        }
+    }
+    return true;
+}
+
+void makeHashTable()
+{
+    int i;
+    // build the name lookup table; a different seed has never been needed, but just in case
+    while (!buildNameTable()) {
+        gNameSeed = gNameSeed * 0x01000193 + 1;
     }
     // Done once to initialize gBlockDefinitions[i].subtype_mask values properly.
     // These values determine if a bit determines if an object is a separate type of
@@ -1871,18 +1979,12 @@ int findIndexFromName(char* name)
     //	name[0] = name[0];
     //}
 #endif
-    int hashNum = computeHash(name);
-    int* hl = HashArray[hashNum & HASH_MASK];
+    unsigned int hashNum = nameHash(name);
+    int index = NameSlots[nameSlot(hashNum, NameDisplacement[hashNum & NAME_BUCKET_MASK])];
 
-    // now compare entries one by one in hash table list until a match is found
-    while (*hl > -1) {
-        if (hashNum == BlockTranslations[*hl].hashSum) {
-            // OK, do full string compare
-            if (strcmp(name, BlockTranslations[*hl].name) == 0) {
-                return *hl;
-            }
-        }
-        hl++;
+    // every name lands on some entry, so check that it's really this one
+    if ((int)hashNum == BlockTranslations[index].hashSum && strcmp(name, BlockTranslations[index].name) == 0) {
+        return index;
     }
     // fail!
     return -1;
@@ -1899,6 +2001,92 @@ int SlowFindIndexFromName(char* name)
     return -1;
 }
 
+static void initNameMemo(NameMemo* pMemo)
+{
+    for (int i = 0; i < NAME_MEMO_SIZE; i++) {
+        pMemo->index[i] = -1;
+    }
+}
+
+// findIndexFromName(), checking first if this palette position had the same name last time
+static int memoFindIndexFromName(NameMemo* pMemo, int position, char* name)
+{
+    if (pMemo == NULL || position >= NAME_MEMO_SIZE)
+        return findIndexFromName(name);
+    // the prefix test also fails for names too short to have anything past "minecraft:"
+    int index = pMemo->index[position];
+    if (index >= 0 && memcmp(name, "minecraft:", 10) == 0 && strcmp(name + 10, BlockTranslations[index].name) == 0)
+        return index;
+
+    index = findIndexFromName(name);
+    if (index > -1) {
+        pMemo->index[position] = (short)index;
+    }
+    return index;
+}
+
+#ifdef _DEBUG
+// Debug builds keep the first palette names read from whatever world is opened, with their palette positions,
+// then replay them to time findIndexFromName(), the palette memo, and a linear search. Results go to the debugger output.
+#define BENCHMARK_PALETTE_NAMES 32768
+static char gBenchmarkNames[BENCHMARK_PALETTE_NAMES][MAX_NAME_LENGTH];
+static int gBenchmarkPositions[BENCHMARK_PALETTE_NAMES];
+static volatile LONG gBenchmarkNext = 0;    // next slot to claim
+static volatile LONG gBenchmarkFilled = 0;  // slots written
+
+static void benchmarkNameLookup()
+{
+    const int repeats = 20;
+    int i, r;
+    int checksum = 0;
+    clock_t start = clock();
+    for (r = 0; r < repeats; r++) {
+        for (i = 0; i < BENCHMARK_PALETTE_NAMES; i++) {
+            checksum += findIndexFromName(gBenchmarkNames[i]);
+        }
+    }
+    clock_t hashTime = clock() - start;
+
+    // names from several loading threads may interleave, but each keeps its position, which is what the memo is keyed on
+    NameMemo memo;
+    initNameMemo(&memo);
+    start = clock();
+    for (r = 0; r < repeats; r++) {
+        for (i = 0; i < BENCHMARK_PALETTE_NAMES; i++) {
+            checksum += memoFindIndexFromName(&memo, gBenchmarkPositions[i], gBenchmarkNames[i]);
+        }
+    }
+    clock_t memoTime = clock() - start;
+
+    start = clock();
+    for (i = 0; i < BENCHMARK_PALETTE_NAMES; i++) {
+        // one pass is plenty; skip "minecraft:", as findIndexFromName does
+        checksum += (strlen(gBenchmarkNames[i]) > 10) ? SlowFindIndexFromName(gBenchmarkNames[i] + 10) : -1;
+    }
+    clock_t slowTime = (clock() - start) * repeats;
+
+    char outputString[256];
+    sprintf_s(outputString, 256, "Palette name lookup, %d names x %d: perfect hash %ld ms, with memo %ld ms, linear search %ld ms (checksum %d)\n",
+        BENCHMARK_PALETTE_NAMES, repeats, (long)(hashTime * 1000 / CLOCKS_PER_SEC), (long)(memoTime * 1000 / CLOCKS_PER_SEC),
+        (long)(slowTime * 1000 / CLOCKS_PER_SEC), checksum);
+    OutputDebugStringA(outputString);
+}
+
+// Called by the loading threads for every palette name; whichever thread writes the last slot runs the benchmark, once.
+static void recordPaletteName(int position, const char* name)
+{
+    if (gBenchmarkNext >= BENCHMARK_PALETTE_NAMES)
+        return;
+    LONG slot = InterlockedIncrement(&gBenchmarkNext) - 1;
+    if (slot >= BENCHMARK_PALETTE_NAMES)
+        return;
+    strcpy_s(gBenchmarkNames[slot], MAX_NAME_LENGTH, name);
+    gBenchmarkPositions[slot] = position;
+    if (InterlockedIncrement(&gBenchmarkFilled) == BENCHMARK_PALETTE_NAMES)
+        benchmarkNameLookup();
+}
+#endif
+
 // should be called any time the mod translation pointer changes
 void SetModTranslations(TranslationTuple* mt)
 {
@@ -1984,6 +2172,22 @@ void makeBiomeHashTable()
     }
 }
 
+// Build the block and biome name lookup tables, if not built yet. nbtGetBlocks() does this lazily
+// on first use, which is fine for one thread; call this before decoding chunks on several threads.
+void nbtPrepareTables()
+{
+    if (makeHash) {
+        makeHashTable();
+        makeHash = false;
+    }
+    if (makeBiomeHash) {
+        makeBiomeHashTable();
+        makeBiomeHash = false;
+    }
+    // also picks the unpacking code and builds its tables
+    GetUnpackLevel();
+}
+
 int findIndexFromBiomeName(char* name)
 {
     // to break on a specific named biome
@@ -2306,6 +2510,8 @@ int nbtGetBlocks(bfFile* pbf, unsigned char* buff, unsigned char* data, unsigned
     int returnCode = NBT_VALID_BLOCK;	// means "fine"
     int sectionHeight;
     int formatClass = FORMAT_UP_THROUGH_1_12;
+    NameMemo nameMemo;
+    initNameMemo(&nameMemo);
     //int found;
 
     //int minHeight = ZERO_WORLD_HEIGHT(versionID, mcVersion);
@@ -2754,7 +2960,7 @@ SectionsCode:
                 {
                     ret = 1;
                     
-                    int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, unknownBlock, unknownBlockID);
+                    int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, unknownBlock, unknownBlockID, &nameMemo);
                     // did we hit an error?
                     if (retVal != 0) {
                         // don't worry, the value is a line error
@@ -2784,7 +2990,7 @@ SectionsCode:
                         if (strcmp(thisName, "palette") == 0)
                         {
                             subret = 1;
-                            int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, unknownBlock, unknownBlockID);
+                            int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, unknownBlock, unknownBlockID, &nameMemo);
                             // did we hit an error?
                             if (retVal != 0) {
                                 // don't worry, the value is a line error
@@ -2865,7 +3071,7 @@ SectionsCode:
                                 return LINE_ERROR;
                     }
 
-                    int ix, iz, isx, isz, niz, offset;
+                    int ix, iz, isx, isz, offset;
                     unsigned char bval;
 
                     // if there's just one entry, we're done (no data), assign whole biome that value
@@ -2873,28 +3079,25 @@ SectionsCode:
                         memset(biome, paletteBiomeEntry[0], 256 * sizeof(unsigned char));
                     }
                     // got the data, now interpret it; biomes are now 4x4x4, take the topmost 4x4
-                    else if (biomePaletteLength == 2) {
-                        // easy, common case: take top 16 bits and use as palette indices, 0 or 1
+                    else if (biomePaletteLength > 1) {
+                        // bits per entry are just enough for the palette, e.g., 5 entries need 3 bits
+                        int biomebitlength = 1;
+                        while ((1 << biomebitlength) < biomePaletteLength)
+                            biomebitlength++;
+                        unsigned short biomeIndices[64];
+                        UnpackPaletteIndices(biomebuff, biomebufflen, biomebitlength, 64, biomeIndices);
                         for (iz = 0; iz < 4; iz++) {
                             for (ix = 0; ix < 4; ix++) {
-                                niz = 3 - iz;
-                                bval = paletteBiomeEntry[(biomebuff[iz >> 1] >> ((((niz << 2) + ix)) & 0x7)) & 0x1];
-                                offset = niz * 64 + ix * 4;
-                                for (isz = 0; isz < 4; isz++) {
-                                    for (isx = 0; isx < 4; isx++) {
-                                        biome[offset + isz * 16 + isx] = bval;
-                                    }
+                                // entries are in y, z, x order, so the top layer is the last 16
+                                int biomebits = biomeIndices[48 + iz * 4 + ix];
+                                // sanity check
+                                if (biomebits >= biomePaletteLength) {
+                                    // Should never reach here; means that a stored index value is greater than any value in the palette.
+                                    assert(0);
+                                    biomebits = 0;
                                 }
-                            }
-                        }
-                    }
-                    else if (biomePaletteLength <= 4) {
-                        // uncommon case: palette indices are 2 bits
-                        for (iz = 0; iz < 4; iz++) {
-                            for (ix = 0; ix < 4; ix++) {
-                                niz = 3 - iz;
-                                bval = paletteBiomeEntry[(biomebuff[iz] >> 2*ix) & 0x3];
-                                offset = niz * 64 + ix * 4;
+                                bval = paletteBiomeEntry[biomebits];
+                                offset = iz * 64 + ix * 4;
                                 for (isz = 0; isz < 4; isz++) {
                                     for (isx = 0; isx < 4; isx++) {
                                         biome[offset + isz * 16 + isx] = bval;
@@ -2902,184 +3105,10 @@ SectionsCode:
                                 }
                             }
                         }
-                    }
-                    else if (biomePaletteLength > 4) {
-                        // Cheat for now - not sure how 3 bit data is packed into 8 bits
-                        // - see general decoder (commented out, untested, clone of one for chunk data) below, may need to use that.
-                        // Never have run into a 5+ biome section,
-                        // at least not at sea level.
-                        memset(biome, paletteBiomeEntry[0], 256 * sizeof(unsigned char));
-                        assert(0);
-
-                        /* doesn't work, but code to at least think about the problem...
-                        // compute number of bits for each palette entry. For example, 21 entries is 5 bits, which can access 17-32 entries.
-                        int biomebitlength = biomebufflen;
-
-                        // Not so sure about this... uncompressed? or not? Need to find an example TODO
-                        bool uncompressed = (biomebufflen > 64 * biomebitlength);
-                        unsigned long int biomebitmask = (1 << biomebitlength) - 1;
-
-                        unsigned char biome4x4x4[64];
-                        unsigned char* biomeout = biome4x4x4;
-
-                        int biomebitpull = 0;
-                        for (i = 0; i < 64; i++, biomebitpull += biomebitlength) {
-                            // Pull out bits. Here is the lowest bit's index, if the array is thought of as one long string of bits.
-                            // That is, if you see "5" here, the bits in the 64-bit long long are in order
-                            // which bb should we access for these bits? Divide by 8
-                        RestartBiome:
-                            int bbbindex = biomebitpull >> 3;
-                            // Have to count from top to bottom 8 bytes of each long long. I suspect if I read the long longs as bytes the order might be right.
-                            // But, this works.
-                            bbbindex = (bbbindex & 0xfff8) + 7 - (bbbindex & 0x7);
-                            int bbbshift = biomebitpull & 0x7;
-                            // get the top bits out of the topmost byte, on down the row
-                            int biomebits = (biomebuff[bbbindex] >> bbbshift) & biomebitmask;
-                            // Check if we got enough bits. If we had only a few bits retrieved, need to get more from the next byte.
-                            // 'While' is needed only when remainingBitLength > 0, as 3 bytes may be needed
-                            int remainingBitLength = biomebitlength - (8 - bbbshift);
-                            while (remainingBitLength > 0) {
-                                if (bbbindex & 0x7) {
-                                    // one of the middle bytes, not the bottommost one
-                                    biomebits |= (biomebuff[bbbindex - 1] << (8 - bbbshift)) & biomebitmask;
-                                }
-                                else {
-                                    // Bottommost byte, and not enough bits left: need to jump to topmost byte of next long long and restart.
-                                    // If this is the new format and the length of biomebufflen is greater than expected,
-                                    // e.g., 5*64 is 320, but might be 342, then we have to add to bitpull (need to make that number
-                                    // incremental up above) and pull entirely from the next +15 index, as shown here.
-                                    if (uncompressed) {
-                                        // start on next long long
-                                        //biomebits = biomebuff[bbbindex + 15] & biomebitmask;
-                                        biomebitpull += (8 - bbbshift);
-                                        goto RestartBiome;
-                                        //next iteration it will be: bbshift = 0;
-                                    }
-                                    else {
-                                        biomebits |= (biomebuff[bbbindex + 15] << (8 - bbbshift)) & biomebitmask;
-                                    }
-                                }
-                                // a waste 99% of the time - any faster way? TODO - could unwind loops, could properly track bbindex and bbshift without
-                                // recomputing them each time. Maybe try some timing tests one day to see if it matters.
-                                remainingBitLength -= 8;
-                                bbbindex--;
-                                bbbshift = 0;
-                            }
-
-                            // sanity check
-                            if (biomebits >= biomePaletteLength) {
-                                // Should never reach here; means that a stored index value is greater than any value in the palette.
-                                assert(0);
-#ifdef _DEBUG
-                                // maximum value is entryIndex - 1; which is useful for debugging - see things go bad
-                                biomebits = biomePaletteLength - 1;
-#else
-                                bits = 0; // which is likely air
-#endif
-                            }
-                            *biomeout++ = paletteBiomeEntry[biomebits];
-                        }
-                        // OK, got the biome, stretch and paste the top 4x4 into the 16x16 final storage
-                        biomeout = biome4x4x4 + 48 * sizeof(unsigned char);
-                        for (ix = 0; ix < 4; ix++) {
-                            for (iz = 0; iz < 4; iz++) {
-                                bval = *biomeout++;
-                                offset = ix * 16 + iz * 4;
-                                for (isx = 0; isx < 4; isx++) {
-                                    for (isz = 0; isz < 4; isz++) {
-                                        biome[offset + isx + isz] = bval;
-                                    }
-                                }
-                            }
-                        }
-                        */
                     } else {
                         // somehow there are zero biome palette entries!
                         assert(0);
                     }
-                    /*
-                    // compute number of bits for each palette entry. For example, 21 entries is 5 bits, which can access 17-32 entries.
-                    int biomebitlength = biomebufflen;
-
-                    // Not so sure about this... uncompressed? or not? Need to find an example TODO
-                    bool uncompressed = (biomebufflen > 64 * biomebitlength);
-                    unsigned long int biomebitmask = (1 << biomebitlength) - 1;
-
-                    unsigned char biome4x4x4[64];
-                    unsigned char* biomeout = biome4x4x4;
-
-                    int biomebitpull = 0;
-                    for (i = 0; i < 64; i++, biomebitpull += biomebitlength) {
-                        // Pull out bits. Here is the lowest bit's index, if the array is thought of as one long string of bits.
-                        // That is, if you see "5" here, the bits in the 64-bit long long are in order
-                        // which bb should we access for these bits? Divide by 8
-                    RestartBiome:
-                        int bbbindex = biomebitpull >> 3;
-                        // Have to count from top to bottom 8 bytes of each long long. I suspect if I read the long longs as bytes the order might be right.
-                        // But, this works.
-                        bbbindex = (bbbindex & 0xfff8) + 7 - (bbbindex & 0x7);
-                        int bbbshift = biomebitpull & 0x7;
-                        // get the top bits out of the topmost byte, on down the row
-                        int biomebits = (biomebuff[bbbindex] >> bbbshift) & biomebitmask;
-                        // Check if we got enough bits. If we had only a few bits retrieved, need to get more from the next byte.
-                        // 'While' is needed only when remainingBitLength > 0, as 3 bytes may be needed
-                        int remainingBitLength = biomebitlength - (8 - bbbshift);
-                        while (remainingBitLength > 0) {
-                            if (bbbindex & 0x7) {
-                                // one of the middle bytes, not the bottommost one
-                                biomebits |= (biomebuff[bbbindex - 1] << (8 - bbbshift)) & biomebitmask;
-                            }
-                            else {
-                                // Bottommost byte, and not enough bits left: need to jump to topmost byte of next long long and restart.
-                                // If this is the new format and the length of biomebufflen is greater than expected,
-                                // e.g., 5*64 is 320, but might be 342, then we have to add to bitpull (need to make that number
-                                // incremental up above) and pull entirely from the next +15 index, as shown here.
-                                if (uncompressed) {
-                                    // start on next long long
-                                    //biomebits = biomebuff[bbbindex + 15] & biomebitmask;
-                                    biomebitpull += (8 - bbbshift);
-                                    goto RestartBiome;
-                                    //next iteration it will be: bbshift = 0;
-                                }
-                                else {
-                                    biomebits |= (biomebuff[bbbindex + 15] << (8 - bbbshift)) & biomebitmask;
-                                }
-                            }
-                            // a waste 99% of the time - any faster way? TODO - could unwind loops, could properly track bbindex and bbshift without
-                            // recomputing them each time. Maybe try some timing tests one day to see if it matters.
-                            remainingBitLength -= 8;
-                            bbbindex--;
-                            bbbshift = 0;
-                        }
-
-                        // sanity check
-                        if (biomebits >= biomePaletteLength) {
-                            // Should never reach here; means that a stored index value is greater than any value in the palette.
-                            assert(0);
-#ifdef _DEBUG
-                                    // maximum value is entryIndex - 1; which is useful for debugging - see things go bad
-                                    biomebits = biomePaletteLength - 1;
-#else
-                                    bits = 0; // which is likely air
-#endif
-                                }
-                                *biomeout++ = paletteBiomeEntry[biomebits];
-                            }
-                            // OK, got the biome, stretch and paste the top 4x4 into the 16x16 final storage
-                            biomeout = biome4x4x4 + 48 * sizeof(unsigned char);
-                            for (int ix = 0; ix < 4; ix++) {
-                                for (int iz = 0; iz < 4; iz++) {
-                                    unsigned char bval = *biomeout++;
-                                    int offset = ix * 16 + iz * 4;
-                                    for (int isx = 0; isx < 4; isx++) {
-                                        for (int isz = 0; isz < 4; isz++) {
-                                            biome[offset + isx + isz] = bval;
-                                        }
-                                    }
-                                }
-                            }
-                            */
-
                 }
 
                 // Did we not read through the object by some code above? If so, then skip it
@@ -3116,63 +3145,87 @@ SectionsCode:
                         mfsHeight = sectionHeight;
                     }
 
-                    int bitpull = 0;
-                    for (i = 0; i < 16 * 256; i++, bitpull += bitlength) {
-                        // Pull out bits. Here is the lowest bit's index, if the array is thought of as one long string of bits.
-                        // That is, if you see "5" here, the bits in the 64-bit long long are in order 
-                        // which bb should we access for these bits? Divide by 8
-                    Restart:
-                        int bbindex = bitpull >> 3;
-                        // Have to count from top to bottom 8 bytes of each long long. I suspect if I read the long longs as bytes the order might be right.
-                        // But, this works.
-                        bbindex = (bbindex & 0xfff8) + 7 - (bbindex & 0x7);
-                        int bbshift = bitpull & 0x7;
-                        // get the top bits out of the topmost byte, on down the row
-                        int bits = (bigbuff[bbindex] >> bbshift) & bitmask;
-                        // Check if we got enough bits. If we had only a few bits retrieved, need to get more from the next byte.
-                        // 'While' is needed only when remainingBitLength > 0, as 3 bytes may be needed
-                        int remainingBitLength = bitlength - (8 - bbshift);
-                        while (remainingBitLength > 0) {
-                            if (bbindex & 0x7) {
-                                // one of the middle bytes, not the bottommost one
-                                bits |= (bigbuff[bbindex - 1] << (8 - bbshift)) & bitmask;
+                    if ((uncompressed || (64 % bitlength) == 0) && bitlength <= 16) {
+                        // no index spans two longs, which is the easy, fast case
+                        unsigned short indices[16 * 16 * 16];
+                        UnpackPaletteIndices(bigbuff, bigbufflen, bitlength, 16 * 16 * 16, indices);
+                        for (i = 0; i < 16 * 256; i++) {
+                            int bits = indices[i];
+                            // sanity check
+                            if (bits >= paletteLength) {
+                                // Should never reach here; means that a stored index value is greater than any value in the palette.
+                                assert(0);
+#ifdef _DEBUG
+                                // maximum value is entryIndex - 1; which is useful for debugging - see things go bad
+                                bits = paletteLength - 1;
+#else
+                                bits = 0; // which is likely air
+#endif
                             }
-                            else {
-                                // Bottommost byte, and not enough bits left: need to jump to topmost byte of next long long and restart.
-                                // If this is the new format and the length of bigbufflen is greater than expected,
-                                // e.g., 5*64 is 320, but might be 342, then we have to add to bitpull (need to make that number
-                                // incremental up above) and pull entirely from the next +15 index, as shown here.
-                                if (uncompressed) {
-                                    // start on next long long
-                                    //bits = bigbuff[bbindex + 15] & bitmask;
-                                    bitpull += (8 - bbshift);
-                                    goto Restart;
-                                    //next iteration it will be: bbshift = 0;
+                            *bout++ = paletteBlockEntry[bits];
+                            *dout++ = paletteDataEntry[bits];
+                        }
+                    }
+                    else {
+                        // 1.13 through 1.15: indices run on from one long into the next
+                        int bitpull = 0;
+                        for (i = 0; i < 16 * 256; i++, bitpull += bitlength) {
+                            // Pull out bits. Here is the lowest bit's index, if the array is thought of as one long string of bits.
+                            // That is, if you see "5" here, the bits in the 64-bit long long are in order 
+                            // which bb should we access for these bits? Divide by 8
+                        Restart:
+                            int bbindex = bitpull >> 3;
+                            // Have to count from top to bottom 8 bytes of each long long. I suspect if I read the long longs as bytes the order might be right.
+                            // But, this works.
+                            bbindex = (bbindex & 0xfff8) + 7 - (bbindex & 0x7);
+                            int bbshift = bitpull & 0x7;
+                            // get the top bits out of the topmost byte, on down the row
+                            int bits = (bigbuff[bbindex] >> bbshift) & bitmask;
+                            // Check if we got enough bits. If we had only a few bits retrieved, need to get more from the next byte.
+                            // 'While' is needed only when remainingBitLength > 0, as 3 bytes may be needed
+                            int remainingBitLength = bitlength - (8 - bbshift);
+                            while (remainingBitLength > 0) {
+                                if (bbindex & 0x7) {
+                                    // one of the middle bytes, not the bottommost one
+                                    bits |= (bigbuff[bbindex - 1] << (8 - bbshift)) & bitmask;
                                 }
                                 else {
-                                    bits |= (bigbuff[bbindex + 15] << (8 - bbshift)) & bitmask;
+                                    // Bottommost byte, and not enough bits left: need to jump to topmost byte of next long long and restart.
+                                    // If this is the new format and the length of bigbufflen is greater than expected,
+                                    // e.g., 5*64 is 320, but might be 342, then we have to add to bitpull (need to make that number
+                                    // incremental up above) and pull entirely from the next +15 index, as shown here.
+                                    if (uncompressed) {
+                                        // start on next long long
+                                        //bits = bigbuff[bbindex + 15] & bitmask;
+                                        bitpull += (8 - bbshift);
+                                        goto Restart;
+                                        //next iteration it will be: bbshift = 0;
+                                    }
+                                    else {
+                                        bits |= (bigbuff[bbindex + 15] << (8 - bbshift)) & bitmask;
+                                    }
                                 }
+                                // a waste 99% of the time - any faster way? TODO - could unwind loops, could properly track bbindex and bbshift without
+                                // recomputing them each time. Maybe try some timing tests one day to see if it matters.
+                                remainingBitLength -= 8;
+                                bbindex--;
+                                bbshift = 0;
                             }
-                            // a waste 99% of the time - any faster way? TODO - could unwind loops, could properly track bbindex and bbshift without
-                            // recomputing them each time. Maybe try some timing tests one day to see if it matters.
-                            remainingBitLength -= 8;
-                            bbindex--;
-                            bbshift = 0;
-                        }
 
-                        // sanity check
-                        if (bits >= paletteLength) {
-                            // Should never reach here; means that a stored index value is greater than any value in the palette.
-                            assert(0);
+                            // sanity check
+                            if (bits >= paletteLength) {
+                                // Should never reach here; means that a stored index value is greater than any value in the palette.
+                                assert(0);
 #ifdef _DEBUG
-                            // maximum value is entryIndex - 1; which is useful for debugging - see things go bad
-                            bits = paletteLength - 1;
+                                // maximum value is entryIndex - 1; which is useful for debugging - see things go bad
+                                bits = paletteLength - 1;
 #else
-                            bits = 0; // which is likely air
+                                bits = 0; // which is likely air
 #endif
+                            }
+                            *bout++ = paletteBlockEntry[bits];
+                            *dout++ = paletteDataEntry[bits];
                         }
-                        *bout++ = paletteBlockEntry[bits];
-                        *dout++ = paletteDataEntry[bits];
                     }
                 }
                 else {
@@ -3502,7 +3555,7 @@ static int readBiomePalette(bfFile* pbf, unsigned char* paletteBiomeEntry, int&
     return 0;
 }
 
-static int readPalette(int& returnCode, bfFile* pbf, int mcVersion, unsigned char *paletteBlockEntry, unsigned char *paletteDataEntry, int& entryIndex, char* unknownBlock, int unknownBlockID)
+static int readPalette(int& returnCode, bfFile* pbf, int mcVersion, unsigned char *paletteBlockEntry, unsigned char *paletteDataEntry, int& entryIndex, char* unknownBlock, int unknownBlockID, NameMemo* pMemo)
 {
     int dataVal, len;
     unsigned char type;
@@ -3600,7 +3653,10 @@ static int readPalette(int& returnCode, bfFile* pbf, int mcVersion, unsigned cha
                 //}
 
                 // convert name to block value.
-                typeIndex = findIndexFromName(thisBlockName);
+#ifdef _DEBUG
+                recordPaletteName(entryIndex, thisBlockName);
+#endif
+                typeIndex = memoFindIndexFromName(pMemo, entryIndex, thisBlockName);
                 if (typeIndex > -1) {
                     useData = true;
                     paletteBlockEntry[entryIndex] = BlockTranslations[typeIndex].blockId;
@@ -5160,6 +5216,8 @@ int nbtGetHeights(bfFile* pbf, int& minHeight, int& heightAlloc, int mcVersion)
     int len, nsections;
 
     int returnCode = NBT_VALID_BLOCK;	// means "fine"
+    NameMemo nameMemo;
+    initNameMemo(&nameMemo);
 
     //Level/Blocks
     if (bfseek(pbf, 1, SEEK_CUR) < 0)
@@ -5259,7 +5317,7 @@ SectionsCode:
             {
                 ret = 1;
 
-                int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, NULL, 0);
+                int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, NULL, 0, &nameMemo);
                 // did we hit an error?
                 if (retVal != 0) {
                     return retVal;
@@ -5289,7 +5347,7 @@ SectionsCode:
                     if (strcmp(thisName, "palette") == 0)
                     {
                         subret = 1;
-                        int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, NULL, 0);
+                        int retVal = readPalette(returnCode, pbf, mcVersion, paletteBlockEntry, paletteDataEntry, paletteLength, NULL, 0, &nameMemo);
                         // did we hit an error?
                         if (retVal != 0) {
                             return retVal;
@@ -6749,7 +6807,7 @@ int nbtGetSpongeSchematic(bfFile* pbf,
     *outData = NULL;
     *outWidth = *outHeight = *outLength = 0;
 
-    // findIndexFromName (used by spongeParseStateString below) relies on HashArray[]; if no
+    // findIndexFromName (used by spongeParseStateString below) relies on the name table; if no
     // 1.13+ chunk has been read this session, that table is still uninitialized. Force its
     // construction now so the palette name lookup works on the very first load.
     if (makeHash) {
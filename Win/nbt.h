@@ -136,6 +136,7 @@ int nbtGetSpongeSchematic(bfFile* pbf,
 void nbtClose(bfFile* pbf);
 
 int SlowFindIndexFromName(char* name);
+void nbtPrepareTables();
 void SetModTranslations(TranslationTuple* mt);
 
 // Sponge Schematic v3 export (issue #40): build the canonical Minecraft block-state string
@@ -0,0 +1,287 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "outstream.h"
+#include <assert.h>
+#include <math.h>
+
+// OBJ and USDA exports have a model file and a material file open, USDA a block library file as well
+#define OUT_STREAM_SLOTS 4
+#define OUT_STREAM_BUFFER_SIZE (4 * 1024 * 1024)
+
+typedef struct OutStream {
+    bool used;
+    bool failed;            // a write failed; report it on every later call
+    PORTAFILE fh;
+    char* buffer;           // kept when the file is closed, for the next one
+    size_t length;
+    unsigned int lastUse;
+} OutStream;
+
+static OutStream gOutStreams[OUT_STREAM_SLOTS];
+static unsigned int gOutUseCounter = 0;
+
+static bool outWriteFile(PORTAFILE fh, const void* data, size_t length)
+{
+    DWORD br;
+    return (PortaWrite(fh, data, length));
+}
+
+static bool outFlushStream(OutStream* pStream)
+{
+    if (pStream->length > 0 && !pStream->failed) {
+        pStream->failed = outWriteFile(pStream->fh, pStream->buffer, pStream->length);
+    }
+    pStream->length = 0;
+    return pStream->failed;
+}
+
+static OutStream* outFindStream(PORTAFILE fh)
+{
+    for (int i = 0; i < OUT_STREAM_SLOTS; i++) {
+        if (gOutStreams[i].used && gOutStreams[i].fh == fh)
+            return &gOutStreams[i];
+    }
+    return NULL;
+}
+
+// Get the file a slot, emptying the one used least recently if need be. Returns NULL if out of memory.
+static OutStream* outAddStream(PORTAFILE fh)
+{
+    OutStream* pStream = &gOutStreams[0];
+    for (int i = 0; i < OUT_STREAM_SLOTS; i++) {
+        if (!gOutStreams[i].used) {
+            pStream = &gOutStreams[i];
+            break;
+        }
+        if (gOutStreams[i].lastUse < pStream->lastUse)
+            pStream = &gOutStreams[i];
+    }
+    if (pStream->used) {
+        // whatever fails here will be seen when the file is written to next, directly
+        outFlushStream(pStream);
+        pStream->used = false;
+    }
+    if (pStream->buffer == NULL) {
+        pStream->buffer = (char*)malloc(OUT_STREAM_BUFFER_SIZE);
+        if (pStream->buffer == NULL)
+            return NULL;
+    }
+    pStream->used = true;
+    pStream->failed = false;
+    pStream->fh = fh;
+    pStream->length = 0;
+    return pStream;
+}
+
+PORTAFILE OutCreate(const wchar_t* filename)
+{
+    PORTAFILE fh = PortaCreate(filename);
+    if (fh != INVALID_HANDLE_VALUE) {
+        OutStream* pStream = outFindStream(fh);
+        if (pStream != NULL) {
+            // left over from a file with this handle that was closed directly
+            pStream->used = false;
+            pStream->length = 0;
+        }
+    }
+    return fh;
+}
+
+bool OutWrite(PORTAFILE fh, const void* data, size_t length)
+{
+    OutStream* pStream = outFindStream(fh);
+    if (pStream == NULL) {
+        pStream = outAddStream(fh);
+        if (pStream == NULL)
+            return outWriteFile(fh, data, length);
+    }
+    pStream->lastUse = ++gOutUseCounter;
+    if (pStream->failed)
+        return true;
+
+    if (pStream->length + length > OUT_STREAM_BUFFER_SIZE) {
+        if (outFlushStream(pStream))
+            return true;
+        if (length > OUT_STREAM_BUFFER_SIZE) {
+            pStream->failed = outWriteFile(fh, data, length);
+            return pStream->failed;
+        }
+    }
+    memcpy(pStream->buffer + pStream->length, data, length);
+    pStream->length += length;
+    return false;
+}
+
+bool OutFlush(PORTAFILE fh)
+{
+    OutStream* pStream = outFindStream(fh);
+    return (pStream != NULL) ? outFlushStream(pStream) : false;
+}
+
+bool OutClose(PORTAFILE fh)
+{
+    bool failed = false;
+    OutStream* pStream = outFindStream(fh);
+    if (pStream != NULL) {
+        failed = outFlushStream(pStream);
+        pStream->used = false;
+    }
+    PortaClose(fh);
+    return failed;
+}
+
+static const char gDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Write value's decimal digits, at least minDigits of them, zero-padded.
+static char* outFormatUnsigned(char* dst, unsigned long long value, int minDigits)
+{
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    while (value >= 100) {
+        unsigned int pair = (unsigned int)(value % 100);
+        value /= 100;
+        *--p = gDigitPairs[pair * 2 + 1];
+        *--p = gDigitPairs[pair * 2];
+    }
+    if (value >= 10) {
+        *--p = gDigitPairs[value * 2 + 1];
+        *--p = gDigitPairs[value * 2];
+    }
+    else {
+        *--p = (char)('0' + value);
+    }
+    int count = (int)(digits + sizeof(digits) - p);
+    for (; count < minDigits; count++)
+        *dst++ = '0';
+    memcpy(dst, p, digits + sizeof(digits) - p);
+    return dst + (digits + sizeof(digits) - p);
+}
+
+char* OutFormatInt(char* dst, int value)
+{
+    unsigned int magnitude = (unsigned int)value;
+    if (value < 0) {
+        *dst++ = '-';
+        magnitude = 0u - magnitude;
+    }
+    return outFormatUnsigned(dst, magnitude, 1);
+}
+
+// Powers of ten up to 10^9 are exact as doubles, and a float times one of these needs at most 24 + 21 bits, as
+// 10^9 = 2^9 * 5^9 and 5^9 < 2^21, so the product is exact too: rounding it to an integer rounds the float's
+// exact value, half to even, the same as sprintf_s().
+static const double gPowersOfTen[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+static unsigned long long outRoundHalfEven(double value)
+{
+    double whole = floor(value);
+    unsigned long long rounded = (unsigned long long)whole;
+    double fraction = value - whole;
+    if (fraction > 0.5 || (fraction == 0.5 && (rounded & 1)))
+        rounded++;
+    return rounded;
+}
+
+// decimals < 0 for "%g"
+static char* outFormatFallback(char* dst, float value, int decimals)
+{
+    char number[64];
+    int length = (decimals < 0) ? sprintf_s(number, 64, "%g", (double)value) : sprintf_s(number, 64, "%.*f", decimals, (double)value);
+    memcpy(dst, number, length);
+    return dst + length;
+}
+
+char* OutFormatFloat(char* dst, float value)
+{
+    if (value == 0.0f) {
+        if (signbit(value))
+            *dst++ = '-';
+        *dst++ = '0';
+        return dst;
+    }
+    double magnitude = fabs((double)value);
+    // exponential form, and infinity and NaN, are left to sprintf_s()
+    if (!(magnitude >= 1e-4 && magnitude < 999999.5))
+        return outFormatFallback(dst, value, -1);
+
+    // exponent of the leading digit, -4 to 5
+    int exponent = 5;
+    while (exponent > -4 && magnitude < ((exponent >= 0) ? gPowersOfTen[exponent] : 1.0 / gPowersOfTen[-exponent]))
+        exponent--;
+    unsigned long long digits = outRoundHalfEven(magnitude * gPowersOfTen[5 - exponent]);
+    if (digits >= 1000000) {
+        // rounded up to the next power of ten
+        digits /= 10;
+        exponent++;
+    }
+    // drop trailing zeros; decimals left after the point
+    int decimals = 5 - exponent;
+    while (decimals > 0 && digits % 10 == 0) {
+        digits /= 10;
+        decimals--;
+    }
+
+    if (value < 0.0f)
+        *dst++ = '-';
+    if (decimals <= 0)
+        return outFormatUnsigned(dst, digits, 1);
+    unsigned long long scale = (unsigned long long)gPowersOfTen[decimals];
+    dst = outFormatUnsigned(dst, digits / scale, 1);
+    *dst++ = '.';
+    return outFormatUnsigned(dst, digits % scale, decimals);
+}
+
+char* OutFormatFixed(char* dst, float value, int decimals)
+{
+    assert(decimals >= 0 && decimals <= 9);
+    double magnitude = fabs((double)value);
+    // past this the digits no longer fit in a double's mantissa
+    if (!(magnitude < 8e6))
+        return outFormatFallback(dst, value, decimals);
+
+    unsigned long long digits = outRoundHalfEven(magnitude * gPowersOfTen[decimals]);
+    if (signbit(value))
+        *dst++ = '-';
+    if (decimals == 0)
+        return outFormatUnsigned(dst, digits, 1);
+    unsigned long long scale = (unsigned long long)gPowersOfTen[decimals];
+    dst = outFormatUnsigned(dst, digits / scale, 1);
+    *dst++ = '.';
+    return outFormatUnsigned(dst, digits % scale, decimals);
+}
@@ -0,0 +1,52 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Buffered writing of text export files. Each file written through here gets a large buffer, filled by OutWrite()
+// and written out in big pieces, instead of a WriteFile() call for every line or number. Files are known by their
+// handle, so OutWrite() drops in for PortaWrite(), OutCreate() for PortaCreate() and OutClose() for PortaClose().
+// Only a few files can be buffered at once, about as many as any export has open; past that, the file that went
+// the longest without a write is flushed and loses its buffer. Not thread-safe; exports run on one thread.
+
+// PortaCreate(), and forget anything a file closed without OutClose(), e.g., on an error, left with the same handle.
+PORTAFILE OutCreate(const wchar_t* filename);
+// Like PortaWrite(): returns true if it failed, now or when flushing earlier output.
+bool OutWrite(PORTAFILE fh, const void* data, size_t length);
+// Write out what's buffered for the file. Returns true if it failed.
+bool OutFlush(PORTAFILE fh);
+// Flush the file and PortaClose() it. Returns true if the flush failed.
+bool OutClose(PORTAFILE fh);
+
+// Number formatting for export lines, much faster than sprintf_s(). Each writes the same characters sprintf_s()
+// would for the format noted, with no terminating null, and returns where it stopped.
+// "%d"
+char* OutFormatInt(char* dst, int value);
+// "%g", i.e., 6 significant digits, trailing zeros removed
+char* OutFormatFloat(char* dst, float value);
+// "%.*f", up to 9 decimals
+char* OutFormatFixed(char* dst, float value, int decimals);
@@ -0,0 +1,205 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "XZip.h"
+#include "parallelzip.h"
+
+// Blocks read in and compressed per batch, per worker, to keep all the workers busy.
+#define ZIP_BLOCKS_PER_WORKER 2
+
+typedef struct DeflateJob {
+    DeflateBlock* blocks;
+    int level;
+    bool crc;
+} DeflateJob;
+
+typedef struct ZipSource {
+    const TCHAR* filename;
+    int maxBlocks;
+    // dictionary for the first block, followed by the data for all blocks of the batch
+    unsigned char* inBuffer;
+    unsigned char* outBuffer;
+    DeflateBlock* blocks;
+} ZipSource;
+
+static void deflateBlockTask(int taskIndex, int workerIndex, void* userData);
+static bool deflateZipSource(void* param, ZIPWRITEFUNC write, void* zip, unsigned long* crc, unsigned long* len);
+
+
+bool DeflateBlocks(DeflateBlock* blocks, int numBlocks, int level, bool crc)
+{
+    DeflateJob job;
+    job.blocks = blocks;
+    job.level = level;
+    job.crc = crc;
+    RunWorkerTasks(numBlocks, deflateBlockTask, &job);
+
+    for (int i = 0; i < numBlocks; i++) {
+        if (!blocks[i].ok)
+            return false;
+    }
+    return true;
+}
+
+static void deflateBlockTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    DeflateJob* pJob = (DeflateJob*)userData;
+    DeflateBlock* pBlock = &pJob->blocks[taskIndex];
+
+    pBlock->check = pJob->crc ? crc32(crc32(0L, Z_NULL, 0), pBlock->in, pBlock->inLen) :
+        adler32(adler32(0L, Z_NULL, 0), pBlock->in, pBlock->inLen);
+    pBlock->outLen = 0;
+    pBlock->ok = false;
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(z_stream));
+    // negative window bits give raw deflate data, no zlib header or trailer
+    if (deflateInit2(&strm, pJob->level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return;
+    if (pBlock->dictLen == 0 || deflateSetDictionary(&strm, pBlock->in - pBlock->dictLen, pBlock->dictLen) == Z_OK) {
+        strm.next_in = (Bytef*)pBlock->in;
+        strm.avail_in = pBlock->inLen;
+        strm.next_out = pBlock->out;
+        strm.avail_out = DEFLATE_BLOCK_OUT_SIZE;
+        // a sync flush ends the block's output on a byte boundary, without ending the stream,
+        // so the next block's output can simply follow it
+        int status = deflate(&strm, pBlock->last ? Z_FINISH : Z_SYNC_FLUSH);
+        pBlock->outLen = DEFLATE_BLOCK_OUT_SIZE - strm.avail_out;
+        pBlock->ok = pBlock->last ? (status == Z_STREAM_END) :
+            (status == Z_OK && strm.avail_in == 0 && strm.avail_out > 0);
+    }
+    deflateEnd(&strm);
+}
+
+
+ZRESULT ZipAddParallel(HZIP hz, const TCHAR* dstzn, const TCHAR* fn)
+{
+    WIN32_FILE_ATTRIBUTE_DATA fileData;
+    if (!GetFileAttributesEx(fn, GetFileExInfoStandard, &fileData) ||
+        (fileData.nFileSizeHigh == 0 && fileData.nFileSizeLow <= DEFLATE_BLOCK_SIZE) ||
+        GetWorkerCount() < 2)
+    {
+        return ZipAdd(hz, dstzn, (void*)fn, 0, ZIP_FILENAME);
+    }
+
+    ZipSource source;
+    source.filename = fn;
+    source.maxBlocks = GetWorkerCount() * ZIP_BLOCKS_PER_WORKER;
+    if (fileData.nFileSizeHigh == 0) {
+        int fileBlocks = (int)((fileData.nFileSizeLow + DEFLATE_BLOCK_SIZE - 1) / DEFLATE_BLOCK_SIZE);
+        source.maxBlocks = min(source.maxBlocks, fileBlocks);
+    }
+    source.inBuffer = (unsigned char*)malloc(DEFLATE_DICT_SIZE + (size_t)source.maxBlocks * DEFLATE_BLOCK_SIZE);
+    source.outBuffer = (unsigned char*)malloc((size_t)source.maxBlocks * DEFLATE_BLOCK_OUT_SIZE);
+    source.blocks = (DeflateBlock*)malloc(source.maxBlocks * sizeof(DeflateBlock));
+
+    ZRESULT zr;
+    if (source.inBuffer == NULL || source.outBuffer == NULL || source.blocks == NULL) {
+        zr = ZipAdd(hz, dstzn, (void*)fn, 0, ZIP_FILENAME);
+    }
+    else {
+        ZIPDEFLATESOURCE zipSource;
+        zipSource.filename = fn;
+        zipSource.deflate = deflateZipSource;
+        zipSource.param = &source;
+        zr = ZipAdd(hz, dstzn, &zipSource, 0, ZIP_DEFLATED);
+    }
+
+    free(source.inBuffer);
+    free(source.outBuffer);
+    free(source.blocks);
+    return zr;
+}
+
+static bool deflateZipSource(void* param, ZIPWRITEFUNC write, void* zip, unsigned long* crc, unsigned long* len)
+{
+    ZipSource* pSource = (ZipSource*)param;
+
+    HANDLE hf = CreateFile(pSource->filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (hf == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    // zip entries without the zip64 extensions are limited to 4 GB
+    if (!GetFileSizeEx(hf, &fileSize) || fileSize.QuadPart > 0xffffffffLL) {
+        CloseHandle(hf);
+        return false;
+    }
+
+    unsigned long long remaining = (unsigned long long)fileSize.QuadPart;
+    unsigned int dictLen = 0;
+    bool ok = true;
+    *crc = crc32(0L, Z_NULL, 0);
+    *len = 0;
+    do {
+        unsigned int batchLen = (unsigned int)min(remaining, (unsigned long long)pSource->maxBlocks * DEFLATE_BLOCK_SIZE);
+        DWORD br;
+        if (batchLen > 0 && (!ReadFile(hf, pSource->inBuffer + DEFLATE_DICT_SIZE, batchLen, &br, NULL) || br != batchLen)) {
+            ok = false;
+            break;
+        }
+        remaining -= batchLen;
+
+        // an empty file still gets one (empty) last block, to end the stream
+        int numBlocks = 0;
+        unsigned int offset = 0;
+        do {
+            DeflateBlock* pBlock = &pSource->blocks[numBlocks];
+            pBlock->in = pSource->inBuffer + DEFLATE_DICT_SIZE + offset;
+            pBlock->inLen = min(batchLen - offset, (unsigned int)DEFLATE_BLOCK_SIZE);
+            pBlock->dictLen = (offset > 0) ? DEFLATE_DICT_SIZE : dictLen;
+            pBlock->out = pSource->outBuffer + (size_t)numBlocks * DEFLATE_BLOCK_OUT_SIZE;
+            offset += pBlock->inLen;
+            pBlock->last = (remaining == 0 && offset == batchLen);
+            numBlocks++;
+        } while (offset < batchLen);
+
+        // level 8, as XZip uses for files it deflates itself
+        ok = DeflateBlocks(pSource->blocks, numBlocks, 8, true);
+
+        for (int i = 0; i < numBlocks && ok; i++) {
+            DeflateBlock* pBlock = &pSource->blocks[i];
+            if (write(zip, (const char*)pBlock->out, pBlock->outLen) != pBlock->outLen) {
+                ok = false;
+            }
+            else {
+                *crc = crc32_combine(*crc, pBlock->check, (z_off_t)pBlock->inLen);
+                *len += pBlock->inLen;
+            }
+        }
+
+        // the end of this batch is the dictionary for the first block of the next one
+        if (remaining > 0) {
+            memmove(pSource->inBuffer, pSource->inBuffer + batchLen, DEFLATE_DICT_SIZE);
+            dictLen = DEFLATE_DICT_SIZE;
+        }
+    } while (ok && remaining > 0);
+
+    CloseHandle(hf);
+    return ok;
+}
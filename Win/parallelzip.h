@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "XZip.h"
+
+// Data is deflated on the worker threads in blocks of this size. Each block is given the 32 KB of data
+// before it as its dictionary, so the output is barely larger than deflating it all at once.
+#define DEFLATE_BLOCK_SIZE (256*1024)
+#define DEFLATE_DICT_SIZE (32*1024)
+// Room for a block's compressed output, which is a bit more than the input if it won't compress.
+#define DEFLATE_BLOCK_OUT_SIZE (DEFLATE_BLOCK_SIZE + (DEFLATE_BLOCK_SIZE >> 8) + 64)
+
+typedef struct DeflateBlock {
+    const unsigned char* in;    // preceded in memory by dictLen bytes of dictionary
+    unsigned char* out;         // DEFLATE_BLOCK_OUT_SIZE bytes
+    unsigned int dictLen;
+    unsigned int inLen;         // at most DEFLATE_BLOCK_SIZE
+    unsigned int outLen;
+    unsigned long check;        // CRC-32 or Adler-32 of the input, see DeflateBlocks()
+    bool last;                  // ends the stream
+    bool ok;
+} DeflateBlock;
+
+// Deflate the blocks on the worker threads, as raw deflate data, no header or trailer. The blocks' outputs,
+// one after another, make up a single deflate stream. Each block's check is set to the CRC-32 of its input if
+// crc is true, as for zip, else its Adler-32, as for zlib streams. Returns false if any block failed.
+bool DeflateBlocks(DeflateBlock* blocks, int numBlocks, int level, bool crc);
+
+// Add a file to the zip, like ZipAdd(hz, dstzn, fn, 0, ZIP_FILENAME), but compress it on the
+// worker threads. The file is split into blocks that are each deflated on their own, primed with
+// the last 32 KB of the previous block so compression barely suffers, then written in order as
+// one raw deflate stream. Small files, or a failure to get memory, use plain ZipAdd().
+ZRESULT ZipAddParallel(HZIP hz, const TCHAR* dstzn, const TCHAR* fn);
@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "radixsort.h"
+
+// below this, insertion sort
+#define RADIX_SORT_SMALL 64
+// at or above this, split each pass across the workers
+#define RADIX_SORT_PARALLEL (256 * 1024)
+
+#define RADIX_DIGITS 256
+
+typedef struct RadixJob {
+    void** srcItems;
+    unsigned long long* srcKeys;
+    void** dstItems;
+    unsigned long long* dstKeys;
+    int count;
+    int numChunks;
+    int shift;
+    // per chunk: first the number of keys with each digit, then where the first of them goes
+    unsigned int (*offsets)[RADIX_DIGITS];
+} RadixJob;
+
+static void radixChunkRange(RadixJob* pJob, int chunk, int& start, int& end)
+{
+    start = (int)((long long)pJob->count * chunk / pJob->numChunks);
+    end = (int)((long long)pJob->count * (chunk + 1) / pJob->numChunks);
+}
+
+static void radixCountTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    RadixJob* pJob = (RadixJob*)userData;
+    unsigned int* counts = pJob->offsets[taskIndex];
+    int start, end;
+    radixChunkRange(pJob, taskIndex, start, end);
+    memset(counts, 0, RADIX_DIGITS * sizeof(unsigned int));
+    for (int i = start; i < end; i++)
+        counts[(pJob->srcKeys[i] >> pJob->shift) & 0xff]++;
+}
+
+static void radixScatterTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    RadixJob* pJob = (RadixJob*)userData;
+    unsigned int* offsets = pJob->offsets[taskIndex];
+    int start, end;
+    radixChunkRange(pJob, taskIndex, start, end);
+    for (int i = start; i < end; i++) {
+        unsigned int to = offsets[(pJob->srcKeys[i] >> pJob->shift) & 0xff]++;
+        pJob->dstKeys[to] = pJob->srcKeys[i];
+        pJob->dstItems[to] = pJob->srcItems[i];
+    }
+}
+
+static void insertionSortByKey(void** items, unsigned long long* keys, int count)
+{
+    for (int i = 1; i < count; i++) {
+        unsigned long long key = keys[i];
+        void* item = items[i];
+        int j = i - 1;
+        while (j >= 0 && keys[j] > key) {
+            keys[j + 1] = keys[j];
+            items[j + 1] = items[j];
+            j--;
+        }
+        keys[j + 1] = key;
+        items[j + 1] = item;
+    }
+}
+
+bool RadixSortByKey(void** items, unsigned long long* keys, int count)
+{
+    int i;
+    if (count < RADIX_SORT_SMALL) {
+        insertionSortByKey(items, keys, count);
+        return true;
+    }
+
+    // bytes that are the same in every key don't need a pass; nor does anything already in order
+    unsigned long long anyBits = 0;
+    unsigned long long allBits = ~0ull;
+    bool sorted = true;
+    for (i = 0; i < count; i++) {
+        anyBits |= keys[i];
+        allBits &= keys[i];
+        if (i > 0 && keys[i] < keys[i - 1])
+            sorted = false;
+    }
+    if (sorted)
+        return true;
+    unsigned long long varying = anyBits ^ allBits;
+
+    RadixJob job;
+    job.count = count;
+    job.numChunks = (count >= RADIX_SORT_PARALLEL) ? GetWorkerCount() : 1;
+    job.offsets = (unsigned int (*)[RADIX_DIGITS])malloc(job.numChunks * sizeof(*job.offsets));
+    void** tempItems = (void**)malloc(count * sizeof(void*));
+    unsigned long long* tempKeys = (unsigned long long*)malloc(count * sizeof(unsigned long long));
+    if (job.offsets == NULL || tempItems == NULL || tempKeys == NULL) {
+        free(job.offsets);
+        free(tempItems);
+        free(tempKeys);
+        return false;
+    }
+
+    job.srcItems = items;
+    job.srcKeys = keys;
+    job.dstItems = tempItems;
+    job.dstKeys = tempKeys;
+    for (job.shift = 0; job.shift < 64; job.shift += 8) {
+        if (((varying >> job.shift) & 0xff) == 0)
+            continue;
+
+        if (job.numChunks > 1)
+            RunWorkerTasks(job.numChunks, radixCountTask, &job);
+        else
+            radixCountTask(0, 0, &job);
+
+        // turn counts into where each chunk's first key with each digit goes: all keys with lower digits come first,
+        // then those with this digit in earlier chunks
+        unsigned int total = 0;
+        for (int digit = 0; digit < RADIX_DIGITS; digit++) {
+            for (int chunk = 0; chunk < job.numChunks; chunk++) {
+                unsigned int digitCount = job.offsets[chunk][digit];
+                job.offsets[chunk][digit] = total;
+                total += digitCount;
+            }
+        }
+
+        if (job.numChunks > 1)
+            RunWorkerTasks(job.numChunks, radixScatterTask, &job);
+        else
+            radixScatterTask(0, 0, &job);
+
+        void** swapItems = job.srcItems;
+        job.srcItems = job.dstItems;
+        job.dstItems = swapItems;
+        unsigned long long* swapKeys = job.srcKeys;
+        job.srcKeys = job.dstKeys;
+        job.dstKeys = swapKeys;
+    }
+
+    if (job.srcKeys != keys) {
+        memcpy(items, job.srcItems, count * sizeof(void*));
+        memcpy(keys, job.srcKeys, count * sizeof(unsigned long long));
+    }
+    free(job.offsets);
+    free(tempItems);
+    free(tempKeys);
+    return true;
+}
+
+unsigned int RadixKeyFloat(float value)
+{
+    // -0 sorts with 0, as it compares equal
+    if (value == 0.0f)
+        return 0x80000000u;
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // negative: flip everything, so larger magnitudes come first; positive: just put them after the negatives
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Stable sorting of items, e.g., pointers to records, by 64-bit keys made for them ahead of time, instead of qsort_s()
+// with a comparison callback. A least-significant-digit radix sort, a byte at a time, skipping bytes that are the same
+// for every key, and splitting large sorts across the workers. Since it's stable, a key too long for 64 bits can be
+// sorted on by sorting by its low part first, then by its high part.
+
+// Sort the count items by keys, ascending, keeping items with equal keys in the order given. keys are sorted too.
+// Returns false, leaving items and keys as they were, if out of memory; sort some other way, e.g., qsort_s().
+bool RadixSortByKey(void** items, unsigned long long* keys, int count);
+
+// Keys for signed and floating point values, in the same order as the values.
+inline unsigned int RadixKeyInt(int value)
+{
+    return (unsigned int)value ^ 0x80000000u;
+}
+inline unsigned int RadixKeyShort(short value)
+{
+    return (unsigned int)(unsigned short)value ^ 0x8000u;
+}
+unsigned int RadixKeyFloat(float value);
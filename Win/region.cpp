@@ -62,87 +62,379 @@ deflated data is the chunk length - 1.
 
 #include "stdafx.h"
 
+#include <assert.h>
+
 #define CHUNK_DEFLATE_MAX (1024 * 1024)  // 1MB limit for compressed chunks
 // had to kick this up due to F Seaworld 1.18 world test
 #define CHUNK_INFLATE_MAX (20 * 1024 * 1024) // 20MB limit for inflated chunks
+// each decoder's output buffer starts at this size and doubles as needed, up to CHUNK_INFLATE_MAX
+#define CHUNK_INFLATE_START (2 * 1024 * 1024)
+
+// Region files are opened once, mapped into memory as a whole, and kept around in a small table
+// for the rest of the draw or export pass, after which regionReleaseFiles() lets them go.
+// Previously every chunk read opened the .mca, seeked to its 4-byte location entry, seeked again
+// for the data, and closed the file: 1024 open/close pairs per region.
+#ifndef MINEWAYS_X64
+// 32 bits has little address space to spare for views of large region files
+#define REGION_CACHE_SLOTS 16
+#else
+#define REGION_CACHE_SLOTS 64
+#endif
 
-#define RERROR(x) if(x) { PortaClose(regionFile); return 0; }
+#define REGION_HEADER_SIZE 8192
+#define REGION_CHUNKS 1024
 
-static z_stream strm;
-static int strm_initialized = 0;
+typedef struct RegionFile {
+    bool used;              // slot holds a region, possibly one that does not exist on disk
+    bool exists;            // false means we looked and found no usable file; remembered so we don't look again
+    int rx, rz;
+    wchar_t directory[MAX_PATH_AND_FILE];
+    unsigned char* view;    // the whole file, read-only
+    unsigned int size;
+#ifdef WIN32
+    HANDLE fileHandle;
+    HANDLE mapHandle;
+#endif
+    // parsed 8 KB header: location is (sector offset << 8) | sector count, timestamp is Unix time
+    unsigned int location[REGION_CHUNKS];
+    unsigned int timestamp[REGION_CHUNKS];
+    unsigned int lastUse;
+    int pins;               // number of threads currently inflating straight from the view; such slots can't be evicted
+} RegionFile;
 
-static int regionPrepareBuffer(bfFile & bf, wchar_t* directory, int cx, int cz)
-{
-    wchar_t filename[256];
-    PORTAFILE regionFile;
+static RegionFile gRegionFiles[REGION_CACHE_SLOTS];
+static unsigned int gRegionUseCounter = 0;
+
+// The region table is shared by all chunk loading threads; the inflate state and output buffer are not.
 #ifdef WIN32
-    DWORD br;
+static SRWLOCK gRegionLock = SRWLOCK_INIT;
+#define LOCK_REGIONS()      AcquireSRWLockExclusive(&gRegionLock)
+#define UNLOCK_REGIONS()    ReleaseSRWLockExclusive(&gRegionLock)
+#else
+#define LOCK_REGIONS()
+#define UNLOCK_REGIONS()
 #endif
-    static unsigned char buf[CHUNK_DEFLATE_MAX];
-    static unsigned char out[CHUNK_INFLATE_MAX];
 
-    int sectorNumber, offset, chunkLength;
+// everything one thread needs to inflate chunks
+struct RegionDecoder {
+    z_stream strm;
+    int strmInitialized;
+    unsigned char* out;
+    int outSize;
+};
 
-    int status;
+// used by the main thread, i.e., whenever no decoder is passed in
+static RegionDecoder gMainDecoder;
 
-    // open the region file - note we get the new mca 1.2 file type here!
-    swprintf_s(filename, 256, L"%sregion/r.%d.%d.mca", directory, cx >> 5, cz >> 5);
+static void regionClose(RegionFile* pRegion)
+{
+#ifdef WIN32
+    if (pRegion->view != NULL)
+        UnmapViewOfFile(pRegion->view);
+    if (pRegion->mapHandle != NULL)
+        CloseHandle(pRegion->mapHandle);
+    if (pRegion->fileHandle != INVALID_HANDLE_VALUE)
+        PortaClose(pRegion->fileHandle);
+    pRegion->mapHandle = NULL;
+    pRegion->fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (pRegion->view != NULL)
+        free(pRegion->view);
+#endif
+    pRegion->view = NULL;
+    pRegion->size = 0;
+    pRegion->used = false;
+    pRegion->exists = false;
+}
+
+// map the file and parse its header; returns false if there is no usable region file
+static bool regionOpen(RegionFile* pRegion, const wchar_t* filename)
+{
+    unsigned int i;
+    unsigned char* pHeader;
 
-    regionFile = PortaOpen(filename);
+    pRegion->view = NULL;
+    pRegion->size = 0;
+#ifdef WIN32
+    pRegion->mapHandle = NULL;
+    pRegion->fileHandle = PortaOpen(filename);
     // this error means that we're trying to open an .mca that doesn't actually exist;
     // no data -> nothing to do, but don't flag an error
-    if (regionFile == INVALID_HANDLE_VALUE)
-        return 0;
+    if (pRegion->fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    // a file smaller than the header has no chunks; one larger than 4 GB is not a region file we can address
+    if (!GetFileSizeEx(pRegion->fileHandle, &fileSize) || fileSize.QuadPart < REGION_HEADER_SIZE || fileSize.HighPart != 0)
+        return false;
+    pRegion->size = fileSize.LowPart;
+
+    pRegion->mapHandle = CreateFileMappingW(pRegion->fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (pRegion->mapHandle == NULL)
+        return false;
+    pRegion->view = (unsigned char*)MapViewOfFile(pRegion->mapHandle, FILE_MAP_READ, 0, 0, 0);
+    if (pRegion->view == NULL)
+        return false;
+#else
+    // no mapping available, so read the whole file in one shot instead
+    PORTAFILE regionFile = PortaOpen(filename);
+    if (regionFile == NULL)
+        return false;
+    long fileSize = 0;
+    if (fseek(regionFile, 0, SEEK_END) == 0)
+        fileSize = ftell(regionFile);
+    if (fileSize < REGION_HEADER_SIZE || PortaSeek(regionFile, 0)) {
+        PortaClose(regionFile);
+        return false;
+    }
+    pRegion->view = (unsigned char*)malloc(fileSize);
+    if (pRegion->view == NULL || PortaRead(regionFile, pRegion->view, fileSize)) {
+        PortaClose(regionFile);
+        return false;
+    }
+    PortaClose(regionFile);
+    pRegion->size = (unsigned int)fileSize;
+#endif
+
+    // parse the location and timestamp tables, both 4-byte big-endian integers
+    pHeader = pRegion->view;
+    for (i = 0; i < REGION_CHUNKS; i++, pHeader += 4) {
+        pRegion->location[i] = ((unsigned int)pHeader[0] << 24) | ((unsigned int)pHeader[1] << 16) | ((unsigned int)pHeader[2] << 8) | (unsigned int)pHeader[3];
+    }
+    for (i = 0; i < REGION_CHUNKS; i++, pHeader += 4) {
+        pRegion->timestamp[i] = ((unsigned int)pHeader[0] << 24) | ((unsigned int)pHeader[1] << 16) | ((unsigned int)pHeader[2] << 8) | (unsigned int)pHeader[3];
+    }
+    return true;
+}
+
+// Find the region file holding chunk cx, cz, opening it if it's not already in the table.
+// Check "exists" to see if the region file is actually there. Must be called with the table locked.
+// Returns NULL only if every slot is pinned, which can't happen as long as there are fewer workers than slots.
+static RegionFile* regionFind(const wchar_t* directory, int cx, int cz)
+{
+    int i;
+    int rx = cx >> 5;
+    int rz = cz >> 5;
+    RegionFile* pOldest = NULL;
+
+    for (i = 0; i < REGION_CACHE_SLOTS; i++) {
+        RegionFile* pRegion = &gRegionFiles[i];
+        if (pRegion->used) {
+            if (pRegion->rx == rx && pRegion->rz == rz && wcscmp(pRegion->directory, directory) == 0) {
+                pRegion->lastUse = ++gRegionUseCounter;
+                return pRegion;
+            }
+            if (pRegion->pins == 0 && (pOldest == NULL || (pOldest->used && pRegion->lastUse < pOldest->lastUse)))
+                pOldest = pRegion;
+        }
+        else if (pOldest == NULL || pOldest->used) {
+            // an empty slot beats any used one
+            pOldest = pRegion;
+        }
+    }
+
+    if (pOldest == NULL) {
+        assert(0);
+        return NULL;
+    }
+
+    // not found, so replace the least recently used slot
+    if (pOldest->used)
+        regionClose(pOldest);
+
+    wchar_t filename[MAX_PATH_AND_FILE];
+    // open the region file - note we get the new mca 1.2 file type here!
+    swprintf_s(filename, MAX_PATH_AND_FILE, L"%sregion/r.%d.%d.mca", directory, rx, rz);
+
+    if (!regionOpen(pOldest, filename)) {
+        // remember the miss, so we don't try opening the file again for every chunk in the region
+        regionClose(pOldest);
+    }
+    else {
+        pOldest->exists = true;
+    }
+    pOldest->used = true;
+    pOldest->rx = rx;
+    pOldest->rz = rz;
+    wcscpy_s(pOldest->directory, MAX_PATH_AND_FILE, directory);
+    pOldest->lastUse = ++gRegionUseCounter;
+    return pOldest;
+}
 
-    // seek to the chunk offset
-    RERROR(PortaSeek(regionFile, 4 * ((cx & 31) + (cz & 31) * 32)));
+// Return a pointer directly into the mapped region file for the chunk's compressed data, and its length.
+// Returns the region, pinned so that it stays mapped until regionUnpin() is called, or NULL if the
+// chunk or region does not exist or is not a zlib-compressed chunk.
+static RegionFile* regionPinChunk(const wchar_t* directory, int cx, int cz, const unsigned char** compressed, int* length)
+{
+    LOCK_REGIONS();
+    RegionFile* pRegion = regionFind(directory, cx, cz);
+    if (pRegion == NULL || !pRegion->exists) {
+        UNLOCK_REGIONS();
+        return NULL;
+    }
 
-    // get the chunk offset
-    RERROR(PortaRead(regionFile, buf, 4));
+    unsigned int location = pRegion->location[(cx & 31) + (cz & 31) * 32];
+    unsigned int offset = location >> 8; // 4KB sector the chunk is in
+    unsigned int sectorNumber = location & 0xff; // how many 4096B sectors the chunk takes up
+
+    const unsigned char* buf = pRegion->view + (size_t)offset * 4096;
+    unsigned int chunkLength = 0;
+    // the chunk's 5 byte header must be in the file
+    bool valid = (offset != 0) && // an empty chunk
+        (sectorNumber * 4096 <= CHUNK_DEFLATE_MAX) &&
+        ((unsigned long long)offset * 4096 + 5 <= pRegion->size);
+    if (valid) {
+        chunkLength = ((unsigned int)buf[0] << 24) | ((unsigned int)buf[1] << 16) | ((unsigned int)buf[2] << 8) | (unsigned int)buf[3];
+
+        // sanity check chunk size
+        valid = (chunkLength >= 1) && (chunkLength <= sectorNumber * 4096) && (chunkLength <= CHUNK_DEFLATE_MAX) &&
+            ((unsigned long long)offset * 4096 + 4 + chunkLength <= pRegion->size) &&
+            // only handle zlib-compressed chunks (v2)
+            (buf[4] == 2);
+    }
+    if (!valid) {
+        UNLOCK_REGIONS();
+        return NULL;
+    }
 
-    sectorNumber = buf[3]; // how many 4096B sectors the chunk takes up
-    offset = (buf[0] << 16) | (buf[1] << 8) | buf[2]; // 4KB sector the chunk is in
+    pRegion->pins++;
+    UNLOCK_REGIONS();
 
-    RERROR(offset == 0); // an empty chunk
+    *compressed = buf + 5;
+    *length = (int)chunkLength - 1;
+    return pRegion;
+}
 
-    RERROR(PortaSeek(regionFile, 4096 * offset));
+static void regionUnpin(RegionFile* pRegion)
+{
+    LOCK_REGIONS();
+    assert(pRegion->pins > 0);
+    pRegion->pins--;
+    UNLOCK_REGIONS();
+}
 
-    RERROR(sectorNumber * 4096 > CHUNK_DEFLATE_MAX);
+// Return the last-modified Unix time for the chunk, from the region file's header, or 0 if it does not exist
+unsigned int regionGetChunkTimestamp(const wchar_t* directory, int cx, int cz)
+{
+    unsigned int timestamp = 0;
+    LOCK_REGIONS();
+    RegionFile* pRegion = regionFind(directory, cx, cz);
+    if (pRegion != NULL && pRegion->exists)
+        timestamp = pRegion->timestamp[(cx & 31) + (cz & 31) * 32];
+    UNLOCK_REGIONS();
+    return timestamp;
+}
 
-    // read chunk in one shot
-    // this is faster than reading the header and data separately
-    RERROR(PortaRead(regionFile, buf, 4096 * sectorNumber));
+// Copy the timestamps of the width x height chunks starting at cx, cz, which must all be in one region, row by row;
+// 0 for each chunk that does not exist. Returns false if none of them do.
+bool regionGetChunkTimestamps(const wchar_t* directory, int cx, int cz, int width, int height, unsigned int* timestamps)
+{
+    assert((cx >> 5) == ((cx + width - 1) >> 5) && (cz >> 5) == ((cz + height - 1) >> 5));
+    bool any = false;
+    LOCK_REGIONS();
+    RegionFile* pRegion = regionFind(directory, cx, cz);
+    for (int z = 0; z < height; z++) {
+        for (int x = 0; x < width; x++) {
+            unsigned int timestamp = 0;
+            if (pRegion != NULL && pRegion->exists)
+                timestamp = pRegion->timestamp[((cx + x) & 31) + ((cz + z) & 31) * 32];
+            *timestamps++ = timestamp;
+            any = any || (timestamp != 0);
+        }
+    }
+    UNLOCK_REGIONS();
+    return any;
+}
 
-    chunkLength = (buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+RegionDecoder* regionNewDecoder()
+{
+    // all fields start zeroed; the inflate state and buffer are set up on first use
+    return (RegionDecoder*)calloc(1, sizeof(RegionDecoder));
+}
 
-    // sanity check chunk size
-    RERROR(chunkLength > sectorNumber * 4096 || chunkLength > CHUNK_DEFLATE_MAX);
+static void regionCleanupDecoder(RegionDecoder* pDecoder)
+{
+    if (pDecoder->strmInitialized) {
+        inflateEnd(&pDecoder->strm);
+        pDecoder->strmInitialized = 0;
+    }
+    if (pDecoder->out != NULL) {
+        free(pDecoder->out);
+        pDecoder->out = NULL;
+        pDecoder->outSize = 0;
+    }
+}
 
-    // only handle zlib-compressed chunks (v2)
-    RERROR(buf[4] != 2);
+void regionFreeDecoder(RegionDecoder* pDecoder)
+{
+    if (pDecoder == NULL)
+        return;
+    regionCleanupDecoder(pDecoder);
+    free(pDecoder);
+}
 
-    PortaClose(regionFile);
+static int regionPrepareBuffer(bfFile & bf, RegionDecoder* pDecoder, wchar_t* directory, int cx, int cz)
+{
+    const unsigned char* compressed;
+    int compressedLength;
 
-    // decompress chunk
+    int status;
+
+    if (pDecoder == NULL)
+        pDecoder = &gMainDecoder;
+
+    RegionFile* pRegion = regionPinChunk(directory, cx, cz, &compressed, &compressedLength);
+    if (pRegion == NULL)
+        return 0;
 
+    // decompress chunk, straight from the mapped file
 
-    if (!strm_initialized) {
+
+    if (!pDecoder->strmInitialized) {
         // we re-use dynamically allocated memory
-        strm.zalloc = (alloc_func)NULL;
-        strm.zfree = (free_func)NULL;
-        strm.opaque = NULL;
-        if (inflateInit(&strm) != Z_OK)
+        pDecoder->strm.zalloc = (alloc_func)NULL;
+        pDecoder->strm.zfree = (free_func)NULL;
+        pDecoder->strm.opaque = NULL;
+        if (inflateInit(&pDecoder->strm) != Z_OK) {
+            regionUnpin(pRegion);
             return ERROR_INFLATE;
-        strm_initialized = 1;
+        }
+        pDecoder->strmInitialized = 1;
     }
 
-    strm.next_out = out;
-    strm.avail_out = CHUNK_INFLATE_MAX;
-    strm.avail_in = chunkLength - 1;
-    strm.next_in = buf + 5;
-
-    inflateReset(&strm);
-    status = inflate(&strm, Z_FINISH); // decompress in one step
+    for (;;) {
+        if (pDecoder->out == NULL) {
+            pDecoder->out = (unsigned char*)malloc(CHUNK_INFLATE_START);
+            if (pDecoder->out == NULL) {
+                regionUnpin(pRegion);
+                return ERROR_INFLATE;
+            }
+            pDecoder->outSize = CHUNK_INFLATE_START;
+        }
+
+        pDecoder->strm.next_out = pDecoder->out;
+        pDecoder->strm.avail_out = pDecoder->outSize;
+        pDecoder->strm.avail_in = compressedLength;
+        // zlib's interface is not const-correct, but inflate never writes to its input
+        pDecoder->strm.next_in = (Bytef*)compressed;
+
+        inflateReset(&pDecoder->strm);
+        status = inflate(&pDecoder->strm, Z_FINISH); // decompress in one step
+
+        // out of room? Double the buffer and start over. Rare, almost all chunks are well under a MB.
+        if ((status == Z_BUF_ERROR || status == Z_OK) && pDecoder->strm.avail_out == 0 && pDecoder->outSize < CHUNK_INFLATE_MAX) {
+            int newSize = min(2 * pDecoder->outSize, CHUNK_INFLATE_MAX);
+            unsigned char* newOut = (unsigned char*)realloc(pDecoder->out, newSize);
+            if (newOut == NULL)
+                break;
+            pDecoder->out = newOut;
+            pDecoder->outSize = newSize;
+        }
+        else {
+            break;
+        }
+    }
+    regionUnpin(pRegion);
 
     if (status != Z_STREAM_END) // error inflating (not enough space? Increase CHUNK_INFLATE_MAX, ugh)
         return ERROR_INFLATE;
@@ -150,8 +442,8 @@ static int regionPrepareBuffer(bfFile & bf, wchar_t* directory, int cx, int cz)
     // the uncompressed chunk data is now in "out", with length strm.avail_out
 
     bf.type = BF_BUFFER;
-    bf.buf = out;
-    bf.buflen = CHUNK_INFLATE_MAX - (int)strm.avail_out;
+    bf.buf = pDecoder->out;
+    bf.buflen = pDecoder->outSize - (int)pDecoder->strm.avail_out;
     bf._offset = 0;
     bf.offset = &bf._offset;
 
@@ -160,16 +452,17 @@ static int regionPrepareBuffer(bfFile & bf, wchar_t* directory, int cx, int cz)
 }
 
 // directory: the base world directory, e.g. "/home/ryan/.minecraft/saves/World1/" - note the trailing "/" is in place
+// pDecoder: inflate state and buffer from regionNewDecoder(), one per thread; NULL for the main thread
 // cx, cz: the chunk's x and z offset
 // block: a 32KB buffer to write block data into
 // blockLight: a 16KB buffer to write block light into (not skylight)
 //
 // returns 1 on success, 0 on error or nothing found
-int regionGetBlocks(wchar_t* directory, int cx, int cz, unsigned char* block, unsigned char* data, unsigned char* blockLight, unsigned char* biome, BlockEntity* entities, int* numEntities, int mcVersion, int minHeight, int maxHeight, int & mfsHeight, char* unknownBlock, int unknownBlockID)
+int regionGetBlocks(RegionDecoder* pDecoder, wchar_t* directory, int cx, int cz, unsigned char* block, unsigned char* data, unsigned char* blockLight, unsigned char* biome, BlockEntity* entities, int* numEntities, int mcVersion, int minHeight, int maxHeight, int & mfsHeight, char* unknownBlock, int unknownBlockID)
 {
     bfFile bf;
 
-    int errCode = regionPrepareBuffer(bf, directory, cx, cz);
+    int errCode = regionPrepareBuffer(bf, pDecoder, directory, cx, cz);
     if (errCode <= 0) {
         // failed
         return errCode < 0 ? ERROR_INFLATE : 0;
@@ -182,7 +475,7 @@ int regionTestHeights(wchar_t* directory, int& minHeight, int& maxHeight, int mc
 {
     bfFile bf;
 
-    int errCode = regionPrepareBuffer(bf, directory, cx, cz);
+    int errCode = regionPrepareBuffer(bf, NULL, directory, cx, cz);
     if (errCode <= 0) {
         // failed
         return errCode < 0 ? ERROR_INFLATE : 0;
@@ -191,11 +484,24 @@ int regionTestHeights(wchar_t* directory, int& minHeight, int& maxHeight, int mc
     return nbtGetHeights(&bf, minHeight, maxHeight, mcVersion);
 }
 
-void regionCleanup()
+// Unmap the region files, and forget which ones were missing. Call at the end of each draw or export pass:
+// an open mapping keeps Minecraft from truncating or resizing the file, and goes stale once Minecraft rewrites it.
+void regionReleaseFiles()
 {
-    if (strm_initialized) {
-        inflateEnd(&strm);
-        strm_initialized = 0;
+    int i;
+    LOCK_REGIONS();
+    for (i = 0; i < REGION_CACHE_SLOTS; i++) {
+        // a pinned region is being read by some other thread right now, so leave it to the next pass
+        if (gRegionFiles[i].used && gRegionFiles[i].pins == 0)
+            regionClose(&gRegionFiles[i]);
     }
+    UNLOCK_REGIONS();
+}
+
+// Release all mapped region files and the main decoder; call when the world is closed.
+void regionCleanup()
+{
+    regionReleaseFiles();
+    regionCleanupDecoder(&gMainDecoder);
 }
 
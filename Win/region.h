@@ -30,6 +30,14 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 #define ERROR_INFLATE	-9876
 
-int regionGetBlocks(wchar_t* directory, int cx, int cz, unsigned char* block, unsigned char* data, unsigned char* blockLight, unsigned char* biome, BlockEntity* entities, int* numEntities, int mcVersion, int minHeight, int maxHeight, int& mfsHeight, char* unknownBlock, int unknownBlockID);
+// per-thread inflate state; opaque outside of region.cpp
+typedef struct RegionDecoder RegionDecoder;
+
+RegionDecoder* regionNewDecoder();
+void regionFreeDecoder(RegionDecoder* pDecoder);
+int regionGetBlocks(RegionDecoder* pDecoder, wchar_t* directory, int cx, int cz, unsigned char* block, unsigned char* data, unsigned char* blockLight, unsigned char* biome, BlockEntity* entities, int* numEntities, int mcVersion, int minHeight, int maxHeight, int& mfsHeight, char* unknownBlock, int unknownBlockID);
 int regionTestHeights(wchar_t* directory, int& minHeight, int& maxHeight, int mcVersion, int cx, int cz);
+unsigned int regionGetChunkTimestamp(const wchar_t* directory, int cx, int cz);
+bool regionGetChunkTimestamps(const wchar_t* directory, int cx, int cz, int width, int height, unsigned int* timestamps);
+void regionReleaseFiles();
 void regionCleanup();
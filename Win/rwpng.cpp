@@ -27,6 +27,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "stdafx.h"
 #include "rwpng.h"
+#include "parallelzip.h"
 
 #include <assert.h>
 
@@ -107,38 +108,105 @@ int readpngheader(progimage_info* im, wchar_t* filename, LodePNGColorType& color
     return 0;
 }
 
+// Compression settings for each PNG effort level.
+typedef struct PNGEffortSettings {
+    int zlibLevel;
+    LodePNGFilterStrategy filterStrategy;
+    unsigned autoConvert;   // let lodepng pick a smaller color type, which costs a pass over the pixels
+} PNGEffortSettings;
+
+static const PNGEffortSettings gPNGEffortSettings[PNG_EFFORT_SMALL + 1] = {
+    { 0, LFS_ZERO, 0 },     // PNG_EFFORT_STORE
+    { 1, LFS_FOUR, 0 },     // PNG_EFFORT_FAST: Paeth for every scanline, instead of trying all five filters
+    { 6, LFS_MINSUM, 1 },   // PNG_EFFORT_DEFAULT: lodepng's usual filter choice
+    { 9, LFS_MINSUM, 1 },   // PNG_EFFORT_SMALL
+};
+
+static int gPNGEffort = PNG_EFFORT_DEFAULT;
+
+// Big images are deflated in blocks on the worker threads, see DeflateBlocks().
+typedef struct PNGDeflateContext {
+    int level;
+    bool parallel;  // if false, we're already on a worker thread, so don't start more
+} PNGDeflateContext;
+
+static unsigned pngZlibCompress(unsigned char** out, size_t* outsize, const unsigned char* in, size_t insize, const LodePNGCompressSettings* settings);
+static bool parallelZlibCompress(unsigned char** out, size_t* outsize, const unsigned char* in, size_t insize, int level);
+static void writePNGTask(int taskIndex, int workerIndex, void* userData);
+
+void setpngeffort(int effort)
+{
+    gPNGEffort = clamp(effort, PNG_EFFORT_STORE, PNG_EFFORT_SMALL);
+}
+
+int getpngeffort()
+{
+    return gPNGEffort;
+}
+
 // from http://lodev.org/lodepng/example_encode.cpp
 
 //Encode from raw pixels to disk with a single function call
 //The image argument has width * height RGBA pixels or width * height * channels
 // return 0 on success
-int writepng(progimage_info *im, int channels, wchar_t *filename)
+int writepng(progimage_info *im, int channels, wchar_t *filename, bool parallelDeflate)
 {
-    //char filename[MAX_PATH];
-    //dumb_wcharToChar(wfilename,filename);
-
     //Encode the image, depending on type
-    unsigned int error = 1;	// 1 means didn't reach lodepng
+    LodePNGColorType colortype;
     if ( channels == 4 )
     {
         // 32 bit RGBA, the default
-        error = lodepng::encode(filename, im->image_data, (unsigned int)im->width, (unsigned int)im->height, LCT_RGBA );
+        colortype = LCT_RGBA;
     }
     else if ( channels == 3 )
     {
         // 24 bit RGB
-        error = lodepng::encode(filename, im->image_data, (unsigned int)im->width, (unsigned int)im->height, LCT_RGB );
+        colortype = LCT_RGB;
     }
     else if (channels == 1)
     {
         // 8 bit grayscale
-        error = lodepng::encode(filename, im->image_data, (unsigned int)im->width, (unsigned int)im->height, LCT_GREY);
+        colortype = LCT_GREY;
     }
     else
     {
         assert(0);
+        return 1;	// 1 means didn't reach lodepng
+    }
+    // same check lodepng::encode makes, error 84 being "image too small"
+    if (im->image_data.size() < (size_t)im->width * (size_t)im->height * (size_t)channels)
+    {
+        return 84;
     }
 
+    const PNGEffortSettings* pEffort = &gPNGEffortSettings[gPNGEffort];
+    PNGDeflateContext context;
+    context.level = pEffort->zlibLevel;
+    context.parallel = parallelDeflate;
+
+    LodePNGState state;
+    lodepng_state_init(&state);
+    state.info_raw.colortype = colortype;
+    state.info_raw.bitdepth = 8;
+    state.info_png.color.colortype = colortype;
+    state.info_png.color.bitdepth = 8;
+    state.encoder.auto_convert = pEffort->autoConvert;
+    state.encoder.filter_strategy = pEffort->filterStrategy;
+    // zlib's deflate is much faster than lodepng's own, and can be run in pieces on the workers
+    state.encoder.zlibsettings.custom_zlib = pngZlibCompress;
+    state.encoder.zlibsettings.custom_context = &context;
+
+    unsigned char* buffer = NULL;
+    size_t buffersize = 0;
+    unsigned int error = lodepng_encode(&buffer, &buffersize, im->image_data.empty() ? 0 : &im->image_data[0],
+        (unsigned int)im->width, (unsigned int)im->height, &state);
+    if (!error)
+    {
+        error = lodepng_save_file(buffer, buffersize, filename);
+    }
+    free(buffer);
+    lodepng_state_cleanup(&state);
+
     //if there's an error, display it
     if (error)
     {
@@ -149,6 +217,107 @@ int writepng(progimage_info *im, int channels, wchar_t *filename)
     return 0;
 }
 
+void writepngs(pngwrite_info* writes, int count)
+{
+    if (count == 1)
+    {
+        // a lone image can use all the workers for its deflate instead
+        writes[0].rc = writepng(writes[0].image, writes[0].channels, writes[0].filename);
+    }
+    else
+    {
+        RunWorkerTasks(count, writePNGTask, writes);
+    }
+}
+
+static void writePNGTask(int taskIndex, int workerIndex, void* userData)
+{
+    UNREFERENCED_PARAMETER(workerIndex);
+    pngwrite_info* pWrite = &((pngwrite_info*)userData)[taskIndex];
+    pWrite->rc = writepng(pWrite->image, pWrite->channels, pWrite->filename, false);
+}
+
+// lodepng's custom_zlib hook: make a zlib stream of the filtered image data, in memory lodepng will free()
+static unsigned pngZlibCompress(unsigned char** out, size_t* outsize, const unsigned char* in, size_t insize, const LodePNGCompressSettings* settings)
+{
+    const PNGDeflateContext* pContext = (const PNGDeflateContext*)settings->custom_context;
+    if (pContext->parallel && pContext->level > 0 && insize > 2 * DEFLATE_BLOCK_SIZE && GetWorkerCount() > 1)
+    {
+        if (parallelZlibCompress(out, outsize, in, insize, pContext->level))
+            return 0;
+        // else out of memory, most likely, so try it the simple way
+    }
+
+    uLong outLen = compressBound((uLong)insize);
+    *out = (unsigned char*)malloc(outLen);
+    if (*out == NULL)
+        return 83;  // lodepng's "memory allocation failed"
+    if (compress2(*out, &outLen, in, (uLong)insize, pContext->level) != Z_OK)
+    {
+        free(*out);
+        *out = NULL;
+        return 1;
+    }
+    *outsize = outLen;
+    return 0;
+}
+
+static bool parallelZlibCompress(unsigned char** out, size_t* outsize, const unsigned char* in, size_t insize, int level)
+{
+    int i;
+    int numBlocks = (int)((insize + DEFLATE_BLOCK_SIZE - 1) / DEFLATE_BLOCK_SIZE);
+    // two bytes of zlib header, the blocks, then four bytes of Adler-32 checksum
+    unsigned char* buffer = (unsigned char*)malloc(2 + (size_t)numBlocks * DEFLATE_BLOCK_OUT_SIZE + 4);
+    DeflateBlock* blocks = (DeflateBlock*)malloc(numBlocks * sizeof(DeflateBlock));
+    if (buffer == NULL || blocks == NULL)
+    {
+        free(buffer);
+        free(blocks);
+        return false;
+    }
+
+    for (i = 0; i < numBlocks; i++)
+    {
+        size_t offset = (size_t)i * DEFLATE_BLOCK_SIZE;
+        blocks[i].in = in + offset;
+        blocks[i].inLen = (unsigned int)min(insize - offset, (size_t)DEFLATE_BLOCK_SIZE);
+        blocks[i].dictLen = (unsigned int)min(offset, (size_t)DEFLATE_DICT_SIZE);
+        blocks[i].out = buffer + 2 + (size_t)i * DEFLATE_BLOCK_OUT_SIZE;
+        blocks[i].last = (i == numBlocks - 1);
+    }
+    if (!DeflateBlocks(blocks, numBlocks, level, false))
+    {
+        free(buffer);
+        free(blocks);
+        return false;
+    }
+
+    // zlib header: deflate with a 32K window, with the level noted the way zlib does it
+    unsigned int header = (0x78 << 8) | ((level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3))) << 6);
+    header += 31 - (header % 31);
+    buffer[0] = (unsigned char)(header >> 8);
+    buffer[1] = (unsigned char)header;
+
+    // close up the gaps between the blocks' outputs, which are in order, so only ever move down
+    size_t len = 2;
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (i = 0; i < numBlocks; i++)
+    {
+        memmove(buffer + len, blocks[i].out, blocks[i].outLen);
+        len += blocks[i].outLen;
+        adler = adler32_combine(adler, blocks[i].check, (z_off_t)blocks[i].inLen);
+    }
+    free(blocks);
+
+    buffer[len++] = (unsigned char)(adler >> 24);
+    buffer[len++] = (unsigned char)(adler >> 16);
+    buffer[len++] = (unsigned char)(adler >> 8);
+    buffer[len++] = (unsigned char)adler;
+    *out = buffer;
+    *outsize = len;
+    return true;
+}
+
 
 void writepng_cleanup(progimage_info *im)
 {
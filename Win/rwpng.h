@@ -39,7 +39,27 @@ int readpng(progimage_info *mainprog_ptr, wchar_t *filename, LodePNGColorType co
 void readpng_cleanup(int free_image_data, progimage_info *mainprog_ptr);
 int readpngheader(progimage_info* im, wchar_t* filename, LodePNGColorType& colortype);
 
-int writepng(progimage_info *mainprog_ptr, int channels, wchar_t *filename);
+// How hard writepng() works to make small files. The lower levels are much faster on big
+// textures, handy when iterating on an export, but the files are larger.
+#define PNG_EFFORT_STORE    0   // no compression at all
+#define PNG_EFFORT_FAST     1
+#define PNG_EFFORT_DEFAULT  2
+#define PNG_EFFORT_SMALL    3
+
+void setpngeffort(int effort);
+int getpngeffort();
+
+typedef struct _pngwrite_info {
+    progimage_info* image;
+    int channels;
+    wchar_t* filename;
+    int rc;     // what writepng() would have returned
+} pngwrite_info;
+
+// parallelDeflate splits big images up over the worker threads; pass false if already on one
+int writepng(progimage_info *mainprog_ptr, int channels, wchar_t *filename, bool parallelDeflate = true);
+// write a set of different images to different files, in parallel
+void writepngs(pngwrite_info* writes, int count);
 void writepng_cleanup(progimage_info *mainprog_ptr);
 
 progimage_info* allocateGrayscaleImage(progimage_info* source_ptr);
@@ -49,6 +49,7 @@ THE POSSIBILITY OF SUCH DAMAGE.
 #include "nbt.h"
 #include "region.h"
 #include "terrainExtData.h"
+#include "workers.h"
 
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 // Windows Header Files:
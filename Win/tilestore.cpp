@@ -0,0 +1,423 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+#include "tilestore.h"
+#include <ShlObj.h>
+#include <assert.h>
+
+// each loaded file costs about 1 MB, mostly for its tiles
+#ifndef MINEWAYS_X64
+#define TILE_STORE_SLOTS 8
+#else
+#define TILE_STORE_SLOTS 32
+#endif
+
+#define TILE_REGION_CHUNKS 1024
+#define TILE_BYTES (16 * 16 * 4)
+
+// bump this if a tile's contents change in any way the settings number doesn't capture
+#define TILE_FILE_VERSION 1
+
+typedef struct TileFileHeader {
+    char magic[4];          // "MWTS"
+    unsigned int version;
+} TileFileHeader;
+
+typedef struct TileEntry {
+    unsigned int settings;      // 0 means no tile
+    unsigned int timestamp;     // region timestamps of the chunk and of the chunk to its west when drawn, or whatever the caller keys on
+    unsigned int westTimestamp;
+    short eastHeights[16];      // level 0 only
+} TileEntry;
+
+// one file's worth of tiles: at level 0, one region
+typedef struct TileRegion {
+    bool used;
+    bool loading;           // being read in by the thread that took the slot; others wanting it wait, see tileRegionFind()
+    bool dirty;             // changed since read in
+    bool readOnly;          // couldn't be written, e.g., the disk is full; don't keep trying
+    int level;
+    int rx, rz;
+    wchar_t directory[MAX_PATH_AND_FILE];
+    TileEntry entry[TILE_REGION_CHUNKS];
+    unsigned char* tiles;   // TILE_REGION_CHUNKS tiles, NULL until there's at least one
+    unsigned int lastUse;
+} TileRegion;
+
+static TileRegion gTileRegions[TILE_STORE_SLOTS];
+static unsigned int gTileUseCounter = 0;
+
+// Tile files go in the user's local application data, %LOCALAPPDATA%\Mineways\tiles, in a directory for each dimension
+// named by a hash of the dimension's path, so that nothing is ever written to a world's save folder. Set on first use;
+// empty if there's no such folder, in which case nothing is read or saved.
+static bool gTileRootFound = false;
+static wchar_t gTileRoot[MAX_PATH_AND_FILE];
+
+// The table lock guards the table. Tile files are read and written with the table unlocked, so that threads finding
+// tiles in files already loaded don't wait on the disk: a thread reading a file in marks its slot as loading, and any
+// thread wanting that file waits for the read to finish. The file lock is held shared while reading a tile file and
+// exclusive while writing them: a file is written after the table is unlocked, and the file lock, taken while the table
+// is still locked, makes any later read of that file wait for the write to finish. Always lock the table first, and
+// never lock the table while holding the file lock.
+#ifdef WIN32
+static SRWLOCK gTileLock = SRWLOCK_INIT;
+static SRWLOCK gTileFileLock = SRWLOCK_INIT;
+static CONDITION_VARIABLE gTileLoaded = CONDITION_VARIABLE_INIT;
+#define LOCK_TILES()      AcquireSRWLockExclusive(&gTileLock)
+#define UNLOCK_TILES()    ReleaseSRWLockExclusive(&gTileLock)
+#define LOCK_TILE_FILES()     AcquireSRWLockExclusive(&gTileFileLock)
+#define UNLOCK_TILE_FILES()   ReleaseSRWLockExclusive(&gTileFileLock)
+#define LOCK_TILE_FILES_SHARED()     AcquireSRWLockShared(&gTileFileLock)
+#define UNLOCK_TILE_FILES_SHARED()   ReleaseSRWLockShared(&gTileFileLock)
+// with the table locked, wait for some slot to finish loading
+#define WAIT_TILES_LOADED()     SleepConditionVariableSRW(&gTileLoaded, &gTileLock, INFINITE, 0)
+#define WAKE_TILES_LOADED()     WakeAllConditionVariable(&gTileLoaded)
+#else
+#define LOCK_TILES()
+#define UNLOCK_TILES()
+#define LOCK_TILE_FILES()
+#define UNLOCK_TILE_FILES()
+#define LOCK_TILE_FILES_SHARED()
+#define UNLOCK_TILE_FILES_SHARED()
+#define WAIT_TILES_LOADED()
+#define WAKE_TILES_LOADED()
+#endif
+
+static bool readAll(PORTAFILE file, void* buffer, DWORD length)
+{
+    DWORD br;
+    return !(PortaRead(file, buffer, length)) && br == length;
+}
+
+static bool writeAll(PORTAFILE file, const void* buffer, DWORD length)
+{
+    DWORD br;
+    return !(PortaWrite(file, buffer, length)) && br == length;
+}
+
+// Must be called with the table locked.
+static void findTileRoot()
+{
+    if (gTileRootFound)
+        return;
+    gTileRootFound = true;
+    gTileRoot[0] = 0;
+    wchar_t path[MAX_PATH];
+    if (SUCCEEDED(SHGetFolderPathW(NULL, CSIDL_LOCAL_APPDATA | CSIDL_FLAG_CREATE, NULL, 0, path)))
+        swprintf_s(gTileRoot, MAX_PATH_AND_FILE, L"%s\\Mineways", path);
+}
+
+// the directory holding the dimension's tile files
+static void tileDirectoryName(wchar_t* dirname, const wchar_t* directory)
+{
+    // FNV-1a, 64 bits, of the path, ignoring case and which way the slashes lean
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const wchar_t* pChar = directory; *pChar; pChar++) {
+        wchar_t ch = towlower(*pChar);
+        hash ^= (ch == L'/') ? L'\\' : ch;
+        hash *= 1099511628211ULL;
+    }
+    swprintf_s(dirname, MAX_PATH_AND_FILE, L"%s\\tiles\\%016llx", gTileRoot, hash);
+}
+
+static void tileRegionFileName(wchar_t* filename, TileRegion* pRegion)
+{
+    wchar_t dirname[MAX_PATH_AND_FILE];
+    tileDirectoryName(dirname, pRegion->directory);
+    if (pRegion->level == 0)
+        swprintf_s(filename, MAX_PATH_AND_FILE, L"%s\\t.%d.%d.mwt", dirname, pRegion->rx, pRegion->rz);
+    else
+        swprintf_s(filename, MAX_PATH_AND_FILE, L"%s\\lod%d.%d.%d.mwt", dirname, pRegion->level, pRegion->rx, pRegion->rz);
+}
+
+// read in the region's tiles, if saved earlier; anything unexpected means starting over with no tiles
+static void tileRegionRead(TileRegion* pRegion)
+{
+    wchar_t filename[MAX_PATH_AND_FILE];
+    tileRegionFileName(filename, pRegion);
+    memset(pRegion->entry, 0, sizeof(pRegion->entry));
+
+    PORTAFILE file = PortaOpen(filename);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    TileFileHeader header;
+    bool ok = readAll(file, &header, sizeof(TileFileHeader)) &&
+        memcmp(header.magic, "MWTS", 4) == 0 && header.version == TILE_FILE_VERSION &&
+        readAll(file, pRegion->entry, sizeof(pRegion->entry));
+    if (ok) {
+        pRegion->tiles = (unsigned char*)malloc(TILE_REGION_CHUNKS * TILE_BYTES);
+        ok = (pRegion->tiles != NULL) && readAll(file, pRegion->tiles, TILE_REGION_CHUNKS * TILE_BYTES);
+    }
+    PortaClose(file);
+    if (!ok) {
+        memset(pRegion->entry, 0, sizeof(pRegion->entry));
+        free(pRegion->tiles);
+        pRegion->tiles = NULL;
+    }
+}
+
+static bool makeDirectory(const wchar_t* path)
+{
+    return CreateDirectoryW(path, NULL) || ERROR_ALREADY_EXISTS == GetLastError();
+}
+
+static void tileRegionWrite(TileRegion* pRegion)
+{
+    wchar_t filename[MAX_PATH_AND_FILE];
+    wchar_t dirname[MAX_PATH_AND_FILE];
+    swprintf_s(filename, MAX_PATH_AND_FILE, L"%s\\tiles", gTileRoot);
+    tileDirectoryName(dirname, pRegion->directory);
+    if (!(makeDirectory(gTileRoot) && makeDirectory(filename) && makeDirectory(dirname))) {
+        pRegion->readOnly = true;
+        return;
+    }
+    tileRegionFileName(filename, pRegion);
+    PORTAFILE file = PortaCreate(filename);
+    if (file == INVALID_HANDLE_VALUE) {
+        pRegion->readOnly = true;
+        return;
+    }
+    TileFileHeader header;
+    memcpy(header.magic, "MWTS", 4);
+    header.version = TILE_FILE_VERSION;
+    bool ok = writeAll(file, &header, sizeof(TileFileHeader)) &&
+        writeAll(file, pRegion->entry, sizeof(pRegion->entry)) &&
+        writeAll(file, pRegion->tiles, TILE_REGION_CHUNKS * TILE_BYTES);
+    PortaClose(file);
+    if (!ok) {
+        // don't leave a partial file around to be read next time
+        DeleteFileW(filename);
+        pRegion->readOnly = true;
+    }
+}
+
+// Free the slot. If it needs writing, it's moved to a copy that is returned, to be written once the table is unlocked;
+// NULL if there's nothing to write. Must be called with the table locked.
+static TileRegion* tileRegionClose(TileRegion* pRegion)
+{
+    TileRegion* pWrite = NULL;
+    if (pRegion->dirty && !pRegion->readOnly && pRegion->tiles != NULL) {
+        pWrite = (TileRegion*)malloc(sizeof(TileRegion));
+        if (pWrite != NULL) {
+            memcpy(pWrite, pRegion, sizeof(TileRegion));
+            pRegion->tiles = NULL;
+        }
+        else {
+            // out of memory, so write it now
+            LOCK_TILE_FILES();
+            tileRegionWrite(pRegion);
+            UNLOCK_TILE_FILES();
+        }
+    }
+    free(pRegion->tiles);
+    pRegion->tiles = NULL;
+    pRegion->used = false;
+    pRegion->dirty = false;
+    pRegion->readOnly = false;
+    return pWrite;
+}
+
+// Unlock the table, then write and free the copies tileRegionClose() returned; NULL entries are skipped.
+static void unlockTilesAndWrite(TileRegion** writes, int numWrites)
+{
+    int i;
+    for (i = 0; i < numWrites && writes[i] == NULL; i++)
+        ;
+    if (i == numWrites) {
+        UNLOCK_TILES();
+        return;
+    }
+    LOCK_TILE_FILES();
+    UNLOCK_TILES();
+    for (; i < numWrites; i++) {
+        if (writes[i] != NULL) {
+            tileRegionWrite(writes[i]);
+            free(writes[i]->tiles);
+            free(writes[i]);
+        }
+    }
+    UNLOCK_TILE_FILES();
+}
+
+// Find the file holding tile tx, tz of the level. Must be called with the table locked. If the file is being read in
+// by another thread, this waits for it. If it's not in the table, the least recently used slot that's not loading is
+// taken for it and marked as loading, for the caller to read in; if a changed file had to be pushed out to make room,
+// pWrite is set to it, else to NULL, see tileRegionClose().
+static TileRegion* tileRegionFind(const wchar_t* directory, int level, int tx, int tz, TileRegion** pWrite)
+{
+    int i;
+    int rx = tx >> 5;
+    int rz = tz >> 5;
+    *pWrite = NULL;
+
+    for (;;) {
+        TileRegion* pOldest = NULL;
+        TileRegion* pFound = NULL;
+        for (i = 0; i < TILE_STORE_SLOTS; i++) {
+            TileRegion* pRegion = &gTileRegions[i];
+            if (pRegion->used) {
+                if (pRegion->rx == rx && pRegion->rz == rz && pRegion->level == level && wcscmp(pRegion->directory, directory) == 0) {
+                    pFound = pRegion;
+                    break;
+                }
+                if (!pRegion->loading && (pOldest == NULL || (pOldest->used && pRegion->lastUse < pOldest->lastUse)))
+                    pOldest = pRegion;
+            }
+            else if (pOldest == NULL || pOldest->used) {
+                // an empty slot beats any used one
+                pOldest = pRegion;
+            }
+        }
+
+        if (pFound != NULL) {
+            if (!pFound->loading) {
+                pFound->lastUse = ++gTileUseCounter;
+                return pFound;
+            }
+        }
+        else if (pOldest != NULL) {
+            // not found, so replace the least recently used slot
+            if (pOldest->used)
+                *pWrite = tileRegionClose(pOldest);
+            pOldest->used = true;
+            pOldest->loading = true;
+            pOldest->level = level;
+            pOldest->rx = rx;
+            pOldest->rz = rz;
+            wcscpy_s(pOldest->directory, MAX_PATH_AND_FILE, directory);
+            pOldest->lastUse = ++gTileUseCounter;
+            return pOldest;
+        }
+        // the file is being read in, or every slot is, so wait and look again
+        WAIT_TILES_LOADED();
+    }
+}
+
+// Lock the table and find the file holding tile tx, tz of the level, reading it in, with the table unlocked, if it's
+// not loaded yet. Returns with the table locked.
+static TileRegion* lockTilesAndFind(const wchar_t* directory, int level, int tx, int tz)
+{
+    TileRegion* pWrite;
+    LOCK_TILES();
+    findTileRoot();
+    TileRegion* pRegion = tileRegionFind(directory, level, tx, tz, &pWrite);
+    if (pRegion->loading) {
+        // the slot is ours to fill; no other thread touches it until it's no longer loading
+        unlockTilesAndWrite(&pWrite, 1);
+        if (gTileRoot[0]) {
+            LOCK_TILE_FILES_SHARED();
+            tileRegionRead(pRegion);
+            UNLOCK_TILE_FILES_SHARED();
+        }
+        else {
+            memset(pRegion->entry, 0, sizeof(pRegion->entry));
+            pRegion->readOnly = true;
+        }
+        LOCK_TILES();
+        pRegion->loading = false;
+        WAKE_TILES_LOADED();
+    }
+    return pRegion;
+}
+
+bool tileStoreFindTile(const wchar_t* directory, int level, int tx, int tz, unsigned int settings, unsigned int timestamp, unsigned int westTimestamp, unsigned char* tile)
+{
+    assert(settings != 0);
+    bool found = false;
+    TileRegion* pRegion = lockTilesAndFind(directory, level, tx, tz);
+    int index = (tx & 31) + (tz & 31) * 32;
+    TileEntry* pEntry = &pRegion->entry[index];
+    if (pRegion->tiles != NULL && pEntry->settings == settings && pEntry->timestamp == timestamp && pEntry->westTimestamp == westTimestamp) {
+        if (tile != NULL)
+            memcpy(tile, pRegion->tiles + index * TILE_BYTES, TILE_BYTES);
+        found = true;
+    }
+    UNLOCK_TILES();
+    return found;
+}
+
+bool tileStoreFindEastHeights(const wchar_t* directory, int bx, int bz, unsigned int settings, unsigned int timestamp, short* eastHeights)
+{
+    assert(settings != 0);
+    bool found = false;
+    TileRegion* pRegion = lockTilesAndFind(directory, 0, bx, bz);
+    TileEntry* pEntry = &pRegion->entry[(bx & 31) + (bz & 31) * 32];
+    if (pRegion->tiles != NULL && pEntry->settings == settings && pEntry->timestamp == timestamp) {
+        memcpy(eastHeights, pEntry->eastHeights, sizeof(pEntry->eastHeights));
+        found = true;
+    }
+    UNLOCK_TILES();
+    return found;
+}
+
+void tileStoreSave(const wchar_t* directory, int level, int tx, int tz, unsigned int settings, unsigned int timestamp, unsigned int westTimestamp, const unsigned char* tile, const short* eastHeights)
+{
+    assert(settings != 0);
+    TileEntry newEntry;
+    memset(&newEntry, 0, sizeof(TileEntry));
+    newEntry.settings = settings;
+    newEntry.timestamp = timestamp;
+    newEntry.westTimestamp = westTimestamp;
+    if (eastHeights != NULL)
+        memcpy(newEntry.eastHeights, eastHeights, sizeof(newEntry.eastHeights));
+
+    TileRegion* pRegion = lockTilesAndFind(directory, level, tx, tz);
+    if (pRegion->tiles == NULL && !pRegion->readOnly)
+        pRegion->tiles = (unsigned char*)calloc(TILE_REGION_CHUNKS, TILE_BYTES);
+    if (pRegion->tiles != NULL && !pRegion->readOnly) {
+        int index = (tx & 31) + (tz & 31) * 32;
+        unsigned char* pTile = pRegion->tiles + index * TILE_BYTES;
+        // the same tile is often drawn again, e.g., when the map is redrawn with nothing changed; don't rewrite the file for it
+        if (memcmp(&pRegion->entry[index], &newEntry, sizeof(TileEntry)) != 0 || memcmp(pTile, tile, TILE_BYTES) != 0) {
+            memcpy(&pRegion->entry[index], &newEntry, sizeof(TileEntry));
+            memcpy(pTile, tile, TILE_BYTES);
+            pRegion->dirty = true;
+        }
+    }
+    UNLOCK_TILES();
+}
+
+void tileStoreClose()
+{
+    TileRegion* writes[TILE_STORE_SLOTS];
+    int i;
+    bool loading;
+    LOCK_TILES();
+    // let any reads in progress finish
+    do {
+        loading = false;
+        for (i = 0; i < TILE_STORE_SLOTS; i++)
+            loading = loading || gTileRegions[i].loading;
+        if (loading)
+            WAIT_TILES_LOADED();
+    } while (loading);
+    for (i = 0; i < TILE_STORE_SLOTS; i++) {
+        writes[i] = gTileRegions[i].used ? tileRegionClose(&gTileRegions[i]) : NULL;
+    }
+    unlockTilesAndWrite(writes, TILE_STORE_SLOTS);
+}
@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Map tiles, as drawn, saved in %LOCALAPPDATA%\Mineways\tiles, in a directory named by a hash of the dimension's
+// directory, so that nothing is written into the world save itself and so that
+// chunks drawn in an earlier session need not be read in and decoded again just to show them on the map.
+// Level 0 tiles are chunks. A tile at level L covers 2^L x 2^L chunks, shrunk to the same 16x16 pixels, for zoomed
+// out views; its x,z are chunk x,z divided by 2^L. A tile is good only for the settings it was drawn with, which the
+// caller boils down to a single nonzero number, and for the two timestamps given, e.g., of the chunk's and its west
+// neighbor's region file entries, as a chunk's shading depends on the heights of the chunk to its west.
+// Files hold 32x32 tiles of one level, so a region's worth at level 0; they are read in whole on first use and written
+// back when pushed out of the small table of loaded files, or when closed. All calls are thread-safe; a thread
+// needing a file that another thread is reading in waits for that file only.
+
+// Copy the 16x16 RGBA tile tx,tz of the level to tile and return true, if there's one with these settings and timestamps.
+// Pass in NULL for tile to just check.
+bool tileStoreFindTile(const wchar_t* directory, int level, int tx, int tz, unsigned int settings, unsigned int timestamp, unsigned int westTimestamp, unsigned char* tile);
+// Copy the 16 heights along the east edge of chunk bx,bz, those the chunk to its east is shaded by, if there's a tile
+// with these settings and timestamp. The heights don't depend on the chunk to the west.
+bool tileStoreFindEastHeights(const wchar_t* directory, int bx, int bz, unsigned int settings, unsigned int timestamp, short* eastHeights);
+// Save the tile, replacing what's there. eastHeights is for level 0 and may be NULL otherwise.
+void tileStoreSave(const wchar_t* directory, int level, int tx, int tz, unsigned int settings, unsigned int timestamp, unsigned int westTimestamp, const unsigned char* tile, const short* eastHeights);
+// Write out all changed files and free everything.
+void tileStoreClose();
@@ -0,0 +1,246 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define UNPACK_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// widest index the SIMD paths handle: with the index's lowest bit anywhere in a byte, it must fit in 16 bits
+#define SIMD_MAX_BITS 9
+
+#define UNPACK_LEVEL_SCALAR 0
+#define UNPACK_LEVEL_SSSE3  1
+#define UNPACK_LEVEL_AVX2   2
+
+static int gUnpackLevel = -1;       // -1 until the processor is checked
+static int gMaxUnpackLevel = -1;
+
+#ifdef UNPACK_SIMD
+// For each index width and each starting index within a long, how to unpack the next 8 indices from the
+// 16 bytes starting at that long: which two bytes go into each 16-bit lane (the shuffle also does the
+// big-endian swap), and what to multiply the lane by so that the index's lowest bit lands at bit 7.
+typedef struct UnpackPattern {
+    __m128i shuffle;
+    __m128i multiplier;
+} UnpackPattern;
+
+// bits 1 to 9 have 64, 32, 21, 16, 12, 10, 9, 8, 7 indices per long
+static UnpackPattern gPatterns[SIMD_MAX_BITS + 1][64];
+
+static void makePatterns()
+{
+    for (int bits = 1; bits <= SIMD_MAX_BITS; bits++) {
+        int perLong = 64 / bits;
+        for (int start = 0; start < perLong; start++) {
+            unsigned char shuffle[16];
+            unsigned short multiplier[8];
+            for (int lane = 0; lane < 8; lane++) {
+                // long 0 or 1 of the 16 bytes, and the index within that long
+                int whichLong = (start + lane) / perLong;
+                int bitOffset = ((start + lane) % perLong) * bits;
+                int lowByte = bitOffset >> 3;
+                // the byte of significance b of a long is stored at offset 7 - b
+                shuffle[2 * lane] = (unsigned char)(whichLong * 8 + 7 - lowByte);
+                // 0x80 zeroes the lane's high byte; if the index starts in the top byte, it's all in there
+                shuffle[2 * lane + 1] = (lowByte < 7) ? (unsigned char)(whichLong * 8 + 6 - lowByte) : 0x80;
+                multiplier[lane] = (unsigned short)(1 << (7 - (bitOffset & 7)));
+            }
+            gPatterns[bits][start].shuffle = _mm_loadu_si128((const __m128i*)shuffle);
+            gPatterns[bits][start].multiplier = _mm_loadu_si128((const __m128i*)multiplier);
+        }
+    }
+}
+
+static void cpuid(int info[4], int leaf)
+{
+#ifdef _MSC_VER
+    __cpuidex(info, leaf, 0);
+#else
+    __asm__ __volatile__("cpuid" : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3]) : "a"(leaf), "c"(0));
+#endif
+}
+
+static unsigned long long xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static int detectUnpackLevel()
+{
+    int info[4];
+    cpuid(info, 0);
+    int maxLeaf = info[0];
+    cpuid(info, 1);
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave) {
+        // the OS must save the YMM registers, too
+        unsigned long long xcr0 = xgetbv0();
+        if ((xcr0 & 6) == 6) {
+            cpuid(info, 7);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+    }
+    return avx2 ? UNPACK_LEVEL_AVX2 : (ssse3 ? UNPACK_LEVEL_SSSE3 : UNPACK_LEVEL_SCALAR);
+}
+#endif
+
+static void initUnpack()
+{
+    if (gMaxUnpackLevel < 0) {
+#ifdef UNPACK_SIMD
+        makePatterns();
+        gMaxUnpackLevel = detectUnpackLevel();
+#else
+        gMaxUnpackLevel = UNPACK_LEVEL_SCALAR;
+#endif
+        if (gUnpackLevel < 0)
+            gUnpackLevel = gMaxUnpackLevel;
+    }
+}
+
+int GetUnpackLevel()
+{
+    initUnpack();
+    return gUnpackLevel;
+}
+
+void SetUnpackLevel(int level)
+{
+    initUnpack();
+    gUnpackLevel = clamp(level, UNPACK_LEVEL_SCALAR, gMaxUnpackLevel);
+}
+
+// unpack indices from first to count - 1
+static void unpackScalar(const unsigned char* packed, int numLongs, int bits, int first, int count, unsigned short* indices)
+{
+    int perLong = 64 / bits;
+    unsigned long long mask = (1ULL << bits) - 1;
+    int whichLong = first / perLong;
+    int i = first;
+    int skip = first % perLong;
+    for (; i < count && whichLong < numLongs; whichLong++) {
+        const unsigned char* p = packed + 8 * whichLong;
+        unsigned long long value = 0;
+        for (int b = 0; b < 8; b++) {
+            value = (value << 8) | p[b];
+        }
+        value >>= skip * bits;
+        for (int j = skip; j < perLong && i < count; j++, i++) {
+            indices[i] = (unsigned short)(value & mask);
+            value >>= bits;
+        }
+        skip = 0;
+    }
+    // ran out of data
+    for (; i < count; i++) {
+        indices[i] = 0;
+    }
+}
+
+#ifdef UNPACK_SIMD
+// MSVC needs no flags to use any intrinsics; gcc and clang need to be told, per function
+#ifdef _MSC_VER
+#define SSSE3_FUNCTION
+#define AVX2_FUNCTION
+#else
+#define SSSE3_FUNCTION __attribute__((target("ssse3")))
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+// Returns how many indices were unpacked, a multiple of 8; the rest is left for unpackScalar().
+SSSE3_FUNCTION static int unpackSSSE3(const unsigned char* packed, int numLongs, int bits, int count, unsigned short* indices)
+{
+    int perLong = 64 / bits;
+    __m128i mask = _mm_set1_epi16((short)((1 << bits) - 1));
+    int i;
+    // each group of 8 reads the 16 bytes from the long where it starts
+    for (i = 0; i + 8 <= count && (i / perLong) + 2 <= numLongs; i += 8) {
+        const UnpackPattern* pPattern = &gPatterns[bits][i % perLong];
+        __m128i v = _mm_loadu_si128((const __m128i*)(packed + 8 * (i / perLong)));
+        v = _mm_shuffle_epi8(v, pPattern->shuffle);
+        v = _mm_mullo_epi16(v, pPattern->multiplier);
+        v = _mm_and_si128(_mm_srli_epi16(v, 7), mask);
+        _mm_storeu_si128((__m128i*)(indices + i), v);
+    }
+    return i;
+}
+
+// As unpackSSSE3(), 16 indices at a time
+AVX2_FUNCTION static int unpackAVX2(const unsigned char* packed, int numLongs, int bits, int count, unsigned short* indices)
+{
+    int perLong = 64 / bits;
+    __m256i mask = _mm256_set1_epi16((short)((1 << bits) - 1));
+    int i;
+    for (i = 0; i + 16 <= count && ((i + 8) / perLong) + 2 <= numLongs; i += 16) {
+        const UnpackPattern* pLow = &gPatterns[bits][i % perLong];
+        const UnpackPattern* pHigh = &gPatterns[bits][(i + 8) % perLong];
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(packed + 8 * (i / perLong)))),
+            _mm_loadu_si128((const __m128i*)(packed + 8 * ((i + 8) / perLong))), 1);
+        __m256i shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(pLow->shuffle), pHigh->shuffle, 1);
+        __m256i multiplier = _mm256_inserti128_si256(_mm256_castsi128_si256(pLow->multiplier), pHigh->multiplier, 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_mullo_epi16(v, multiplier);
+        v = _mm256_and_si256(_mm256_srli_epi16(v, 7), mask);
+        _mm256_storeu_si256((__m256i*)(indices + i), v);
+    }
+    return i;
+}
+#endif
+
+void UnpackPaletteIndices(const unsigned char* packed, int numLongs, int bits, int count, unsigned short* indices)
+{
+    initUnpack();
+    if (bits < 1 || bits > 16) {
+        // not a valid width; treat as no data
+        memset(indices, 0, count * sizeof(unsigned short));
+        return;
+    }
+    int done = 0;
+#ifdef UNPACK_SIMD
+    if (bits <= SIMD_MAX_BITS) {
+        if (gUnpackLevel >= UNPACK_LEVEL_AVX2)
+            done = unpackAVX2(packed, numLongs, bits, count, indices);
+        else if (gUnpackLevel >= UNPACK_LEVEL_SSSE3)
+            done = unpackSSSE3(packed, numLongs, bits, count, indices);
+    }
+#endif
+    unpackScalar(packed, numLongs, bits, done, count, indices);
+}
@@ -0,0 +1,43 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Unpacking of the palette indices in 1.16 and later BlockStates and biome "data" long arrays. Each long holds
+// as many whole indices as fit, starting at its low bits, so no index spans two longs; the longs are as read
+// from the NBT file, i.e., big-endian. For 4, 8 and 16 bits this is also the 1.13-1.15 layout.
+// Indices of up to 9 bits, which covers MAX_PALETTE, are unpacked with AVX2 or SSSE3 when the processor has
+// them, else and for wider indices with plain C.
+
+// Unpack count indices, each bits wide (1 to 16), from the numLongs longs in packed. Indices that would be
+// past the end of packed are returned as 0.
+void UnpackPaletteIndices(const unsigned char* packed, int numLongs, int bits, int count, unsigned short* indices);
+
+// What UnpackPaletteIndices() will use: 2 for AVX2, 1 for SSSE3, 0 for plain C.
+int GetUnpackLevel();
+// Lower the level used, e.g., 0 to compare against plain C. Levels the processor doesn't support are ignored.
+void SetUnpackLevel(int level);
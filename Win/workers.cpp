@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "stdafx.h"
+
+static int gWorkerCount = 0;    // 0 means not yet determined
+
+typedef struct WorkerJob {
+    WorkerTask task;
+    void* userData;
+    int numTasks;
+    volatile LONG nextTask;
+} WorkerJob;
+
+typedef struct WorkerThread {
+    WorkerJob* pJob;
+    int workerIndex;
+} WorkerThread;
+
+static void runTasks(WorkerJob* pJob, int workerIndex)
+{
+    for (;;) {
+        // grab the next task not yet taken by some worker
+        int taskIndex = (int)InterlockedIncrement(&pJob->nextTask) - 1;
+        if (taskIndex >= pJob->numTasks)
+            break;
+        pJob->task(taskIndex, workerIndex, pJob->userData);
+    }
+}
+
+static DWORD WINAPI workerThreadFunc(LPVOID lpParam)
+{
+    WorkerThread* pThread = (WorkerThread*)lpParam;
+    runTasks(pThread->pJob, pThread->workerIndex);
+    return 0;
+}
+
+int GetWorkerCount()
+{
+    if (gWorkerCount <= 0) {
+        SYSTEM_INFO sysInfo;
+        GetSystemInfo(&sysInfo);
+        gWorkerCount = (int)sysInfo.dwNumberOfProcessors;
+#ifndef MINEWAYS_X64
+        // each worker holds per-thread scratch buffers, and 32 bits runs out of address space quickly
+        gWorkerCount = min(gWorkerCount, 4);
+#endif
+        gWorkerCount = clamp(gWorkerCount, 1, MAX_WORKERS);
+    }
+    return gWorkerCount;
+}
+
+void SetWorkerCount(int count)
+{
+    // 0 will make GetWorkerCount() figure it out again
+    gWorkerCount = clamp(count, 0, MAX_WORKERS);
+}
+
+void RunWorkerTasks(int numTasks, WorkerTask task, void* userData, int maxWorkers)
+{
+    int i;
+    if (numTasks <= 0)
+        return;
+
+    int numWorkers = GetWorkerCount();
+    if (maxWorkers > 0 && maxWorkers < numWorkers)
+        numWorkers = maxWorkers;
+    if (numWorkers > numTasks)
+        numWorkers = numTasks;
+
+    WorkerJob job;
+    job.task = task;
+    job.userData = userData;
+    job.numTasks = numTasks;
+    job.nextTask = 0;
+
+    WorkerThread threads[MAX_WORKERS];
+    HANDLE handles[MAX_WORKERS];
+    int numStarted = 0;
+    for (i = 1; i < numWorkers; i++) {
+        threads[numStarted].pJob = &job;
+        threads[numStarted].workerIndex = i;
+        handles[numStarted] = CreateThread(NULL, WORKER_STACK_SIZE, workerThreadFunc, &threads[numStarted], STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+        // if we can't make a thread, no problem, the threads we do have will pick up the slack
+        if (handles[numStarted] != NULL)
+            numStarted++;
+    }
+
+    // the calling thread is worker 0
+    runTasks(&job, 0);
+
+    if (numStarted > 0) {
+        WaitForMultipleObjects(numStarted, handles, TRUE, INFINITE);
+        for (i = 0; i < numStarted; i++) {
+            CloseHandle(handles[i]);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2026, Eric Haines
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// A minimal task runner: split numTasks independent jobs across worker threads and wait for all
+// of them to finish. The calling thread does its share of the work, too. Tasks are handed out in
+// increasing index order, but may complete in any order, so each task must write only to its own
+// output. workerIndex runs from 0 to (number of workers - 1) and can be used to select per-thread
+// scratch memory, with 0 always being the calling thread.
+
+typedef void (*WorkerTask)(int taskIndex, int workerIndex, void* userData);
+
+// Stack reserved for each worker thread. LoadBlock() puts a ~400 KB BlockEntity array on the
+// stack, and the main thread is given 1.5 MB (see StackReserveSize in the project), so match that.
+#define WORKER_STACK_SIZE 1500000
+
+// upper limit on workers, as we wait on all of their handles at once
+#define MAX_WORKERS 64
+
+// Returns the number of workers RunWorkerTasks will use, at least 1.
+int GetWorkerCount();
+// 0 means "use all processors"; 1 makes everything serial, handy for debugging.
+void SetWorkerCount(int count);
+// Run task(i, worker, userData) for i in [0, numTasks), using up to maxWorkers threads (0 means GetWorkerCount()).
+void RunWorkerTasks(int numTasks, WorkerTask task, void* userData, int maxWorkers = 0);